@@ -20,6 +20,12 @@ set(CONFIG_USE_driver_inputmux true)
 set(CONFIG_USE_driver_lpc_gpio true)
 set(CONFIG_USE_driver_lpc_iocon_lite true)
 set(CONFIG_USE_driver_lpc_miniusart true)
+set(CONFIG_USE_driver_lpc_miniusart_dma true)
+set(CONFIG_USE_driver_lpc_dma true)
+set(CONFIG_USE_driver_ctimer true)
+set(CONFIG_USE_driver_mrt true)
+set(CONFIG_USE_driver_wkt true)
+set(CONFIG_USE_driver_pint true)
 set(CONFIG_USE_driver_swm true)
 set(CONFIG_USE_driver_syscon true)
 set(CONFIG_USE_utility_assert_lite true)
@@ -27,6 +33,11 @@ set(CONFIG_USE_utilities_misc_utilities true)
 set(CONFIG_USE_utility_str true)
 set(CONFIG_USE_utility_debug_console_lite true)
 set(CONFIG_USE_component_miniusart_adapter true)
+set(CONFIG_USE_component_button true)
+set(CONFIG_USE_component_lists true)
+set(CONFIG_USE_component_lpc_gpio_adapter true)
+set(CONFIG_USE_component_mrt_adapter true)
+set(CONFIG_USE_component_timer_manager true)
 set(CONFIG_CORE cm0p)
 set(CONFIG_DEVICE LPC845)
 set(CONFIG_BOARD lpc845breakout)
@@ -0,0 +1,88 @@
+# Reporte de RAM estatica por tarea y por buzon, a partir de los simbolos del
+# ELF ya enlazado. Se ejecuta como paso POST_BUILD (ver CMakeLists.txt):
+#   cmake -DELF=<archivo.elf> -DNM=<nm> -DSIZE=<size> [-DRAM=<bytes>] -P reporte_ram.cmake
+#
+# tareas.c reserva la memoria de cada objeto con nombres fijos: pila_<tarea> y
+# tcb_<tarea> para las tareas, datos_<buzon> y bloque_<buzon> para los
+# buzones, las colas y los pools. Aca se agrupan por objeto. RAM es el
+# tamano de la SRAM para informar cuanto queda libre.
+
+cmake_minimum_required(VERSION 3.10.0)
+
+if(NOT ELF OR NOT NM OR NOT SIZE)
+    message(FATAL_ERROR "uso: cmake -DELF=... -DNM=... -DSIZE=... [-DRAM=...] -P reporte_ram.cmake")
+endif()
+
+execute_process(COMMAND ${NM} -S ${ELF} OUTPUT_VARIABLE simbolos)
+string(REPLACE "\n" ";" simbolos "${simbolos}")
+
+set(objetos "")
+foreach(linea IN LISTS simbolos)
+    # El sufijo que agregan LTO o los static locales (".0", ".lto_priv.0") no
+    # forma parte del nombre.
+    if(linea MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [bBdD] (pila|tcb|datos|bloque)_([A-Za-z0-9_]+)")
+        math(EXPR bytes "0x${CMAKE_MATCH_1}")
+        set(objeto ${CMAKE_MATCH_3})
+        if(CMAKE_MATCH_2 STREQUAL "pila" OR CMAKE_MATCH_2 STREQUAL "datos")
+            set(columna memoria)
+        else()
+            set(columna control)
+        endif()
+        if(NOT objeto IN_LIST objetos)
+            list(APPEND objetos ${objeto})
+            set(memoria_${objeto} 0)
+            set(control_${objeto} 0)
+        endif()
+        math(EXPR ${columna}_${objeto} "${${columna}_${objeto}} + ${bytes}")
+    endif()
+endforeach()
+
+# Alinea texto a la izquierda (ancho > 0) o a la derecha (ancho < 0).
+set(espacios "                    ")
+function(columna salida texto ancho)
+    string(LENGTH "${texto}" largo)
+    if(ancho LESS 0)
+        math(EXPR relleno "-(${ancho}) - ${largo}")
+    else()
+        math(EXPR relleno "${ancho} - ${largo}")
+    endif()
+    if(relleno LESS 1)
+        set(relleno 1)
+    endif()
+    string(SUBSTRING "${espacios}" 0 ${relleno} hueco)
+    if(ancho LESS 0)
+        set(${salida} "${${salida}}${hueco}${texto}" PARENT_SCOPE)
+    else()
+        set(${salida} "${${salida}}${texto}${hueco}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+list(SORT objetos)
+set(total 0)
+set(tabla "  objeto                pila/datos   tcb/bloque        total\n")
+foreach(objeto IN LISTS objetos)
+    math(EXPR suma "${memoria_${objeto}} + ${control_${objeto}}")
+    math(EXPR total "${total} + ${suma}")
+    set(fila "  ")
+    columna(fila ${objeto} 20)
+    columna(fila ${memoria_${objeto}} -12)
+    columna(fila ${control_${objeto}} -13)
+    columna(fila ${suma} -13)
+    string(APPEND tabla "${fila}\n")
+endforeach()
+message(STATUS "RAM estatica por objeto (bytes):\n${tabla}  total de tareas y buzones: ${total} bytes")
+
+# data + bss: toda la RAM que reserva la imagen, incluidas la pila de main y
+# el heap de la libc que define el linker script.
+execute_process(COMMAND ${SIZE} -B ${ELF} OUTPUT_VARIABLE tamano)
+string(REPLACE "\n" ";" tamano "${tamano}")
+list(GET tamano 1 linea)
+string(REGEX MATCH "^[ \t]*[0-9]+[ \t]+([0-9]+)[ \t]+([0-9]+)" _ "${linea}")
+math(EXPR ram_usada "${CMAKE_MATCH_1} + ${CMAKE_MATCH_2}")
+if(RAM)
+    math(EXPR ram_total "${RAM}")
+    math(EXPR ram_libre "${ram_total} - ${ram_usada}")
+    message(STATUS "RAM de la imagen (data + bss): ${ram_usada} de ${ram_total} bytes, libres ${ram_libre}")
+else()
+    message(STATUS "RAM de la imagen (data + bss): ${ram_usada} bytes")
+endif()
@@ -0,0 +1,34 @@
+# Reporte de tamano y de rutinas de punto flotante por software del ELF.
+# Se ejecuta como paso POST_BUILD (ver CMakeLists.txt):
+#   cmake -DELF=<archivo.elf> -DNM=<nm> -DSIZE=<size> -P reporte_softfloat.cmake
+#
+# El Cortex-M0+ no tiene FPU: cada operacion float/double se resuelve con una
+# llamada a __aeabi_f*/__aeabi_d* de libgcc. Con el camino de datos en enteros
+# (escalas.h) la lista debe quedar vacia; si aparece alguna, se informa su
+# tamano y quien la arrastro se puede buscar en output.map.
+
+if(NOT ELF OR NOT NM OR NOT SIZE)
+    message(FATAL_ERROR "uso: cmake -DELF=... -DNM=... -DSIZE=... -P reporte_softfloat.cmake")
+endif()
+
+execute_process(COMMAND ${SIZE} -B ${ELF} OUTPUT_VARIABLE tamano)
+message(STATUS "Tamano de la imagen:\n${tamano}")
+
+execute_process(COMMAND ${NM} -S --size-sort ${ELF} OUTPUT_VARIABLE simbolos)
+string(REPLACE "\n" ";" simbolos "${simbolos}")
+
+set(total 0)
+set(rutinas "")
+foreach(linea IN LISTS simbolos)
+    if(linea MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [tT] (__aeabi_(d|f|i2f|i2d|ui2f|ui2d|l2f|l2d|ul2f|ul2d)[a-z0-9_]*|__(add|sub|mul|div|fix|float|extend|trunc|cmp|eq|ne|lt|le|gt|ge|unord)[sd]f[a-z0-9_]*)$")
+        math(EXPR bytes "0x${CMAKE_MATCH_1}")
+        math(EXPR total "${total} + ${bytes}")
+        string(APPEND rutinas "  ${CMAKE_MATCH_2} (${bytes} bytes)\n")
+    endif()
+endforeach()
+
+if(total EQUAL 0)
+    message(STATUS "Punto flotante por software: ninguna rutina enlazada")
+else()
+    message(WARNING "Punto flotante por software enlazado (${total} bytes):\n${rutinas}")
+endif()
@@ -0,0 +1,118 @@
+#include <string.h>
+#include "bh1750.h"
+
+/* Conversion mas larga con MTreg tipico, en us (hoja de datos) */
+#define BH1750_ESPERA_H_US 180000U
+#define BH1750_ESPERA_L_US 24000U
+
+/* lux = cuenta / 1,2 * 69 / MTreg, la mitad en H2. En Q8 es
+ * cuenta * 14720 / MTreg: el factor lleva 4 bits de fraccion mas, asi
+ * cuenta * factor entra en 32 bits (65535 * 7597 con MTreg 31). */
+#define BH1750_LUX_Q8_MTREG 14720U
+#define BH1750_FACTOR_BITS  4U
+
+#define BH1750_ES_H2(modo) (((uint32_t)(modo) & 0x0FU) == 0x01U)
+#define BH1750_ES_L(modo)  (((uint32_t)(modo) & 0x0FU) == 0x03U)
+#define BH1750_ES_CONTINUO(modo) (((uint32_t)(modo) & 0xF0U) == 0x10U)
+
+static void bh1750_comando_hecho(bus_i2c_transaccion_t *t, status_t estado, void *usuario) {
+    bh1750_t *s = usuario;
+
+    (void)t;
+    if (estado != kStatus_Success) s->errores++;
+}
+
+static void bh1750_lectura_hecha(bus_i2c_transaccion_t *t, status_t estado, void *usuario) {
+    bh1750_t *s = usuario;
+
+    (void)t;
+    /* Primero el byte alto */
+    if (estado == kStatus_Success) s->cuenta = (uint16_t)(((uint16_t)s->crudo[0] << 8) | s->crudo[1]);
+    if (s->aviso != NULL) s->aviso(s, estado, s->usuario);
+}
+
+static void bh1750_preparar(bus_i2c_transaccion_t *t, uint8_t direccion, i2c_direction_t sentido, uint8_t *datos,
+                            size_t tamanio, bus_i2c_aviso_t aviso, bh1750_t *s) {
+    memset(t, 0, sizeof(*t));
+    t->xfer.slaveAddress = direccion;
+    t->xfer.direction = sentido;
+    t->xfer.data = datos;
+    t->xfer.dataSize = tamanio;
+    t->xfer.flags = kI2C_TransferDefaultFlag;
+    t->aviso = aviso;
+    t->usuario = s;
+    t->estado = kStatus_Success;
+}
+
+/* Las dos divisiones por MTreg se hacen aca, una vez por configuracion; cada
+ * muestra despues es una multiplicacion y un corrimiento. */
+static void bh1750_calcular(bh1750_t *s) {
+    const uint32_t mtreg = s->mtreg;
+    const uint32_t espera = BH1750_ES_L(s->modo) ? BH1750_ESPERA_L_US : BH1750_ESPERA_H_US;
+
+    s->factor = ((BH1750_LUX_Q8_MTREG << BH1750_FACTOR_BITS) + mtreg / 2U) / mtreg;
+    s->espera_us = (espera * mtreg + BH1750_MTREG_TIPICO - 1U) / BH1750_MTREG_TIPICO;
+}
+
+void bh1750_iniciar(bh1750_t *s, bus_i2c_t *bus, uint8_t direccion, bh1750_aviso_t aviso, void *usuario) {
+    uint32_t i;
+
+    memset(s, 0, sizeof(*s));
+    s->bus = bus;
+    s->modo = BH1750_UNICO_H;
+    s->mtreg = BH1750_MTREG_TIPICO;
+    s->aviso = aviso;
+    s->usuario = usuario;
+    for (i = 0; i < 3U; i++) {
+        bh1750_preparar(&s->comandos[i], direccion, kI2C_Write, &s->codigos[i], 1U, bh1750_comando_hecho, s);
+    }
+    bh1750_preparar(&s->lectura, direccion, kI2C_Read, s->crudo, sizeof(s->crudo), bh1750_lectura_hecha, s);
+    bh1750_calcular(s);
+}
+
+status_t bh1750_configurar(bh1750_t *s, bh1750_modo_t modo, uint8_t mtreg) {
+    uint32_t i;
+
+    if (mtreg < BH1750_MTREG_MIN || mtreg > BH1750_MTREG_MAX) return kStatus_InvalidArgument;
+    for (i = 0; i < 3U; i++) {
+        if (s->comandos[i].estado == kStatus_I2C_Busy) return kStatus_I2C_Busy;
+    }
+
+    s->modo = modo;
+    s->mtreg = mtreg;
+    bh1750_calcular(s);
+
+    /* MTreg va en dos comandos: 01000_MT[7:5] y 011_MT[4:0] */
+    s->codigos[0] = (uint8_t)(0x40U | (mtreg >> 5));
+    s->codigos[1] = (uint8_t)(0x60U | (mtreg & 0x1FU));
+    s->codigos[2] = (uint8_t)modo;
+    (void)bus_i2c_encolar(s->bus, &s->comandos[0]);
+    (void)bus_i2c_encolar(s->bus, &s->comandos[1]);
+    /* MTreg vale desde el proximo comando de medicion */
+    if (BH1750_ES_CONTINUO(modo)) (void)bus_i2c_encolar(s->bus, &s->comandos[2]);
+    return kStatus_Success;
+}
+
+status_t bh1750_medir(bh1750_t *s) {
+    if (s->comandos[2].estado == kStatus_I2C_Busy) return kStatus_I2C_Busy;
+    s->codigos[2] = (uint8_t)s->modo;
+    return bus_i2c_encolar(s->bus, &s->comandos[2]);
+}
+
+status_t bh1750_leer(bh1750_t *s) {
+    return bus_i2c_encolar(s->bus, &s->lectura);
+}
+
+uint32_t bh1750_espera_us(const bh1750_t *s) {
+    return s->espera_us;
+}
+
+uint32_t bh1750_lux_q8(const bh1750_t *s) {
+    const uint32_t bits = BH1750_ES_H2(s->modo) ? BH1750_FACTOR_BITS + 1U : BH1750_FACTOR_BITS;
+
+    return ((uint32_t)s->cuenta * s->factor) >> bits;
+}
+
+uint32_t bh1750_lux(const bh1750_t *s) {
+    return (bh1750_lux_q8(s) + 128U) >> 8;
+}
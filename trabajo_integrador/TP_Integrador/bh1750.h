@@ -0,0 +1,85 @@
+#ifndef BH1750_H
+#define BH1750_H
+
+#include <stdint.h>
+#include "bus_i2c.h"
+
+/* Sensor de luz BH1750 sobre la cola del bus I2C (bus_i2c.h). Los comandos y
+ * la lectura son transacciones encoladas: ninguna funcion espera al bus ni a
+ * la conversion. La conversion dura hasta bh1750_espera_us() y el bus queda
+ * libre mientras tanto; la tarea que mide espera ese tiempo por su cuenta
+ * (vTaskDelay, un temporizador) y despues encola la lectura.
+ *
+ * - Unico: bh1750_medir() dispara una conversion y el sensor se apaga al
+ *   terminarla.
+ * - Continuo: bh1750_configurar() deja al sensor convirtiendo sin parar; cada
+ *   bh1750_leer() trae la ultima conversion terminada.
+ *
+ * MTreg (31 a 254, 69 de fabrica) estira o acorta la conversion: con mas
+ * MTreg mas resolucion y mas demora, proporcionales. */
+
+#define BH1750_DIRECCION     0x23U /* ADDR a GND */
+#define BH1750_DIRECCION_ALT 0x5CU /* ADDR a VCC */
+
+#define BH1750_MTREG_MIN    31U
+#define BH1750_MTREG_TIPICO 69U
+#define BH1750_MTREG_MAX    254U
+
+/* Los valores son los codigos de operacion. Resolucion y conversion con
+ * MTreg tipico: H 1 lx y 180 ms, H2 0,5 lx y 180 ms, L 4 lx y 24 ms (maximos
+ * de la hoja de datos). */
+typedef enum {
+    BH1750_CONTINUO_H = 0x10,
+    BH1750_CONTINUO_H2 = 0x11,
+    BH1750_CONTINUO_L = 0x13,
+    BH1750_UNICO_H = 0x20,
+    BH1750_UNICO_H2 = 0x21,
+    BH1750_UNICO_L = 0x23,
+} bh1750_modo_t;
+
+typedef struct bh1750 bh1750_t;
+
+/* Fin de una lectura, desde el aviso del bus (interrupcion del I2C). */
+typedef void (*bh1750_aviso_t)(bh1750_t *s, status_t estado, void *usuario);
+
+struct bh1750 {
+    bus_i2c_t *bus;
+    bh1750_modo_t modo;
+    uint8_t mtreg;
+    uint32_t espera_us;
+    uint32_t factor;                  /* cuenta -> lux Q8, con el modo y MTreg */
+    /* MTreg alto, MTreg bajo y modo, un byte por escritura */
+    bus_i2c_transaccion_t comandos[3];
+    uint8_t codigos[3];
+    bus_i2c_transaccion_t lectura;
+    uint8_t crudo[2];
+    volatile uint16_t cuenta;         /* ultima cuenta leida */
+    uint32_t errores;                 /* comandos sin ACK */
+    bh1750_aviso_t aviso;
+    void *usuario;
+};
+
+/* Prepara el sensor en la direccion dada, en unico H con MTreg tipico. No
+ * sale nada al bus. aviso puede ser NULL. */
+void bh1750_iniciar(bh1750_t *s, bus_i2c_t *bus, uint8_t direccion, bh1750_aviso_t aviso, void *usuario);
+
+/* Encola MTreg y, en los modos continuos, el modo, que arranca las
+ * conversiones. Devuelve kStatus_InvalidArgument con MTreg fuera de rango y
+ * kStatus_I2C_Busy si todavia hay comandos en la cola. */
+status_t bh1750_configurar(bh1750_t *s, bh1750_modo_t modo, uint8_t mtreg);
+
+/* Encola el comando del modo: en unico dispara una conversion, en continuo
+ * la vuelve a empezar. */
+status_t bh1750_medir(bh1750_t *s);
+
+/* Encola la lectura de la cuenta; el resultado llega con el aviso. */
+status_t bh1750_leer(bh1750_t *s);
+
+/* Conversion mas larga con el modo y MTreg actuales, en us. */
+uint32_t bh1750_espera_us(const bh1750_t *s);
+
+/* Lux de la ultima lectura en Q8 (lux * 256), y redondeados a entero. */
+uint32_t bh1750_lux_q8(const bh1750_t *s);
+uint32_t bh1750_lux(const bh1750_t *s);
+
+#endif /* BH1750_H */
@@ -0,0 +1,32 @@
+#include "botones.h"
+
+static QueueHandle_t suscriptores[BOTONES_CANTIDAD];
+static TaskHandle_t avisados[BOTONES_CANTIDAD];
+static uint32_t bits_aviso[BOTONES_CANTIDAD];
+static volatile uint32_t descartados;
+
+void botones_suscribir(boton_t boton, QueueHandle_t cola) {
+    configASSERT(boton < BOTONES_CANTIDAD);
+    suscriptores[boton] = cola;
+}
+
+void botones_avisar(boton_t boton, TaskHandle_t tarea, uint32_t bits) {
+    configASSERT(boton < BOTONES_CANTIDAD);
+    avisados[boton] = tarea;
+    bits_aviso[boton] = bits;
+}
+
+void botones_publicar_desde_isr(boton_t boton, boton_accion_t accion, BaseType_t *despertar) {
+    boton_evento_t evento = {(uint8_t)boton, (uint8_t)accion};
+
+    if (suscriptores[boton] == NULL) return;
+    if (xQueueSendFromISR(suscriptores[boton], &evento, despertar) != pdPASS) {
+        descartados++;
+    } else if (avisados[boton] != NULL) {
+        xTaskNotifyFromISR(avisados[boton], bits_aviso[boton], eSetBits, despertar);
+    }
+}
+
+uint32_t botones_descartados(void) {
+    return descartados;
+}
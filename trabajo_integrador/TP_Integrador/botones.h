@@ -0,0 +1,56 @@
+#ifndef BOTONES_H
+#define BOTONES_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Botones por interrupcion. El backend de cada plataforma detecta los flancos
+ * por interrupcion de pin, filtra el rebote con un temporizador que solo corre
+ * mientras hay un boton en movimiento y entrega cada pulsacion ya clasificada
+ * como un evento en la cola de la tarea suscripta. Las tareas bloquean en su
+ * cola: con los botones quietos no hay ninguna activacion y el tickless idle
+ * puede dormir hasta la proxima tarea periodica.
+ *
+ *   placa:     botones_lpc845.c, sobre fsl_component_button (PINT + MRT)
+ *   simulador: host/botones_sim.c, con flancos y rebotes sinteticos */
+
+typedef enum {
+    BOTON_S1,
+    BOTON_S2,
+    BOTON_USER,
+    BOTONES_CANTIDAD
+} boton_t;
+
+typedef enum {
+    BOTON_CLICK = 1,  /* pulsacion corta */
+    BOTON_LARGO,      /* mantenido mas de BOTON_LARGO_MS */
+} boton_accion_t;
+
+#define BOTON_LARGO_MS 500
+
+typedef struct {
+    uint8_t boton;   /* boton_t */
+    uint8_t accion;  /* boton_accion_t */
+} boton_evento_t;
+
+/* Los eventos de "boton" van a "cola" (de boton_evento_t). Se llama antes de
+ * botones_iniciar(); varios botones pueden compartir una cola. */
+void botones_suscribir(boton_t boton, QueueHandle_t cola);
+
+/* Ademas de encolar cada evento de "boton", pone "bits" en la notificacion
+ * de "tarea": para una tarea que tambien espera otros avisos y no puede
+ * bloquear solo en su cola. Se llama antes de botones_iniciar(). */
+void botones_avisar(boton_t boton, TaskHandle_t tarea, uint32_t bits);
+
+/* Arranca el backend: configura los pines y las interrupciones. */
+void botones_iniciar(void);
+
+/* Eventos descartados porque la cola del suscriptor estaba llena. */
+uint32_t botones_descartados(void);
+
+/* Para los backends, desde la interrupcion del temporizador de antirrebote. */
+void botones_publicar_desde_isr(boton_t boton, boton_accion_t accion, BaseType_t *despertar);
+
+#endif /* BOTONES_H */
@@ -0,0 +1,77 @@
+#include "fsl_component_button.h"
+#include "fsl_component_timer_manager.h"
+#include "fsl_clock.h"
+#include "FreeRTOS.h"
+#include "tracerecorder.h"
+#include "botones.h"
+
+#if BUTTON_LONG_PRESS_THRESHOLD != BOTON_LARGO_MS
+#error "BOTON_LARGO_MS debe coincidir con BUTTON_LONG_PRESS_THRESHOLD"
+#endif
+
+/* Backend de la placa sobre el componente button del SDK: cada pin tiene una
+ * interrupcion PINT por flanco y el componente arranca un temporizador de
+ * BUTTON_TIMER_INTERVAL ms (MRT, via timer_manager) que muestrea los pines
+ * mientras alguno esta presionado y se detiene al soltarlos. Sin OSA el
+ * callback corre en la interrupcion del temporizador. */
+
+/* Pulsadores a masa con pull-up: S1 es K3 (PIO0_4) y S2 es K1/ISP (PIO0_12)
+ * del LPC845-BRK; USER es un pulsador externo en PIO0_13. */
+static const button_config_t config_botones[BOTONES_CANTIDAD] = {
+    [BOTON_S1] = {.gpio = {.direction = kHAL_GpioDirectionIn, .pinStateDefault = 1U, .port = 0U, .pin = 4U}},
+    [BOTON_S2] = {.gpio = {.direction = kHAL_GpioDirectionIn, .pinStateDefault = 1U, .port = 0U, .pin = 12U}},
+    [BOTON_USER] = {.gpio = {.direction = kHAL_GpioDirectionIn, .pinStateDefault = 1U, .port = 0U, .pin = 13U}},
+};
+
+static BUTTON_HANDLE_ARRAY_DEFINE(handles, BOTONES_CANTIDAD);
+static UBaseType_t traza_mrt;
+
+static button_status_t al_evento(void *handle, button_callback_message_t *mensaje, void *parametro) {
+    boton_t boton = (boton_t)(uintptr_t)parametro;
+    BaseType_t despertar = pdFALSE;
+
+    (void)handle;
+    vTraceRecorderISREnter(traza_mrt);
+    switch (mensaje->event) {
+        case kBUTTON_EventOneClick:
+        case kBUTTON_EventShortPress:
+            botones_publicar_desde_isr(boton, BOTON_CLICK, &despertar);
+            break;
+        case kBUTTON_EventDoubleClick:
+            /* Son dos pulsaciones cortas. */
+            botones_publicar_desde_isr(boton, BOTON_CLICK, &despertar);
+            botones_publicar_desde_isr(boton, BOTON_CLICK, &despertar);
+            break;
+        case kBUTTON_EventLongPress:
+            botones_publicar_desde_isr(boton, BOTON_LARGO, &despertar);
+            break;
+        default:
+            break;
+    }
+    vTraceRecorderISRExit(traza_mrt);
+    portYIELD_FROM_ISR(despertar);
+    return kStatus_BUTTON_Success;
+}
+
+void botones_iniciar(void) {
+    timer_config_t config_timer = {0};
+    button_config_t config;
+    uint32_t i;
+
+    traza_mrt = uxTraceRecorderRegister(traceOBJECT_ISR, "MRT");
+
+    /* El MRT cuenta con el reloj del sistema. */
+    config_timer.instance = 0U;
+    config_timer.srcClock_Hz = CLOCK_GetFreq(kCLOCK_CoreSysClk);
+    (void)TM_Init(&config_timer);
+
+    for (i = 0; i < BOTONES_CANTIDAD; i++) {
+        config = config_botones[i];
+        (void)BUTTON_Init((button_handle_t)handles[i], &config);
+        (void)BUTTON_InstallCallback((button_handle_t)handles[i], al_evento, (void *)(uintptr_t)i);
+
+        /* El adaptador GPIO asigna los canales PINT en orden; el flanco tiene
+         * que despertar al nucleo del deep sleep (tickless_wkt.c). */
+        EnableDeepSleepIRQ((IRQn_Type)(PIN_INT0_IRQn + i));
+    }
+}
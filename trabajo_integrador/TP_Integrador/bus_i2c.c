@@ -0,0 +1,133 @@
+#include <string.h>
+#include "bus_i2c.h"
+
+static void bus_i2c_avanzar(bus_i2c_t *bus);
+
+static bus_i2c_transaccion_t *bus_i2c_sacar(bus_i2c_t *bus) {
+    bus_i2c_transaccion_t *t = bus->primera;
+
+    bus->primera = t->siguiente;
+    if (bus->primera == NULL) bus->ultima = NULL;
+    t->siguiente = NULL;
+    return t;
+}
+
+/* El aviso y el usuario se leen antes del estado: con el estado final la
+ * transaccion vuelve a ser del que la encolo. */
+static void bus_i2c_avisar(bus_i2c_t *bus, bus_i2c_transaccion_t *t, status_t estado) {
+    const bus_i2c_aviso_t aviso = t->aviso;
+    void *usuario = t->usuario;
+
+    if (estado == kStatus_Success) {
+        bus->completadas++;
+    } else {
+        bus->errores++;
+    }
+    t->estado = estado;
+    if (aviso != NULL) aviso(t, estado, usuario);
+}
+
+/* Fin de una transferencia de fsl_i2c.c, en su interrupcion. Despues de la
+ * seleccion del multiplexor sale la transaccion; despues de la transaccion,
+ * la siguiente de la cola arranca antes del aviso, para no dejar el bus
+ * quieto mientras corre. */
+static void bus_i2c_al_terminar(I2C_Type *base, i2c_master_handle_t *handle, status_t estado, void *datos) {
+    bus_i2c_t *bus = datos;
+    bus_i2c_transaccion_t *t;
+
+    (void)base;
+    (void)handle;
+
+    if (bus->seleccionando) {
+        bus->seleccionando = 0;
+        if (estado == kStatus_Success) {
+            estado = I2C_MasterTransferNonBlocking(bus->base, &bus->manejador, &bus->primera->xfer);
+            if (estado == kStatus_Success) return;
+        } else {
+            /* El canal no quedo seleccionado: que la proxima lo vuelva a
+             * escribir. */
+            bus->primera->mux->last_chan = 0;
+        }
+    }
+
+    bus->ocupado = 0;
+    t = bus_i2c_sacar(bus);
+    bus_i2c_avanzar(bus);
+    bus_i2c_avisar(bus, t, estado);
+}
+
+/* Arranca la primera de la cola si el bus esta libre. Las que no pueden
+ * arrancar terminan ahi mismo con el error. */
+static void bus_i2c_avanzar(bus_i2c_t *bus) {
+    bus_i2c_transaccion_t *t;
+    status_t estado;
+
+    while (!bus->ocupado && bus->primera != NULL) {
+        t = bus->primera;
+        estado = kStatus_Success;
+        if (t->mux != NULL) estado = PCA954X_SelectChan(t->mux, t->canal);
+        if (estado == kStatus_Success && !bus->seleccionando) {
+            estado = I2C_MasterTransferNonBlocking(bus->base, &bus->manejador, &t->xfer);
+        }
+        if (estado == kStatus_Success) {
+            bus->ocupado = 1;
+        } else {
+            (void)bus_i2c_sacar(bus);
+            bus_i2c_avisar(bus, t, estado);
+        }
+    }
+}
+
+void bus_i2c_iniciar(bus_i2c_t *bus, I2C_Type *base) {
+    memset(bus, 0, sizeof(*bus));
+    bus->base = base;
+    I2C_MasterTransferCreateHandle(base, &bus->manejador, bus_i2c_al_terminar, bus);
+}
+
+status_t bus_i2c_encolar(bus_i2c_t *bus, bus_i2c_transaccion_t *t) {
+    uint32_t mascara = DisableGlobalIRQ();
+
+    if (t->estado == kStatus_I2C_Busy) {
+        EnableGlobalIRQ(mascara);
+        return kStatus_I2C_Busy;
+    }
+    t->estado = kStatus_I2C_Busy;
+    t->siguiente = NULL;
+    if (bus->ultima != NULL) {
+        bus->ultima->siguiente = t;
+    } else {
+        bus->primera = t;
+    }
+    bus->ultima = t;
+    bus_i2c_avanzar(bus);
+
+    EnableGlobalIRQ(mascara);
+    return kStatus_Success;
+}
+
+status_t bus_i2c_pca954x_enviar(void *base, uint8_t deviceAddress, uint32_t subAddress, uint8_t subaddressSize,
+                                const uint8_t *txBuff, uint8_t txBuffSize, uint32_t flags) {
+    bus_i2c_t *bus = base;
+    status_t estado;
+
+    /* PCA954X_SelectChan() pasa el registro de control desde su pila: se
+     * copia para la transferencia, que termina despues. */
+    if (txBuffSize != 1U) return kStatus_InvalidArgument;
+    bus->dato_mux = txBuff[0];
+
+    memset(&bus->xfer_mux, 0, sizeof(bus->xfer_mux));
+    bus->xfer_mux.slaveAddress = deviceAddress;
+    bus->xfer_mux.direction = kI2C_Write;
+    bus->xfer_mux.subaddress = subAddress;
+    bus->xfer_mux.subaddressSize = subaddressSize;
+    bus->xfer_mux.data = &bus->dato_mux;
+    bus->xfer_mux.dataSize = 1U;
+    bus->xfer_mux.flags = flags;
+
+    estado = I2C_MasterTransferNonBlocking(bus->base, &bus->manejador, &bus->xfer_mux);
+    if (estado == kStatus_Success) {
+        bus->seleccionando = 1;
+        bus->selecciones++;
+    }
+    return estado;
+}
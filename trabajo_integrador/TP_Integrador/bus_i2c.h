@@ -0,0 +1,71 @@
+#ifndef BUS_I2C_H
+#define BUS_I2C_H
+
+#include <stdint.h>
+#include "fsl_i2c.h"
+#include "fsl_pca954x.h"
+
+/* Cola de transacciones sobre un bus I2C maestro (fsl_i2c.c). Las tareas
+ * encolan transacciones sin esperar al bus; la interrupcion del I2C arranca
+ * cada una apenas termina la anterior, sin pasar por ninguna tarea, y avisa
+ * el fin de cada una por separado.
+ *
+ * Las transacciones son del que las encola y quedan enlazadas en la cola
+ * hasta el aviso: no se tocan ni se vuelven a encolar mientras tanto. El
+ * aviso corre en la interrupcion del I2C (o dentro de bus_i2c_encolar() si la
+ * transferencia ni siquiera pudo arrancar); para despertar a una tarea se usa
+ * xTaskNotifyFromISR() o similar desde ahi.
+ *
+ * Un esclavo detras de un multiplexor PCA954x lleva el handle del
+ * multiplexor (fsl_pca954x.c) y el canal en la transaccion. Antes de
+ * arrancarla, el bus selecciona el canal con PCA954X_SelectChan(), que solo
+ * escribe al multiplexor si el canal cambio; la seleccion y la transaccion
+ * salen juntas, sin que otra se meta en el medio. */
+
+typedef struct bus_i2c_transaccion bus_i2c_transaccion_t;
+
+typedef void (*bus_i2c_aviso_t)(bus_i2c_transaccion_t *t, status_t estado, void *usuario);
+
+struct bus_i2c_transaccion {
+    i2c_master_transfer_t xfer;     /* lo que sale al bus (fsl_i2c.h) */
+    pca954x_handle_t *mux;          /* NULL si el esclavo no esta detras de un multiplexor */
+    uint8_t canal;                  /* canal del multiplexor */
+    bus_i2c_aviso_t aviso;          /* puede ser NULL */
+    void *usuario;
+    volatile status_t estado;       /* kStatus_I2C_Busy hasta el aviso, despues el resultado */
+    bus_i2c_transaccion_t *siguiente;
+};
+
+typedef struct {
+    I2C_Type *base;
+    i2c_master_handle_t manejador;
+    /* Cola: la primera es la que esta en el bus */
+    bus_i2c_transaccion_t *primera;
+    bus_i2c_transaccion_t *ultima;
+    /* Hay una transferencia de fsl_i2c.c en curso, y es la seleccion del
+     * multiplexor */
+    volatile uint8_t ocupado;
+    uint8_t seleccionando;
+    i2c_master_transfer_t xfer_mux;
+    uint8_t dato_mux;
+    uint32_t completadas;
+    uint32_t errores;
+    uint32_t selecciones;           /* escrituras a multiplexores */
+} bus_i2c_t;
+
+/* Toma el I2C ya iniciado con I2C_MasterInit(); crea el handle de fsl_i2c.c,
+ * asi que el bus es el unico que hace transferencias en ese I2C. */
+void bus_i2c_iniciar(bus_i2c_t *bus, I2C_Type *base);
+
+/* Agrega la transaccion al final de la cola. Devuelve kStatus_I2C_Busy si la
+ * transaccion ya esta encolada; si no, kStatus_Success y el resultado llega
+ * con el aviso. Se puede llamar desde tareas y desde los avisos. */
+status_t bus_i2c_encolar(bus_i2c_t *bus, bus_i2c_transaccion_t *t);
+
+/* Funcion de envio para pca954x_config_t, con el bus como i2cBase: la
+ * seleccion de canal sale por el bus sin bloquear. Solo la llama el bus,
+ * dentro de PCA954X_SelectChan(). */
+status_t bus_i2c_pca954x_enviar(void *base, uint8_t deviceAddress, uint32_t subAddress, uint8_t subaddressSize,
+                                const uint8_t *txBuff, uint8_t txBuffSize, uint32_t flags);
+
+#endif /* BUS_I2C_H */
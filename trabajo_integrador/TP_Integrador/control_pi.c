@@ -0,0 +1,41 @@
+#include "control_pi.h"
+
+#define GANANCIA_SHIFT 12
+
+void control_pi_iniciar(control_pi_t *pi, int16_t kp, int16_t ki,
+                        int16_t salida_min, int16_t salida_max) {
+    pi->kp = kp;
+    pi->ki = ki;
+    pi->salida_min = salida_min;
+    pi->salida_max = salida_max;
+    pi->integral = 0;
+}
+
+int16_t control_pi_paso(control_pi_t *pi, int16_t referencia, int16_t medicion) {
+    const int32_t min = (int32_t)pi->salida_min << GANANCIA_SHIFT;
+    const int32_t max = (int32_t)pi->salida_max << GANANCIA_SHIFT;
+    int32_t error = (int32_t)referencia - medicion;
+    int32_t integral;
+    int32_t salida;
+
+    /* |error| < 2^16 y |ganancia| < 2^15: el producto entra en 31 bits. */
+    if (error > INT16_MAX) error = INT16_MAX;
+    if (error < -INT16_MAX) error = -INT16_MAX;
+
+    integral = pi->integral + pi->ki * error;
+    if (integral > max) integral = max;
+    if (integral < min) integral = min;
+
+    salida = pi->kp * error + integral;
+    if (salida > max) {
+        salida = max;
+        /* Integracion condicional: no seguir cargando en saturacion. */
+        if (error > 0) integral = pi->integral;
+    } else if (salida < min) {
+        salida = min;
+        if (error < 0) integral = pi->integral;
+    }
+
+    pi->integral = integral;
+    return (int16_t)(salida >> GANANCIA_SHIFT);
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef CONTROL_PI_H
+#define CONTROL_PI_H
+
+#include <stdint.h>
+
+/* Controlador PI en punto fijo, sin operaciones de punto flotante. La razon
+ * es que el Cortex-M0+ no tiene FPU: con FPU la version en float es mas
+ * rapida (en el host, bench_control da el Q15 a 0.7-0.8x).
+ *
+ * - Senales (referencia, medicion, salida) en Q15: 0..32767 = 0..100 %.
+ * - Ganancias en Q4.12 (0..7.999). ki ya incluye el periodo de muestreo.
+ * - El integrador se guarda en Q27 (Q15 << 12) y todos los productos entran
+ *   en 32 bits, asi que un paso no llama a ninguna rutina de la libreria.
+ *
+ * Anti-windup: el integrador queda acotado al rango de la salida y no integra
+ * mientras la salida esta saturada en el sentido del error. */
+
+#define CONTROL_PI_Q15(x)      ((int16_t)((x) * 32767.0 + 0.5))
+#define CONTROL_PI_GANANCIA(x) ((int16_t)((x) * 4096.0 + 0.5))
+
+typedef struct {
+    int16_t kp;
+    int16_t ki;
+    int16_t salida_min;
+    int16_t salida_max;
+    int32_t integral;
+} control_pi_t;
+
+void control_pi_iniciar(control_pi_t *pi, int16_t kp, int16_t ki,
+                        int16_t salida_min, int16_t salida_max);
+
+/* Un paso del controlador; devuelve la salida en Q15. */
+int16_t control_pi_paso(control_pi_t *pi, int16_t referencia, int16_t medicion);
+
+#endif /* CONTROL_PI_H */
@@ -1,24 +1,16 @@
-#include <stdio.h>
-#include <stdint.h>
-#include <stdbool.h>
+#include "drivers_simulados.h"
 
-#define S1 1
-#define S2 2
-#define BOTON_USER 3
+/* Luz que aporta el LED al sensor, para que el lazo de control tenga planta:
+ * hasta LED_LUX_MAX con 100 % de duty, con respuesta de primer orden. */
+#define LED_LUX_MAX 10000
+static uint16_t led_lux_objetivo = 0;
 
 uint16_t BH1750_ReadLux(void) {
     static uint16_t lux = 0;
+    static int32_t led_lux = 0;
     lux = (lux + 500) % 21000;
-    return lux;
-}
-
-bool BotonPresionado(int boton) {
-    static int contador = 0;
-    contador++;
-    if (boton == S1 && contador % 100 == 0) return true;
-    if (boton == S2 && contador % 150 == 0) return true;
-    if (boton == BOTON_USER && contador % 200 == 0) return true;
-    return false;
+    led_lux += ((int32_t)led_lux_objetivo - led_lux) / 4;
+    return lux + (uint16_t)led_lux;
 }
 
 uint16_t LeerADC(void) {
@@ -27,10 +19,12 @@ uint16_t LeerADC(void) {
     return adc;
 }
 
-void PWM_SetDutyCycle(float porcentaje) {
-    printf("[PWM] LED azul: %.1f%%\r\n", porcentaje);
+void PWM_SetDutyCycle(int16_t duty) {
+    led_lux_objetivo = (uint16_t)(((uint32_t)duty * LED_LUX_MAX) >> 15);
 }
 
+/* Los valores mostrados y el duty ya no se imprimen: viajan en la telemetria
+ * (telemetria.h) sin bloquear a las tareas en la UART. */
 void Display7Segmentos_Mostrar(int valor) {
-    printf("[Display] Valor mostrado: %d\r\n", valor);
+    (void)valor;
 }
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef DRIVERS_SIMULADOS_H
+#define DRIVERS_SIMULADOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+uint16_t BH1750_ReadLux(void);
+uint16_t LeerADC(void);
+/* duty en Q15 (ver escalas.h) */
+void PWM_SetDutyCycle(int16_t duty);
+void Display7Segmentos_Mostrar(int valor);
+
+#endif /* DRIVERS_SIMULADOS_H */
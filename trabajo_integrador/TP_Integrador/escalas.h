@@ -0,0 +1,33 @@
+#ifndef ESCALAS_H
+#define ESCALAS_H
+
+#include <stdint.h>
+
+/* Representacion entera del camino de datos. Luz, setpoint y duty viajan en
+ * Q15: 0..32767 = 0..100 %. Las conversiones de este archivo son
+ * multiplicacion y desplazamiento por constantes calculadas en compilacion:
+ * el Cortex-M0+ no tiene FPU ni division por hardware, y estas macros no
+ * llaman a ninguna rutina de la libreria (__aeabi_dmul, __aeabi_ddiv,
+ * __aeabi_uidiv...). El resto del firmware si divide en tiempo de ejecucion
+ * (__aeabi_uidiv, __aeabi_uldivmod): latencia.c, periodica.c, monitor.c,
+ * tickless.c y el paso a digitos decimales (/ 10, % 10) del display. */
+
+#define Q15_MAX 32767
+
+/* Lux que corresponden al 100 % de luz. */
+#define LUX_MAX 20000U
+
+#define ESCALA_LUX_Q15        ((((uint32_t)Q15_MAX << 16) + LUX_MAX / 2) / LUX_MAX)
+#define ESCALA_PORCENTAJE_Q15 ((((uint32_t)Q15_MAX << 16) + 50U) / 100U)
+
+/* lux en 0..LUX_MAX -> Q15 */
+#define LUX_A_Q15(lux) ((int16_t)(((uint32_t)(lux) * ESCALA_LUX_Q15 + 0x8000U) >> 16))
+
+/* Porcentaje entero 0..100 -> Q15 */
+#define PORCENTAJE_A_Q15(p) ((int16_t)(((uint32_t)(p) * ESCALA_PORCENTAJE_Q15 + 0x8000U) >> 16))
+
+/* Q15 -> porcentaje entero y decimas de porcentaje, redondeados. */
+#define Q15_A_PORCENTAJE(q) ((uint16_t)(((uint32_t)(q) * 100U + 0x4000U) >> 15))
+#define Q15_A_DECIMAS(q)    ((uint16_t)(((uint32_t)(q) * 1000U + 0x4000U) >> 15))
+
+#endif /* ESCALAS_H */
@@ -0,0 +1,56 @@
+#include "fsl_ctimer.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+#include "tracerecorder.h"
+
+/* CTIMER0 corriendo libre a 1 MHz, 1000 veces el tick. Es la base de tiempo de
+ * las run-time stats del kernel y el contador de los temporizadores de alta
+ * resolucion (FreeRTOSConfig.h). Con 32 bits da la vuelta cada ~71.6 min;
+ * el monitor solo usa diferencias entre reportes y los temporizadores,
+ * distancias de menos de media vuelta.
+ *
+ * El match 1 interrumpe cuando vence el primer temporizador de alta
+ * resolucion (timers.c lo programa). Se arma recien al iniciar el scheduler,
+ * asi que esos temporizadores se arrancan desde las tareas. */
+#define ESTADISTICAS_HZ configHIGH_RES_TIMER_HZ
+
+static UBaseType_t traza_ctimer;
+
+static void ctimer_match(uint32_t flags) {
+    (void)flags;
+    vTraceRecorderISREnter(traza_ctimer);
+    vTimerHighResInterruptHandler();
+    vTraceRecorderISRExit(traza_ctimer);
+}
+
+static ctimer_callback_t callback_ctimer = ctimer_match;
+
+void vConfigureTimerForRunTimeStats(void) {
+    ctimer_config_t config;
+
+    traza_ctimer = uxTraceRecorderRegister(traceOBJECT_ISR, "CTIMER0");
+    CTIMER_GetDefaultConfig(&config);
+    config.prescale = SystemCoreClock / ESTADISTICAS_HZ - 1U;
+    CTIMER_Init(CTIMER0, &config);
+    CTIMER_RegisterCallBack(CTIMER0, &callback_ctimer, kCTIMER_SingleCallback);
+    EnableIRQ(CTIMER0_IRQn);
+    CTIMER_StartTimer(CTIMER0);
+}
+
+uint32_t ulGetRunTimeCounterValue(void) {
+    return CTIMER0->TC;
+}
+
+/* Se llaman con las interrupciones enmascaradas. */
+void vHighResTimerSetCompare(uint32_t cuenta) {
+    CTIMER0->MR[1] = cuenta;
+    CTIMER0->MCR |= CTIMER_MCR_MR1I_MASK;
+
+    /* Si la cuenta ya paso, el match no llega hasta la proxima vuelta: se
+     * dispara la interrupcion a mano y el handler ve el vencimiento. */
+    if (CTIMER0->TC - cuenta <= 0x7FFFFFFFUL) NVIC_SetPendingIRQ(CTIMER0_IRQn);
+}
+
+void vHighResTimerDisableCompare(void) {
+    CTIMER0->MCR &= ~CTIMER_MCR_MR1I_MASK;
+}
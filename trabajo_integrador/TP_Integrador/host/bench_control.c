@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "control_pi.h"
+
+/* Costo por paso del PI en punto fijo frente a la version en float, y
+ * diferencia maxima entre ambas salidas. En el host el float es por hardware
+ * y el PI en Q15 es mas lento (relacion menor que 1x, entre 0.7x y 0.8x): el
+ * punto fijo no se justifica por velocidad aca, sino porque el Cortex-M0+ no
+ * tiene FPU y cada operacion float alli es una llamada a la libreria de
+ * emulacion. Esa diferencia en la placa no se mide con este programa. */
+
+#define PASOS 10000000UL
+#define MUESTRAS 1024
+
+static int16_t medicion_q15[MUESTRAS];
+static float medicion_f32[MUESTRAS];
+static volatile int32_t sumidero;
+
+/* Version de referencia en float, con el mismo algoritmo que control_pi.c.
+ * Vive solo en el host: la aplicacion no usa punto flotante. */
+typedef struct {
+    float kp;
+    float ki;
+    float salida_min;
+    float salida_max;
+    float integral;
+} control_pi_f32_t;
+
+static void control_pi_f32_iniciar(control_pi_f32_t *pi, float kp, float ki,
+                                   float salida_min, float salida_max) {
+    pi->kp = kp;
+    pi->ki = ki;
+    pi->salida_min = salida_min;
+    pi->salida_max = salida_max;
+    pi->integral = 0;
+}
+
+static float control_pi_f32_paso(control_pi_f32_t *pi, float referencia, float medicion) {
+    float error = referencia - medicion;
+    float integral;
+    float salida;
+
+    integral = pi->integral + pi->ki * error;
+    if (integral > pi->salida_max) integral = pi->salida_max;
+    if (integral < pi->salida_min) integral = pi->salida_min;
+
+    salida = pi->kp * error + integral;
+    if (salida > pi->salida_max) {
+        salida = pi->salida_max;
+        if (error > 0) integral = pi->integral;
+    } else if (salida < pi->salida_min) {
+        salida = pi->salida_min;
+        if (error < 0) integral = pi->integral;
+    }
+
+    pi->integral = integral;
+    return salida;
+}
+
+static uint64_t ahora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+int main(void) {
+    control_pi_t pi;
+    control_pi_f32_t pi_f32;
+    const int16_t referencia_q15 = CONTROL_PI_Q15(0.5);
+    const float referencia_f32 = 0.5f;
+    uint32_t semilla = 1;
+    uint64_t t0, t1;
+    double ns_q15, ns_f32, error_max = 0;
+    unsigned long i;
+
+    /* Mediciones pseudoaleatorias alrededor de la referencia. */
+    for (i = 0; i < MUESTRAS; i++) {
+        semilla = semilla * 1664525U + 1013904223U;
+        medicion_q15[i] = (int16_t)(semilla >> 17);
+        medicion_f32[i] = medicion_q15[i] / 32767.0f;
+    }
+
+    /* Precision: ambos controladores cierran el lazo sobre la misma planta de
+     * primer orden (la de drivers_simulados.c) con escalones de referencia. */
+    control_pi_iniciar(&pi, CONTROL_PI_GANANCIA(0.5), CONTROL_PI_GANANCIA(0.25), 0, CONTROL_PI_Q15(1.0));
+    control_pi_f32_iniciar(&pi_f32, 0.5f, 0.25f, 0.0f, 1.0f);
+    {
+        double planta_q15 = 0, planta_f32 = 0;
+        for (i = 0; i < 4000; i++) {
+            double referencia = (i / 500) % 2 ? 0.3 : 0.6;
+            double q15 = control_pi_paso(&pi, CONTROL_PI_Q15(referencia), CONTROL_PI_Q15(planta_q15)) / 32767.0;
+            double f32 = control_pi_f32_paso(&pi_f32, (float)referencia, (float)planta_f32);
+            double diferencia = q15 > f32 ? q15 - f32 : f32 - q15;
+            if (diferencia > error_max) error_max = diferencia;
+            planta_q15 += (0.5 * q15 - planta_q15) / 4;
+            planta_f32 += (0.5 * f32 - planta_f32) / 4;
+        }
+    }
+
+    t0 = ahora_ns();
+    for (i = 0; i < PASOS; i++) {
+        sumidero = control_pi_paso(&pi, referencia_q15, medicion_q15[i % MUESTRAS]);
+    }
+    t1 = ahora_ns();
+    ns_q15 = (double)(t1 - t0) / PASOS;
+
+    t0 = ahora_ns();
+    for (i = 0; i < PASOS; i++) {
+        sumidero = (int32_t)control_pi_f32_paso(&pi_f32, referencia_f32, medicion_f32[i % MUESTRAS]);
+    }
+    t1 = ahora_ns();
+    ns_f32 = (double)(t1 - t0) / PASOS;
+
+    printf("PI float: %.2f ns/paso | PI Q15: %.2f ns/paso | relacion: %.2fx\n",
+           ns_f32, ns_q15, ns_f32 / ns_q15);
+    printf("Diferencia maxima de salida en lazo cerrado: %.4f %%\n", error_max * 100.0);
+    return 0;
+}
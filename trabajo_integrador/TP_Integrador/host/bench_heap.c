@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Estres aleatorio del heap: la misma secuencia de pedidos y liberaciones
+ * (tamanos de colas, buffers y pilas chicas) contra heap_tlsf.c, que es el
+ * heap del kernel en este build, y contra heap_2.c, compilado aparte con los
+ * nombres cambiados (ver CMakeLists.txt). Ambos tienen configTOTAL_HEAP_SIZE.
+ *
+ * Por heap se informa el costo de cada pvPortMalloc/vPortFree (media, p99 y
+ * maximo, con el reloj del host) y las fallas. Una falla "por fragmentacion"
+ * es un pedido que no entra aunque la memoria libre total alcanzaba. Cada
+ * bloque se llena con un patron que se verifica al liberarlo, asi que un
+ * heap que entregue bloques solapados se detecta. */
+
+#define ITERACIONES 2000000UL
+#define RANURAS 64
+#define SEMILLA 12345U
+
+/* Lo que cualquiera de los dos heaps agrega a un pedido en 64 bits: cabecera
+ * mas redondeo a portBYTE_ALIGNMENT. */
+#define CABECERA_MAX 32
+
+/* Histograma de latencias en pasos de 10 ns hasta 20 us. */
+#define CUBETA_NS 10
+#define CUBETAS 2000
+
+/* heap_2.c con otros nombres. */
+void *pvHeap2Malloc(size_t xSize);
+void vHeap2Free(void *pv);
+size_t xHeap2GetFreeHeapSize(void);
+
+typedef struct {
+    const char *nombre;
+    void *(*reservar)(size_t);
+    void (*liberar)(void *);
+    size_t (*libre)(void);
+} heap_t;
+
+typedef struct {
+    uint32_t cubetas[CUBETAS];
+    uint64_t suma_ns;
+    uint64_t max_ns;
+    uint32_t cantidad;
+} latencias_t;
+
+typedef struct {
+    latencias_t reservas;
+    latencias_t liberaciones;
+    uint32_t fallas;
+    uint32_t fallas_fragmentacion;
+    size_t libre_minimo;
+} resultado_t;
+
+static void *ranuras[RANURAS];
+static size_t tamanos[RANURAS];
+
+static uint32_t azar(uint32_t *estado) {
+    *estado = *estado * 1103515245U + 12345U;
+    return *estado >> 8;
+}
+
+/* 70 % bloques chicos (colas de pocos elementos), 25 % medianos (buffers) y
+ * 5 % grandes (pilas). */
+static size_t tamano_azar(uint32_t *estado) {
+    uint32_t r = azar(estado) % 100;
+
+    if (r < 70) return 8 + azar(estado) % 57;
+    if (r < 95) return 64 + azar(estado) % 449;
+    return 512 + azar(estado) % 1537;
+}
+
+static void registrar(latencias_t *l, uint64_t ns) {
+    uint64_t cubeta = ns / CUBETA_NS;
+
+    l->cubetas[cubeta < CUBETAS ? cubeta : CUBETAS - 1]++;
+    l->suma_ns += ns;
+    if (ns > l->max_ns) l->max_ns = ns;
+    l->cantidad++;
+}
+
+static uint64_t percentil_ns(const latencias_t *l, uint32_t por_mil) {
+    uint64_t objetivo = (uint64_t)l->cantidad * por_mil / 1000;
+    uint64_t acumulado = 0;
+    int i;
+
+    for (i = 0; i < CUBETAS; i++) {
+        acumulado += l->cubetas[i];
+        if (acumulado >= objetivo) return (uint64_t)(i + 1) * CUBETA_NS;
+    }
+    return (uint64_t)CUBETAS * CUBETA_NS;
+}
+
+static void verificar(int ranura) {
+    const uint8_t *p = ranuras[ranura];
+    size_t i;
+
+    for (i = 0; i < tamanos[ranura]; i++) {
+        if (p[i] != (uint8_t)ranura) {
+            fprintf(stderr, "bloque de la ranura %d corrompido\n", ranura);
+            abort();
+        }
+    }
+}
+
+static void correr(const heap_t *heap, resultado_t *r) {
+    uint32_t estado = SEMILLA;
+    uint64_t t0, t1;
+    unsigned long n;
+    size_t tamano, libre;
+    int ranura;
+
+    memset(r, 0, sizeof(*r));
+    r->libre_minimo = heap->libre();
+
+    for (n = 0; n < ITERACIONES; n++) {
+        ranura = (int)(azar(&estado) % RANURAS);
+
+        if (ranuras[ranura] == NULL) {
+            tamano = tamano_azar(&estado);
+            libre = heap->libre();
+
+            t0 = ullPortSimGetHostTimeNs();
+            ranuras[ranura] = heap->reservar(tamano);
+            t1 = ullPortSimGetHostTimeNs();
+            registrar(&r->reservas, t1 - t0);
+
+            if (ranuras[ranura] == NULL) {
+                r->fallas++;
+                if (libre >= tamano + CABECERA_MAX) r->fallas_fragmentacion++;
+                continue;
+            }
+            tamanos[ranura] = tamano;
+            memset(ranuras[ranura], ranura, tamano);
+            if (heap->libre() < r->libre_minimo) r->libre_minimo = heap->libre();
+        } else {
+            verificar(ranura);
+
+            t0 = ullPortSimGetHostTimeNs();
+            heap->liberar(ranuras[ranura]);
+            t1 = ullPortSimGetHostTimeNs();
+            registrar(&r->liberaciones, t1 - t0);
+            ranuras[ranura] = NULL;
+        }
+    }
+
+    /* Todo vuelve al heap para que el siguiente arranque igual. */
+    for (ranura = 0; ranura < RANURAS; ranura++) {
+        if (ranuras[ranura] == NULL) continue;
+        verificar(ranura);
+        heap->liberar(ranuras[ranura]);
+        ranuras[ranura] = NULL;
+    }
+}
+
+static void imprimir_latencias(const char *heap, const char *op, const latencias_t *l) {
+    printf("%-10s %-8s %9.1f ns %9lu ns %9lu ns\n", heap, op,
+           l->cantidad ? (double)l->suma_ns / l->cantidad : 0.0,
+           (unsigned long)percentil_ns(l, 990), (unsigned long)l->max_ns);
+}
+
+static void tarea_bench(void *pvParameters) {
+    static const heap_t heaps[] = {
+        {"heap_2", pvHeap2Malloc, vHeap2Free, xHeap2GetFreeHeapSize},
+        {"heap_tlsf", pvPortMalloc, vPortFree, xPortGetFreeHeapSize},
+    };
+    static resultado_t resultados[2];
+    HeapStats_t stats;
+    size_t libre_inicial;
+    int h;
+
+    (void)pvParameters;
+
+    printf("%lu operaciones, %d ranuras, heap de %u bytes\n\n", ITERACIONES, RANURAS,
+           (unsigned)configTOTAL_HEAP_SIZE);
+
+    for (h = 0; h < 2; h++) {
+        /* El primer pedido inicializa el heap; se descuenta del resto. */
+        heaps[h].liberar(heaps[h].reservar(1));
+        libre_inicial = heaps[h].libre();
+        correr(&heaps[h], &resultados[h]);
+        if (heaps[h].libre() != libre_inicial) {
+            printf("%s: %lu bytes libres al terminar, %lu al empezar\n", heaps[h].nombre,
+                   (unsigned long)heaps[h].libre(), (unsigned long)libre_inicial);
+        }
+    }
+
+    printf("%-10s %-8s %12s %12s %12s\n", "", "", "media", "p99", "max");
+    for (h = 0; h < 2; h++) {
+        imprimir_latencias(heaps[h].nombre, "reservar", &resultados[h].reservas);
+        imprimir_latencias(heaps[h].nombre, "liberar", &resultados[h].liberaciones);
+    }
+
+    printf("\n%-10s %10s %16s %14s\n", "", "fallas", "por fragmentar", "libre minimo");
+    for (h = 0; h < 2; h++) {
+        printf("%-10s %10lu %16lu %10lu B\n", heaps[h].nombre, (unsigned long)resultados[h].fallas,
+               (unsigned long)resultados[h].fallas_fragmentacion, (unsigned long)resultados[h].libre_minimo);
+    }
+
+    /* Con todo liberado, heap_tlsf.c vuelve a un unico bloque libre. */
+    vPortGetHeapStats(&stats);
+    printf("\nheap_tlsf al final: %lu bloques libres, el mayor de %lu de %lu B, minimo historico %lu B\n",
+           (unsigned long)stats.xNumberOfFreeBlocks, (unsigned long)stats.xSizeOfLargestFreeBlockInBytes,
+           (unsigned long)stats.xAvailableHeapSpaceInBytes, (unsigned long)stats.xMinimumEverFreeBytesRemaining);
+
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    static StackType_t pila[256];
+    static StaticTask_t tcb;
+
+    /* Estatica, para que el heap del kernel arranque vacio. */
+    xTaskCreateStatic(tarea_bench, "Bench", 256, NULL, 1, pila, &tcb);
+    vTaskStartScheduler();
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "mailbox.h"
+
+/* Compara el costo de publicar/leer el ultimo valor con una cola de un
+ * elemento (xQueueOverwrite/xQueuePeek) y con un buzon (vMailboxPublish/
+ * xMailboxPeek). Corre dentro de una tarea, con el scheduler en marcha. */
+
+#define ITERACIONES 2000000UL
+
+static volatile float sumidero;
+
+static double ns_por_op(uint64_t inicio, uint64_t fin) {
+    return (double)(fin - inicio) / ITERACIONES;
+}
+
+static void tarea_bench(void *pvParameters) {
+    QueueHandle_t cola = xQueueCreate(1, sizeof(float));
+    MailboxHandle_t buzon = xMailboxCreate(sizeof(float));
+    float valor = 0, leido = 0;
+    uint64_t t0, t1;
+    double cola_pub, cola_peek, buzon_pub, buzon_peek;
+    unsigned long i;
+
+    (void)pvParameters;
+    t0 = ullPortSimGetHostTimeNs();
+    for (i = 0; i < ITERACIONES; i++) {
+        valor += 1.0f;
+        xQueueOverwrite(cola, &valor);
+    }
+    t1 = ullPortSimGetHostTimeNs();
+    cola_pub = ns_por_op(t0, t1);
+
+    t0 = ullPortSimGetHostTimeNs();
+    for (i = 0; i < ITERACIONES; i++) {
+        xQueuePeek(cola, &leido, 0);
+        sumidero = leido;
+    }
+    t1 = ullPortSimGetHostTimeNs();
+    cola_peek = ns_por_op(t0, t1);
+
+    t0 = ullPortSimGetHostTimeNs();
+    for (i = 0; i < ITERACIONES; i++) {
+        valor += 1.0f;
+        vMailboxPublish(buzon, &valor);
+    }
+    t1 = ullPortSimGetHostTimeNs();
+    buzon_pub = ns_por_op(t0, t1);
+
+    t0 = ullPortSimGetHostTimeNs();
+    for (i = 0; i < ITERACIONES; i++) {
+        xMailboxPeek(buzon, &leido);
+        sumidero = leido;
+    }
+    t1 = ullPortSimGetHostTimeNs();
+    buzon_peek = ns_por_op(t0, t1);
+
+    printf("%-10s %12s %12s\n", "", "publicar", "leer");
+    printf("%-10s %9.1f ns %9.1f ns\n", "cola", cola_pub, cola_peek);
+    printf("%-10s %9.1f ns %9.1f ns\n", "buzon", buzon_pub, buzon_peek);
+    printf("%-10s %11.1fx %11.1fx\n", "mejora", cola_pub / buzon_pub, cola_peek / buzon_peek);
+
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    xTaskCreate(tarea_bench, "Bench", 256, NULL, 1, NULL);
+    vTaskStartScheduler();
+    return 0;
+}
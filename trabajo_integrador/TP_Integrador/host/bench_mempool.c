@@ -0,0 +1,181 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mempool.h"
+
+/* Dos pruebas de mempool.c:
+ *
+ * - Costo: reservar y liberar RANURAS bloques de TAMANO bytes en tandas, con
+ *   un pool y con pvPortMalloc/vPortFree (heap_tlsf.c). Corre dentro de una
+ *   tarea, con el scheduler en marcha.
+ * - Estres: HILOS hilos del host (en paralelo de verdad, no corrutinas del
+ *   port) reservan y liberan del mismo pool sin ningun lock, con menos bloques
+ *   que los que piden entre todos. Cada hilo marca sus bloques con un testigo
+ *   propio y lo verifica antes de liberarlos, asi que un bloque entregado a dos
+ *   hilos a la vez se detecta. Al final los contadores del pool deben cerrar. */
+
+#define ITERACIONES 20000UL
+#define RANURAS 32
+#define TAMANO 128
+
+#define HILOS 4
+#define OPERACIONES_HILO 1000000UL
+#define RETENIDOS_HILO 4
+#define BLOQUES_ESTRES 10
+
+typedef struct {
+    uint32_t hilo;
+    uint32_t vuelta;
+    uint32_t palabras[6];
+} testigo_t;
+
+static uint64_t datos_estres[mempoolSTORAGE_SIZE(sizeof(testigo_t), BLOQUES_ESTRES) / sizeof(uint64_t)];
+static StaticMemPool_t bloque_estres;
+static MemPoolHandle_t pool_estres;
+static volatile uint32_t corrupciones;
+static volatile uint32_t liberaciones;
+
+static void marcar(testigo_t *t, uint32_t hilo, uint32_t vuelta) {
+    int i;
+
+    t->hilo = hilo;
+    t->vuelta = vuelta;
+    for (i = 0; i < 6; i++) t->palabras[i] = hilo * 0x9E3779B9U ^ vuelta ^ (uint32_t)i;
+}
+
+static int intacto(const testigo_t *t, uint32_t hilo, uint32_t vuelta) {
+    int i;
+
+    if (t->hilo != hilo || t->vuelta != vuelta) return 0;
+    for (i = 0; i < 6; i++) {
+        if (t->palabras[i] != (hilo * 0x9E3779B9U ^ vuelta ^ (uint32_t)i)) return 0;
+    }
+    return 1;
+}
+
+static void *hilo_estres(void *arg) {
+    uint32_t hilo = (uint32_t)(uintptr_t)arg;
+    testigo_t *retenidos[RETENIDOS_HILO] = {NULL};
+    uint32_t vueltas[RETENIDOS_HILO] = {0};
+    uint32_t estado = hilo + 1;
+    unsigned long n;
+    int r;
+
+    for (n = 0; n < OPERACIONES_HILO; n++) {
+        estado = estado * 1103515245U + 12345U;
+        r = (int)((estado >> 8) % RETENIDOS_HILO);
+
+        if (retenidos[r] == NULL) {
+            retenidos[r] = mempoolALLOC(pool_estres, testigo_t);
+            if (retenidos[r] == NULL) continue;
+            vueltas[r] = (uint32_t)n;
+            marcar(retenidos[r], hilo, vueltas[r]);
+        } else {
+            if (!intacto(retenidos[r], hilo, vueltas[r])) __sync_add_and_fetch(&corrupciones, 1U);
+            vMemPoolFree(pool_estres, retenidos[r]);
+            retenidos[r] = NULL;
+            __sync_add_and_fetch(&liberaciones, 1U);
+        }
+    }
+
+    for (r = 0; r < RETENIDOS_HILO; r++) {
+        if (retenidos[r] == NULL) continue;
+        vMemPoolFree(pool_estres, retenidos[r]);
+        __sync_add_and_fetch(&liberaciones, 1U);
+    }
+    return NULL;
+}
+
+static int estresar(void) {
+    pthread_t hilos[HILOS];
+    MemPoolStats_t s;
+    uint32_t h;
+
+    pool_estres = xMemPoolCreateStatic(sizeof(testigo_t), BLOQUES_ESTRES, (uint8_t *)datos_estres, &bloque_estres);
+
+    for (h = 0; h < HILOS; h++) pthread_create(&hilos[h], NULL, hilo_estres, (void *)(uintptr_t)h);
+    for (h = 0; h < HILOS; h++) pthread_join(hilos[h], NULL);
+
+    vMemPoolGetStats(pool_estres, &s);
+    printf("estres: %d hilos, %lu operaciones, %d bloques de %lu B\n", HILOS, HILOS * OPERACIONES_HILO,
+           BLOQUES_ESTRES, (unsigned long)s.xBlockSize);
+    printf("  reservas %lu, liberaciones %lu, pool vacio %lu, libres %lu (minimo %lu), corrupciones %lu\n",
+           (unsigned long)s.ulAllocations, (unsigned long)s.ulFrees, (unsigned long)s.ulFailures,
+           (unsigned long)s.uxFree, (unsigned long)s.uxMinimumEverFree, (unsigned long)corrupciones);
+
+    /* Las liberaciones que cuenta el pool deben coincidir con las que hicieron
+     * los hilos. */
+    return corrupciones == 0 && s.ulFrees == liberaciones && s.uxFree == BLOQUES_ESTRES;
+}
+
+static void *ranuras[RANURAS];
+
+typedef struct {
+    const char *nombre;
+    void *(*reservar)(void *);
+    void (*liberar)(void *, void *);
+    void *contexto;
+} asignador_t;
+
+static void *reservar_pool(void *pool) { return pvMemPoolAlloc(pool); }
+static void liberar_pool(void *pool, void *p) { vMemPoolFree(pool, p); }
+static void *reservar_heap(void *contexto) { (void)contexto; return pvPortMalloc(TAMANO); }
+static void liberar_heap(void *contexto, void *p) { (void)contexto; vPortFree(p); }
+
+static void medir(const asignador_t *a) {
+    uint64_t t0, t_reservar = 0, t_liberar = 0;
+    unsigned long n;
+    int i;
+
+    for (n = 0; n < ITERACIONES; n++) {
+        t0 = ullPortSimGetHostTimeNs();
+        for (i = 0; i < RANURAS; i++) ranuras[i] = a->reservar(a->contexto);
+        t_reservar += ullPortSimGetHostTimeNs() - t0;
+
+        for (i = 0; i < RANURAS; i++) {
+            if (ranuras[i] == NULL) {
+                printf("%s: sin memoria\n", a->nombre);
+                abort();
+            }
+        }
+
+        /* Se libera en otro orden que el de reserva. */
+        t0 = ullPortSimGetHostTimeNs();
+        for (i = 0; i < RANURAS; i++) a->liberar(a->contexto, ranuras[(i * 7) % RANURAS]);
+        t_liberar += ullPortSimGetHostTimeNs() - t0;
+    }
+
+    printf("%-12s %9.1f ns %9.1f ns\n", a->nombre, (double)t_reservar / (ITERACIONES * RANURAS),
+           (double)t_liberar / (ITERACIONES * RANURAS));
+}
+
+static void tarea_bench(void *pvParameters) {
+    static uint64_t datos[mempoolSTORAGE_SIZE(TAMANO, RANURAS) / sizeof(uint64_t)];
+    static StaticMemPool_t bloque;
+    MemPoolHandle_t pool = xMemPoolCreateStatic(TAMANO, RANURAS, (uint8_t *)datos, &bloque);
+    const asignador_t asignadores[] = {
+        {"pvPortMalloc", reservar_heap, liberar_heap, NULL},
+        {"mempool", reservar_pool, liberar_pool, pool},
+    };
+    unsigned i;
+
+    (void)pvParameters;
+
+    printf("\n%lu tandas de %d bloques de %d B\n", ITERACIONES, RANURAS, TAMANO);
+    printf("%-12s %12s %12s\n", "", "reservar", "liberar");
+    for (i = 0; i < sizeof(asignadores) / sizeof(asignadores[0]); i++) medir(&asignadores[i]);
+
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    static StackType_t pila[256];
+    static StaticTask_t tcb;
+    int ok = estresar();
+
+    xTaskCreateStatic(tarea_bench, "Bench", 256, NULL, 1, pila, &tcb);
+    vTaskStartScheduler();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,287 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "mpscring.h"
+
+/* Dos pruebas de mpscring.c:
+ *
+ * - Estres: HILOS hilos del host (en paralelo de verdad) escriben registros
+ *   de largo al azar en el mismo anillo, a veces de a tandas, mientras otro
+ *   hilo los lee. Cada registro lleva el hilo, un numero de secuencia y un
+ *   relleno que depende de los dos; el lector verifica que de cada hilo llegan
+ *   todos, en orden y sanos. Despues lo mismo leyendo el anillo como flujo de
+ *   bytes, en pedazos que no coinciden con los registros.
+ * - Costo: dentro de una tarea, escribir y leer registros de varios tamanos
+ *   con el anillo y con un stream buffer protegido con una seccion critica
+ *   (lo que hace falta hoy para tener varios escritores). Se compara ademas
+ *   cuanto dura la parte exclusiva de cada escritura: la seccion critica
+ *   entera en el stream buffer, solo la reserva en el anillo.
+ *
+ * Termina con error si algun registro se pierde, se repite, llega fuera de
+ * orden o corrupto. */
+
+#define HILOS 4
+#define REGISTROS_HILO 400000UL
+#define TANDA 3U
+#define LARGO_MAX 80U
+#define TAMANO_ANILLO 4096U
+
+#define TRABADO_NS 2000000000ULL
+
+#define ITERACIONES 200000UL
+#define LOTE 8U
+
+typedef struct {
+    uint16_t hilo;
+    uint16_t largo;
+    uint32_t secuencia;
+} cabecera_t;
+
+static uint32_t datos_anillo[TAMANO_ANILLO / sizeof(uint32_t)];
+static StaticMpscRing_t bloque_anillo;
+static MpscRingHandle_t anillo;
+static volatile unsigned long corrupciones;
+static volatile int modo_bytes;
+static volatile int productores_listos;
+
+static uint8_t relleno(const cabecera_t *c, size_t i) { return (uint8_t)(c->hilo * 31U + c->secuencia * 7U + i); }
+
+static void escribir(uint8_t *registro, uint32_t hilo, uint32_t secuencia, size_t largo) {
+    cabecera_t c = {(uint16_t)hilo, (uint16_t)largo, secuencia};
+    size_t i;
+
+    memcpy(registro, &c, sizeof(c));
+    for (i = sizeof(c); i < largo; i++) registro[i] = relleno(&c, i);
+}
+
+/* Verifica un registro y avanza la secuencia esperada de su hilo. */
+static void verificar(const uint8_t *registro, size_t largo, uint32_t *esperadas) {
+    cabecera_t c;
+    size_t i;
+
+    memcpy(&c, registro, sizeof(c));
+    if (c.hilo >= HILOS || c.largo != largo) {
+        corrupciones++;
+        return;
+    }
+    /* Despues de un salto se sigue desde el registro recibido. */
+    if (c.secuencia != esperadas[c.hilo]) corrupciones++;
+    esperadas[c.hilo] = c.secuencia + 1U;
+    for (i = sizeof(c); i < largo; i++) {
+        if (registro[i] != relleno(&c, i)) {
+            corrupciones++;
+            return;
+        }
+    }
+}
+
+static uint32_t azar(uint32_t *estado) {
+    *estado = *estado * 1103515245U + 12345U;
+    return *estado >> 8;
+}
+
+/* En modo bytes todos los registros tienen el largo maximo, para que el lector
+ * pueda volver a cortar el flujo. */
+static size_t largo_al_azar(uint32_t *estado) {
+    return modo_bytes ? LARGO_MAX : sizeof(cabecera_t) + azar(estado) % (LARGO_MAX - sizeof(cabecera_t) + 1U);
+}
+
+static void *hilo_productor(void *arg) {
+    uint32_t hilo = (uint32_t)(uintptr_t)arg, estado = hilo + 1U, secuencia = 0;
+    size_t largos[TANDA];
+    void *registros[TANDA];
+    unsigned i, n;
+
+    while (secuencia < REGISTROS_HILO) {
+        /* Uno de cada cuatro intentos es una tanda. */
+        n = (azar(&estado) % 4U == 0U && secuencia + TANDA <= REGISTROS_HILO) ? TANDA : 1U;
+        for (i = 0; i < n; i++) largos[i] = largo_al_azar(&estado);
+
+        /* Si no entra, se reintenta hasta que el lector haga lugar. */
+        while (xMpscRingReserveBatch(anillo, largos, registros, n) != pdPASS) sched_yield();
+
+        for (i = 0; i < n; i++) escribir(registros[i], hilo, secuencia + i, largos[i]);
+        vMpscRingCommit(anillo, registros[0]);
+        secuencia += n;
+    }
+    return NULL;
+}
+
+static void *hilo_lector(void *arg) {
+    uint32_t esperadas[HILOS] = {0};
+    uint8_t registro[LARGO_MAX], pedazo[37];
+    size_t largo, n, i, armado = 0;
+    uint64_t ultimo = ullPortSimGetHostTimeNs();
+    int listos;
+
+    (void)arg;
+    for (;;) {
+        /* Se lee el aviso antes de vaciar el anillo por ultima vez. */
+        listos = productores_listos;
+        __sync_synchronize();
+
+        if (!modo_bytes) {
+            largo = xMpscRingReceiveRecord(anillo, registro, sizeof(registro));
+            if (largo != 0U) verificar(registro, largo, esperadas);
+            n = largo;
+        } else {
+            n = xMpscRingReceive(anillo, pedazo, sizeof(pedazo));
+            for (i = 0; i < n; i++) {
+                registro[armado++] = pedazo[i];
+                if (armado == LARGO_MAX) {
+                    verificar(registro, LARGO_MAX, esperadas);
+                    armado = 0;
+                }
+            }
+        }
+
+        if (n != 0U) {
+            ultimo = ullPortSimGetHostTimeNs();
+        } else if (listos) {
+            break;
+        } else if (ullPortSimGetHostTimeNs() - ultimo > TRABADO_NS) {
+            /* Un registro que nunca se confirma, o productores que nunca
+             * encuentran lugar: el anillo quedo roto. */
+            printf("estres: el anillo no avanza\n");
+            exit(1);
+        } else {
+            sched_yield();
+        }
+    }
+
+    if (armado != 0U) corrupciones++;
+
+    for (i = 0; i < HILOS; i++) {
+        if (esperadas[i] != REGISTROS_HILO) corrupciones++;
+    }
+    return NULL;
+}
+
+static int estresar(int bytes) {
+    pthread_t productores[HILOS], lector;
+    MpscRingStats_t s;
+    uint32_t h;
+
+    modo_bytes = bytes;
+    productores_listos = 0;
+    anillo = xMpscRingCreateStatic(TAMANO_ANILLO, (uint8_t *)datos_anillo, &bloque_anillo);
+
+    pthread_create(&lector, NULL, hilo_lector, NULL);
+    for (h = 0; h < HILOS; h++) pthread_create(&productores[h], NULL, hilo_productor, (void *)(uintptr_t)h);
+    for (h = 0; h < HILOS; h++) pthread_join(productores[h], NULL);
+    __sync_synchronize();
+    productores_listos = 1;
+    pthread_join(lector, NULL);
+
+    vMpscRingGetStats(anillo, &s);
+    printf("estres %-9s %d hilos, %lu registros, anillo de %lu B\n", bytes ? "(bytes):" : "(registros):", HILOS,
+           HILOS * REGISTROS_HILO, (unsigned long)s.xSize);
+    printf("  escritos %lu, sin lugar %lu, ocupacion maxima %lu B, quedan %lu B, corrupciones %lu\n",
+           (unsigned long)s.ulRecords, (unsigned long)s.ulDropped, (unsigned long)s.xMaximumUsed,
+           (unsigned long)s.xUsed, corrupciones);
+
+    return corrupciones == 0U && s.ulRecords == HILOS * REGISTROS_HILO && s.xUsed == 0U;
+}
+
+static const size_t tamanos[] = {8, 32, 128};
+
+static StreamBufferHandle_t flujo;
+static uint64_t t_exclusivo;
+static double reloj_ns;
+
+/* Lo que cuesta leer el reloj dos veces, para descontarlo de las partes
+ * exclusivas. */
+static void calibrar_reloj(void) {
+    uint64_t t0, total = 0;
+    unsigned long n;
+
+    for (n = 0; n < ITERACIONES; n++) {
+        t0 = ullPortSimGetHostTimeNs();
+        total += ullPortSimGetHostTimeNs() - t0;
+    }
+    reloj_ns = (double)total / ITERACIONES;
+}
+
+static void escribir_flujo(const uint8_t *datos, size_t largo) {
+    uint64_t t0 = ullPortSimGetHostTimeNs();
+
+    taskENTER_CRITICAL();
+    xStreamBufferSend(flujo, datos, largo, 0);
+    taskEXIT_CRITICAL();
+    t_exclusivo += ullPortSimGetHostTimeNs() - t0;
+}
+
+static void escribir_anillo(const uint8_t *datos, size_t largo) {
+    uint64_t t0 = ullPortSimGetHostTimeNs();
+    void *registro = pvMpscRingReserve(anillo, largo);
+
+    t_exclusivo += ullPortSimGetHostTimeNs() - t0;
+    memcpy(registro, datos, largo);
+    vMpscRingCommit(anillo, registro);
+}
+
+static void medir(const char *nombre, int en_anillo, size_t largo) {
+    uint8_t datos[128], leidos[128];
+    uint64_t t0, t1;
+    unsigned long n;
+    unsigned i;
+
+    memset(datos, 0x5A, sizeof(datos));
+    t_exclusivo = 0;
+    t0 = ullPortSimGetHostTimeNs();
+    for (n = 0; n < ITERACIONES; n += LOTE) {
+        for (i = 0; i < LOTE; i++) {
+            if (en_anillo) {
+                escribir_anillo(datos, largo);
+            } else {
+                escribir_flujo(datos, largo);
+            }
+        }
+        for (i = 0; i < LOTE; i++) {
+            if (en_anillo) {
+                if (xMpscRingReceiveRecord(anillo, leidos, sizeof(leidos)) != largo) corrupciones++;
+            } else {
+                if (xStreamBufferReceive(flujo, leidos, largo, 0) != largo) corrupciones++;
+            }
+        }
+    }
+    t1 = ullPortSimGetHostTimeNs();
+
+    printf("  %-14s %4lu B %8.1f ns %8.1f ns\n", nombre, (unsigned long)largo, (double)(t1 - t0) / ITERACIONES,
+           (double)t_exclusivo / ITERACIONES - reloj_ns);
+}
+
+static void tarea_bench(void *pvParameters) {
+    unsigned i;
+
+    (void)pvParameters;
+    flujo = xStreamBufferCreate(TAMANO_ANILLO, 1);
+    anillo = xMpscRingCreateStatic(TAMANO_ANILLO, (uint8_t *)datos_anillo, &bloque_anillo);
+    configASSERT(flujo);
+    calibrar_reloj();
+
+    printf("\n%lu escrituras por caso, de a %u antes de leer\n", ITERACIONES, LOTE);
+    printf("  %-14s %6s %11s %11s\n", "", "", "escribir+leer", "exclusivo");
+    for (i = 0; i < sizeof(tamanos) / sizeof(tamanos[0]); i++) {
+        medir("stream buffer", 0, tamanos[i]);
+        medir("anillo mpsc", 1, tamanos[i]);
+    }
+
+    vStreamBufferDelete(flujo);
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    static StackType_t pila[256];
+    static StaticTask_t tcb;
+    int ok = estresar(0) && estresar(1);
+
+    xTaskCreateStatic(tarea_bench, "Bench", 256, NULL, 1, pila, &tcb);
+    vTaskStartScheduler();
+    return ok && corrupciones == 0U ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "mempool.h"
+#include "msgqueue.h"
+
+/* Compara pasar tramas de varios tamanos con una cola que copia
+ * (xQueueSend/xQueueReceive) y con una cola de mensajes que pasa punteros a
+ * bloques de un pool (msgqueue.h). En los dos casos el productor escribe la
+ * trama y el consumidor la lee entera:
+ *
+ * - misma tarea: se encolan LOTE tramas y se desencolan, sin cambios de
+ *   contexto; mide solo el costo de la cola.
+ * - entre tareas: el consumidor tiene mas prioridad, asi que cada envio lo
+ *   despierta, como en una cadena sensor -> proceso.
+ *
+ * Despues verifica las referencias: mensajes enviados desde una interrupcion
+ * y un mismo mensaje en dos colas. Termina con error si algun mensaje llega
+ * mal o si al final falta algun bloque en el pool. */
+
+#define ITERACIONES 200000UL
+#define LOTE 8U
+#define TAMANO_MAX 256U
+#define BLOQUES (LOTE + 2U)
+
+static const size_t tamanos[] = {4, 16, 64, 128, 256};
+
+static QueueHandle_t cola;
+static MemPoolHandle_t pool;
+static size_t tamano;
+static int copiando;
+static TaskHandle_t handle_bench;
+static volatile unsigned long errores;
+static volatile uint32_t sumidero;
+
+/* La trama lleva su numero en la primera palabra y lo repite en el resto. */
+static void escribir(uint8_t *trama, uint32_t numero) {
+    memset(trama, (int)(numero & 0xFFU), tamano);
+    memcpy(trama, &numero, sizeof(numero));
+}
+
+static void leer(const uint8_t *trama, uint32_t esperado) {
+    uint32_t numero, suma = 0;
+    size_t i;
+
+    memcpy(&numero, trama, sizeof(numero));
+    for (i = sizeof(numero); i < tamano; i++) suma += trama[i];
+    if (numero != esperado || suma != (uint32_t)(tamano - sizeof(numero)) * (esperado & 0xFFU)) errores++;
+    sumidero = suma;
+}
+
+static void enviar(uint32_t numero) {
+    uint8_t trama[TAMANO_MAX];
+    uint8_t *mensaje;
+
+    if (copiando) {
+        escribir(trama, numero);
+        xQueueSend(cola, trama, portMAX_DELAY);
+    } else {
+        mensaje = pvMsgAlloc(pool);
+        if (mensaje == NULL) {
+            errores++;
+            return;
+        }
+        escribir(mensaje, numero);
+        xMsgQueueSend(cola, mensaje, portMAX_DELAY);
+    }
+}
+
+static void recibir(uint32_t numero) {
+    uint8_t trama[TAMANO_MAX];
+    uint8_t *mensaje;
+
+    if (copiando) {
+        xQueueReceive(cola, trama, portMAX_DELAY);
+        leer(trama, numero);
+    } else {
+        mensaje = pvMsgQueueReceive(cola, portMAX_DELAY);
+        leer(mensaje, numero);
+        vMsgRelease(mensaje);
+    }
+}
+
+static void preparar(int copia, size_t t) {
+    copiando = copia;
+    tamano = t;
+    cola = copia ? xQueueCreate(LOTE, t) : xMsgQueueCreate(LOTE);
+    configASSERT(cola);
+}
+
+static void terminar(void) {
+    if (copiando) {
+        vQueueDelete(cola);
+    } else {
+        vMsgQueueDelete(cola);
+    }
+}
+
+/* Ademas del tiempo por trama deja en *enmascarado lo que dura en promedio
+ * cada seccion con interrupciones enmascaradas. */
+static double misma_tarea(int copia, size_t t, double *enmascarado) {
+    SimCriticalStats_t secciones, tick;
+    uint64_t t0, t1;
+    uint32_t n;
+    unsigned i;
+
+    preparar(copia, t);
+    vPortSimMeasureCritical(pdTRUE);
+    t0 = ullPortSimGetHostTimeNs();
+    for (n = 0; n < ITERACIONES; n += LOTE) {
+        for (i = 0; i < LOTE; i++) enviar(n + i);
+        for (i = 0; i < LOTE; i++) recibir(n + i);
+    }
+    t1 = ullPortSimGetHostTimeNs();
+    vPortSimGetCriticalStats(&secciones, &tick);
+    vPortSimMeasureCritical(pdFALSE);
+    terminar();
+
+    *enmascarado = secciones.ullCount > 0U ? (double)secciones.ullTotalNs / (double)secciones.ullCount : 0.0;
+    return (double)(t1 - t0) / ITERACIONES;
+}
+
+static void tarea_consumidora(void *pvParameters) {
+    uint32_t n;
+
+    (void)pvParameters;
+    for (n = 0; n < ITERACIONES; n++) recibir(n);
+    xTaskNotifyGive(handle_bench);
+    vTaskDelete(NULL);
+}
+
+static double entre_tareas(int copia, size_t t) {
+    uint64_t t0, t1;
+    uint32_t n;
+
+    preparar(copia, t);
+    t0 = ullPortSimGetHostTimeNs();
+    xTaskCreate(tarea_consumidora, "Consumidora", 256, NULL, uxTaskPriorityGet(NULL) + 1, NULL);
+    for (n = 0; n < ITERACIONES; n++) enviar(n);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    t1 = ullPortSimGetHostTimeNs();
+    terminar();
+
+    /* La tarea idle libera la memoria de la consumidora. */
+    vTaskDelay(1);
+    return (double)(t1 - t0) / ITERACIONES;
+}
+
+/* Interrupcion simulada que publica la trama numero isr_enviadas. */
+static uint32_t isr_enviadas;
+
+static void isr_productora(void) {
+    BaseType_t despertar = pdFALSE;
+    uint8_t *mensaje = pvMsgAllocFromISR(pool);
+
+    if (mensaje == NULL) return;
+    escribir(mensaje, isr_enviadas);
+    if (xMsgQueueSendFromISR(cola, mensaje, &despertar) == pdPASS) {
+        isr_enviadas++;
+    } else {
+        vMsgReleaseFromISR(mensaje);
+    }
+    portYIELD_FROM_ISR(despertar);
+}
+
+static void verificar_referencias(void) {
+    QueueHandle_t otra = xMsgQueueCreate(LOTE);
+    MemPoolStats_t s;
+    uint8_t *mensaje, *a, *b;
+    uint32_t n;
+
+    preparar(0, 64);
+
+    /* Desde una interrupcion: la cola se llena y el resto se descarta sin
+     * perder bloques. */
+    isr_enviadas = 0;
+    for (n = 0; n < 2 * LOTE; n++) vPortSimulateInterrupt(isr_productora);
+    if (isr_enviadas != LOTE) errores++;
+    for (n = 0; n < isr_enviadas; n++) recibir(n);
+
+    /* Un mensaje en dos colas: vuelve al pool con la ultima liberacion. */
+    mensaje = pvMsgAlloc(pool);
+    escribir(mensaje, 7);
+    vMsgRetain(mensaje);
+    xMsgQueueSend(cola, mensaje, 0);
+    xMsgQueueSend(otra, mensaje, 0);
+    a = pvMsgQueueReceive(cola, 0);
+    b = pvMsgQueueReceive(otra, 0);
+    if (a != mensaje || b != mensaje || uxMsgGetReferences(mensaje) != 2U || xMsgGetSize(mensaje) < 64U) errores++;
+    leer(a, 7);
+    vMsgRelease(a);
+    vMemPoolGetStats(pool, &s);
+    if (s.uxFree != BLOQUES - 1U) errores++;
+    leer(b, 7);
+    vMsgRelease(b);
+
+    /* Borrar una cola con mensajes los devuelve al pool. */
+    mensaje = pvMsgAlloc(pool);
+    xMsgQueueSend(otra, mensaje, 0);
+    vMsgQueueDelete(otra);
+    terminar();
+
+    vMemPoolGetStats(pool, &s);
+    if (s.uxFree != BLOQUES) errores++;
+    printf("\nreferencias: %lu errores, %lu de %lu bloques libres\n", errores, (unsigned long)s.uxFree,
+           (unsigned long)s.uxBlocks);
+}
+
+static void tarea_bench(void *pvParameters) {
+    double copia[2], referencia[2], enmascarado_copia, enmascarado_referencia;
+    unsigned i;
+
+    (void)pvParameters;
+    handle_bench = xTaskGetCurrentTaskHandle();
+    pool = xMemPoolCreate(msgqueueMESSAGE_SIZE(TAMANO_MAX), BLOQUES);
+    configASSERT(pool);
+
+    printf("%lu tramas por caso, colas de %u\n", ITERACIONES, LOTE);
+    printf("%8s %25s %25s %25s\n", "", "misma tarea", "seccion enmascarada", "entre tareas");
+    printf("%8s %8s %8s %7s %8s %8s %7s %8s %8s %7s\n", "bytes", "copia", "punteros", "mejora", "copia", "punteros",
+           "mejora", "copia", "punteros", "mejora");
+    for (i = 0; i < sizeof(tamanos) / sizeof(tamanos[0]); i++) {
+        copia[0] = misma_tarea(1, tamanos[i], &enmascarado_copia);
+        referencia[0] = misma_tarea(0, tamanos[i], &enmascarado_referencia);
+        copia[1] = entre_tareas(1, tamanos[i]);
+        referencia[1] = entre_tareas(0, tamanos[i]);
+        printf("%8lu %5.0f ns %5.0f ns %6.2fx %5.0f ns %5.0f ns %6.2fx %5.0f ns %5.0f ns %6.2fx\n",
+               (unsigned long)tamanos[i], copia[0], referencia[0], copia[0] / referencia[0], enmascarado_copia,
+               enmascarado_referencia, enmascarado_copia / enmascarado_referencia, copia[1], referencia[1],
+               copia[1] / referencia[1]);
+    }
+
+    verificar_referencias();
+    if (errores != 0U) exit(1);
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    xTaskCreate(tarea_bench, "Bench", 256, NULL, 1, NULL);
+    vTaskStartScheduler();
+    return 0;
+}
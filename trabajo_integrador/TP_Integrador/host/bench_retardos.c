@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Costo de llevar las tareas demoradas segun cuantas hay: listas ordenadas
+ * (el kernel de siempre) o rueda de tiempos (configUSE_DELAY_WHEEL). El mismo
+ * fuente se compila contra los dos kernels (bench_retardos y
+ * bench_retardos_rueda).
+ *
+ * N tareas dormilonas hacen vTaskDelay() al azar. Una tarea de mayor
+ * prioridad se bloquea K veces con un timeout al azar y mide cada insercion
+ * (vTaskPlaceOnEventList(), que corre con el scheduler suspendido). El port
+ * mide ademas las secciones con interrupciones enmascaradas y la interrupcion
+ * del tick, que es donde se despiertan las tareas.
+ *
+ * Los kernels del bench arrancan con el contador de ticks cerca de dar la
+ * vuelta, y cada tarea revisa que despierta en el tick exacto: el bench falla
+ * si alguna despierta antes o despues. */
+
+#define N_MAX 512U
+#define MEDICIONES 2000U
+#define RETARDO_MAX 5000U        /* la mayoria de los retardos */
+#define RETARDO_LARGO_MAX 200000U  /* uno de cada 16 */
+
+static const unsigned niveles[] = {0, 4, 16, 64, 256, N_MAX};
+
+static StaticTask_t tcb_dormilonas[N_MAX];
+static StackType_t pila_dormilonas[N_MAX][configMINIMAL_STACK_SIZE];
+static uint64_t muestras[MEDICIONES];
+static volatile unsigned long fuera_de_hora;
+
+static uint32_t azar(uint32_t *estado) {
+    *estado = *estado * 1103515245U + 12345U;
+    return *estado >> 8;
+}
+
+static TickType_t retardo_al_azar(uint32_t *estado) {
+    if (azar(estado) % 16U == 0U) return 1U + azar(estado) % RETARDO_LARGO_MAX;
+    return 1U + azar(estado) % RETARDO_MAX;
+}
+
+static void tarea_dormilona(void *pvParameters) {
+    uint32_t estado = (uint32_t)(uintptr_t)pvParameters;
+    TickType_t retardo, antes;
+
+    for (;;) {
+        retardo = retardo_al_azar(&estado);
+        antes = xTaskGetTickCount();
+        vTaskDelay(retardo);
+        if ((TickType_t)(xTaskGetTickCount() - antes) != retardo) fuera_de_hora++;
+    }
+}
+
+static int comparar(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+static double media_ns(const SimCriticalStats_t *s) {
+    return s->ullCount > 0U ? (double)s->ullTotalNs / (double)s->ullCount : 0.0;
+}
+
+static void tarea_bench(void *pvParameters) {
+    List_t evento;
+    SimCriticalStats_t enmascarado, tick;
+    uint32_t estado = 12345U;
+    unsigned creadas = 0, nivel, i;
+    TickType_t retardo, antes;
+    uint64_t t0, t1, total;
+
+    (void)pvParameters;
+    vListInitialise(&evento);
+
+    printf("kernel con %s, %u bloqueos por nivel\n\n", configUSE_DELAY_WHEEL ? "rueda de tiempos" : "listas ordenadas",
+           MEDICIONES);
+    printf("%6s %27s %20s %20s\n", "", "insertar", "tick", "enmascarado");
+    printf("%6s %9s %8s %8s %10s %9s %10s %9s\n", "tareas", "media", "p99", "max", "media", "max", "media", "max");
+
+    for (nivel = 0; nivel < sizeof(niveles) / sizeof(niveles[0]); nivel++) {
+        for (; creadas < niveles[nivel]; creadas++) {
+            xTaskCreateStatic(tarea_dormilona, "Dorm", configMINIMAL_STACK_SIZE, (void *)(uintptr_t)(creadas + 1U),
+                              tskIDLE_PRIORITY + 1, pila_dormilonas[creadas], &tcb_dormilonas[creadas]);
+        }
+
+        /* Las nuevas se demoran por primera vez antes de medir. */
+        vTaskDelay(RETARDO_MAX);
+        vPortSimMeasureCritical(pdTRUE);
+        total = 0;
+
+        for (i = 0; i < MEDICIONES; i++) {
+            retardo = retardo_al_azar(&estado) % RETARDO_MAX + 1U;
+            antes = xTaskGetTickCount();
+
+            vTaskSuspendAll();
+            t0 = ullPortSimGetHostTimeNs();
+            vTaskPlaceOnEventList(&evento, retardo);
+            t1 = ullPortSimGetHostTimeNs();
+            if (xTaskResumeAll() == pdFALSE) portYIELD_WITHIN_API();
+
+            /* Despierta por timeout: el tick la saca de la lista del evento. */
+            if ((TickType_t)(xTaskGetTickCount() - antes) != retardo) fuera_de_hora++;
+            muestras[i] = t1 - t0;
+            total += t1 - t0;
+        }
+
+        vPortSimGetCriticalStats(&enmascarado, &tick);
+        vPortSimMeasureCritical(pdFALSE);
+        qsort(muestras, MEDICIONES, sizeof(muestras[0]), comparar);
+
+        printf("%6u %6.0f ns %5llu ns %5llu ns %7.0f ns %6llu ns %7.0f ns %6llu ns\n", creadas,
+               (double)total / MEDICIONES, (unsigned long long)muestras[MEDICIONES * 99U / 100U],
+               (unsigned long long)muestras[MEDICIONES - 1U], media_ns(&tick), (unsigned long long)tick.ullMaxNs,
+               media_ns(&enmascarado), (unsigned long long)enmascarado.ullMaxNs);
+    }
+
+    printf("\n%lu despertares fuera de hora; ticks de %lu a %lu\n", fuera_de_hora,
+           (unsigned long)configINITIAL_TICK_COUNT, (unsigned long)xTaskGetTickCount());
+    if (fuera_de_hora != 0U) exit(1);
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    xTaskCreate(tarea_bench, "Bench", 256, NULL, tskIDLE_PRIORITY + 2, NULL);
+    vTaskStartScheduler();
+    return 0;
+}
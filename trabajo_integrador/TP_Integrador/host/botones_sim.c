@@ -0,0 +1,156 @@
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tracerecorder.h"
+#include "botones.h"
+
+/* Backend del simulador. Reproduce el camino de la placa (botones_lpc845.c):
+ * un guion genera flancos con rebote en los pines, cada flanco entra por una
+ * "interrupcion de pin" que arranca el temporizador de muestreo y este, cada
+ * MUESTREO_MS, clasifica las pulsaciones como el componente button del SDK y
+ * se detiene cuando todos los botones estan sueltos. Las interrupciones se
+ * agendan con vPortSimScheduleInterrupt(), asi el tickless idle se despierta
+ * para atenderlas igual que en la placa. */
+
+#define MUESTREO_MS 25  /* BUTTON_TIMER_INTERVAL */
+#define REBOTE_MS 1     /* separacion entre flancos del rebote */
+#define FLANCOS 6       /* presiona, rebota y suelta, rebota */
+
+/* Guion de cada boton: una pulsacion cada "cada_ms", la primera en
+ * "primera_ms"; una de cada "largo_cada" se mantiene presionada. */
+typedef struct {
+    uint32_t primera_ms;
+    uint32_t cada_ms;
+    uint32_t corta_ms;
+    uint32_t largo_ms;
+    uint32_t largo_cada;
+} guion_t;
+
+static const guion_t guion[BOTONES_CANTIDAD] = {
+    [BOTON_S1] = {10000, 10000, 80, 700, 4},
+    [BOTON_S2] = {15050, 15000, 120, 900, 5},
+    [BOTON_USER] = {20100, 20000, 60, 0, 0},
+};
+
+typedef struct {
+    bool presionado;        /* nivel del pin */
+    TickType_t proximo;     /* proximo flanco del guion */
+    uint8_t flanco;         /* indice dentro de la pulsacion en curso */
+    TickType_t inicio;      /* comienzo de la pulsacion en curso */
+    uint32_t pulsaciones;
+    /* Estado del antirrebote. */
+    bool activo;
+    uint32_t muestras;      /* muestras consecutivas presionado */
+} boton_sim_t;
+
+static boton_sim_t botones[BOTONES_CANTIDAD];
+static bool muestreando;
+static UBaseType_t traza_pin, traza_mrt;
+
+static void isr_muestreo(void);
+
+static TickType_t duracion(const guion_t *g, uint32_t pulsacion) {
+    bool largo = g->largo_cada != 0 && pulsacion % g->largo_cada == g->largo_cada - 1;
+    return pdMS_TO_TICKS(largo ? g->largo_ms : g->corta_ms);
+}
+
+/* Instante del flanco "f" de la pulsacion que empieza en "inicio". */
+static TickType_t instante_flanco(const guion_t *g, boton_sim_t *b, uint8_t f) {
+    TickType_t soltar = b->inicio + duracion(g, b->pulsaciones);
+    return f < FLANCOS / 2 ? b->inicio + f * pdMS_TO_TICKS(REBOTE_MS)
+                           : soltar + (f - FLANCOS / 2) * pdMS_TO_TICKS(REBOTE_MS);
+}
+
+static void agendar_flancos(void);
+
+/* Interrupcion de pin: aplica los flancos que vencen ahora y, como PINT en la
+ * placa, arranca el muestreo si estaba detenido. */
+static void isr_pin(void) {
+    TickType_t ahora = xTaskGetTickCount();
+    const guion_t *g;
+    boton_sim_t *b;
+    int i;
+
+    vTraceRecorderISREnter(traza_pin);
+    for (i = 0; i < BOTONES_CANTIDAD; i++) {
+        g = &guion[i];
+        b = &botones[i];
+        if (g->cada_ms == 0 || b->proximo != ahora) continue;
+
+        /* Los flancos alternan: pares presionan, impares sueltan. */
+        b->presionado = b->flanco % 2 == 0;
+        if (++b->flanco < FLANCOS) {
+            b->proximo = instante_flanco(g, b, b->flanco);
+        } else {
+            b->flanco = 0;
+            b->pulsaciones++;
+            b->inicio += pdMS_TO_TICKS(g->cada_ms);
+            b->proximo = b->inicio;
+        }
+    }
+
+    if (!muestreando) {
+        muestreando = true;
+        vPortSimScheduleInterrupt(pdMS_TO_TICKS(MUESTREO_MS), isr_muestreo);
+    }
+    agendar_flancos();
+    vTraceRecorderISRExit(traza_pin);
+}
+
+static void agendar_flancos(void) {
+    TickType_t ahora = xTaskGetTickCount();
+    TickType_t proximo = portMAX_DELAY;
+    int i;
+
+    for (i = 0; i < BOTONES_CANTIDAD; i++) {
+        if (guion[i].cada_ms != 0 && botones[i].proximo - ahora < proximo) {
+            proximo = botones[i].proximo - ahora;
+        }
+    }
+    if (proximo != portMAX_DELAY) vPortSimScheduleInterrupt(proximo, isr_pin);
+}
+
+/* Temporizador de antirrebote: un boton cuenta como presionado cuando lo esta
+ * en la muestra, y la pulsacion se clasifica al soltarlo por la cantidad de
+ * muestras. Un rebote mas corto que MUESTREO_MS nunca llega a dos muestras
+ * distintas. */
+static void isr_muestreo(void) {
+    BaseType_t despertar = pdFALSE;
+    bool alguno = false;
+    boton_sim_t *b;
+    int i;
+
+    vTraceRecorderISREnter(traza_mrt);
+    for (i = 0; i < BOTONES_CANTIDAD; i++) {
+        b = &botones[i];
+        if (b->presionado) {
+            b->activo = true;
+            b->muestras++;
+        } else if (b->activo) {
+            botones_publicar_desde_isr((boton_t)i,
+                                       b->muestras * MUESTREO_MS >= BOTON_LARGO_MS ? BOTON_LARGO : BOTON_CLICK,
+                                       &despertar);
+            b->activo = false;
+            b->muestras = 0;
+        }
+        alguno = alguno || b->activo;
+    }
+
+    muestreando = alguno;
+    if (muestreando) vPortSimScheduleInterrupt(pdMS_TO_TICKS(MUESTREO_MS), isr_muestreo);
+    vTraceRecorderISRExit(traza_mrt);
+    portYIELD_FROM_ISR(despertar);
+}
+
+void botones_iniciar(void) {
+    int i;
+
+    /* Las mismas interrupciones que en la placa, para la traza. */
+    traza_pin = uxTraceRecorderRegister(traceOBJECT_ISR, "PINT");
+    traza_mrt = uxTraceRecorderRegister(traceOBJECT_ISR, "MRT");
+    for (i = 0; i < BOTONES_CANTIDAD; i++) {
+        botones[i].inicio = pdMS_TO_TICKS(guion[i].primera_ms);
+        botones[i].proximo = botones[i].inicio;
+    }
+    agendar_flancos();
+}
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "telemetria_trama.h"
+#include "escalas.h"
+
+/* Lee la telemetria binaria (telemetria_trama.h) de un archivo o de stdin,
+ * por ejemplo directo del puerto serie o de la salida de tp_integrador_sim, y
+ * la imprime en texto. Se resincroniza ante bytes basura o tramas con CRC
+ * incorrecto. El resumen, con el ultimo reporte del monitor, va a stderr. */
+
+static unsigned long tramas, muestras, perdidas, errores, saltos, bytes, reportes;
+static telemetria_monitor_t ultimo_reporte;
+
+static void imprimir_monitor(const telemetria_monitor_t *m, FILE *salida) {
+    const telemetria_tarea_t *t;
+
+    fprintf(salida, "[MON] %lu ms | heap libre: ", (unsigned long)m->tiempo_ms);
+    if (m->heap_libre == TELEMETRIA_SIN_HEAP) {
+        fprintf(salida, "sin heap\n");
+    } else {
+        fprintf(salida, "%lu bytes\n", (unsigned long)m->heap_libre);
+    }
+    fprintf(salida, "[MON]   %-10s %4s %7s %11s %8s %9s %13s %14s\n", "tarea", "prio", "cpu", "pila libre",
+            "periodo", "perdidos", "jitter max", "jitter medio");
+    for (t = m->tareas; t < m->tareas + m->n; t++) {
+        if (t->nombre[0] == '\0') continue;
+        fprintf(salida, "[MON]   %-10s %4u %5u.%u%% %11u", t->nombre, t->prioridad, t->cpu_decimas / 10,
+                t->cpu_decimas % 10, t->pila_libre);
+        if (t->periodo_ms) {
+            fprintf(salida, " %5u ms %9u %10u us %11u us\n", t->periodo_ms, t->perdidos, t->jitter_max_us,
+                    t->jitter_medio_us);
+        } else {
+            fprintf(salida, " %8s\n", "eventos");
+        }
+    }
+}
+
+static void imprimir_decimas(const char *nombre, int16_t q15) {
+    uint16_t d = Q15_A_DECIMAS(q15 < 0 ? 0 : q15);
+    printf(" | %s: %u.%u%%", nombre, d / 10, d % 10);
+}
+
+static void procesar(const uint8_t *trama, int largo, int silencioso) {
+    static int primera = 1;
+    static uint16_t esperada;
+    telemetria_muestra_t lote[TELEMETRIA_CARGA_MAX / TELEMETRIA_MUESTRA_BYTES];
+    uint16_t secuencia = (uint16_t)(trama[4] | (trama[5] << 8));
+    uint16_t perdidas_trama;
+    int i, n;
+
+    tramas++;
+    if (!primera && secuencia != esperada) saltos += (uint16_t)(secuencia - esperada);
+    primera = 0;
+    esperada = (uint16_t)(secuencia + 1);
+
+    if (trama[2] == TELEMETRIA_MONITOR) {
+        if (telemetria_monitor_decodificar(&trama[TELEMETRIA_CABECERA], trama[3], &ultimo_reporte) < 0) {
+            errores++;
+            return;
+        }
+        reportes++;
+        if (!silencioso) imprimir_monitor(&ultimo_reporte, stdout);
+        return;
+    }
+    if (trama[2] != TELEMETRIA_MUESTRAS) return;
+    n = telemetria_muestras_decodificar(&trama[TELEMETRIA_CABECERA], trama[3], lote, &perdidas_trama);
+    if (n < 0) {
+        errores++;
+        return;
+    }
+    muestras += (unsigned long)n;
+    bytes += (unsigned long)largo;
+    perdidas += perdidas_trama;
+    if (silencioso) return;
+
+    if (perdidas_trama) printf("[TLM] trama %u: %u muestras perdidas\n", secuencia, perdidas_trama);
+    for (i = 0; i < n; i++) {
+        printf("[TLM] %lu ms", (unsigned long)lote[i].tiempo_ms);
+        imprimir_decimas("Luz", lote[i].luz);
+        imprimir_decimas("Setpoint", lote[i].setpoint);
+        imprimir_decimas("LED", lote[i].pwm);
+        printf("\n");
+    }
+}
+
+static void uso(const char *prog) {
+    fprintf(stderr,
+            "Uso: %s [-q] [archivo]\n"
+            "  -q  solo el resumen\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    static uint8_t buf[4 * TELEMETRIA_TRAMA_MAX];
+    size_t usados = 0, leidos, inicio;
+    FILE *entrada = stdin;
+    int silencioso = 0, opt, r;
+
+    while ((opt = getopt(argc, argv, "qh")) != -1) {
+        switch (opt) {
+            case 'q': silencioso = 1; break;
+            default: uso(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind < argc) {
+        entrada = fopen(argv[optind], "rb");
+        if (entrada == NULL) {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+
+    while ((leidos = fread(buf + usados, 1, sizeof(buf) - usados, entrada)) > 0) {
+        usados += leidos;
+        inicio = 0;
+        while (inicio < usados) {
+            r = telemetria_trama_validar(buf + inicio, usados - inicio);
+            if (r == 0) break;
+            if (r < 0) {
+                /* Un byte de basura, o un sincronismo falso: avanzar uno. */
+                if (buf[inicio] == TELEMETRIA_SINCRO_0) errores++;
+                inicio++;
+                continue;
+            }
+            procesar(buf + inicio, r, silencioso);
+            inicio += (size_t)r;
+        }
+        memmove(buf, buf + inicio, usados - inicio);
+        usados -= inicio;
+    }
+
+    fprintf(stderr, "[TLM] %lu tramas | %lu muestras | %lu perdidas | %lu reportes | %lu tramas salteadas | %lu errores\n",
+            tramas, muestras, perdidas, reportes, saltos, errores);
+    if (muestras) {
+        fprintf(stderr, "[TLM] %.1f bytes por muestra\n", (double)bytes / muestras);
+    }
+    if (reportes) imprimir_monitor(&ultimo_reporte, stderr);
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fsl_component_mem_manager.h"
+#include "tareas.h"
+#include "botones.h"
+#include "latencia.h"
+#include "telemetria.h"
+#include "tracerecorder.h"
+
+static FILE *salida_telemetria;
+static FILE *salida_traza;
+
+/* En el simulador la telemetria va a un archivo (o a stdout), y cada trama
+ * vuelve al pool apenas se escribe. */
+void telemetria_puerto_escribir(uint8_t *trama, size_t largo) {
+    fwrite(trama, 1, largo, salida_telemetria);
+    telemetria_trama_enviada(trama);
+}
+
+static void imprimir_latencia(void) {
+    latencia_stats_t lat;
+    int i;
+
+    latencia_obtener(&lat);
+    if (lat.muestras == 0) return;
+
+    fprintf(stderr, "[SIM] Latencia sensor->actuador: %lu muestras | min %lu us | media %lu us | max %lu us\n",
+            (unsigned long)lat.muestras, (unsigned long)lat.min_us,
+            (unsigned long)(lat.suma_us / lat.muestras), (unsigned long)lat.max_us);
+    for (i = 0; i < LATENCIA_CUBETAS; i++) {
+        if (lat.cubetas[i] == 0) continue;
+        fprintf(stderr, "[SIM]   %s%2d ms: %lu\n", i == LATENCIA_CUBETAS - 1 ? ">=" : "  ", i,
+                (unsigned long)lat.cubetas[i]);
+    }
+}
+
+static void imprimir_pool_tramas(void) {
+    MemPoolStats_t stats;
+
+    vMemPoolGetStats(pool_tramas, &stats);
+    fprintf(stderr, "[SIM] Pool de tramas: %lu reservas | %lu bloques de %lu B | minimo libre %lu | vacio %lu veces\n",
+            (unsigned long)stats.ulAllocations, (unsigned long)stats.uxBlocks, (unsigned long)stats.xBlockSize,
+            (unsigned long)stats.uxMinimumEverFree, (unsigned long)stats.ulFailures);
+}
+
+static void escribir_traza(const void *datos, size_t largo, void *contexto) {
+    fwrite(datos, 1, largo, (FILE *)contexto);
+}
+
+static void uso(const char *prog) {
+    fprintf(stderr,
+            "Uso: %s [-t segundos] [-x factor] [-o archivo] [-r archivo]\n"
+            "  -t  tiempo virtual a simular (por defecto 3600 s)\n"
+            "  -x  velocidad respecto del reloj real, 0 = lo mas rapido posible (por defecto)\n"
+            "  -o  archivo para la telemetria binaria (por defecto stdout)\n"
+            "  -r  archivo para la traza del kernel al terminar (ver traza_json)\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long segundos = 3600;
+    unsigned long factor = 0;
+    const char *archivo = NULL, *archivo_traza = NULL;
+    uint64_t inicio_ns, fin_ns;
+    double real_s, virtual_s;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:x:o:r:h")) != -1) {
+        switch (opt) {
+            case 't': segundos = strtoul(optarg, NULL, 10); break;
+            case 'x': factor = strtoul(optarg, NULL, 10); break;
+            case 'o': archivo = optarg; break;
+            case 'r': archivo_traza = optarg; break;
+            default: uso(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    salida_telemetria = archivo != NULL ? fopen(archivo, "wb") : stdout;
+    if (salida_telemetria == NULL) {
+        perror(archivo);
+        return 1;
+    }
+    if (archivo_traza != NULL) {
+        salida_traza = fopen(archivo_traza, "wb");
+        if (salida_traza == NULL) {
+            perror(archivo_traza);
+            return 1;
+        }
+        vTraceRecorderStart();
+    }
+
+    vPortSimSetEndTick(pdMS_TO_TICKS(segundos * 1000UL));
+    vPortSimSetSpeed(factor);
+
+    MEM_Init();
+    tareas_crear();
+    botones_iniciar();
+
+    inicio_ns = ullPortSimGetHostTimeNs();
+    vTaskStartScheduler();
+    fin_ns = ullPortSimGetHostTimeNs();
+
+    /* El reporte va a stderr para no mezclarse con la telemetria. */
+    real_s = (double)(fin_ns - inicio_ns) / 1e9;
+    virtual_s = (double)xTaskGetTickCount() / configTICK_RATE_HZ;
+    fprintf(stderr, "[SIM] Tiempo virtual: %.3f s | Tiempo real: %.3f s | Aceleracion: %.0fx\n",
+            virtual_s, real_s, real_s > 0 ? virtual_s / real_s : 0.0);
+    fprintf(stderr, "[SIM] Cambios de contexto: %llu (%.1f/s virtual)\n",
+            (unsigned long long)ullPortSimGetContextSwitches(),
+            virtual_s > 0 ? (double)ullPortSimGetContextSwitches() / virtual_s : 0.0);
+    imprimir_latencia();
+    imprimir_pool_tramas();
+    fclose(salida_telemetria);
+    if (salida_traza != NULL) {
+        /* El anillo guarda los ultimos eventos de la corrida. */
+        vTraceRecorderDump(escribir_traza, salida_traza);
+        fclose(salida_traza);
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef CORE_CM0PLUS_H
+#define CORE_CM0PLUS_H
+
+#include <stdint.h>
+
+/* Reemplazo de host del core_cm0plus.h de CMSIS para compilar los drivers del
+ * SDK contra el modelo de registros de modelo_lpc845.c. Los registros de los
+ * perifericos estan en sus direcciones reales; el NVIC, PRIMASK y las barreras
+ * los implementa el modelo. */
+
+#define __I volatile const
+#define __O volatile
+#define __IO volatile
+#define __IM volatile const
+#define __OM volatile
+#define __IOM volatile
+
+#define __ASM __asm__
+#define __INLINE inline
+#define __STATIC_INLINE static inline
+#define __STATIC_FORCEINLINE static inline
+#define __WEAK __attribute__((weak))
+#define __USED __attribute__((used))
+#define __PACKED __attribute__((packed))
+#define __ALIGNED(x) __attribute__((aligned(x)))
+#define __NO_RETURN __attribute__((__noreturn__))
+#define __RESTRICT __restrict
+#define __COMPILER_BARRIER() __asm__ volatile("" ::: "memory")
+
+/* Registros del core que usan fsl_common_arm.c. */
+typedef struct {
+    __IO uint32_t VTOR;
+} SCB_Type;
+
+extern SCB_Type modelo_scb;
+#define SCB (&modelo_scb)
+
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn);
+void NVIC_SetPendingIRQ(IRQn_Type IRQn);
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn);
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+uint32_t NVIC_GetPriority(IRQn_Type IRQn);
+
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+void __enable_irq(void);
+
+#define __NOP() __COMPILER_BARRIER()
+#define __DSB() __COMPILER_BARRIER()
+#define __ISB() __COMPILER_BARRIER()
+#define __DMB() __COMPILER_BARRIER()
+#define __WFI() __COMPILER_BARRIER()
+#define __REV(x) __builtin_bswap32(x)
+
+#endif /* CORE_CM0PLUS_H */
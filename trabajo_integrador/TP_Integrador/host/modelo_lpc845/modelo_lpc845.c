@@ -0,0 +1,1181 @@
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "fsl_device_registers.h"
+#include "fsl_dma.h"
+#include "modelo_lpc845.h"
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error El modelo atrapa los accesos con el paso a paso de x86_64 Linux.
+#endif
+
+#define PAGINA 0x1000U
+#define CANALES FSL_FEATURE_DMA_MAX_CHANNELS
+#define VUELTAS_MAX 100000U
+
+/* Pedidos de DMA de los perifericos (LPC84x UM, tabla de pedidos de DMA). */
+#define PEDIDO_USART0_RX 0U
+#define PEDIDO_USART0_TX 1U
+#define PEDIDO_SPI0_RX 10U
+#define PEDIDO_SPI0_TX 11U
+
+/* Los manejadores son de los drivers: un ejecutable que no enlaza uno no
+ * puede habilitar su interrupcion. */
+extern void DMA0_DriverIRQHandler(void) __attribute__((weak));
+extern void USART0_DriverIRQHandler(void) __attribute__((weak));
+extern void SPI0_DriverIRQHandler(void) __attribute__((weak));
+extern void I2C0_DriverIRQHandler(void) __attribute__((weak));
+
+SCB_Type modelo_scb;
+uint32_t SystemCoreClock;
+
+/*----------------------------------------------------------------------------
+ * Paginas atrapadas
+ *--------------------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t base;
+    /* efectos es cero cuando el valor es solo el punto de partida de una
+     * escritura (una instruccion que lee y escribe). */
+    uint32_t (*leer)(uint32_t desplazamiento, int efectos);
+    void (*escribir)(uint32_t desplazamiento, uint32_t valor);
+} region_t;
+
+static uint32_t dma_leer(uint32_t desplazamiento, int efectos);
+static void dma_escribir(uint32_t desplazamiento, uint32_t valor);
+static uint32_t usart_leer(uint32_t desplazamiento, int efectos);
+static void usart_escribir(uint32_t desplazamiento, uint32_t valor);
+static uint32_t spi_leer(uint32_t desplazamiento, int efectos);
+static void spi_escribir(uint32_t desplazamiento, uint32_t valor);
+static uint32_t i2c_leer(uint32_t desplazamiento, int efectos);
+static void i2c_escribir(uint32_t desplazamiento, uint32_t valor);
+
+static const region_t regiones[] = {
+    {DMA0_BASE, dma_leer, dma_escribir},
+    {USART0_BASE, usart_leer, usart_escribir},
+    {SPI0_BASE, spi_leer, spi_escribir},
+    {I2C0_BASE, i2c_leer, i2c_escribir},
+};
+
+#define REGIONES (sizeof(regiones) / sizeof(regiones[0]))
+
+/* El acceso en curso, entre el SIGSEGV y el SIGTRAP del paso siguiente. */
+static struct {
+    const region_t *region;
+    uint32_t desplazamiento;
+    int escritura;
+} acceso;
+
+static const region_t *buscar_region(uintptr_t direccion) {
+    uint32_t i;
+
+    for (i = 0; i < REGIONES; i++) {
+        if (direccion >= regiones[i].base && direccion < regiones[i].base + PAGINA) return &regiones[i];
+    }
+    return NULL;
+}
+
+static void al_fallar(int senal, siginfo_t *info, void *contexto) {
+    ucontext_t *uc = contexto;
+    const region_t *r = buscar_region((uintptr_t)info->si_addr);
+
+    if (r == NULL || acceso.region != NULL) {
+        /* Un acceso fuera del modelo: que termine como cualquier SIGSEGV. */
+        signal(senal, SIG_DFL);
+        return;
+    }
+    acceso.region = r;
+    acceso.desplazamiento = ((uint32_t)(uintptr_t)info->si_addr - r->base) & ~3U;
+    acceso.escritura = (uc->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+
+    mprotect((void *)(uintptr_t)r->base, PAGINA, PROT_READ | PROT_WRITE);
+    *(volatile uint32_t *)(uintptr_t)(r->base + acceso.desplazamiento) = r->leer(acceso.desplazamiento, !acceso.escritura);
+    uc->uc_mcontext.gregs[REG_EFL] |= 0x100; /* TF: un paso y SIGTRAP */
+}
+
+static void al_pasar(int senal, siginfo_t *info, void *contexto) {
+    ucontext_t *uc = contexto;
+    const region_t *r = acceso.region;
+
+    (void)info;
+    if (r == NULL) {
+        signal(senal, SIG_DFL);
+        return;
+    }
+    if (acceso.escritura) r->escribir(acceso.desplazamiento, *(volatile uint32_t *)(uintptr_t)(r->base + acceso.desplazamiento));
+    mprotect((void *)(uintptr_t)r->base, PAGINA, PROT_NONE);
+    uc->uc_mcontext.gregs[REG_EFL] &= ~0x100;
+    acceso.region = NULL;
+}
+
+static void mapear(uintptr_t base, size_t largo) {
+    void *p = mmap((void *)base, largo, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (p == MAP_FAILED || (uintptr_t)p != base) {
+        /* Ya estaba mapeado por una llamada anterior: se limpia. */
+        if (munmap((void *)base, largo) != 0 ||
+            mmap((void *)base, largo, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) !=
+                (void *)base) {
+            perror("modelo_lpc845: mmap");
+            exit(2);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * NVIC y PRIMASK
+ *--------------------------------------------------------------------------*/
+
+static uint32_t nvic_habilitadas, nvic_pendientes, primask;
+static uint32_t nvic_prioridad[32];
+static uint32_t irqs_atendidas[32];
+
+void NVIC_EnableIRQ(IRQn_Type IRQn) {
+    nvic_habilitadas |= 1UL << (uint32_t)IRQn;
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn) {
+    nvic_habilitadas &= ~(1UL << (uint32_t)IRQn);
+}
+
+uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn) {
+    return (nvic_habilitadas >> (uint32_t)IRQn) & 1U;
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type IRQn) {
+    nvic_pendientes |= 1UL << (uint32_t)IRQn;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn) {
+    nvic_pendientes &= ~(1UL << (uint32_t)IRQn);
+}
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn) {
+    return (nvic_pendientes >> (uint32_t)IRQn) & 1U;
+}
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority) {
+    if ((int32_t)IRQn >= 0) nvic_prioridad[IRQn] = priority;
+}
+
+uint32_t NVIC_GetPriority(IRQn_Type IRQn) {
+    return (int32_t)IRQn >= 0 ? nvic_prioridad[IRQn] : 0U;
+}
+
+uint32_t __get_PRIMASK(void) {
+    return primask;
+}
+
+void __set_PRIMASK(uint32_t priMask) {
+    primask = priMask & 1U;
+}
+
+void __disable_irq(void) {
+    primask = 1U;
+}
+
+void __enable_irq(void) {
+    primask = 0U;
+}
+
+/*----------------------------------------------------------------------------
+ * USART0
+ *--------------------------------------------------------------------------*/
+
+#define USART_COLA 4096U
+#define USART_SALIDA 8192U
+#define USART_STAT_W1C                                                                                       \
+    (USART_STAT_DELTACTS_MASK | USART_STAT_OVERRUNINT_MASK | USART_STAT_DELTARXBRK_MASK | USART_STAT_START_MASK | \
+     USART_STAT_FRAMERRINT_MASK | USART_STAT_PARITYERRINT_MASK | USART_STAT_RXNOISEINT_MASK | USART_STAT_ABERR_MASK)
+
+static struct {
+    uint32_t cfg, ctl, intenset, brg, osr, addr, banderas;
+    uint8_t rxdat, txdat, desplazado;
+    int rx_lleno, tx_lleno;
+    /* Caracter en la linea de RX y en el registro de desplazamiento de TX */
+    int recibiendo, desplazando;
+    uint64_t fin_rx, fin_tx;
+    uint8_t cola[USART_COLA];
+    size_t cola_ini, cola_fin;
+    uint8_t salida[USART_SALIDA];
+    size_t enviados;
+    uint32_t desbordes;
+} usart;
+
+static uint64_t ahora;
+static uint32_t reloj;
+
+uint64_t modelo_usart_ciclos_caracter(void) {
+    uint32_t bits = 1U + 7U + ((usart.cfg & USART_CFG_DATALEN_MASK) >> USART_CFG_DATALEN_SHIFT) + 1U;
+
+    if ((usart.cfg & USART_CFG_PARITYSEL_MASK) != 0U) bits++;
+    if ((usart.cfg & USART_CFG_STOPLEN_MASK) != 0U) bits++;
+    return (uint64_t)(usart.osr + 1U) * (usart.brg + 1U) * bits;
+}
+
+static uint32_t usart_stat(void) {
+    uint32_t stat = usart.banderas;
+
+    if (usart.rx_lleno) stat |= USART_STAT_RXRDY_MASK;
+    if (!usart.recibiendo) stat |= USART_STAT_RXIDLE_MASK;
+    if (!usart.tx_lleno) stat |= USART_STAT_TXRDY_MASK;
+    if (!usart.tx_lleno && !usart.desplazando) stat |= USART_STAT_TXIDLE_MASK;
+    if ((usart.ctl & USART_CTL_TXDIS_MASK) != 0U && !usart.desplazando) stat |= USART_STAT_TXDISSTAT_MASK;
+    return stat;
+}
+
+static uint32_t usart_leer(uint32_t desplazamiento, int efectos) {
+    uint32_t valor;
+
+    switch (desplazamiento) {
+        case offsetof(USART_Type, CFG):
+            return usart.cfg;
+        case offsetof(USART_Type, CTL):
+            return usart.ctl;
+        case offsetof(USART_Type, STAT):
+            return usart_stat();
+        case offsetof(USART_Type, INTENSET):
+            return usart.intenset;
+        case offsetof(USART_Type, RXDAT):
+        case offsetof(USART_Type, RXDATSTAT):
+            valor = usart.rxdat;
+            if (efectos) usart.rx_lleno = 0;
+            return valor;
+        case offsetof(USART_Type, TXDAT):
+            return usart.txdat;
+        case offsetof(USART_Type, BRG):
+            return usart.brg;
+        case offsetof(USART_Type, INTSTAT):
+            return usart_stat() & usart.intenset;
+        case offsetof(USART_Type, OSR):
+            return usart.osr;
+        case offsetof(USART_Type, ADDR):
+            return usart.addr;
+        default:
+            return 0U;
+    }
+}
+
+static void usart_escribir(uint32_t desplazamiento, uint32_t valor) {
+    switch (desplazamiento) {
+        case offsetof(USART_Type, CFG):
+            usart.cfg = valor;
+            break;
+        case offsetof(USART_Type, CTL):
+            usart.ctl = valor;
+            break;
+        case offsetof(USART_Type, STAT):
+            usart.banderas &= ~(valor & USART_STAT_W1C);
+            break;
+        case offsetof(USART_Type, INTENSET):
+            usart.intenset |= valor;
+            break;
+        case offsetof(USART_Type, INTENCLR):
+            usart.intenset &= ~valor;
+            break;
+        case offsetof(USART_Type, TXDAT):
+            /* Escribir con TXRDY en cero pisa el dato, como en el chip. */
+            usart.txdat = (uint8_t)valor;
+            usart.tx_lleno = 1;
+            break;
+        case offsetof(USART_Type, BRG):
+            usart.brg = valor & 0xFFFFU;
+            break;
+        case offsetof(USART_Type, OSR):
+            usart.osr = valor & 0xFU;
+            break;
+        case offsetof(USART_Type, ADDR):
+            usart.addr = valor & 0xFFU;
+            break;
+        default:
+            break;
+    }
+}
+
+void modelo_usart_recibir(const uint8_t *datos, size_t n) {
+    while (n-- > 0U) {
+        if (usart.cola_fin - usart.cola_ini == USART_COLA) {
+            fprintf(stderr, "modelo_lpc845: cola de RX llena\n");
+            exit(2);
+        }
+        usart.cola[usart.cola_fin++ % USART_COLA] = *datos++;
+    }
+}
+
+size_t modelo_usart_enviados(uint8_t *datos, size_t max) {
+    size_t n = usart.enviados < max ? usart.enviados : max;
+
+    memcpy(datos, usart.salida, n);
+    memmove(usart.salida, usart.salida + n, usart.enviados - n);
+    usart.enviados -= n;
+    return n;
+}
+
+uint32_t modelo_usart_desbordes(void) {
+    return usart.desbordes;
+}
+
+/* Eventos de la USART que vencen en ahora. Devuelve cuantos hubo. */
+static uint32_t usart_actualizar(void) {
+    uint32_t cambios = 0;
+
+    if ((usart.cfg & USART_CFG_ENABLE_MASK) == 0U) return 0;
+
+    if (usart.recibiendo && usart.fin_rx <= ahora) {
+        if (usart.rx_lleno) {
+            usart.banderas |= USART_STAT_OVERRUNINT_MASK;
+            usart.desbordes++;
+        } else {
+            usart.rxdat = usart.cola[usart.cola_ini % USART_COLA];
+            usart.rx_lleno = 1;
+        }
+        usart.cola_ini++;
+        usart.recibiendo = 0;
+        cambios++;
+    }
+    if (!usart.recibiendo && usart.cola_ini != usart.cola_fin) {
+        usart.recibiendo = 1;
+        usart.fin_rx = ahora + modelo_usart_ciclos_caracter();
+        usart.banderas |= USART_STAT_START_MASK;
+        cambios++;
+    }
+
+    if (usart.desplazando && usart.fin_tx <= ahora) {
+        if (usart.enviados < USART_SALIDA) usart.salida[usart.enviados++] = usart.desplazado;
+        usart.desplazando = 0;
+        cambios++;
+    }
+    if (!usart.desplazando && usart.tx_lleno && (usart.ctl & USART_CTL_TXDIS_MASK) == 0U) {
+        /* El registro de desplazamiento se queda con una copia: txdat sigue
+         * leyendose como el ultimo dato escrito. */
+        usart.desplazado = usart.txdat;
+        usart.desplazando = 1;
+        usart.tx_lleno = 0;
+        usart.fin_tx = ahora + modelo_usart_ciclos_caracter();
+        cambios++;
+    }
+    return cambios;
+}
+
+static uint64_t usart_proximo_evento(void) {
+    uint64_t proximo = UINT64_MAX;
+
+    if (usart.recibiendo) proximo = usart.fin_rx;
+    if (usart.desplazando && usart.fin_tx < proximo) proximo = usart.fin_tx;
+    return proximo;
+}
+
+/*----------------------------------------------------------------------------
+ * SPI0, solo maestro
+ *--------------------------------------------------------------------------*/
+
+#define SPI_STAT_W1C (SPI_STAT_RXOV_MASK | SPI_STAT_TXUR_MASK | SPI_STAT_SSA_MASK | SPI_STAT_SSD_MASK)
+#define SPI_CONTROL                                                                                  \
+    (SPI_TXDATCTL_TXSSEL0_N_MASK | SPI_TXDATCTL_TXSSEL1_N_MASK | SPI_TXDATCTL_TXSSEL2_N_MASK |     \
+     SPI_TXDATCTL_TXSSEL3_N_MASK | SPI_TXDATCTL_EOT_MASK | SPI_TXDATCTL_EOF_MASK |                 \
+     SPI_TXDATCTL_RXIGNORE_MASK | SPI_TXDATCTL_LEN_MASK)
+#define SPI_SSEL_N                                                                        \
+    (SPI_TXDATCTL_TXSSEL0_N_MASK | SPI_TXDATCTL_TXSSEL1_N_MASK | SPI_TXDATCTL_TXSSEL2_N_MASK | \
+     SPI_TXDATCTL_TXSSEL3_N_MASK)
+
+static struct {
+    uint32_t cfg, dly, intenset, txctl, div, banderas;
+    /* Dato y control esperando en TXDAT, y la trama en el registro de
+     * desplazamiento */
+    uint32_t txdat, trama;
+    uint16_t rxdat, miso;
+    int tx_lleno, rx_lleno, desplazando, seleccionado, inicio;
+    uint64_t fin_trama;
+    modelo_spi_esclavo_t esclavo;
+    uint32_t fines;
+} spi;
+
+static uint32_t spi_bits(uint32_t control) {
+    return ((control & SPI_TXDATCTL_LEN_MASK) >> SPI_TXDATCTL_LEN_SHIFT) + 1U;
+}
+
+uint64_t modelo_spi_ciclos_trama(void) {
+    return (uint64_t)(spi.div + 1U) * spi_bits(spi.txctl);
+}
+
+void modelo_spi_conectar(modelo_spi_esclavo_t esclavo) {
+    spi.esclavo = esclavo;
+}
+
+uint32_t modelo_spi_fines(void) {
+    return spi.fines;
+}
+
+int modelo_spi_seleccionado(void) {
+    return spi.seleccionado;
+}
+
+static uint32_t spi_stat(void) {
+    uint32_t stat = spi.banderas;
+
+    if (spi.rx_lleno) stat |= SPI_STAT_RXRDY_MASK;
+    if (!spi.tx_lleno) stat |= SPI_STAT_TXRDY_MASK;
+    if (!spi.tx_lleno && !spi.desplazando) stat |= spi.seleccionado ? SPI_STAT_STALLED_MASK : SPI_STAT_MSTIDLE_MASK;
+    return stat;
+}
+
+static uint32_t spi_leer(uint32_t desplazamiento, int efectos) {
+    switch (desplazamiento) {
+        case offsetof(SPI_Type, CFG):
+            return spi.cfg;
+        case offsetof(SPI_Type, DLY):
+            return spi.dly;
+        case offsetof(SPI_Type, STAT):
+            return spi_stat();
+        case offsetof(SPI_Type, INTENSET):
+            return spi.intenset;
+        case offsetof(SPI_Type, RXDAT):
+            if (efectos) spi.rx_lleno = 0;
+            return spi.rxdat;
+        case offsetof(SPI_Type, TXCTL):
+            return spi.txctl;
+        case offsetof(SPI_Type, DIV):
+            return spi.div;
+        case offsetof(SPI_Type, INTSTAT):
+            return spi_stat() & spi.intenset;
+        default:
+            return 0U;
+    }
+}
+
+static void spi_escribir(uint32_t desplazamiento, uint32_t valor) {
+    switch (desplazamiento) {
+        case offsetof(SPI_Type, CFG):
+            /* Deshabilitarla reinicia la maquina de estados: se pierden la
+             * trama en curso y los datos de TXDAT y RXDAT. */
+            if ((valor & SPI_CFG_ENABLE_MASK) == 0U) {
+                if (spi.seleccionado) {
+                    spi.banderas |= SPI_STAT_SSD_MASK;
+                    spi.fines++;
+                }
+                spi.tx_lleno = spi.rx_lleno = spi.desplazando = spi.seleccionado = 0;
+            }
+            spi.cfg = valor;
+            break;
+        case offsetof(SPI_Type, DLY):
+            spi.dly = valor;
+            break;
+        case offsetof(SPI_Type, STAT):
+            spi.banderas &= ~(valor & SPI_STAT_W1C);
+            if ((valor & SPI_STAT_ENDTRANSFER_MASK) != 0U) {
+                /* Termina despues de lo que ya esta en TXDAT, o ya si no hay
+                 * nada */
+                if (spi.tx_lleno) {
+                    spi.txdat |= SPI_TXDATCTL_EOT_MASK;
+                } else if (spi.desplazando) {
+                    spi.trama |= SPI_TXDATCTL_EOT_MASK;
+                } else if (spi.seleccionado) {
+                    spi.seleccionado = 0;
+                    spi.banderas |= SPI_STAT_SSD_MASK;
+                    spi.fines++;
+                }
+            }
+            break;
+        case offsetof(SPI_Type, INTENSET):
+            spi.intenset |= valor;
+            break;
+        case offsetof(SPI_Type, INTENCLR):
+            spi.intenset &= ~valor;
+            break;
+        case offsetof(SPI_Type, TXDATCTL):
+            /* El control escrito con el dato queda tambien en TXCTL. */
+            spi.txctl = valor & SPI_CONTROL;
+            spi.txdat = valor & (SPI_CONTROL | SPI_TXDATCTL_TXDAT_MASK);
+            spi.tx_lleno = 1;
+            break;
+        case offsetof(SPI_Type, TXDAT):
+            spi.txdat = spi.txctl | (valor & SPI_TXDAT_DATA_MASK);
+            spi.tx_lleno = 1;
+            break;
+        case offsetof(SPI_Type, TXCTL):
+            spi.txctl = valor & SPI_CONTROL;
+            break;
+        case offsetof(SPI_Type, DIV):
+            spi.div = valor & SPI_DIV_DIVVAL_MASK;
+            break;
+        default:
+            break;
+    }
+}
+
+/* Eventos de la SPI0 que vencen en ahora. Las demoras de DLY no se modelan:
+ * las tramas salen una detras de otra. */
+static uint32_t spi_actualizar(void) {
+    const uint32_t maestro = SPI_CFG_ENABLE_MASK | SPI_CFG_MASTER_MASK;
+    uint32_t cambios = 0, mascara;
+
+    if ((spi.cfg & maestro) != maestro) return 0;
+
+    if (spi.desplazando && spi.fin_trama <= ahora) {
+        mascara = (1UL << spi_bits(spi.trama)) - 1U;
+        if ((spi.trama & SPI_TXDATCTL_RXIGNORE_MASK) == 0U) {
+            spi.rxdat = (uint16_t)(spi.miso & mascara);
+            spi.rx_lleno = 1;
+        }
+        spi.desplazando = 0;
+        if ((spi.trama & SPI_TXDATCTL_EOT_MASK) != 0U) {
+            spi.seleccionado = 0;
+            spi.banderas |= SPI_STAT_SSD_MASK;
+            spi.fines++;
+        }
+        cambios++;
+    }
+    /* El maestro no pisa RXDAT: espera a que se lea si la trama recibe. */
+    if (!spi.desplazando && spi.tx_lleno && (!spi.rx_lleno || (spi.txdat & SPI_TXDATCTL_RXIGNORE_MASK) != 0U)) {
+        spi.trama = spi.txdat;
+        spi.tx_lleno = 0;
+        spi.desplazando = 1;
+        if (!spi.seleccionado && (spi.trama & SPI_SSEL_N) != SPI_SSEL_N) {
+            spi.seleccionado = 1;
+            spi.inicio = 1;
+            spi.banderas |= SPI_STAT_SSA_MASK;
+        }
+        mascara = (1UL << spi_bits(spi.trama)) - 1U;
+        spi.miso = spi.esclavo != NULL ? spi.esclavo((uint16_t)(spi.trama & mascara), spi.inicio) : 0xFFFFU;
+        spi.inicio = 0;
+        spi.fin_trama = ahora + (uint64_t)(spi.div + 1U) * spi_bits(spi.trama);
+        cambios++;
+    }
+    return cambios;
+}
+
+static uint64_t spi_proximo_evento(void) {
+    return spi.desplazando ? spi.fin_trama : UINT64_MAX;
+}
+
+/*----------------------------------------------------------------------------
+ * I2C0, solo maestro
+ *--------------------------------------------------------------------------*/
+
+#define I2C_ESCLAVOS 8U
+#define I2C_STAT_W1C (I2C_STAT_MSTARBLOSS_MASK | I2C_STAT_MSTSTSTPERR_MASK)
+#define I2C_IDLE 0U
+#define I2C_RXREADY 1U
+#define I2C_TXREADY 2U
+#define I2C_NACKADR 3U
+#define I2C_NACKDAT 4U
+
+/* Lo que el maestro esta haciendo en el bus hasta fin */
+typedef enum { I2C_NADA, I2C_DIRECCION, I2C_ESCRITURA, I2C_LECTURA, I2C_PARADA } i2c_operacion_t;
+
+static struct {
+    uint32_t cfg, intenset, timeout, clkdiv, msttime, banderas;
+    /* MSTDAT y MSTSTATE */
+    uint32_t mstdat, estado;
+    int pendiente;
+    i2c_operacion_t operacion;
+    uint64_t fin;
+    /* Esclavo que contesto la direccion, entre START y STOP */
+    modelo_i2c_esclavo_t direccionado;
+    int en_transferencia;
+    uint64_t inicio_ocupado, ocupado;
+    struct {
+        uint8_t direccion;
+        modelo_i2c_esclavo_t esclavo;
+    } esclavos[I2C_ESCLAVOS];
+    uint32_t n_esclavos;
+} i2c;
+
+uint64_t modelo_i2c_ciclos_bit(void) {
+    const uint32_t bajo = (i2c.msttime & I2C_MSTTIME_MSTSCLLOW_MASK) >> I2C_MSTTIME_MSTSCLLOW_SHIFT;
+    const uint32_t alto = (i2c.msttime & I2C_MSTTIME_MSTSCLHIGH_MASK) >> I2C_MSTTIME_MSTSCLHIGH_SHIFT;
+
+    return (uint64_t)((i2c.clkdiv & I2C_CLKDIV_DIVVAL_MASK) + 1U) * (bajo + 2U + alto + 2U);
+}
+
+uint64_t modelo_i2c_ciclos_ocupado(void) {
+    return i2c.ocupado + (i2c.en_transferencia ? ahora - i2c.inicio_ocupado : 0U);
+}
+
+void modelo_i2c_conectar(uint8_t direccion, modelo_i2c_esclavo_t esclavo) {
+    uint32_t i;
+
+    for (i = 0; i < i2c.n_esclavos; i++) {
+        if (i2c.esclavos[i].direccion == direccion) break;
+    }
+    if (i == I2C_ESCLAVOS) {
+        fprintf(stderr, "modelo_lpc845: mas de %u esclavos I2C\n", I2C_ESCLAVOS);
+        exit(2);
+    }
+    if (i == i2c.n_esclavos) i2c.n_esclavos++;
+    i2c.esclavos[i].direccion = direccion;
+    i2c.esclavos[i].esclavo = esclavo;
+}
+
+static modelo_i2c_esclavo_t i2c_buscar(uint8_t direccion) {
+    uint32_t i;
+
+    for (i = 0; i < i2c.n_esclavos; i++) {
+        if (i2c.esclavos[i].direccion == direccion) return i2c.esclavos[i].esclavo;
+    }
+    return NULL;
+}
+
+static uint32_t i2c_stat(void) {
+    uint32_t stat = i2c.banderas;
+
+    if ((i2c.cfg & I2C_CFG_MSTEN_MASK) != 0U && i2c.pendiente) stat |= I2C_STAT_MSTPENDING_MASK;
+    return stat | I2C_STAT_MSTSTATE(i2c.estado);
+}
+
+static void i2c_operar(i2c_operacion_t operacion, uint32_t bits) {
+    i2c.operacion = operacion;
+    i2c.pendiente = 0;
+    i2c.fin = ahora + bits * modelo_i2c_ciclos_bit();
+}
+
+static uint32_t i2c_leer(uint32_t desplazamiento, int efectos) {
+    (void)efectos;
+    switch (desplazamiento) {
+        case offsetof(I2C_Type, CFG):
+            return i2c.cfg;
+        case offsetof(I2C_Type, STAT):
+            return i2c_stat();
+        case offsetof(I2C_Type, INTENSET):
+            return i2c.intenset;
+        case offsetof(I2C_Type, TIMEOUT):
+            return i2c.timeout;
+        case offsetof(I2C_Type, CLKDIV):
+            return i2c.clkdiv;
+        case offsetof(I2C_Type, INTSTAT):
+            return i2c_stat() & i2c.intenset;
+        case offsetof(I2C_Type, MSTTIME):
+            return i2c.msttime;
+        case offsetof(I2C_Type, MSTDAT):
+            return i2c.mstdat;
+        default:
+            return 0U;
+    }
+}
+
+/* Lo que pide MSTCTL, con los largos en bits de SCL: el START va con la
+ * direccion y, en una lectura, con el primer byte; cada byte siguiente lleva
+ * el ACK del anterior, y despues del ultimo byte leido va el NACK. */
+static void i2c_mstctl(uint32_t valor) {
+    if ((i2c.cfg & I2C_CFG_MSTEN_MASK) == 0U || !i2c.pendiente) return;
+
+    if ((valor & I2C_MSTCTL_MSTSTOP_MASK) != 0U) {
+        if (i2c.en_transferencia) i2c_operar(I2C_PARADA, i2c.estado == I2C_RXREADY ? 2U : 1U);
+    } else if ((valor & I2C_MSTCTL_MSTSTART_MASK) != 0U) {
+        if (!i2c.en_transferencia) {
+            i2c.en_transferencia = 1;
+            i2c.inicio_ocupado = ahora;
+        }
+        i2c_operar(I2C_DIRECCION, (i2c.mstdat & 1U) != 0U ? 18U : 10U);
+    } else if ((valor & I2C_MSTCTL_MSTCONTINUE_MASK) != 0U) {
+        if (i2c.estado == I2C_TXREADY) {
+            i2c_operar(I2C_ESCRITURA, 9U);
+        } else if (i2c.estado == I2C_RXREADY) {
+            i2c_operar(I2C_LECTURA, 9U);
+        }
+    }
+}
+
+static void i2c_escribir(uint32_t desplazamiento, uint32_t valor) {
+    switch (desplazamiento) {
+        case offsetof(I2C_Type, CFG):
+            if ((valor & I2C_CFG_MSTEN_MASK) == 0U) {
+                i2c.operacion = I2C_NADA;
+                i2c.direccionado = NULL;
+                i2c.en_transferencia = 0;
+                i2c.estado = I2C_IDLE;
+            } else if ((i2c.cfg & I2C_CFG_MSTEN_MASK) == 0U) {
+                i2c.pendiente = 1;
+            }
+            i2c.cfg = valor;
+            break;
+        case offsetof(I2C_Type, STAT):
+            i2c.banderas &= ~(valor & I2C_STAT_W1C);
+            break;
+        case offsetof(I2C_Type, INTENSET):
+            i2c.intenset |= valor;
+            break;
+        case offsetof(I2C_Type, INTENCLR):
+            i2c.intenset &= ~valor;
+            break;
+        case offsetof(I2C_Type, TIMEOUT):
+            i2c.timeout = valor;
+            break;
+        case offsetof(I2C_Type, CLKDIV):
+            i2c.clkdiv = valor & I2C_CLKDIV_DIVVAL_MASK;
+            break;
+        case offsetof(I2C_Type, MSTCTL):
+            i2c_mstctl(valor);
+            break;
+        case offsetof(I2C_Type, MSTTIME):
+            i2c.msttime = valor & (I2C_MSTTIME_MSTSCLLOW_MASK | I2C_MSTTIME_MSTSCLHIGH_MASK);
+            break;
+        case offsetof(I2C_Type, MSTDAT):
+            i2c.mstdat = valor & 0xFFU;
+            break;
+        default:
+            break;
+    }
+}
+
+/* Fin de la operacion del maestro: el esclavo ve cada evento cuando termina
+ * en el bus. */
+static uint32_t i2c_actualizar(void) {
+    const i2c_operacion_t operacion = i2c.operacion;
+    uint8_t dato;
+
+    if (operacion == I2C_NADA || i2c.fin > ahora) return 0;
+    i2c.operacion = I2C_NADA;
+    i2c.pendiente = 1;
+
+    switch (operacion) {
+        case I2C_DIRECCION:
+            i2c.direccionado = i2c_buscar((uint8_t)(i2c.mstdat >> 1));
+            dato = (uint8_t)(i2c.mstdat & 1U);
+            if (i2c.direccionado == NULL || !i2c.direccionado(MODELO_I2C_INICIO, &dato)) {
+                i2c.direccionado = NULL;
+                i2c.estado = I2C_NACKADR;
+            } else if ((i2c.mstdat & 1U) != 0U) {
+                dato = 0xFFU;
+                i2c.direccionado(MODELO_I2C_LECTURA, &dato);
+                i2c.mstdat = dato;
+                i2c.estado = I2C_RXREADY;
+            } else {
+                i2c.estado = I2C_TXREADY;
+            }
+            break;
+        case I2C_ESCRITURA:
+            dato = (uint8_t)i2c.mstdat;
+            i2c.estado = i2c.direccionado(MODELO_I2C_ESCRITURA, &dato) ? I2C_TXREADY : I2C_NACKDAT;
+            break;
+        case I2C_LECTURA:
+            dato = 0xFFU;
+            i2c.direccionado(MODELO_I2C_LECTURA, &dato);
+            i2c.mstdat = dato;
+            i2c.estado = I2C_RXREADY;
+            break;
+        case I2C_PARADA:
+        default:
+            if (i2c.direccionado != NULL) i2c.direccionado(MODELO_I2C_PARADA, &dato);
+            i2c.direccionado = NULL;
+            i2c.en_transferencia = 0;
+            i2c.ocupado += ahora - i2c.inicio_ocupado;
+            i2c.estado = I2C_IDLE;
+            break;
+    }
+    return 1;
+}
+
+static uint64_t i2c_proximo_evento(void) {
+    return i2c.operacion != I2C_NADA ? i2c.fin : UINT64_MAX;
+}
+
+/*----------------------------------------------------------------------------
+ * DMA
+ *--------------------------------------------------------------------------*/
+
+#define DMA_COMUN(registro) (offsetof(DMA_Type, COMMON[0].registro))
+#define DMA_CANAL(registro) (offsetof(DMA_Type, CHANNEL[0].registro))
+#define DMA_PASO_CANAL (offsetof(DMA_Type, CHANNEL[1]) - offsetof(DMA_Type, CHANNEL[0]))
+
+typedef struct {
+    uint32_t cfg, xfercfg;
+    int valido, valido_pendiente, disparado;
+    /* Direcciones de fin del descriptor en curso y el siguiente */
+    uintptr_t fin_origen, fin_destino, enlace;
+} canal_t;
+
+static struct {
+    uint32_t ctrl, srambase;
+    uint32_t habilitados, intenset, inta, intb, errint;
+    canal_t canal[CANALES];
+} dma;
+
+static uint32_t dma_activos(void) {
+    uint32_t activos = 0, i;
+
+    for (i = 0; i < CANALES; i++) {
+        if (dma.canal[i].valido && dma.canal[i].disparado) activos |= 1UL << i;
+    }
+    return activos;
+}
+
+static void dma_cargar(canal_t *c, const dma_descriptor_t *d) {
+    c->fin_origen = (uintptr_t)d->srcEndAddr;
+    c->fin_destino = (uintptr_t)d->dstEndAddr;
+    c->enlace = (uintptr_t)d->linkToNextDesc;
+}
+
+static uint32_t dma_leer(uint32_t desplazamiento, int efectos) {
+    uint32_t i;
+
+    (void)efectos;
+    if (desplazamiento >= DMA_CANAL(CFG) && desplazamiento < DMA_CANAL(CFG) + CANALES * DMA_PASO_CANAL) {
+        canal_t *c = &dma.canal[(desplazamiento - DMA_CANAL(CFG)) / DMA_PASO_CANAL];
+
+        switch ((desplazamiento - DMA_CANAL(CFG)) % DMA_PASO_CANAL) {
+            case DMA_CANAL(CFG) - DMA_CANAL(CFG):
+                return c->cfg;
+            case DMA_CANAL(CTLSTAT) - DMA_CANAL(CFG):
+                return (c->valido_pendiente ? DMA_CHANNEL_CTLSTAT_VALIDPENDING_MASK : 0U) |
+                       (c->disparado ? DMA_CHANNEL_CTLSTAT_TRIG_MASK : 0U);
+            case DMA_CANAL(XFERCFG) - DMA_CANAL(CFG):
+                return c->xfercfg;
+            default:
+                return 0U;
+        }
+    }
+
+    switch (desplazamiento) {
+        case offsetof(DMA_Type, CTRL):
+            return dma.ctrl;
+        case offsetof(DMA_Type, INTSTAT):
+            i = ((dma.inta | dma.intb) & dma.intenset) != 0U ? DMA_INTSTAT_ACTIVEINT_MASK : 0U;
+            return i | (dma.errint != 0U ? DMA_INTSTAT_ACTIVEERRINT_MASK : 0U);
+        case offsetof(DMA_Type, SRAMBASE):
+            return dma.srambase;
+        case DMA_COMUN(ENABLESET):
+            return dma.habilitados;
+        case DMA_COMUN(ACTIVE):
+            return dma_activos();
+        case DMA_COMUN(BUSY):
+            /* Cada transferencia es atomica para el modelo. */
+            return 0U;
+        case DMA_COMUN(ERRINT):
+            return dma.errint;
+        case DMA_COMUN(INTENSET):
+            return dma.intenset;
+        case DMA_COMUN(INTA):
+            return dma.inta;
+        case DMA_COMUN(INTB):
+            return dma.intb;
+        default:
+            return 0U;
+    }
+}
+
+static void dma_escribir(uint32_t desplazamiento, uint32_t valor) {
+    uint32_t i;
+
+    if (desplazamiento >= DMA_CANAL(CFG) && desplazamiento < DMA_CANAL(CFG) + CANALES * DMA_PASO_CANAL) {
+        i = (desplazamiento - DMA_CANAL(CFG)) / DMA_PASO_CANAL;
+        canal_t *c = &dma.canal[i];
+
+        switch ((desplazamiento - DMA_CANAL(CFG)) % DMA_PASO_CANAL) {
+            case DMA_CANAL(CFG) - DMA_CANAL(CFG):
+                c->cfg = valor;
+                break;
+            case DMA_CANAL(XFERCFG) - DMA_CANAL(CFG):
+                /* El descriptor del canal esta en la tabla de SRAMBASE; el
+                 * driver lo escribe antes de XFERCFG. */
+                c->xfercfg = valor;
+                if ((valor & DMA_CHANNEL_XFERCFG_CFGVALID_MASK) != 0U) {
+                    dma_cargar(c, &((const dma_descriptor_t *)(uintptr_t)dma.srambase)[i]);
+                    c->valido = 1;
+                }
+                if ((valor & DMA_CHANNEL_XFERCFG_SWTRIG_MASK) != 0U) c->disparado = 1;
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+
+    switch (desplazamiento) {
+        case offsetof(DMA_Type, CTRL):
+            dma.ctrl = valor & DMA_CTRL_ENABLE_MASK;
+            break;
+        case offsetof(DMA_Type, SRAMBASE):
+            dma.srambase = valor & ~(FSL_FEATURE_DMA_DESCRIPTOR_ALIGN_SIZE - 1U);
+            break;
+        case DMA_COMUN(ENABLESET):
+            dma.habilitados |= valor;
+            break;
+        case DMA_COMUN(ENABLECLR):
+            dma.habilitados &= ~valor;
+            break;
+        case DMA_COMUN(ERRINT):
+            dma.errint &= ~valor;
+            break;
+        case DMA_COMUN(INTENSET):
+            dma.intenset |= valor;
+            break;
+        case DMA_COMUN(INTENCLR):
+            dma.intenset &= ~valor;
+            break;
+        case DMA_COMUN(INTA):
+            dma.inta &= ~valor;
+            break;
+        case DMA_COMUN(INTB):
+            dma.intb &= ~valor;
+            break;
+        case DMA_COMUN(SETVALID):
+            for (i = 0; i < CANALES; i++) {
+                if ((valor & (1UL << i)) == 0U) continue;
+                if (dma.canal[i].valido) {
+                    dma.canal[i].valido_pendiente = 1;
+                } else {
+                    dma.canal[i].valido = 1;
+                }
+            }
+            break;
+        case DMA_COMUN(SETTRIG):
+            for (i = 0; i < CANALES; i++) {
+                if ((valor & (1UL << i)) != 0U) dma.canal[i].disparado = 1;
+            }
+            break;
+        case DMA_COMUN(ABORT):
+            for (i = 0; i < CANALES; i++) {
+                if ((valor & (1UL << i)) == 0U) continue;
+                dma.canal[i].valido = dma.canal[i].valido_pendiente = dma.canal[i].disparado = 0;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static int dma_pedido(uint32_t canal) {
+    const int usart_habilitada = (usart.cfg & USART_CFG_ENABLE_MASK) != 0U;
+    const int spi_habilitada = (spi.cfg & SPI_CFG_ENABLE_MASK) != 0U;
+
+    switch (canal) {
+        case PEDIDO_USART0_RX:
+            return usart_habilitada && usart.rx_lleno;
+        case PEDIDO_USART0_TX:
+            return usart_habilitada && !usart.tx_lleno;
+        case PEDIDO_SPI0_RX:
+            return spi_habilitada && spi.rx_lleno;
+        case PEDIDO_SPI0_TX:
+            return spi_habilitada && !spi.tx_lleno;
+        default:
+            return 0;
+    }
+}
+
+/* Lectura y escritura del DMA: pasan por el modelo si caen en un periferico
+ * modelado y si no van directo a la memoria. */
+static uint32_t bus_leer(uintptr_t direccion, uint32_t ancho) {
+    const region_t *r = buscar_region(direccion);
+
+    if (r != NULL) return r->leer(((uint32_t)direccion - r->base) & ~3U, 1);
+    if (ancho == 1U) return *(const uint8_t *)direccion;
+    if (ancho == 2U) return *(const uint16_t *)direccion;
+    return *(const uint32_t *)direccion;
+}
+
+static void bus_escribir(uintptr_t direccion, uint32_t ancho, uint32_t valor) {
+    const region_t *r = buscar_region(direccion);
+
+    if (r != NULL) {
+        r->escribir(((uint32_t)direccion - r->base) & ~3U, valor);
+    } else if (ancho == 1U) {
+        *(uint8_t *)direccion = (uint8_t)valor;
+    } else if (ancho == 2U) {
+        *(uint16_t *)direccion = (uint16_t)valor;
+    } else {
+        *(uint32_t *)direccion = valor;
+    }
+}
+
+static uint32_t dma_incremento(uint32_t campo) {
+    return campo == 3U ? 4U : campo;
+}
+
+/* Fin del descriptor en curso: banderas, recarga del siguiente. */
+static void dma_terminar(uint32_t i) {
+    canal_t *c = &dma.canal[i];
+    uint32_t xfercfg = c->xfercfg;
+    const dma_descriptor_t *d;
+
+    if ((xfercfg & DMA_CHANNEL_XFERCFG_SETINTA_MASK) != 0U) dma.inta |= 1UL << i;
+    if ((xfercfg & DMA_CHANNEL_XFERCFG_SETINTB_MASK) != 0U) dma.intb |= 1UL << i;
+    if ((xfercfg & DMA_CHANNEL_XFERCFG_CLRTRIG_MASK) != 0U) c->disparado = 0;
+
+    if ((xfercfg & DMA_CHANNEL_XFERCFG_RELOAD_MASK) != 0U && c->enlace != 0U) {
+        d = (const dma_descriptor_t *)c->enlace;
+        c->xfercfg = d->xfercfg;
+        dma_cargar(c, d);
+        c->valido = (c->xfercfg & DMA_CHANNEL_XFERCFG_CFGVALID_MASK) != 0U || c->valido_pendiente;
+        if ((c->xfercfg & DMA_CHANNEL_XFERCFG_SWTRIG_MASK) != 0U) c->disparado = 1;
+    } else {
+        /* XFERCOUNT queda en 0x3FF, como lo espera DMA_GetRemainingBytes() */
+        c->xfercfg = (xfercfg & ~DMA_CHANNEL_XFERCFG_CFGVALID_MASK) | DMA_CHANNEL_XFERCFG_XFERCOUNT_MASK;
+        c->valido = c->valido_pendiente;
+    }
+    c->valido_pendiente = 0;
+}
+
+static void dma_transferir(uint32_t i) {
+    canal_t *c = &dma.canal[i];
+    uint32_t resto = (c->xfercfg & DMA_CHANNEL_XFERCFG_XFERCOUNT_MASK) >> DMA_CHANNEL_XFERCFG_XFERCOUNT_SHIFT;
+    uint32_t campo = (c->xfercfg & DMA_CHANNEL_XFERCFG_WIDTH_MASK) >> DMA_CHANNEL_XFERCFG_WIDTH_SHIFT;
+    uint32_t ancho = 1UL << campo;
+    uint32_t inc_origen =
+        dma_incremento((c->xfercfg & DMA_CHANNEL_XFERCFG_SRCINC_MASK) >> DMA_CHANNEL_XFERCFG_SRCINC_SHIFT);
+    uint32_t inc_destino =
+        dma_incremento((c->xfercfg & DMA_CHANNEL_XFERCFG_DSTINC_MASK) >> DMA_CHANNEL_XFERCFG_DSTINC_SHIFT);
+
+    /* Los descriptores guardan la ultima direccion: faltan resto + 1. */
+    bus_escribir(c->fin_destino - (uintptr_t)resto * inc_destino * ancho, ancho,
+                 bus_leer(c->fin_origen - (uintptr_t)resto * inc_origen * ancho, ancho));
+
+    if (resto > 0U) {
+        c->xfercfg = (c->xfercfg & ~DMA_CHANNEL_XFERCFG_XFERCOUNT_MASK) |
+                     ((resto - 1U) << DMA_CHANNEL_XFERCFG_XFERCOUNT_SHIFT);
+    } else {
+        dma_terminar(i);
+    }
+}
+
+/* Mueve todo lo que los canales habilitados pueden mover ahora: de memoria a
+ * memoria hasta el final, contra un periferico mientras haya pedido. */
+static uint32_t dma_servir(void) {
+    uint32_t i, n = 0;
+    canal_t *c;
+
+    if ((dma.ctrl & DMA_CTRL_ENABLE_MASK) == 0U) return 0;
+    for (i = 0; i < CANALES; i++) {
+        c = &dma.canal[i];
+        while ((dma.habilitados & (1UL << i)) != 0U && c->valido && c->disparado) {
+            if ((c->cfg & DMA_CHANNEL_CFG_PERIPHREQEN_MASK) != 0U && !dma_pedido(i)) break;
+            dma_transferir(i);
+            if (++n > VUELTAS_MAX) break;
+        }
+    }
+    return n;
+}
+
+/*----------------------------------------------------------------------------
+ * Interrupciones y tiempo
+ *--------------------------------------------------------------------------*/
+
+typedef struct {
+    IRQn_Type irq;
+    void (*manejador)(void);
+} linea_t;
+
+static int linea_activa(IRQn_Type irq) {
+    switch (irq) {
+        case DMA0_IRQn:
+            return ((dma.inta | dma.intb | dma.errint) & dma.intenset) != 0U;
+        case USART0_IRQn:
+            return (usart_stat() & usart.intenset) != 0U;
+        case SPI0_IRQn:
+            return (spi_stat() & spi.intenset) != 0U;
+        case I2C0_IRQn:
+            return (i2c_stat() & i2c.intenset) != 0U;
+        default:
+            return 0;
+    }
+}
+
+/* Atiende una vez cada linea pedida y habilitada, de la mas prioritaria a la
+ * menos (numero de prioridad menor primero; a igual prioridad, IRQ menor). */
+static uint32_t despachar_irqs(void) {
+    const linea_t lineas[] = {
+        {DMA0_IRQn, DMA0_DriverIRQHandler},
+        {USART0_IRQn, USART0_DriverIRQHandler},
+        {SPI0_IRQn, SPI0_DriverIRQHandler},
+        {I2C0_IRQn, I2C0_DriverIRQHandler},
+    };
+    uint32_t atendidas = 0, prioridad, i;
+    IRQn_Type irq;
+
+    if (primask != 0U) return 0;
+    for (prioridad = 0; prioridad < (1U << __NVIC_PRIO_BITS); prioridad++) {
+        for (i = 0; i < sizeof(lineas) / sizeof(lineas[0]); i++) {
+            irq = lineas[i].irq;
+            if (nvic_prioridad[irq] != prioridad || (nvic_habilitadas & (1UL << irq)) == 0U) continue;
+            if (!linea_activa(irq) && (nvic_pendientes & (1UL << irq)) == 0U) continue;
+            if (lineas[i].manejador == NULL) {
+                fprintf(stderr, "modelo_lpc845: IRQ %d habilitada sin manejador enlazado\n", (int)irq);
+                exit(2);
+            }
+            nvic_pendientes &= ~(1UL << irq);
+            irqs_atendidas[irq]++;
+            lineas[i].manejador();
+            atendidas++;
+        }
+    }
+    return atendidas;
+}
+
+/* Todo lo que pasa en el mismo instante: un dato que llega habilita un pedido
+ * de DMA, el fin del descriptor una interrupcion, y el manejador puede
+ * arrancar otra transferencia. */
+static void resolver_instante(void) {
+    uint32_t vueltas = 0;
+
+    while (usart_actualizar() + spi_actualizar() + i2c_actualizar() + dma_servir() + despachar_irqs() != 0U) {
+        if (++vueltas > VUELTAS_MAX) {
+            fprintf(stderr, "modelo_lpc845: una interrupcion que nunca se limpia\n");
+            exit(2);
+        }
+    }
+}
+
+void modelo_avanzar(uint64_t ciclos) {
+    const uint64_t fin = ahora + ciclos;
+    uint64_t proximo;
+
+    for (;;) {
+        resolver_instante();
+        proximo = usart_proximo_evento();
+        if (spi_proximo_evento() < proximo) proximo = spi_proximo_evento();
+        if (i2c_proximo_evento() < proximo) proximo = i2c_proximo_evento();
+        if (proximo > fin) break;
+        ahora = proximo;
+    }
+    ahora = fin;
+}
+
+void modelo_avanzar_us(uint32_t us) {
+    modelo_avanzar((uint64_t)us * reloj / 1000000U);
+}
+
+uint64_t modelo_ciclos(void) {
+    return ahora;
+}
+
+uint32_t modelo_irqs(uint32_t irq) {
+    return irq < 32U ? irqs_atendidas[irq] : 0U;
+}
+
+void modelo_iniciar(uint32_t reloj_hz) {
+    static int instalado;
+    struct sigaction sa;
+    uint32_t i;
+
+    if (!instalado) {
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_flags = SA_SIGINFO;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_sigaction = al_fallar;
+        sigaction(SIGSEGV, &sa, NULL);
+        sa.sa_sigaction = al_pasar;
+        sigaction(SIGTRAP, &sa, NULL);
+        instalado = 1;
+    }
+
+    mapear(0x40000000U, 0x80000U); /* APB */
+    mapear(0x50000000U, 0x10000U); /* AHB: CRC, SCT, DMA, MTB */
+    for (i = 0; i < REGIONES; i++) mprotect((void *)(uintptr_t)regiones[i].base, PAGINA, PROT_NONE);
+
+    memset(&usart, 0, sizeof(usart));
+    memset(&spi, 0, sizeof(spi));
+    memset(&i2c, 0, sizeof(i2c));
+    memset(&dma, 0, sizeof(dma));
+    memset(nvic_prioridad, 0, sizeof(nvic_prioridad));
+    memset(irqs_atendidas, 0, sizeof(irqs_atendidas));
+    memset(&acceso, 0, sizeof(acceso));
+    nvic_habilitadas = nvic_pendientes = primask = 0;
+    usart.osr = 0xFU;
+    ahora = 0;
+    reloj = reloj_hz;
+    SystemCoreClock = reloj_hz;
+}
@@ -0,0 +1,85 @@
+#ifndef MODELO_LPC845_H
+#define MODELO_LPC845_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Modelo de registros del LPC845 para correr los drivers del SDK en el host.
+ *
+ * Los perifericos estan en sus direcciones reales. Los que tienen registros
+ * con efectos (escribir 1 para limpiar, leer para sacar un dato) tienen la
+ * pagina protegida: cada acceso del driver cae en un SIGSEGV, el modelo
+ * prepara el valor que se lee, la instruccion corre paso a paso y despues se
+ * aplica la escritura. El resto de los perifericos (SYSCON, ...) es memoria
+ * comun.
+ *
+ * Modelados: el DMA (descriptores, recarga encadenada, INTA/INTB, pedidos de
+ * los perifericos), la USART0 (tiempos de caracter segun BRG/OSR/CFG), la
+ * SPI0 como maestro (tiempos de trama segun DIV y LEN, chip select) y la I2C0
+ * como maestro (tiempos de bit segun CLKDIV y MSTTIME, esclavos simulados).
+ * El tiempo solo avanza con modelo_avanzar(), que es tambien donde se
+ * atienden las interrupciones habilitadas en el NVIC con PRIMASK en cero.
+ *
+ * Los ejecutables que lo usan se enlazan sin PIE: el SDK guarda direcciones
+ * en registros de 32 bits, asi que los buffers que ve el DMA tienen que ser
+ * estaticos (nunca en la pila). Solo x86_64 Linux. */
+
+/* Deja el modelo en el estado de reset. reloj_hz es el reloj de los
+ * perifericos, el mismo que se le pasa a USART_Init(). */
+void modelo_iniciar(uint32_t reloj_hz);
+
+/* Avanza el tiempo, atendiendo los eventos de los perifericos, las
+ * transferencias de DMA y las interrupciones en el orden en que ocurren. */
+void modelo_avanzar(uint64_t ciclos);
+void modelo_avanzar_us(uint32_t us);
+uint64_t modelo_ciclos(void);
+
+/* Veces que se atendio la interrupcion irq. */
+uint32_t modelo_irqs(uint32_t irq);
+
+/* Bytes que llegan a la USART0 por RX, uno detras de otro a partir de ahora
+ * (o de que termine lo encolado antes). */
+void modelo_usart_recibir(const uint8_t *datos, size_t n);
+/* Bytes que salieron por TX desde la ultima llamada. */
+size_t modelo_usart_enviados(uint8_t *datos, size_t max);
+/* Bytes recibidos que se perdieron porque nadie leyo RXDAT a tiempo. */
+uint32_t modelo_usart_desbordes(void);
+/* Duracion de un caracter con la configuracion actual. */
+uint64_t modelo_usart_ciclos_caracter(void);
+
+/* Esclavo conectado a la SPI0: recibe cada trama que manda el maestro y
+ * devuelve la que contesta en esa misma trama. inicio es 1 en la primera
+ * trama despues de activarse el chip select. */
+typedef uint16_t (*modelo_spi_esclavo_t)(uint16_t mosi, int inicio);
+void modelo_spi_conectar(modelo_spi_esclavo_t esclavo);
+/* Veces que se libero el chip select, y si esta activo ahora. */
+uint32_t modelo_spi_fines(void);
+int modelo_spi_seleccionado(void);
+/* Duracion de una trama con la configuracion actual (sin las demoras de
+ * DLY, que no se modelan). */
+uint64_t modelo_spi_ciclos_trama(void);
+
+/* Esclavos en el bus de la I2C0. El esclavo direccionado ve cada evento del
+ * bus cuando termina:
+ * - MODELO_I2C_INICIO: START (o START repetido) con su direccion; *dato es 1
+ *   si el maestro va a leer.
+ * - MODELO_I2C_ESCRITURA: byte del maestro en *dato.
+ * - MODELO_I2C_LECTURA: el esclavo deja en *dato el byte para el maestro.
+ * - MODELO_I2C_PARADA: STOP.
+ * Devuelve 1 para ACK y 0 para NACK; en LECTURA y PARADA no cuenta. Una
+ * direccion sin esclavo conectado no contesta. */
+typedef enum {
+    MODELO_I2C_INICIO,
+    MODELO_I2C_ESCRITURA,
+    MODELO_I2C_LECTURA,
+    MODELO_I2C_PARADA,
+} modelo_i2c_evento_t;
+typedef int (*modelo_i2c_esclavo_t)(modelo_i2c_evento_t evento, uint8_t *dato);
+/* Conecta un esclavo a la direccion de 7 bits (reemplaza al que estaba). */
+void modelo_i2c_conectar(uint8_t direccion, modelo_i2c_esclavo_t esclavo);
+/* Duracion de un bit de SCL con la configuracion actual. */
+uint64_t modelo_i2c_ciclos_bit(void);
+/* Tiempo con el bus ocupado (de cada START al STOP) desde modelo_iniciar(). */
+uint64_t modelo_i2c_ciclos_ocupado(void);
+
+#endif /* MODELO_LPC845_H */
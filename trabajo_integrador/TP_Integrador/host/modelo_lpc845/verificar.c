@@ -0,0 +1,23 @@
+#include <stdio.h>
+#include "modelo_lpc845.h"
+#include "verificar.h"
+
+aviso_driver_t aviso_driver;
+
+static int ok = 1;
+
+void verificar(int condicion, const char *que) {
+    printf("  %-62s %s\n", que, condicion ? "ok" : "MAL");
+    if (!condicion) ok = 0;
+}
+
+int verificar_terminar(void) {
+    printf("%s\n", ok ? "todo ok" : "HAY ERRORES");
+    return ok ? 0 : 1;
+}
+
+void verificar_aviso(status_t estado) {
+    aviso_driver.estado = estado;
+    aviso_driver.ciclo = modelo_ciclos();
+    aviso_driver.cuenta++;
+}
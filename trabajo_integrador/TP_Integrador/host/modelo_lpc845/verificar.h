@@ -0,0 +1,40 @@
+#ifndef VERIFICAR_H
+#define VERIFICAR_H
+
+#include <stdint.h>
+#include "fsl_common.h"
+
+/* Lo comun de los programas que prueban drivers contra el modelo
+ * (sim_usart_dma.c, sim_spi_dma.c, sim_bus_i2c.c, sim_bh1750.c): cada
+ * chequeo es una linea del reporte, y el programa termina con error si alguno
+ * fallo. */
+
+/* Imprime que con "ok" o "MAL". */
+void verificar(int condicion, const char *que);
+
+/* Cierra el reporte. Devuelve el codigo de salida: 0 si todos los chequeos
+ * dieron bien. */
+int verificar_terminar(void);
+
+/* Ultimo aviso de fin de transferencia de un driver del SDK. */
+typedef struct {
+    volatile status_t estado;
+    volatile uint32_t cuenta;  /* avisos hasta ahora */
+    uint64_t ciclo;            /* del modelo, al llegar el ultimo */
+} aviso_driver_t;
+
+extern aviso_driver_t aviso_driver;
+
+void verificar_aviso(status_t estado);
+
+/* Define un callback de fin de transferencia con la firma de los drivers del
+ * SDK (base, handle, estado, datos) que anota el aviso. */
+#define VERIFICAR_CALLBACK(nombre, tipo_base, tipo_handle)                                  \
+    static void nombre(tipo_base *base, tipo_handle *handle, status_t estado, void *datos) { \
+        (void)base;                                                                          \
+        (void)handle;                                                                        \
+        (void)datos;                                                                         \
+        verificar_aviso(estado);                                                             \
+    }
+
+#endif /* VERIFICAR_H */
@@ -0,0 +1,359 @@
+#include <stdio.h>
+#include <string.h>
+#include "bh1750.h"
+#include "bus_i2c.h"
+#include "fsl_i2c.h"
+#include "modelo_lpc845.h"
+#include "verificar.h"
+
+/* bh1750.c sobre bus_i2c.c y fsl_i2c.c, contra el modelo de registros de
+ * modelo_lpc845.c, a 400 kHz con un reloj de 30 MHz. El BH1750 simulado
+ * sigue la hoja de datos: codigos de operacion, MTreg en dos comandos que
+ * vale desde la proxima medicion, conversiones de 120 ms (H, H2) o 16 ms (L)
+ * escaladas por MTreg/69, apagado al terminar una medicion unica y el
+ * registro de datos con la medicion anterior mientras convierte.
+ *
+ * - Los comandos que salen con cada configuracion y cada medicion, y MTreg
+ *   fuera de rango.
+ * - Mediciones unicas en los tres modos y con MTreg minimo, tipico y maximo:
+ *   la lectura llega despues del fin de la conversion, el sensor queda
+ *   apagado, los lux en Q8 coinciden con cuenta / 1,2 * 69 / MTreg y el bus
+ *   solo esta ocupado los bits de los dos mensajes.
+ * - Otra transaccion en el bus mientras el sensor convierte.
+ * - Modo continuo leido cada bh1750_espera_us(), siguiendo a la luz.
+ * - Una lectura antes de tiempo trae la medicion anterior. */
+
+#define RELOJ_HZ 30000000U
+#define BAUDIOS 400000U
+#define CICLOS_US (RELOJ_HZ / 1000000U)
+
+#define DIR_OTRO 0x50U
+
+static bus_i2c_t bus;
+static bh1750_t sensor;
+
+/*----------------------------------------------------------------------------
+ * BH1750 simulado
+ *--------------------------------------------------------------------------*/
+
+#define COMANDOS_MAX 16U
+
+static struct {
+    double luz;                       /* lux que ve el sensor */
+    int encendido;
+    uint8_t modo;                     /* 0 sin medir */
+    uint8_t mtreg;
+    uint8_t mtreg_medicion;           /* MTreg del ultimo comando de medicion */
+    uint64_t fin;                     /* ciclo en que termina la conversion en curso */
+    uint16_t registro;
+    uint32_t conversiones;
+    uint8_t comandos[COMANDOS_MAX];
+    uint32_t n_comandos;
+    uint32_t lecturas;
+    uint32_t lecturas_tempranas;      /* durante una medicion unica */
+    uint32_t leidos;
+} bh;
+
+static int bh_es_h2(uint8_t modo) {
+    return (modo & 0x0FU) == 0x01U;
+}
+
+static uint64_t bh_conversion(uint8_t modo, uint8_t mtreg) {
+    const uint64_t tipico_us = (modo & 0x0FU) == 0x03U ? 16000U : 120000U;
+
+    return tipico_us * CICLOS_US * mtreg / BH1750_MTREG_TIPICO;
+}
+
+/* La cuenta es lux * 1,2 * MTreg / 69, el doble en H2 */
+static uint16_t bh_cuenta(uint8_t modo, uint8_t mtreg, double luz) {
+    double cuenta = luz * 1.2 * mtreg / BH1750_MTREG_TIPICO;
+
+    if (bh_es_h2(modo)) cuenta *= 2.0;
+    return cuenta >= 65535.0 ? 65535U : (uint16_t)cuenta;
+}
+
+static void bh_actualizar(void) {
+    const uint64_t ahora = modelo_ciclos();
+
+    while (bh.modo != 0U && ahora >= bh.fin) {
+        bh.registro = bh_cuenta(bh.modo, bh.mtreg_medicion, bh.luz);
+        bh.conversiones++;
+        if ((bh.modo & 0xF0U) == 0x10U) {
+            bh.fin += bh_conversion(bh.modo, bh.mtreg_medicion);
+        } else {
+            bh.modo = 0;
+            bh.encendido = 0;
+        }
+    }
+}
+
+static void bh_comando(uint8_t codigo) {
+    if (bh.n_comandos < COMANDOS_MAX) bh.comandos[bh.n_comandos] = codigo;
+    bh.n_comandos++;
+
+    switch (codigo) {
+        case 0x00U:
+            bh.encendido = 0;
+            bh.modo = 0;
+            return;
+        case 0x01U:
+            bh.encendido = 1;
+            return;
+        case 0x07U:
+            if (bh.encendido) bh.registro = 0;
+            return;
+        case 0x10U:
+        case 0x11U:
+        case 0x13U:
+        case 0x20U:
+        case 0x21U:
+        case 0x23U:
+            bh.encendido = 1;
+            bh.modo = codigo;
+            bh.mtreg_medicion = bh.mtreg;
+            bh.fin = modelo_ciclos() + bh_conversion(codigo, bh.mtreg);
+            return;
+        default:
+            break;
+    }
+    if ((codigo & 0xF8U) == 0x40U) bh.mtreg = (uint8_t)((bh.mtreg & 0x1FU) | ((codigo & 0x07U) << 5));
+    if ((codigo & 0xE0U) == 0x60U) bh.mtreg = (uint8_t)((bh.mtreg & 0xE0U) | (codigo & 0x1FU));
+}
+
+static int bh1750_simulado(modelo_i2c_evento_t evento, uint8_t *dato) {
+    switch (evento) {
+        case MODELO_I2C_INICIO:
+            bh_actualizar();
+            if (*dato) {
+                bh.leidos = 0;
+                bh.lecturas++;
+                if (bh.modo >= 0x20U) bh.lecturas_tempranas++;
+            }
+            return 1;
+        case MODELO_I2C_ESCRITURA:
+            bh_actualizar();
+            bh_comando(*dato);
+            return 1;
+        case MODELO_I2C_LECTURA:
+            *dato = (uint8_t)(bh.leidos++ == 0U ? bh.registro >> 8 : bh.registro);
+            return 1;
+        default:
+            return 1;
+    }
+}
+
+/* Otro esclavo del bus, para ver que la conversion no lo tiene esperando */
+static int otro_simulado(modelo_i2c_evento_t evento, uint8_t *dato) {
+    if (evento == MODELO_I2C_LECTURA) *dato = 0x5AU;
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * Pruebas
+ *--------------------------------------------------------------------------*/
+
+static volatile uint32_t avisos;
+static volatile status_t ultimo_estado;
+static uint64_t ciclo_aviso;
+
+static void al_leer(bh1750_t *s, status_t estado, void *usuario) {
+    (void)s;
+    (void)usuario;
+    ultimo_estado = estado;
+    ciclo_aviso = modelo_ciclos();
+    avisos++;
+}
+
+static void iniciar(void) {
+    i2c_master_config_t config;
+
+    modelo_iniciar(RELOJ_HZ);
+    modelo_i2c_conectar(BH1750_DIRECCION, bh1750_simulado);
+    modelo_i2c_conectar(DIR_OTRO, otro_simulado);
+    memset(&bh, 0, sizeof(bh));
+    bh.mtreg = BH1750_MTREG_TIPICO;
+
+    I2C_MasterGetDefaultConfig(&config);
+    config.baudRate_Bps = BAUDIOS;
+    I2C_MasterInit(I2C0, &config, RELOJ_HZ);
+    bus_i2c_iniciar(&bus, I2C0);
+    bh1750_iniciar(&sensor, &bus, BH1750_DIRECCION, al_leer, NULL);
+    avisos = 0;
+}
+
+/* Hasta que la cola quede vacia */
+static void esperar_bus(void) {
+    uint32_t t;
+
+    for (t = 0; t < 10000U && (bus.ocupado || bus.primera != NULL); t += 10U) modelo_avanzar_us(10);
+}
+
+/* Lo que haria la tarea: leer y esperar el aviso */
+static int leer(void) {
+    const uint32_t antes = avisos;
+
+    if (bh1750_leer(&sensor) != kStatus_Success) return 0;
+    esperar_bus();
+    return avisos == antes + 1U && ultimo_estado == kStatus_Success;
+}
+
+static void probar_comandos(void) {
+    int esperados;
+
+    printf("Comandos\n");
+    iniciar();
+    verificar(bh.n_comandos == 0U, "iniciar no sale al bus");
+    verificar(bh1750_configurar(&sensor, BH1750_CONTINUO_H2, 30) == kStatus_InvalidArgument &&
+                  bh1750_configurar(&sensor, BH1750_CONTINUO_H2, 255) == kStatus_InvalidArgument,
+              "MTreg fuera de 31..254 no se acepta");
+
+    /* 138 = 100_01010: 0x40 | 4 y 0x60 | 10 */
+    verificar(bh1750_configurar(&sensor, BH1750_CONTINUO_H2, 138) == kStatus_Success,
+              "configurar continuo H2, MTreg 138");
+    verificar(bh1750_configurar(&sensor, BH1750_CONTINUO_H, 69) == kStatus_I2C_Busy,
+              "otra configuracion con los comandos en la cola no");
+    esperar_bus();
+    esperados = bh.n_comandos == 3U && bh.comandos[0] == 0x44U && bh.comandos[1] == 0x6AU && bh.comandos[2] == 0x11U;
+    verificar(esperados && bh.mtreg == 138U && bh.modo == 0x11U, "MTreg alto, MTreg bajo y el modo");
+    verificar(bh1750_espera_us(&sensor) == 360000U, "espera de 180 ms * 138 / 69");
+
+    bh.n_comandos = 0;
+    bh1750_configurar(&sensor, BH1750_UNICO_L, 31);
+    esperar_bus();
+    verificar(bh.n_comandos == 2U && bh.comandos[0] == 0x40U && bh.comandos[1] == 0x7FU,
+              "en unico solo MTreg, sin medir");
+    bh1750_medir(&sensor);
+    esperar_bus();
+    verificar(bh.n_comandos == 3U && bh.comandos[2] == 0x23U && bh.mtreg_medicion == 31U, "medir manda el modo");
+    verificar(bh1750_espera_us(&sensor) == 10783U, "espera de 24 ms * 31 / 69, redondeada para arriba");
+    verificar(sensor.errores == 0U, "sin errores");
+}
+
+static void probar_unico(void) {
+    static const struct {
+        bh1750_modo_t modo;
+        uint8_t mtreg;
+        double luz;
+        const char *que;
+    } casos[] = {
+        {BH1750_UNICO_H, 69, 833.0, "H, MTreg 69, 833 lx"},
+        {BH1750_UNICO_H2, 254, 10.3, "H2, MTreg 254, 10,3 lx"},
+        {BH1750_UNICO_L, 69, 1234.0, "L, MTreg 69, 1234 lx"},
+        {BH1750_UNICO_H, 31, 100000.0, "H, MTreg 31, 100000 lx (cuenta y factor maximos)"},
+        {BH1750_UNICO_H2, 31, 0.0, "H2, MTreg 31, oscuridad"},
+    };
+    /* MTreg (2 escrituras de un byte), medicion (una) y lectura de dos bytes */
+    const uint64_t bits = 3U * (11U + 9U) + 18U + 9U + 2U;
+    uint32_t i;
+
+    printf("Mediciones unicas\n");
+    for (i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        const double resolucion = 57.5 / casos[i].mtreg / (bh_es_h2((uint8_t)casos[i].modo) ? 2.0 : 1.0);
+        double lux, exacto;
+        uint64_t inicio, fin_conversion;
+
+        iniciar();
+        bh.luz = casos[i].luz;
+        inicio = modelo_ciclos();
+        bh1750_configurar(&sensor, casos[i].modo, casos[i].mtreg);
+        bh1750_medir(&sensor);
+        esperar_bus();
+        fin_conversion = bh.fin;
+
+        /* La tarea duerme la conversion; el bus queda libre */
+        modelo_avanzar_us(bh1750_espera_us(&sensor));
+        leer();
+
+        lux = bh1750_lux_q8(&sensor) / 256.0;
+        exacto = sensor.cuenta / 1.2 * BH1750_MTREG_TIPICO / casos[i].mtreg /
+                 (bh_es_h2((uint8_t)casos[i].modo) ? 2.0 : 1.0);
+        printf("  %s: cuenta %u, %.3f lx, espera %lu us, bus %lu us\n", casos[i].que, sensor.cuenta, lux,
+               (unsigned long)bh1750_espera_us(&sensor), (unsigned long)(modelo_i2c_ciclos_ocupado() / CICLOS_US));
+        verificar(avisos == 1U && ultimo_estado == kStatus_Success && bh.lecturas_tempranas == 0U &&
+                      ciclo_aviso > fin_conversion && bh.conversiones == 1U && !bh.encendido,
+                  "  leida despues de la conversion, sensor apagado");
+        verificar(lux <= exacto + 0.002 && lux >= exacto * 0.999 - 0.004, "  Q8 igual a cuenta / 1,2 * 69 / MTreg");
+        verificar(lux <= casos[i].luz + 0.001 * casos[i].luz && lux >= casos[i].luz - resolucion - 0.001 * casos[i].luz,
+                  "  dentro de la resolucion de la luz real");
+        verificar(bh1750_lux(&sensor) == (uint32_t)(lux + 0.5), "  lux enteros redondeados");
+        verificar(modelo_i2c_ciclos_ocupado() == bits * modelo_i2c_ciclos_bit() &&
+                      ciclo_aviso - inicio > (uint64_t)bh1750_espera_us(&sensor) * CICLOS_US,
+                  "  bus ocupado solo los bits de los mensajes");
+    }
+}
+
+static void probar_bus_libre(void) {
+    static bus_i2c_transaccion_t otra;
+    static uint8_t dato;
+    uint32_t t;
+
+    printf("Bus libre durante la conversion\n");
+    iniciar();
+    bh.luz = 300.0;
+    bh1750_medir(&sensor);
+    esperar_bus();
+
+    memset(&otra, 0, sizeof(otra));
+    otra.xfer.slaveAddress = DIR_OTRO;
+    otra.xfer.direction = kI2C_Read;
+    otra.xfer.data = &dato;
+    otra.xfer.dataSize = 1U;
+    bus_i2c_encolar(&bus, &otra);
+    for (t = 0; t < 1000U && otra.estado == kStatus_I2C_Busy; t += 10U) modelo_avanzar_us(10);
+    verificar(otra.estado == kStatus_Success && dato == 0x5AU && bh.modo == 0x20U,
+              "otro esclavo leido antes de 1 ms, con el sensor convirtiendo");
+
+    modelo_avanzar_us(bh1750_espera_us(&sensor));
+    verificar(leer() && bh1750_lux(&sensor) == 300U, "y la medicion sigue bien");
+}
+
+static void probar_continuo(void) {
+    static const double luces[] = {50.0, 400.0, 2500.0, 12000.0, 7.0};
+    uint32_t i, siguen = 1;
+
+    printf("Continuo\n");
+    iniciar();
+    bh1750_configurar(&sensor, BH1750_CONTINUO_L, BH1750_MTREG_TIPICO);
+    esperar_bus();
+    for (i = 0; i < sizeof(luces) / sizeof(luces[0]); i++) {
+        bh.luz = luces[i];
+        modelo_avanzar_us(bh1750_espera_us(&sensor));
+        siguen &= leer();
+        /* L: la cuenta sale en pasos de 1 lx, la resolucion es de 4 lx */
+        siguen &= bh1750_lux(&sensor) + 1U >= (uint32_t)luces[i] && bh1750_lux(&sensor) <= (uint32_t)luces[i] + 1U;
+        printf("  %.0f lx -> %lu lx\n", luces[i], (unsigned long)bh1750_lux(&sensor));
+    }
+    verificar(siguen, "cada lectura trae la luz del ultimo periodo");
+    verificar(bh.n_comandos == 3U && bh.encendido && bh.conversiones >= 5U, "sin comandos de medicion, sigue midiendo");
+}
+
+static void probar_lectura_temprana(void) {
+    printf("Lectura antes de tiempo\n");
+    iniciar();
+    bh.luz = 100.0;
+    bh1750_medir(&sensor);
+    esperar_bus();
+    modelo_avanzar_us(bh1750_espera_us(&sensor));
+    leer();
+    verificar(bh1750_lux(&sensor) == 100U, "primera medicion");
+
+    bh.luz = 500.0;
+    bh1750_medir(&sensor);
+    esperar_bus();
+    modelo_avanzar_us(bh1750_espera_us(&sensor) / 10U);
+    leer();
+    verificar(bh.lecturas_tempranas == 1U && bh1750_lux(&sensor) == 100U, "a un decimo de la espera: la anterior");
+    modelo_avanzar_us(bh1750_espera_us(&sensor));
+    leer();
+    verificar(bh1750_lux(&sensor) == 500U, "despues de la espera: la nueva");
+}
+
+int main(void) {
+    printf("BH1750 por I2C a %u kHz, reloj de %u MHz\n", BAUDIOS / 1000U, RELOJ_HZ / 1000000U);
+    probar_comandos();
+    probar_unico();
+    probar_bus_libre();
+    probar_continuo();
+    probar_lectura_temprana();
+    return verificar_terminar();
+}
@@ -0,0 +1,323 @@
+#include <stdio.h>
+#include <string.h>
+#include "bus_i2c.h"
+#include "fsl_i2c.h"
+#include "fsl_pca954x.h"
+#include "modelo_lpc845.h"
+#include "verificar.h"
+
+/* bus_i2c.c sobre fsl_i2c.c y fsl_pca954x.c, contra el modelo de registros
+ * de modelo_lpc845.c, a 400 kHz con un reloj de 30 MHz. En el bus hay un
+ * BH1750, una EEPROM 24C32 y un PCA9548 con dos sensores de temperatura con
+ * la misma direccion en los canales 0 y 1.
+ *
+ * - Transacciones de varios "clientes" encoladas juntas: salen en orden, una
+ *   detras de otra sin tiempo muerto en el bus (el bus ocupado es todo el
+ *   tiempo transcurrido y coincide con la cuenta de bits), con un aviso por
+ *   transaccion y el multiplexor escrito solo cuando cambia el canal.
+ * - Un esclavo que no contesta falla solo su transaccion, tambien detras del
+ *   multiplexor, y la cola sigue.
+ * - Un aviso que vuelve a encolar su transaccion (sondeo encadenado) y una
+ *   transaccion encolada dos veces.
+ *
+ * Los esclavos son funciones que el modelo llama byte a byte. */
+
+#define RELOJ_HZ 30000000U
+#define BAUDIOS 400000U
+
+#define DIR_BH1750 0x23U
+#define DIR_EEPROM 0x50U
+#define DIR_MUX 0x70U
+#define DIR_TEMP 0x48U
+
+static bus_i2c_t bus;
+static pca954x_handle_t mux;
+
+/*----------------------------------------------------------------------------
+ * Esclavos
+ *--------------------------------------------------------------------------*/
+
+/* BH1750: contesta dos bytes con la ultima medicion */
+static uint16_t bh1750_cuenta = 0x1234U;
+static uint32_t bh1750_lecturas;
+
+static int bh1750(modelo_i2c_evento_t evento, uint8_t *dato) {
+    static uint32_t leidos;
+
+    switch (evento) {
+        case MODELO_I2C_INICIO:
+            leidos = 0;
+            if (*dato) bh1750_lecturas++;
+            return 1;
+        case MODELO_I2C_LECTURA:
+            *dato = (uint8_t)(leidos++ == 0U ? bh1750_cuenta >> 8 : bh1750_cuenta);
+            return 1;
+        default:
+            return 1;
+    }
+}
+
+/* 24C32: dos bytes de direccion, escritura y lectura secuenciales */
+static uint8_t eeprom_memoria[4096];
+static uint16_t eeprom_direccion;
+static uint32_t eeprom_recibidos;
+
+static int eeprom(modelo_i2c_evento_t evento, uint8_t *dato) {
+    switch (evento) {
+        case MODELO_I2C_INICIO:
+            eeprom_recibidos = 0;
+            return 1;
+        case MODELO_I2C_ESCRITURA:
+            if (eeprom_recibidos < 2U) {
+                eeprom_direccion = (uint16_t)((eeprom_direccion << 8) | *dato);
+            } else {
+                eeprom_memoria[eeprom_direccion++ % sizeof(eeprom_memoria)] = *dato;
+            }
+            eeprom_recibidos++;
+            return 1;
+        case MODELO_I2C_LECTURA:
+            *dato = eeprom_memoria[eeprom_direccion++ % sizeof(eeprom_memoria)];
+            return 1;
+        default:
+            return 1;
+    }
+}
+
+/* PCA9548: un registro de control, un bit por canal */
+static uint8_t mux_control;
+static uint32_t mux_escrituras;
+
+static int pca9548(modelo_i2c_evento_t evento, uint8_t *dato) {
+    switch (evento) {
+        case MODELO_I2C_ESCRITURA:
+            mux_control = *dato;
+            mux_escrituras++;
+            return 1;
+        case MODELO_I2C_LECTURA:
+            *dato = mux_control;
+            return 1;
+        default:
+            return 1;
+    }
+}
+
+/* Sensores en 0x48 detras del multiplexor: solo contesta el del canal
+ * seleccionado (canales 0 y 1; el 2 esta vacio). */
+static const uint16_t temp_valor[2] = {0x1900U, 0x0C80U};
+
+static int temperatura(modelo_i2c_evento_t evento, uint8_t *dato) {
+    static int canal;
+    static uint32_t leidos;
+
+    switch (evento) {
+        case MODELO_I2C_INICIO:
+            if (mux_control == 0x01U) {
+                canal = 0;
+            } else if (mux_control == 0x02U) {
+                canal = 1;
+            } else {
+                return 0;
+            }
+            if (*dato) leidos = 0;
+            return 1;
+        case MODELO_I2C_LECTURA:
+            *dato = (uint8_t)(leidos++ == 0U ? temp_valor[canal] >> 8 : temp_valor[canal]);
+            return 1;
+        default:
+            return 1;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Transacciones
+ *--------------------------------------------------------------------------*/
+
+#define AVISOS_MAX 32U
+static bus_i2c_transaccion_t *avisadas[AVISOS_MAX];
+static status_t estados[AVISOS_MAX];
+static uint32_t avisos;
+static uint64_t ciclo_ultimo_aviso;
+
+static void al_terminar(bus_i2c_transaccion_t *t, status_t estado, void *usuario) {
+    (void)usuario;
+    if (avisos < AVISOS_MAX) {
+        avisadas[avisos] = t;
+        estados[avisos] = estado;
+    }
+    avisos++;
+    ciclo_ultimo_aviso = modelo_ciclos();
+}
+
+static void preparar(bus_i2c_transaccion_t *t, uint8_t direccion, i2c_direction_t sentido, uint32_t subdireccion,
+                     size_t largo_sub, void *datos, size_t largo) {
+    memset(t, 0, sizeof(*t));
+    t->xfer.slaveAddress = direccion;
+    t->xfer.direction = sentido;
+    t->xfer.subaddress = subdireccion;
+    t->xfer.subaddressSize = largo_sub;
+    t->xfer.data = datos;
+    t->xfer.dataSize = largo;
+    t->aviso = al_terminar;
+}
+
+/* Bits de SCL de una transaccion: START y direccion (con el primer byte si se
+ * lee), 9 por byte, START repetido si lee despues de la subdireccion, y el
+ * NACK y el STOP. */
+static uint32_t bits(const bus_i2c_transaccion_t *t) {
+    const uint32_t sub = (uint32_t)t->xfer.subaddressSize, n = (uint32_t)t->xfer.dataSize;
+
+    if (t->xfer.direction == kI2C_Write) return 11U + 9U * (sub + n);
+    return (sub != 0U ? 10U + 9U * sub : 0U) + 18U + 9U * (n - 1U) + 2U;
+}
+
+static void esperar(uint32_t cuantos, uint32_t limite_us) {
+    uint32_t t;
+
+    for (t = 0; t < limite_us && avisos < cuantos; t += 10U) modelo_avanzar_us(10);
+}
+
+static void iniciar(void) {
+    i2c_master_config_t config;
+    pca954x_config_t config_mux;
+
+    modelo_iniciar(RELOJ_HZ);
+    modelo_i2c_conectar(DIR_BH1750, bh1750);
+    modelo_i2c_conectar(DIR_EEPROM, eeprom);
+    modelo_i2c_conectar(DIR_MUX, pca9548);
+    modelo_i2c_conectar(DIR_TEMP, temperatura);
+    mux_control = 0;
+    mux_escrituras = 0;
+
+    I2C_MasterGetDefaultConfig(&config);
+    config.baudRate_Bps = BAUDIOS;
+    I2C_MasterInit(I2C0, &config, RELOJ_HZ);
+    bus_i2c_iniciar(&bus, I2C0);
+
+    /* El multiplexor escribe por el bus, sin bloquear */
+    memset(&config_mux, 0, sizeof(config_mux));
+    config_mux.i2cAddr = DIR_MUX;
+    config_mux.id = PCA9548_ID;
+    config_mux.i2cBase = &bus;
+    config_mux.I2C_SendFunc = bus_i2c_pca954x_enviar;
+    memset(&mux, 0, sizeof(mux));
+    PCA954X_Init(&mux, &config_mux);
+
+    avisos = 0;
+}
+
+static void probar_cola(void) {
+    static bus_i2c_transaccion_t t[7];
+    static uint8_t luz[2], pagina[16], leida[16], temp[3][2];
+    uint64_t inicio, esperado = 0;
+    uint32_t i;
+    int orden = 1;
+
+    printf("Cola de transacciones\n");
+    iniciar();
+    for (i = 0; i < sizeof(pagina); i++) pagina[i] = (uint8_t)(0xC0U + i);
+
+    /* Cada "cliente" encola lo suyo sin esperar a los demas */
+    preparar(&t[0], DIR_BH1750, kI2C_Read, 0, 0, luz, sizeof(luz));
+    preparar(&t[1], DIR_EEPROM, kI2C_Write, 0x0100U, 2, pagina, sizeof(pagina));
+    preparar(&t[2], DIR_TEMP, kI2C_Read, 0x00U, 1, temp[0], 2);
+    t[2].mux = &mux;
+    t[2].canal = 0;
+    preparar(&t[3], DIR_TEMP, kI2C_Read, 0x00U, 1, temp[1], 2);
+    t[3].mux = &mux;
+    t[3].canal = 1;
+    preparar(&t[4], DIR_EEPROM, kI2C_Read, 0x0100U, 2, leida, sizeof(leida));
+    preparar(&t[5], DIR_TEMP, kI2C_Read, 0x00U, 1, temp[2], 2);
+    t[5].mux = &mux;
+    t[5].canal = 1;
+    preparar(&t[6], DIR_BH1750, kI2C_Read, 0, 0, luz, sizeof(luz));
+
+    inicio = modelo_ciclos();
+    for (i = 0; i < 7U; i++) bus_i2c_encolar(&bus, &t[i]);
+    verificar(bus_i2c_encolar(&bus, &t[3]) == kStatus_I2C_Busy, "una transaccion encolada no se vuelve a encolar");
+    esperar(7, 20000);
+
+    for (i = 0; i < 7U; i++) {
+        orden &= avisadas[i] == &t[i] && estados[i] == kStatus_Success && t[i].estado == kStatus_Success;
+        esperado += bits(&t[i]);
+    }
+    verificar(avisos == 7U && orden, "un aviso por transaccion, en orden");
+    verificar(memcmp(&eeprom_memoria[0x100], pagina, sizeof(pagina)) == 0 &&
+                  memcmp(leida, pagina, sizeof(pagina)) == 0,
+              "EEPROM escrita y leida");
+    verificar(luz[0] == 0x12U && luz[1] == 0x34U && bh1750_lecturas == 2U, "BH1750 leido dos veces");
+    verificar(temp[0][0] == 0x19U && temp[1][0] == 0x0CU && temp[2][0] == 0x0CU && temp[2][1] == 0x80U,
+              "cada sensor detras de su canal");
+    verificar(mux_escrituras == 2U && bus.selecciones == 2U, "el multiplexor solo se escribe al cambiar de canal");
+    esperado += 20U * mux_escrituras;
+
+    printf("  %lu us para 7 transacciones; bus ocupado %lu us, %lu bits de %lu ciclos\n",
+           (unsigned long)((ciclo_ultimo_aviso - inicio) / (RELOJ_HZ / 1000000U)),
+           (unsigned long)(modelo_i2c_ciclos_ocupado() / (RELOJ_HZ / 1000000U)), (unsigned long)esperado,
+           (unsigned long)modelo_i2c_ciclos_bit());
+    verificar(modelo_i2c_ciclos_ocupado() == ciclo_ultimo_aviso - inicio, "sin tiempo muerto entre transacciones");
+    verificar(modelo_i2c_ciclos_ocupado() == esperado * modelo_i2c_ciclos_bit(), "el tiempo de los bits y nada mas");
+}
+
+static void probar_errores(void) {
+    static bus_i2c_transaccion_t t[4];
+    static uint8_t datos[4][2];
+
+    printf("Errores\n");
+    iniciar();
+    preparar(&t[0], DIR_BH1750, kI2C_Read, 0, 0, datos[0], 2);
+    preparar(&t[1], 0x29U, kI2C_Read, 0, 0, datos[1], 2);
+    preparar(&t[2], DIR_TEMP, kI2C_Read, 0x00U, 1, datos[2], 2);
+    t[2].mux = &mux;
+    t[2].canal = 2;
+    preparar(&t[3], DIR_TEMP, kI2C_Read, 0x00U, 1, datos[3], 2);
+    t[3].mux = &mux;
+    t[3].canal = 0;
+    bus_i2c_encolar(&bus, &t[0]);
+    bus_i2c_encolar(&bus, &t[1]);
+    bus_i2c_encolar(&bus, &t[2]);
+    bus_i2c_encolar(&bus, &t[3]);
+    esperar(4, 20000);
+    verificar(avisos == 4U && estados[0] == kStatus_Success && estados[1] == kStatus_I2C_Nak,
+              "una direccion que no contesta falla sola");
+    verificar(estados[2] == kStatus_I2C_Nak && mux_control == 0x01U && estados[3] == kStatus_Success &&
+                  datos[3][0] == 0x19U,
+              "un canal vacio falla solo y la cola sigue");
+    verificar(bus.completadas == 2U && bus.errores == 2U, "cuentas del bus");
+}
+
+/* Sondeo encadenado: el aviso vuelve a encolar la misma transaccion */
+static bus_i2c_transaccion_t sondeo;
+static uint8_t sondeo_datos[2];
+static uint32_t sondeos;
+
+static void al_sondear(bus_i2c_transaccion_t *t, status_t estado, void *usuario) {
+    (void)usuario;
+    if (estado == kStatus_Success && ++sondeos < 10U) bus_i2c_encolar(&bus, t);
+    al_terminar(t, estado, NULL);
+}
+
+static void probar_reencolar(void) {
+    static bus_i2c_transaccion_t otra;
+    static uint8_t otra_datos[2];
+
+    printf("Reencolar desde el aviso\n");
+    iniciar();
+    preparar(&sondeo, DIR_BH1750, kI2C_Read, 0, 0, sondeo_datos, 2);
+    sondeo.aviso = al_sondear;
+    preparar(&otra, DIR_EEPROM, kI2C_Read, 0x0000U, 2, otra_datos, 2);
+    sondeos = 0;
+    bus_i2c_encolar(&bus, &sondeo);
+    bus_i2c_encolar(&bus, &otra);
+    esperar(11, 50000);
+    verificar(sondeos == 10U && avisos == 11U && bus.errores == 0U, "diez sondeos y la otra transaccion");
+    verificar(avisadas[1] == &otra, "la otra sale entre el primer sondeo y el segundo");
+    verificar(bus.primera == NULL && !bus.ocupado, "la cola queda vacia");
+}
+
+int main(void) {
+    printf("I2C a %u kHz, reloj de %u MHz\n", BAUDIOS / 1000U, RELOJ_HZ / 1000000U);
+    probar_cola();
+    probar_errores();
+    probar_reencolar();
+    return verificar_terminar();
+}
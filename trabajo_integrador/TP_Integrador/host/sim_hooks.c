@@ -0,0 +1,21 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Hooks que necesita el kernel en el simulador de host. Los comparten el
+ * simulador de la aplicacion y los benchmarks. */
+
+/* FreeRTOSConfig.h usa SystemCoreClock para configCPU_CLOCK_HZ. */
+uint32_t SystemCoreClock = 30000000;
+
+/* En el simulador el idle hook hace de SysTick: el tiempo virtual solo avanza
+ * cuando todas las tareas estan bloqueadas. */
+void vApplicationIdleHook(void) {
+    vPortSimulateTick();
+}
+
+void vAssertCalled(const char *pcFile, unsigned long ulLine) {
+    fprintf(stderr, "configASSERT fallo en %s:%lu\n", pcFile, ulLine);
+    abort();
+}
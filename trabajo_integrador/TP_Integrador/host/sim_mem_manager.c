@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "mem_manager_pools.h"
+
+/* Verifica el backend del mem_manager sobre mempool.h (mem_manager_pools.c)
+ * con la API del SDK:
+ *
+ * - Pools de id 0 de 32, 48 y 128 bytes y uno de id 1 de 64, agregados
+ *   desordenados, tres con MEM_AddBuffer() y uno con mem_pools_crear(). Un
+ *   quinto no entra en el registro.
+ * - Un pedido sale del pool mas chico en el que entra y, con ese vacio, del
+ *   siguiente; nunca de un pool de otro id.
+ * - MEM_BufferFree() devuelve cada bloque a su pool, y rechaza lo que no es
+ *   de ninguno.
+ * - Los bloques salen en cero; realloc, FreeAllWithId y BufferCheck se
+ *   comportan como en el SDK.
+ *
+ * Termina con error si algo de eso falla. */
+
+MEM_BLOCK_BUFFER_DEFINE(chico, 4, 32, 0);
+MEM_BLOCK_BUFFER_DEFINE(grande, 2, 128, 0);
+MEM_BLOCK_BUFFER_DEFINE(otro_id, 2, 64, 1);
+MEM_BLOCK_BUFFER_DEFINE(sobrante, 1, 16, 0);
+
+static uint64_t datos_medio[mempoolSTORAGE_SIZE(48, 2) / sizeof(uint64_t)];
+static StaticMemPool_t bloque_medio;
+static MemPoolHandle_t medio;
+
+static uint8_t ajeno[32];
+static int fallas;
+
+#define VERIFICAR(c)                                                 \
+    do {                                                             \
+        if (!(c)) {                                                  \
+            printf("  falla en la linea %d: %s\n", __LINE__, #c);   \
+            fallas++;                                                \
+        }                                                            \
+    } while (0)
+
+static void *pedir(uint32_t bytes, uint8_t id, uint16_t tamano_esperado) {
+    void *p = MEM_BufferAllocWithId(bytes, id);
+
+    VERIFICAR(p != NULL);
+    if (p != NULL) VERIFICAR(MEM_BufferGetSize(p) == tamano_esperado);
+    return p;
+}
+
+static void probar_ruteo(void) {
+    void *chicos[4], *p, *q;
+    uint32_t libre;
+    int i;
+
+    printf("Tamano\n");
+    for (i = 0; i < 4; i++) chicos[i] = pedir(20, 0, 32);
+    /* Sin bloques de 32 sigue el de 48, despues el de 128 */
+    p = pedir(20, 0, 48);
+    VERIFICAR(xMemPoolOwns(medio, p));
+    q = pedir(40, 0, 48);
+    VERIFICAR(pedir(33, 0, 128) != NULL);
+    VERIFICAR(pedir(1, 0, 128) != NULL);
+    VERIFICAR(MEM_BufferAllocWithId(1, 0) == NULL);
+    VERIFICAR(MEM_BufferAllocWithId(129, 0) == NULL);
+    VERIFICAR(MEM_BufferAllocWithId(0, 0) == NULL);
+
+    printf("Liberar en el pool de cada bloque\n");
+    libre = MEM_GetFreeHeapSize();
+    VERIFICAR(MEM_BufferFree(chicos[2]) == kStatus_MemSuccess);
+    VERIFICAR(MEM_GetFreeHeapSize() == libre + 32U);
+    VERIFICAR(MEM_BufferFree(q) == kStatus_MemSuccess);
+    VERIFICAR(MEM_GetFreeHeapSize() == libre + 32U + 48U);
+    /* El de 32 vuelve a ser el primero que se elige */
+    VERIFICAR(MEM_BufferAllocWithId(10, 0) == chicos[2]);
+    VERIFICAR(MEM_BufferAllocWithId(10, 0) == q);
+    VERIFICAR(MEM_BufferFree(ajeno) == kStatus_MemFreeError);
+    VERIFICAR(MEM_BufferFree(NULL) == kStatus_MemFreeError);
+    VERIFICAR(MEM_BufferGetSize(ajeno) == 0U);
+    VERIFICAR(MEM_GetFreeHeapSizeLowWaterMark() <= MEM_GetFreeHeapSize());
+    VERIFICAR(MEM_GetFreeHeapSizeByAreaId(1) == 0U);
+
+    printf("Id\n");
+    p = pedir(20, 1, 64);
+    VERIFICAR(pedir(64, 1, 64) != NULL);
+    VERIFICAR(MEM_BufferAllocWithId(20, 1) == NULL);
+    VERIFICAR(MEM_BufferAllocWithId(20, 2) == NULL);
+    VERIFICAR(MEM_BufferFree(p) == kStatus_MemSuccess);
+    VERIFICAR(MEM_BufferAllocWithId(20, 1) == p);
+
+    /* Vuelven todos los del id 1; los de id 0 siguen reservados */
+    libre = MEM_GetFreeHeapSize();
+    VERIFICAR(MEM_BufferFreeAllWithId(1) == kStatus_MemSuccess);
+    VERIFICAR(MEM_GetFreeHeapSize() == libre + 2U * 64U);
+    VERIFICAR(MEM_BufferAllocWithId(1, 0) == NULL);
+    VERIFICAR(MEM_BufferFreeAllWithId(0) == kStatus_MemSuccess);
+}
+
+static void probar_contenido(void) {
+    uint8_t *p, *q;
+    int i, ok = 1;
+
+    printf("Contenido y realloc\n");
+    p = MEM_BufferAlloc(30);
+    VERIFICAR(p != NULL);
+    if (p == NULL) return;
+    memset(p, 0xA5, 32);
+    VERIFICAR(MEM_BufferFree(p) == kStatus_MemSuccess);
+    p = MEM_BufferAlloc(30);
+    for (i = 0; i < 32; i++) ok &= p[i] == 0;
+    VERIFICAR(ok);
+
+    for (i = 0; i < 32; i++) p[i] = (uint8_t)i;
+    VERIFICAR(MEM_BufferRealloc(p, 32) == p);
+    q = MEM_BufferRealloc(p, 100);
+    VERIFICAR(q != NULL && q != p && MEM_BufferGetSize(q) == 128U);
+    for (i = 0, ok = 1; q != NULL && i < 32; i++) ok &= q[i] == i;
+    VERIFICAR(ok);
+    /* El bloque viejo volvio a su pool */
+    VERIFICAR(MEM_BufferAlloc(30) == p);
+
+    VERIFICAR(MEM_BufferCheck(q, 128) == kStatus_MemSuccess);
+    VERIFICAR(MEM_BufferCheck(q, 129) == kStatus_MemOverFlowError);
+    VERIFICAR(MEM_BufferCheck(ajeno, 1) == kStatus_MemUnknownError);
+
+    VERIFICAR(MEM_BufferRealloc(q, 0) == NULL);
+    q = MEM_BufferRealloc(NULL, 20);
+    VERIFICAR(q != NULL && MEM_BufferGetSize(q) == 32U);
+}
+
+int main(void) {
+    printf("Registro\n");
+    VERIFICAR(MEM_Init() == kStatus_MemSuccess);
+    VERIFICAR(MEM_AddBuffer(MEM_BLOCK_BUFFER(grande)) == kStatus_MemSuccess);
+    VERIFICAR(MEM_AddBuffer(MEM_BLOCK_BUFFER(otro_id)) == kStatus_MemSuccess);
+    medio = mem_pools_crear(48, 2, (uint8_t *)datos_medio, &bloque_medio, 0);
+    VERIFICAR(MEM_AddBuffer(MEM_BLOCK_BUFFER(chico)) == kStatus_MemSuccess);
+    VERIFICAR(MEM_AddBuffer(MEM_BLOCK_BUFFER(sobrante)) == kStatus_MemInitError);
+    VERIFICAR(MEM_GetFreeHeapSize() == 4U * 32U + 2U * 48U + 2U * 128U + 2U * 64U);
+
+    probar_ruteo();
+    probar_contenido();
+
+    printf("%s (%d fallas)\n", fallas == 0 ? "OK" : "FALLA", fallas);
+    return fallas == 0 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "samplesync.h"
+
+/* Verifica samplesync.c con SENSORES tareas que muestrean cada PERIODO_MS y
+ * una tarea de fusion que consume los juegos:
+ *
+ * - Sin barrera: cada sensor arranca con su propio desfasaje y a veces se
+ *   atrasa unos ms. Todos los juegos que recibe la fusion tienen las muestras
+ *   del mismo periodo, en orden creciente, y las cuentas cierran: cada periodo
+ *   termina como juego completo o descartado (el sensor 2 saltea una muestra
+ *   cada SALTO periodos). Una muestra de un periodo ya entregado se rechaza.
+ * - Con barrera: los sensores se encuentran en xSampleSyncBarrier() antes de
+ *   muestrear, y la dispersion de las marcas de tiempo baja a menos de un
+ *   tick.
+ *
+ * Termina con error si algo de eso falla. */
+
+#define SENSORES 3U
+#define PERIODO_MS 20U
+#define PERIODOS 200U
+#define SALTO 17U
+#define ESPERA_FUSION_MS 100U
+
+typedef struct {
+    uint32_t periodo;
+    uint32_t sensor;
+    int32_t valor;
+} muestra_t;
+
+static const TickType_t desfasajes[SENSORES] = {0, 3, 7};
+
+static SampleSyncHandle_t sinc;
+static StaticSampleSync_t bloque_sinc;
+static uint8_t bancos[samplesyncSTORAGE_SIZE(SENSORES, sizeof(muestra_t))];
+
+static TaskHandle_t tarea_principal;
+static int con_barrera;
+static uint32_t recibidos, desalineados, desordenados, rechazos_esperados, rechazos_fallidos;
+
+static uint32_t azar(uint32_t *estado) {
+    *estado = *estado * 1103515245U + 12345U;
+    return *estado >> 8;
+}
+
+static void tarea_sensor(void *pvParameters) {
+    uint32_t sensor = (uint32_t)(uintptr_t)pvParameters, estado = sensor + 7U, k;
+    TickType_t proximo;
+    muestra_t m;
+
+    vTaskDelay(desfasajes[sensor] + 1U);
+    proximo = xTaskGetTickCount();
+    for (k = 0; k < PERIODOS; k++) {
+        /* A veces la muestra sale unos ms tarde. */
+        if (azar(&estado) % 4U == 0U) vTaskDelay(1U + azar(&estado) % 4U);
+        if (con_barrera) xSampleSyncBarrier(sinc, sensor, portMAX_DELAY);
+
+        if (sensor != 2U || k % SALTO != 5U) {
+            m.periodo = k;
+            m.sensor = sensor;
+            m.valor = (int32_t)(azar(&estado) % 1000U);
+            xSampleSyncPost(sinc, sensor, k, portHIGH_RES_TIMER_GET_COUNT(), &m);
+        }
+        vTaskDelayUntil(&proximo, pdMS_TO_TICKS(PERIODO_MS));
+    }
+
+    xTaskNotifyGive(tarea_principal);
+    vTaskDelete(NULL);
+}
+
+static void tarea_fusion(void *pvParameters) {
+    muestra_t juego[SENSORES], tarde = {0};
+    SampleSyncSet_t s;
+    uint32_t i, anterior = 0;
+
+    (void)pvParameters;
+    while (xSampleSyncReceive(sinc, juego, &s, pdMS_TO_TICKS(ESPERA_FUSION_MS)) == pdPASS) {
+        for (i = 0; i < SENSORES; i++) {
+            if (juego[i].periodo != s.ulPeriod || juego[i].sensor != i) desalineados++;
+        }
+        if (recibidos > 0U && s.ulPeriod <= anterior) desordenados++;
+        anterior = s.ulPeriod;
+        recibidos++;
+
+        /* Una vez por parte, una muestra que llega cuando su juego ya salio. */
+        if (recibidos == 10U) {
+            rechazos_esperados++;
+            if (xSampleSyncPost(sinc, 0, s.ulPeriod, portHIGH_RES_TIMER_GET_COUNT(), &tarde) != pdFAIL)
+                rechazos_fallidos++;
+        }
+    }
+
+    xTaskNotifyGive(tarea_principal);
+    vTaskDelete(NULL);
+}
+
+static int correr(int barrera, SampleSyncStats_t *s) {
+    static StackType_t pilas[SENSORES + 1U][256];
+    static StaticTask_t tcbs[SENSORES + 1U];
+    uint32_t i, salteados = 0;
+    int ok;
+
+    con_barrera = barrera;
+    recibidos = desalineados = desordenados = 0;
+    sinc = xSampleSyncCreateStatic(SENSORES, sizeof(muestra_t), bancos, &bloque_sinc);
+    configASSERT(sinc);
+
+    /* La fusion tiene mas prioridad: toma cada juego antes del siguiente. */
+    xTaskCreateStatic(tarea_fusion, "Fusion", 256, NULL, 3, pilas[SENSORES], &tcbs[SENSORES]);
+    for (i = 0; i < SENSORES; i++)
+        xTaskCreateStatic(tarea_sensor, "Sensor", 256, (void *)(uintptr_t)i, 2, pilas[i], &tcbs[i]);
+    for (i = 0; i < SENSORES + 1U; i++) ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+    /* Que la tarea idle libere las tareas borradas antes de reusar su
+     * memoria. */
+    vTaskDelay(2);
+
+    for (i = 0; i < PERIODOS; i++) salteados += i % SALTO == 5U;
+    vSampleSyncGetStats(sinc, s);
+
+    ok = desalineados == 0U && desordenados == 0U && recibidos == s->ulSets && s->ulOverwritten == 0U &&
+         s->ulSets == PERIODOS - salteados && s->ulSets + s->ulDropped == PERIODOS && s->ulLate == 1U;
+    printf("%s: %lu juegos, %lu descartados, %lu tarde, %lu pisados, %lu desalineados, %lu fuera de orden\n",
+           barrera ? "con barrera" : "sin barrera", (unsigned long)s->ulSets, (unsigned long)s->ulDropped,
+           (unsigned long)s->ulLate, (unsigned long)s->ulOverwritten, (unsigned long)desalineados,
+           (unsigned long)desordenados);
+    printf("  dispersion: media %lu us, maxima %lu us, %s\n",
+           (unsigned long)(s->ulSets != 0U ? s->ullSkewTotal / s->ulSets : 0U), (unsigned long)s->ulSkewMax,
+           ok ? "ok" : "MAL");
+    return ok;
+}
+
+static int resultado = 1;
+
+static void tarea_prueba(void *pvParameters) {
+    SampleSyncStats_t sin, con;
+    int ok;
+
+    (void)pvParameters;
+    tarea_principal = xTaskGetCurrentTaskHandle();
+    printf("%u sensores cada %u ms, %u periodos\n", SENSORES, PERIODO_MS, PERIODOS);
+    ok = correr(0, &sin);
+    ok &= correr(1, &con);
+
+    /* Sin barrera la dispersion viene de los desfasajes; con barrera todos
+     * muestrean en el mismo tick. */
+    ok &= sin.ulSkewMax >= desfasajes[SENSORES - 1U] * 1000U && con.ulSkewMax < 1000U;
+    ok &= rechazos_esperados == 2U && rechazos_fallidos == 0U;
+
+    resultado = ok ? 0 : 1;
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    static StackType_t pila[256];
+    static StaticTask_t tcb;
+
+    xTaskCreateStatic(tarea_prueba, "Prueba", 256, NULL, 4, pila, &tcb);
+    vTaskStartScheduler();
+    return resultado;
+}
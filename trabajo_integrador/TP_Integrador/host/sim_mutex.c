@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Inversion de prioridades sobre un bus compartido, con las estadisticas de
+ * mutex de queue.c (vSemaphoreGetMutexStats()). En cada ciclo de CICLO_MS:
+ *
+ * - Baja (prioridad 1) toma el bus y lo usa USO_BAJA_MS.
+ * - Media (prioridad 2) ocupa la CPU CARGA_MEDIA_MS sin tocar el bus.
+ * - Control (prioridad 4) necesita el bus y tiene PLAZO_MS para obtenerlo.
+ * - Alarma (prioridad 5) tambien lo pide, despues de Control.
+ *
+ * Con un semaforo binario Media demora a Baja mientras Control espera, y
+ * Control pierde el plazo en todos los ciclos. Con un mutex Baja hereda la
+ * prioridad de Control y lo suelta a tiempo; las estadisticas muestran las
+ * herencias, las dos tareas esperando, la espera maxima de Control por debajo
+ * del plazo y la retencion maxima de Baja. Al final un mutex recursivo cuenta
+ * una sola toma por cada anidamiento.
+ *
+ * Termina con error si algo de eso falla. */
+
+#define CICLOS 50U
+#define CICLO_MS 20U
+#define USO_BAJA_MS 4U
+#define CARGA_MEDIA_MS 6U
+#define PLAZO_MS 5U
+
+static SemaphoreHandle_t bus;
+static StaticSemaphore_t bloque_bus;
+static TaskHandle_t tarea_principal;
+static uint32_t perdidos, espera_control_max;
+
+/* Ocupa la CPU durante n ticks: en el simulador el tiempo virtual solo avanza
+ * con los ticks, que esta tarea genera mientras no la desalojen. */
+static void ocupar(TickType_t n) {
+    while (n-- > 0U) vPortSimulateTick();
+}
+
+static void tarea_baja(void *pvParameters) {
+    TickType_t proximo = xTaskGetTickCount();
+    uint32_t k;
+
+    (void)pvParameters;
+    for (k = 0; k < CICLOS; k++) {
+        xSemaphoreTake(bus, portMAX_DELAY);
+        ocupar(pdMS_TO_TICKS(USO_BAJA_MS));
+        xSemaphoreGive(bus);
+        vTaskDelayUntil(&proximo, pdMS_TO_TICKS(CICLO_MS));
+    }
+    xTaskNotifyGive(tarea_principal);
+    vTaskDelete(NULL);
+}
+
+static void tarea_media(void *pvParameters) {
+    TickType_t proximo;
+    uint32_t k;
+
+    (void)pvParameters;
+    vTaskDelay(1);
+    proximo = xTaskGetTickCount();
+    for (k = 0; k < CICLOS; k++) {
+        ocupar(pdMS_TO_TICKS(CARGA_MEDIA_MS));
+        vTaskDelayUntil(&proximo, pdMS_TO_TICKS(CICLO_MS));
+    }
+    xTaskNotifyGive(tarea_principal);
+    vTaskDelete(NULL);
+}
+
+static void tarea_control(void *pvParameters) {
+    TickType_t proximo, inicio, espera;
+    uint32_t k;
+
+    (void)pvParameters;
+    vTaskDelay(2);
+    proximo = xTaskGetTickCount();
+    for (k = 0; k < CICLOS; k++) {
+        inicio = xTaskGetTickCount();
+        xSemaphoreTake(bus, portMAX_DELAY);
+        espera = xTaskGetTickCount() - inicio;
+        xSemaphoreGive(bus);
+
+        if (espera > pdMS_TO_TICKS(PLAZO_MS)) perdidos++;
+        if (espera > espera_control_max) espera_control_max = espera;
+        vTaskDelayUntil(&proximo, pdMS_TO_TICKS(CICLO_MS));
+    }
+    xTaskNotifyGive(tarea_principal);
+    vTaskDelete(NULL);
+}
+
+static void tarea_alarma(void *pvParameters) {
+    TickType_t proximo;
+    uint32_t k;
+
+    (void)pvParameters;
+    vTaskDelay(3);
+    proximo = xTaskGetTickCount();
+    for (k = 0; k < CICLOS; k++) {
+        xSemaphoreTake(bus, portMAX_DELAY);
+        xSemaphoreGive(bus);
+        vTaskDelayUntil(&proximo, pdMS_TO_TICKS(CICLO_MS));
+    }
+    xTaskNotifyGive(tarea_principal);
+    vTaskDelete(NULL);
+}
+
+static int correr(int con_mutex) {
+    static StackType_t pilas[4][256];
+    static StaticTask_t tcbs[4];
+    const UBaseType_t tareas = uxTaskGetNumberOfTasks();
+    MutexStats_t s;
+    uint32_t i;
+    int ok;
+
+    perdidos = espera_control_max = 0;
+    if (con_mutex) {
+        bus = xSemaphoreCreateMutexStatic(&bloque_bus);
+    } else {
+        bus = xSemaphoreCreateBinaryStatic(&bloque_bus);
+        xSemaphoreGive(bus);
+    }
+    configASSERT(bus);
+
+    xTaskCreateStatic(tarea_baja, "Baja", 256, NULL, 1, pilas[0], &tcbs[0]);
+    xTaskCreateStatic(tarea_media, "Media", 256, NULL, 2, pilas[1], &tcbs[1]);
+    xTaskCreateStatic(tarea_alarma, "Alarma", 256, NULL, 5, pilas[2], &tcbs[2]);
+    xTaskCreateStatic(tarea_control, "Control", 256, NULL, 4, pilas[3], &tcbs[3]);
+    for (i = 0; i < 4U; i++) ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+    /* Que la tarea idle libere las tareas borradas antes de reusar su
+     * memoria. Puede tardar mas de un tick: si la idle estaba durmiendo
+     * cuando se borro la ultima, limpia recien en la vuelta siguiente. */
+    while (uxTaskGetNumberOfTasks() > tareas) vTaskDelay(1);
+
+    printf("%s: Control espero hasta %lu ms, %lu ciclos fuera de plazo\n", con_mutex ? "mutex" : "semaforo binario",
+           (unsigned long)espera_control_max, (unsigned long)perdidos);
+    if (!con_mutex) {
+        ok = perdidos == CICLOS;
+        printf("  %s\n", ok ? "ok" : "MAL");
+        return ok;
+    }
+
+    /* Baja pierde un tick con Media antes de que Control la haga heredar. */
+    vSemaphoreGetMutexStats(bus, &s, pdFALSE);
+    ok = perdidos == 0U && s.ulTakes == 3U * CICLOS && s.ulWaits == 2U * CICLOS && s.ulTimeouts == 0U &&
+         s.ulInheritances == 2U * CICLOS && s.uxMaxWaiters == 2U && s.ulWaitMax <= PLAZO_MS * 1000U &&
+         s.ulHoldMax >= USO_BAJA_MS * 1000U && s.ulHoldMax <= (USO_BAJA_MS + 1U) * 1000U;
+    printf("  %lu tomas, %lu esperas (media %lu us, maxima %lu us), %lu vencidas\n", (unsigned long)s.ulTakes,
+           (unsigned long)s.ulWaits, (unsigned long)(s.ulWaits != 0U ? s.ullWaitTotal / s.ulWaits : 0U),
+           (unsigned long)s.ulWaitMax, (unsigned long)s.ulTimeouts);
+    printf("  retencion media %lu us, maxima %lu us, %lu herencias, hasta %lu esperando, %s\n",
+           (unsigned long)(s.ulTakes != 0U ? s.ullHoldTotal / s.ulTakes : 0U), (unsigned long)s.ulHoldMax,
+           (unsigned long)s.ulInheritances, (unsigned long)s.uxMaxWaiters, ok ? "ok" : "MAL");
+    return ok;
+}
+
+/* Un mutex recursivo tomado tres veces cuenta una toma y una retencion; una
+ * toma que vence sin el mutex cuenta como espera y como vencida. La espera
+ * empieza dentro de un tick y vence al final del tercero: dura entre 2 y 3
+ * ms. */
+static void tarea_ajena(void *pvParameters) {
+    BaseType_t *tomo = pvParameters;
+
+    *tomo = xSemaphoreTakeRecursive(bus, pdMS_TO_TICKS(3));
+    xTaskNotifyGive(tarea_principal);
+    vTaskSuspend(NULL);
+}
+
+static int correr_recursivo(void) {
+    static StackType_t pila[256];
+    static StaticTask_t tcb;
+    TaskHandle_t ajena;
+    MutexStats_t s;
+    BaseType_t tomo = pdTRUE;
+    int i, ok;
+
+    bus = xSemaphoreCreateRecursiveMutexStatic(&bloque_bus);
+    for (i = 0; i < 3; i++) xSemaphoreTakeRecursive(bus, 0);
+    ajena = xTaskCreateStatic(tarea_ajena, "Ajena", 256, &tomo, 5, pila, &tcb);
+    ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    for (i = 0; i < 3; i++) xSemaphoreGiveRecursive(bus);
+    vTaskDelete(ajena);
+
+    vSemaphoreGetMutexStats(bus, &s, pdTRUE);
+    ok = tomo == pdFALSE && s.ulTakes == 1U && s.ulWaits == 1U && s.ulTimeouts == 1U && s.ulWaitMax > 2000U &&
+         s.ulHoldMax >= 3000U;
+    vSemaphoreGetMutexStats(bus, &s, pdFALSE);
+    ok &= s.ulTakes == 0U && s.ulWaits == 0U && s.ulHoldMax == 0U;
+    printf("mutex recursivo: %s\n", ok ? "ok" : "MAL");
+    return ok;
+}
+
+static int resultado = 1;
+
+static void tarea_prueba(void *pvParameters) {
+    int ok;
+
+    (void)pvParameters;
+    tarea_principal = xTaskGetCurrentTaskHandle();
+    printf("%u ciclos de %u ms, plazo de Control %u ms\n", CICLOS, CICLO_MS, PLAZO_MS);
+    ok = correr(0);
+    ok &= correr(1);
+    ok &= correr_recursivo();
+
+    resultado = ok ? 0 : 1;
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    static StackType_t pila[256];
+    static StaticTask_t tcb;
+
+    xTaskCreateStatic(tarea_prueba, "Prueba", 256, NULL, 6, pila, &tcb);
+    vTaskStartScheduler();
+    return resultado;
+}
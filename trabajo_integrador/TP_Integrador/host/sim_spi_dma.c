@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <string.h>
+#include "fsl_spi.h"
+#include "fsl_spi_dma.h"
+#include "modelo_lpc845.h"
+#include "verificar.h"
+
+/* fsl_spi_dma.c contra el modelo de registros y DMA de modelo_lpc845.c, con
+ * la SPI0 como maestro a 15 MHz y un reloj de 30 MHz.
+ *
+ * - Bloque de ida y vuelta: una interrupcion de DMA por bloque en lugar de
+ *   una por trama (se compara con SPI_MasterTransferNonBlocking() de
+ *   fsl_spi.c), y las tramas salen una detras de otra.
+ * - Una memoria flash como esclavo: programar una pagina con el comando y el
+ *   contenido en buffers separados, y leerla con el comando en un segmento y
+ *   la lectura en otro, cada operacion con un solo chip select.
+ * - Sin fin de transferencia el chip select queda activo y la transferencia
+ *   siguiente sigue la misma operacion.
+ * - Tramas de 16 bits, pedidos con el driver ocupado y con segmentos
+ *   invalidos, y abortar a mitad de camino.
+ *
+ * Los esclavos son funciones que contestan trama por trama; el chip select
+ * que ve cada uno es el del modelo. */
+
+#define RELOJ_HZ 30000000U
+#define BAUDIOS 15000000U
+
+static dma_handle_t dma_rx, dma_tx;
+static spi_dma_handle_t manejador;
+static spi_master_handle_t manejador_irq;
+
+VERIFICAR_CALLBACK(al_terminar, SPI_Type, spi_dma_handle_t)
+VERIFICAR_CALLBACK(al_terminar_irq, SPI_Type, spi_master_handle_t)
+
+/* Esclavo que contesta cada trama con su complemento */
+static uint16_t complemento(uint16_t mosi, int inicio) {
+    (void)inicio;
+    return (uint16_t)~mosi;
+}
+
+/* Memoria flash SPI: 0x02 programa y 0x03 lee, los dos con tres bytes de
+ * direccion. Cuenta las operaciones (chip selects) que vio. */
+#define FLASH_BYTES 4096U
+static uint8_t flash[FLASH_BYTES];
+static uint8_t flash_comando;
+static uint32_t flash_direccion, flash_trama, flash_operaciones;
+
+static uint16_t flash_esclavo(uint16_t mosi, int inicio) {
+    uint16_t miso = 0xFFU;
+
+    if (inicio) {
+        flash_trama = 0;
+        flash_direccion = 0;
+        flash_operaciones++;
+    }
+    if (flash_trama == 0U) {
+        flash_comando = (uint8_t)mosi;
+    } else if (flash_trama <= 3U) {
+        flash_direccion = (flash_direccion << 8U) | (mosi & 0xFFU);
+    } else if (flash_comando == 0x02U) {
+        flash[flash_direccion++ % FLASH_BYTES] = (uint8_t)mosi;
+    } else if (flash_comando == 0x03U) {
+        miso = flash[flash_direccion++ % FLASH_BYTES];
+    }
+    flash_trama++;
+    return miso;
+}
+
+static void iniciar(uint8_t bits) {
+    spi_master_config_t config;
+
+    modelo_iniciar(RELOJ_HZ);
+    SPI_MasterGetDefaultConfig(&config);
+    config.baudRate_Bps = BAUDIOS;
+    config.dataWidth = bits - 1U;
+    config.sselNumber = kSPI_Ssel0Assert;
+    SPI_MasterInit(SPI0, &config, RELOJ_HZ);
+
+    DMA_Init(DMA0);
+    DMA_CreateHandle(&dma_rx, DMA0, 10);
+    DMA_CreateHandle(&dma_tx, DMA0, 11);
+    SPI_MasterTransferCreateHandleDMA(SPI0, &manejador, al_terminar, NULL, &dma_tx, &dma_rx);
+    aviso_driver.cuenta = 0;
+}
+
+static void esperar(uint32_t limite_us) {
+    const uint32_t antes = aviso_driver.cuenta;
+    uint32_t t;
+
+    for (t = 0; t < limite_us && aviso_driver.cuenta == antes; t++) modelo_avanzar_us(1);
+}
+
+static void probar_bloque(void) {
+    static uint8_t datos[256], recibidos[256];
+    spi_transfer_t xfer;
+    uint64_t inicio, trama;
+    uint32_t irqs_spi, i;
+    int iguales;
+
+    printf("Bloque de %u bytes\n", (unsigned)sizeof(datos));
+    for (i = 0; i < sizeof(datos); i++) datos[i] = (uint8_t)(i * 13U + 5U);
+
+    /* Primero el driver de fsl_spi.c, con una interrupcion por trama */
+    iniciar(8);
+    modelo_spi_conectar(complemento);
+    SPI_MasterTransferCreateHandle(SPI0, &manejador_irq, al_terminar_irq, NULL);
+    xfer.txData = datos;
+    xfer.rxData = recibidos;
+    xfer.dataSize = sizeof(datos);
+    xfer.configFlags = kSPI_EndOfTransfer;
+    SPI_MasterTransferNonBlocking(SPI0, &manejador_irq, &xfer);
+    esperar(1000);
+    irqs_spi = modelo_irqs(SPI0_IRQn);
+    for (i = 0, iguales = 1; i < sizeof(datos); i++) iguales &= (recibidos[i] ^ datos[i]) == 0xFFU;
+    verificar(aviso_driver.cuenta == 1U && iguales, "por interrupciones: datos completos");
+
+    iniciar(8);
+    modelo_spi_conectar(complemento);
+    trama = modelo_spi_ciclos_trama();
+    memset(recibidos, 0, sizeof(recibidos));
+    xfer.configFlags = kSPI_EndOfTransfer;
+    inicio = modelo_ciclos();
+    verificar(SPI_MasterTransferDMA(SPI0, &manejador, &xfer) == kStatus_Success, "arranca");
+    verificar(SPI_MasterTransferDMA(SPI0, &manejador, &xfer) == kStatus_SPI_Busy, "la segunda espera");
+    esperar(1000);
+    for (i = 0, iguales = 1; i < sizeof(datos); i++) iguales &= (recibidos[i] ^ datos[i]) == 0xFFU;
+    verificar(aviso_driver.estado == kStatus_Success && iguales, "datos completos");
+    printf("  %lu ciclos para %u tramas de %lu ciclos\n", (unsigned long)(aviso_driver.ciclo - inicio),
+           (unsigned)sizeof(datos), (unsigned long)trama);
+    verificar(aviso_driver.ciclo - inicio == sizeof(datos) * trama, "tramas una detras de otra");
+    verificar(modelo_spi_fines() == 1U && !modelo_spi_seleccionado(), "chip select liberado al final");
+    printf("  interrupciones: %lu por tramas, %lu con DMA (%lu de SPI)\n", (unsigned long)irqs_spi,
+           (unsigned long)modelo_irqs(DMA0_IRQn), (unsigned long)modelo_irqs(SPI0_IRQn));
+    verificar(irqs_spi >= sizeof(datos) && modelo_irqs(DMA0_IRQn) == 1U && modelo_irqs(SPI0_IRQn) == 0U,
+              "una interrupcion por bloque");
+}
+
+static void probar_flash(void) {
+    static uint8_t comando[4], pagina[64], leido[64];
+    spi_transfer_t segmentos[2];
+    uint32_t i;
+
+    printf("Flash SPI\n");
+    for (i = 0; i < sizeof(pagina); i++) pagina[i] = (uint8_t)(0x5AU ^ (i * 3U));
+    memset(flash, 0xFF, sizeof(flash));
+    flash_operaciones = 0;
+
+    iniciar(8);
+    modelo_spi_conectar(flash_esclavo);
+
+    /* Programar 0x000123: comando y contenido sin copiarlos juntos */
+    comando[0] = 0x02U;
+    comando[1] = 0x00U;
+    comando[2] = 0x01U;
+    comando[3] = 0x23U;
+    memset(segmentos, 0, sizeof(segmentos));
+    segmentos[0].txData = comando;
+    segmentos[0].dataSize = sizeof(comando);
+    segmentos[1].txData = pagina;
+    segmentos[1].dataSize = sizeof(pagina);
+    segmentos[1].configFlags = kSPI_EndOfTransfer;
+    SPI_MasterTransferScatterGatherDMA(SPI0, &manejador, segmentos, 2);
+    esperar(1000);
+    verificar(aviso_driver.estado == kStatus_Success && memcmp(&flash[0x123], pagina, sizeof(pagina)) == 0 &&
+                  flash[0x122] == 0xFFU && flash[0x123 + sizeof(pagina)] == 0xFFU,
+              "pagina programada");
+    verificar(flash_operaciones == 1U && modelo_spi_fines() == 1U, "con un solo chip select");
+
+    /* Leerla: el comando sin recibir y la lectura sin enviar */
+    comando[0] = 0x03U;
+    memset(segmentos, 0, sizeof(segmentos));
+    segmentos[0].txData = comando;
+    segmentos[0].dataSize = sizeof(comando);
+    segmentos[1].rxData = leido;
+    segmentos[1].dataSize = sizeof(leido);
+    segmentos[1].configFlags = kSPI_EndOfTransfer;
+    SPI_MasterTransferScatterGatherDMA(SPI0, &manejador, segmentos, 2);
+    esperar(1000);
+    verificar(aviso_driver.estado == kStatus_Success && memcmp(leido, pagina, sizeof(pagina)) == 0, "pagina leida");
+    verificar(flash_operaciones == 2U && modelo_spi_fines() == 2U, "con un solo chip select");
+    verificar(modelo_irqs(DMA0_IRQn) == 2U && modelo_irqs(SPI0_IRQn) == 0U, "una interrupcion por operacion");
+
+    /* La misma lectura en dos transferencias: la primera no libera el chip
+     * select */
+    memset(leido, 0, sizeof(leido));
+    segmentos[0].configFlags = 0;
+    SPI_MasterTransferDMA(SPI0, &manejador, &segmentos[0]);
+    esperar(1000);
+    verificar(aviso_driver.estado == kStatus_Success && modelo_spi_seleccionado() && modelo_spi_fines() == 2U,
+              "sin fin de transferencia el chip select sigue activo");
+    SPI_MasterTransferDMA(SPI0, &manejador, &segmentos[1]);
+    esperar(1000);
+    verificar(memcmp(leido, pagina, sizeof(pagina)) == 0 && flash_operaciones == 3U && modelo_spi_fines() == 3U &&
+                  !modelo_spi_seleccionado(),
+              "la segunda sigue la misma operacion");
+}
+
+static void probar_16_bits(void) {
+    static uint16_t datos[32], recibidos[32];
+    spi_transfer_t xfer;
+    uint32_t i;
+    int iguales;
+
+    printf("Tramas de 16 bits\n");
+    for (i = 0; i < 32U; i++) datos[i] = (uint16_t)(0x1234U + i * 0x0101U);
+
+    iniciar(16);
+    modelo_spi_conectar(complemento);
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.txData = (uint8_t *)datos;
+    xfer.rxData = (uint8_t *)recibidos;
+    xfer.dataSize = sizeof(datos);
+    xfer.configFlags = kSPI_EndOfTransfer;
+    SPI_MasterTransferDMA(SPI0, &manejador, &xfer);
+    esperar(1000);
+    for (i = 0, iguales = 1; i < 32U; i++) iguales &= (recibidos[i] ^ datos[i]) == 0xFFFFU;
+    verificar(aviso_driver.estado == kStatus_Success && iguales, "datos completos");
+
+    xfer.dataSize = 7;
+    verificar(SPI_MasterTransferDMA(SPI0, &manejador, &xfer) == kStatus_InvalidArgument,
+              "rechaza un largo que no es de tramas enteras");
+}
+
+static void probar_abortar(void) {
+    static uint8_t datos[512];
+    static uint8_t recibidos[4];
+    spi_transfer_t xfer, segmentos[SPI_DMA_MAX_SEGMENTS + 1U];
+    uint32_t i;
+
+    printf("Abortar\n");
+    iniciar(8);
+    modelo_spi_conectar(complemento);
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.txData = datos;
+    xfer.dataSize = sizeof(datos);
+    xfer.configFlags = kSPI_EndOfTransfer;
+    SPI_MasterTransferDMA(SPI0, &manejador, &xfer);
+    modelo_avanzar(100U * modelo_spi_ciclos_trama() + 1U);
+    SPI_MasterTransferAbortDMA(SPI0, &manejador);
+    verificar(!modelo_spi_seleccionado(), "chip select liberado en el momento");
+    modelo_avanzar(2U * modelo_spi_ciclos_trama());
+    verificar(aviso_driver.cuenta == 0U && !modelo_spi_seleccionado() && modelo_spi_fines() == 1U,
+              "nada mas en el bus, sin aviso");
+
+    xfer.txData = datos;
+    xfer.rxData = recibidos;
+    xfer.dataSize = sizeof(recibidos);
+    datos[0] = 0x0FU;
+    verificar(SPI_MasterTransferDMA(SPI0, &manejador, &xfer) == kStatus_Success, "el canal queda libre");
+    esperar(1000);
+    verificar(aviso_driver.estado == kStatus_Success && recibidos[0] == 0xF0U, "y la transferencia siguiente anda");
+
+    for (i = 0; i < SPI_DMA_MAX_SEGMENTS + 1U; i++) segmentos[i] = xfer;
+    verificar(SPI_MasterTransferScatterGatherDMA(SPI0, &manejador, segmentos, SPI_DMA_MAX_SEGMENTS + 1U) ==
+                  kStatus_InvalidArgument,
+              "rechaza mas segmentos que SPI_DMA_MAX_SEGMENTS");
+}
+
+int main(void) {
+    printf("SPI a %u MHz, reloj de %u MHz\n", BAUDIOS / 1000000U, RELOJ_HZ / 1000000U);
+    probar_bloque();
+    probar_flash();
+    probar_16_bits();
+    probar_abortar();
+    return verificar_terminar();
+}
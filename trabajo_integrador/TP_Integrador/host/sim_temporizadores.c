@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/* Verifica los temporizadores de alta resolucion (timers.h) con el contador
+ * del port del host, que avanza de a un tick (1000 cuentas de 1 us):
+ *
+ * - Periodicos de 1.5 ms en la interrupcion y de 2.4 ms en la tarea de los
+ *   temporizadores: cada vencimiento llega dentro del tick en que vence, sin
+ *   acumular atraso, y la cantidad es la que corresponde al tiempo corrido.
+ *   Con el tickless activo esto prueba tambien que el sueno no pasa del
+ *   compare.
+ * - Uno de 0.7 ms, mas corto que el tick: no se ejecuta dos veces en el mismo
+ *   tick sino que saltea periodos y los cuenta como overruns.
+ * - Uno de un solo disparo vence una vez; otro detenido antes de vencer no
+ *   vence nunca.
+ * - Cambiar el periodo desde una interrupcion rearma el temporizador desde
+ *   ese momento con el periodo nuevo.
+ *
+ * Termina con error si algo de eso falla. */
+
+/* Ningun vencimiento cae justo al final de cada parte: el de la tarea se
+ * ejecutaria despues de que tarea_prueba lo cuente. */
+#define DURACION_MS 1000U
+#define CUENTAS_POR_TICK (configHIGH_RES_TIMER_HZ / configTICK_RATE_HZ)
+
+typedef struct {
+    const char *nombre;
+    uint32_t periodo_us;
+    BaseType_t periodico;
+    BaseType_t contexto;
+    TimerHandle_t handle;
+    StaticTimer_t bloque;
+    uint32_t inicio;
+    uint32_t periodo;       /* vigente, para verificar el atraso */
+    uint32_t vencimientos;
+    uint32_t ultimo;
+    uint32_t atraso_max;
+    uint32_t errores;
+} prueba_t;
+
+enum { ISR_1500, TAREA_2400, CORTO_700, UN_DISPARO, DETENIDO };
+
+static prueba_t pruebas[] = {
+    {.nombre = "1.5 ms isr", .periodo_us = 1500, .periodico = pdTRUE, .contexto = tmrHIGH_RES_CALLBACK_IN_ISR},
+    {.nombre = "2.4 ms tarea", .periodo_us = 2400, .periodico = pdTRUE, .contexto = tmrHIGH_RES_CALLBACK_IN_TASK},
+    {.nombre = "0.7 ms isr", .periodo_us = 700, .periodico = pdTRUE, .contexto = tmrHIGH_RES_CALLBACK_IN_ISR},
+    {.nombre = "3.3 ms 1 vez", .periodo_us = 3300, .periodico = pdFALSE, .contexto = tmrHIGH_RES_CALLBACK_IN_ISR},
+    {.nombre = "5 ms detenido", .periodo_us = 5000, .periodico = pdFALSE, .contexto = tmrHIGH_RES_CALLBACK_IN_TASK},
+};
+
+#define PRUEBAS (sizeof(pruebas) / sizeof(pruebas[0]))
+
+static void vencer(TimerHandle_t temporizador) {
+    prueba_t *p = pvTimerGetTimerID(temporizador);
+    uint32_t ahora = portHIGH_RES_TIMER_GET_COUNT();
+    uint32_t atraso;
+
+    /* Los vencimientos caen en inicio + n * periodo; el contador del host
+     * los ve en el primer tick que llega a cada uno. */
+    if (p->vencimientos > 0U && ahora == p->ultimo) p->errores++;
+    if (p != &pruebas[CORTO_700]) {
+        atraso = ahora - (p->inicio + (p->vencimientos + 1U) * p->periodo);
+        if (atraso >= CUENTAS_POR_TICK) p->errores++;
+        if (atraso > p->atraso_max && atraso < CUENTAS_POR_TICK) p->atraso_max = atraso;
+    }
+
+    p->ultimo = ahora;
+    p->vencimientos++;
+}
+
+static void cambiar_periodo(void) {
+    prueba_t *p = &pruebas[TAREA_2400];
+
+    vTimerHighResChangePeriodFromISR(p->handle, pdUS_TO_HIGH_RES_COUNTS(3600U));
+    p->inicio = portHIGH_RES_TIMER_GET_COUNT();
+    p->periodo = pdUS_TO_HIGH_RES_COUNTS(3600U);
+    p->vencimientos = 0;
+}
+
+static int revisar(prueba_t *p, uint32_t esperados) {
+    int ok = p->errores == 0U && p->vencimientos == esperados;
+
+    printf("  %-14s %6lu vencimientos (esperados %6lu), atraso max %4lu us, %s\n", p->nombre,
+           (unsigned long)p->vencimientos, (unsigned long)esperados, (unsigned long)p->atraso_max, ok ? "ok" : "MAL");
+    return ok;
+}
+
+static int resultado = 1;
+
+static void tarea_prueba(void *pvParameters) {
+    TimerHighResStats_t s;
+    uint32_t total = 0;
+    unsigned i;
+    int ok = 1;
+
+    (void)pvParameters;
+    for (i = 0; i < PRUEBAS; i++) {
+        prueba_t *p = &pruebas[i];
+
+        p->periodo = pdUS_TO_HIGH_RES_COUNTS(p->periodo_us);
+        p->handle = xTimerCreateHighResStatic(p->nombre, p->periodo, p->periodico, p, vencer, p->contexto,
+                                              &p->bloque);
+        configASSERT(p->handle);
+        p->inicio = portHIGH_RES_TIMER_GET_COUNT();
+        vTimerHighResStart(p->handle);
+    }
+
+    vTaskDelay(2);
+    vTimerHighResStop(pruebas[DETENIDO].handle);
+    vTaskDelay(pdMS_TO_TICKS(DURACION_MS) - 2);
+
+    /* Todos arrancaron en el mismo tick: el tiempo corrido es DURACION_MS. */
+    printf("%u ms con el contador del host (%u cuentas por tick)\n", DURACION_MS, (unsigned)CUENTAS_POR_TICK);
+    ok &= revisar(&pruebas[ISR_1500], DURACION_MS * 1000U / 1500U);
+    ok &= revisar(&pruebas[TAREA_2400], DURACION_MS * 1000U / 2400U);
+    ok &= revisar(&pruebas[UN_DISPARO], 1);
+    ok &= revisar(&pruebas[DETENIDO], 0);
+
+    /* El de 0.7 ms vence a lo sumo una vez por tick. */
+    ok &= pruebas[CORTO_700].errores == 0U && pruebas[CORTO_700].vencimientos <= DURACION_MS &&
+          pruebas[CORTO_700].vencimientos >= DURACION_MS / 2U;
+    printf("  %-14s %6lu vencimientos, nunca dos en el mismo tick: %s\n", pruebas[CORTO_700].nombre,
+           (unsigned long)pruebas[CORTO_700].vencimientos, pruebas[CORTO_700].errores == 0U ? "ok" : "MAL");
+
+    for (i = 0; i < PRUEBAS; i++) total += pruebas[i].vencimientos;
+
+    /* El de 2.4 ms pasa a 3.6 ms desde una interrupcion. */
+    vPortSimulateInterrupt(cambiar_periodo);
+    vTaskDelay(pdMS_TO_TICKS(DURACION_MS));
+    total += pruebas[TAREA_2400].vencimientos;
+    printf("periodo cambiado desde una interrupcion:\n");
+    ok &= revisar(&pruebas[TAREA_2400], DURACION_MS * 1000U / 3600U);
+
+    for (i = 0; i < PRUEBAS; i++) vTimerHighResStop(pruebas[i].handle);
+
+    /* Las cuentas de la primera parte del de 1.5 ms y del de 0.7 ms siguen
+     * sumando durante la segunda. */
+    vTimerGetHighResStats(&s);
+    printf("estadisticas: %lu vencimientos, %lu overruns, %lu descartados\n", (unsigned long)s.ulExpiries,
+           (unsigned long)s.ulOverruns, (unsigned long)s.ulDropped);
+    ok &= s.ulOverruns > 0U && s.ulDropped == 0U && s.ulExpiries >= total;
+
+    resultado = ok ? 0 : 1;
+    vTaskEndScheduler();
+}
+
+int main(void) {
+    static StackType_t pila[256];
+    static StaticTask_t tcb;
+
+    xTaskCreateStatic(tarea_prueba, "Prueba", 256, NULL, configTIMER_TASK_PRIORITY + 1, pila, &tcb);
+    vTaskStartScheduler();
+    return resultado;
+}
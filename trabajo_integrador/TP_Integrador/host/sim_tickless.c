@@ -0,0 +1,242 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "tickless.h"
+
+/* Verifica las cuentas de tickless.c (lo que usa tickless_wkt.c en la placa)
+ * contra un reloj ideal, con un modelo del LPC845:
+ *
+ * - SysTick a 18 MHz, tick de 1 ms, que se detiene al dormir.
+ * - WKT con el LPO de 10 kHz, con error de fabrica y deriva lenta por
+ *   temperatura; descuenta en flancos con fase al azar respecto del nucleo y
+ *   se detiene al llegar a 0.
+ * - El nucleo tarda LATENCIA_US +- 2 us en despertar de la alarma, y a veces
+ *   lo despierta antes otra interrupcion.
+ * - A veces el tick vence con las interrupciones ya deshabilitadas, antes
+ *   de detener el SysTick, y queda pendiente. Si no se duerme, la placa lo
+ *   vuelve a marcar pendiente y el kernel lo atiende al salir.
+ * - Cada CALIBRAR_CADA suenos, uno que entra en los 24 bits del SysTick se
+ *   duerme con el SysTick contando libre y calibra el LPO.
+ *
+ * La carga es la de la aplicacion: rafagas cortas de trabajo y suenos de
+ * 2 ms a 60 s. En cada interrupcion del tick se compara el momento real con
+ * el que cree el kernel. Tambien se cuenta cuantas veces habria despertado
+ * el tickless del port, limitado por los 24 bits del SysTick. Falla si el
+ * kernel pasa de su proximo desbloqueo, si pierde un tick o si, con el LPO
+ * estable, deriva mas de DERIVA_MAXIMA. */
+
+#define CPU_HZ 18000000.0
+#define TICK_S 1e-3
+#define CICLOS_POR_TICK 18000U
+#define LPO_HZ 10000.0
+#define LATENCIA_US 10
+#define CALIBRAR_CADA 2
+#define DERIVA_MAXIMA 100e-6
+#define SYSTICK_MAX_TICKS (0xFFFFFFU / CICLOS_POR_TICK)
+
+typedef struct {
+    const char *nombre;
+    double error_lpo;   /* del LPO respecto de LPO_HZ */
+    double deriva;      /* amplitud de la deriva por temperatura */
+    double periodo_s;   /* de la deriva */
+    int recalibrar;
+} escenario_t;
+
+typedef struct {
+    double f0, amplitud, omega, fase0;
+} oscilador_t;
+
+static uint32_t semilla = 1;
+
+static double azar(void) {
+    semilla = semilla * 1103515245U + 12345U;
+    return (double)(semilla >> 8) / (double)(1U << 24);
+}
+
+/* Ciclos del LPO transcurridos hasta x; la frecuencia instantanea es
+ * f0 * (1 + amplitud * sin(omega * x)). */
+static double ciclos_lpo(const oscilador_t *o, double x) {
+    double deriva = o->omega > 0 ? o->amplitud * (1.0 - cos(o->omega * x)) / o->omega : 0.0;
+
+    return o->f0 * (x + deriva) + o->fase0;
+}
+
+static double frecuencia_lpo(const oscilador_t *o, double x) {
+    return o->f0 * (1.0 + o->amplitud * sin(o->omega * x));
+}
+
+static uint32_t flancos(const oscilador_t *o, double desde, double hasta) {
+    return (uint32_t)(floor(ciclos_lpo(o, hasta)) - floor(ciclos_lpo(o, desde)));
+}
+
+/* Momento del flanco numero n despues de desde. */
+static double flanco(const oscilador_t *o, double desde, uint32_t n) {
+    double objetivo = floor(ciclos_lpo(o, desde)) + n;
+    double x = desde + (objetivo - ciclos_lpo(o, desde)) / o->f0;
+    int i;
+
+    for (i = 0; i < 8; i++) x -= (ciclos_lpo(o, x) - objetivo) / frecuencia_lpo(o, x);
+    return x;
+}
+
+static int correr(const escenario_t *e, double duracion_s) {
+    oscilador_t lpo = {LPO_HZ * (1.0 + e->error_lpo), e->deriva, e->periodo_s > 0 ? 2 * M_PI / e->periodo_s : 0,
+                       azar()};
+    tickless_t t;
+    double ahora = 0, proximo_tick = TICK_S, inicio, fin, alarma_s, irq_s, dormido_s = 0, error_s, peor_s = 0;
+    double error_previo = 0;
+    uint32_t tick = 0, esperados, cuentas, contadas, fase, pasos, fraccion, transcurrido, latencia_q16;
+    uint64_t ciclos;
+    unsigned long suenos = 0, despertares_systick = 0, calibraciones = 0, tick_mas_largo = 0, perdidos = 0;
+    int pendiente, alarma, calibrando, durmio = 0, ok = 1;
+    double r;
+
+    latencia_q16 = (uint32_t)(LATENCIA_US * 1e-6 / TICK_S * TICKLESS_UNO_Q16);
+
+    /* Calibracion al arrancar: 500 cuentas desde un flanco, medidas en ciclos
+     * del SysTick. */
+    inicio = flanco(&lpo, -1.0, 1);
+    fin = flanco(&lpo, inicio, 500);
+    ciclos = (uint64_t)((fin - inicio) * CPU_HZ);
+    tickless_calibrar(&t, 500, (ciclos << 16) / CICLOS_POR_TICK);
+
+    while (ahora < duracion_s) {
+        /* Trabajo: de 50 us a 2 ms con el SysTick andando. */
+        ahora += 50e-6 + azar() * 1.95e-3;
+        while (proximo_tick <= ahora) {
+            tick++;
+            error_s = proximo_tick - tick * TICK_S;
+            if (fabs(error_s) > peor_s) peor_s = fabs(error_s);
+            /* Sin un sueno en el medio el error no cambia de un tick al
+             * siguiente: si cambia, el kernel no vio un tick. */
+            if (!durmio && fabs(error_s - error_previo) > TICK_S / 2) perdidos++;
+            error_previo = error_s;
+            durmio = 0;
+            proximo_tick += TICK_S;
+        }
+
+        /* Proximo desbloqueo: casi siempre una tarea periodica, a veces un
+         * timeout largo. */
+        r = azar();
+        esperados = r < 0.80 ? 2 + (uint32_t)(azar() * 198) : r < 0.95 ? 200 + (uint32_t)(azar() * 4800)
+                                                                       : 5000 + (uint32_t)(azar() * 55000);
+
+        /* El tick que vence al entrar queda pendiente y el SysTick, recargado,
+         * ya cuenta parte del siguiente. Con un solo tick por delante muchas
+         * veces no vale la pena dormir. */
+        pendiente = azar() < 0.05;
+        if (pendiente) {
+            ahora = proximo_tick + azar() * 0.95 * TICK_S;
+            if (azar() < 0.5) esperados = 2;
+        }
+
+        fraccion = (uint32_t)(((uint64_t)((ahora - (proximo_tick - (pendiente ? 0 : TICK_S))) * CPU_HZ) << 16) /
+                              CICLOS_POR_TICK);
+        cuentas = tickless_entrar(&t, esperados, fraccion, pendiente, &transcurrido);
+        if (cuentas == 0) {
+            /* Vuelto a marcar pendiente, el tick se atiende al principio de
+             * la vuelta siguiente. */
+            continue;
+        }
+
+        inicio = ahora;
+        alarma_s = flanco(&lpo, inicio, cuentas);
+        irq_s = azar() < 0.3 ? inicio + azar() * (alarma_s - inicio) * 1.2 : alarma_s + 1.0;
+        suenos++;
+        calibrando = e->recalibrar && suenos % CALIBRAR_CADA == 0 && esperados < SYSTICK_MAX_TICKS;
+
+        if (irq_s < alarma_s) {
+            ahora = irq_s + (calibrando ? 0 : (LATENCIA_US + (azar() - 0.5) * 4) * 1e-6);
+            contadas = flancos(&lpo, inicio, ahora);
+            alarma = contadas >= cuentas;
+            if (alarma) contadas = cuentas;
+        } else {
+            ahora = alarma_s + (calibrando ? 0 : (LATENCIA_US + (azar() - 0.5) * 4) * 1e-6);
+            contadas = cuentas;
+            alarma = 1;
+        }
+
+        /* En el sueno de calibracion no hay deep sleep ni latencia, y el
+         * SysTick mide el sueno entero en ciclos. */
+        if (calibrando) {
+            ciclos = (uint64_t)((ahora - inicio) * CPU_HZ);
+            tickless_medir(&t, contadas, alarma, (ciclos << 16) / CICLOS_POR_TICK);
+            calibraciones++;
+        }
+
+        pasos = tickless_despertar(&t, transcurrido, contadas, alarma, calibrando ? 0 : latencia_q16, esperados, &fase);
+        if (pasos > esperados) {
+            printf("  %s: se sumaron %lu ticks con %lu esperados\n", e->nombre, (unsigned long)pasos,
+                   (unsigned long)esperados);
+            ok = 0;
+        }
+
+        tick += pasos;
+        durmio = 1;
+        proximo_tick = ahora + (double)(((uint64_t)(TICKLESS_UNO_Q16 - fase) * CICLOS_POR_TICK) >> 16) / CPU_HZ;
+        dormido_s += ahora - inicio;
+        if (pasos > tick_mas_largo) tick_mas_largo = pasos;
+        despertares_systick += (pasos + SYSTICK_MAX_TICKS - 1) / SYSTICK_MAX_TICKS;
+    }
+
+    error_s = proximo_tick - (tick + 1) * TICK_S;
+    printf("%-22s %8lu %6.1f %% %7lu ms %8lu %8lu %8.1f ms %8.1f ms %7.1f ppm\n", e->nombre, suenos,
+           100.0 * dormido_s / ahora, tick_mas_largo, despertares_systick, calibraciones, peor_s * 1e3,
+           error_s * 1e3, error_s / ahora * 1e6);
+
+    /* Con el LPO estable, recalibrando, el reloj del kernel no puede derivar
+     * mas que un cristal barato. */
+    if (e->recalibrar && e->deriva == 0 && fabs(error_s / ahora) > DERIVA_MAXIMA) {
+        printf("  %s: deriva fuera de tolerancia\n", e->nombre);
+        ok = 0;
+    }
+    if (perdidos > 0) {
+        printf("  %s: el kernel perdio %lu ticks\n", e->nombre, perdidos);
+        ok = 0;
+    }
+    return ok;
+}
+
+/* La entrada con el tick pendiente lo cuenta solo si duerme: con un tick por
+ * delante y el siguiente casi terminado no se duerme, y el tick tiene que
+ * quedar para el kernel. */
+static int probar_pendiente(void) {
+    tickless_t t;
+    uint32_t transcurrido = 0, fraccion = TICKLESS_UNO_Q16 / 4;
+    int ok = 1;
+
+    tickless_calibrar(&t, 10, TICKLESS_UNO_Q16);
+    if (tickless_entrar(&t, 5, fraccion, 1, &transcurrido) != tickless_cuentas_para(&t, 4, fraccion) ||
+        transcurrido != TICKLESS_UNO_Q16 + fraccion) {
+        printf("  tick pendiente: no se cuenta en el sueno\n");
+        ok = 0;
+    }
+
+    transcurrido = 0;
+    if (tickless_entrar(&t, 2, TICKLESS_UNO_Q16 * 9 / 10, 1, &transcurrido) != 0 || transcurrido != 0) {
+        printf("  tick pendiente: se cuenta sin dormir\n");
+        ok = 0;
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    static const escenario_t escenarios[] = {
+        {"LPO exacto", 0.0, 0.0, 0.0, 1},
+        {"LPO +25 %", 0.25, 0.0, 0.0, 1},
+        {"LPO -30 %", -0.30, 0.0, 0.0, 1},
+        {"LPO +25 %, deriva 2 %", 0.25, 0.02, 3600.0, 1},
+        {"  sin recalibrar", 0.25, 0.02, 3600.0, 0},
+    };
+    double duracion_s = argc > 1 ? atof(argv[1]) : 3600.0;
+    unsigned i;
+    int ok = 1;
+
+    printf("%.0f s por escenario, tick de 1 ms, SysTick de 24 bits a 18 MHz (%u ticks como maximo)\n\n", duracion_s,
+           SYSTICK_MAX_TICKS);
+    printf("%-22s %8s %8s %10s %8s %8s %11s %11s %11s\n", "", "suenos", "dormido", "mas largo", "SysTick",
+           "calibr.", "peor error", "error final", "deriva");
+    for (i = 0; i < sizeof(escenarios) / sizeof(escenarios[0]); i++) ok &= correr(&escenarios[i], duracion_s);
+    ok &= probar_pendiente();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,362 @@
+#include <stdio.h>
+#include <string.h>
+#include "fsl_usart.h"
+#include "fsl_usart_dma.h"
+#include "modelo_lpc845.h"
+#include "verificar.h"
+
+/* fsl_usart_dma.c contra el modelo de registros y DMA de modelo_lpc845.c, a
+ * 921600 baudios con un reloj de 30 MHz, como el enlace de telemetria.
+ *
+ * - TX: una interrupcion por bloque en lugar de una por byte (se compara con
+ *   USART_TransferSendNonBlocking() de fsl_usart.c).
+ * - RX simple: el bloque completo, y un bloque cortado por la linea inactiva.
+ * - RX ping pong: tramas de largos variados separadas por silencios y un
+ *   chorro continuo; cada byte tiene que llegar una sola vez y en orden, y
+ *   cada fin de trama tiene que informarse por inactividad.
+ * - Abortar el ping pong deja el canal listo para otra recepcion.
+ * - RX en anillo: el DMA escribe directo en el anillo y cada trama se informa
+ *   donde quedo, tambien las que dan la vuelta; se compara con el anillo de
+ *   fsl_usart.c, que se llena con una interrupcion por byte. Sin liberar las
+ *   tramas, el anillo se desborda y se informa.
+ *
+ * La linea inactiva se busca cada SONDEO_US, como lo haria un timer de la
+ * aplicacion. */
+
+#define RELOJ_HZ 30000000U
+#define BAUDIOS 921600U
+/* Periodo con que se busca la linea inactiva: un poco menos de dos
+ * caracteres. */
+#define SONDEO_US 20U
+
+static dma_handle_t dma_rx, dma_tx;
+static usart_dma_handle_t manejador;
+static usart_handle_t manejador_irq;
+
+VERIFICAR_CALLBACK(al_terminar, USART_Type, usart_dma_handle_t)
+VERIFICAR_CALLBACK(al_terminar_irq, USART_Type, usart_handle_t)
+
+/* Avanza de a SONDEO_US, buscando la linea inactiva como lo haria un timer,
+ * hasta que haya una llamada nueva o pase el limite. */
+static void esperar(uint32_t limite_us) {
+    const uint32_t antes = aviso_driver.cuenta;
+    uint32_t t;
+
+    for (t = 0; t < limite_us && aviso_driver.cuenta == antes; t += SONDEO_US) {
+        modelo_avanzar_us(SONDEO_US);
+        USART_TransferHandleIdleDMA(USART0, &manejador);
+    }
+}
+
+static void iniciar(void) {
+    usart_config_t config;
+
+    modelo_iniciar(RELOJ_HZ);
+    USART_GetDefaultConfig(&config);
+    config.baudRate_Bps = BAUDIOS;
+    config.enableTx = true;
+    config.enableRx = true;
+    USART_Init(USART0, &config, RELOJ_HZ);
+
+    DMA_Init(DMA0);
+    DMA_CreateHandle(&dma_rx, DMA0, 0);
+    DMA_CreateHandle(&dma_tx, DMA0, 1);
+    USART_TransferCreateHandleDMA(USART0, &manejador, al_terminar, NULL, &dma_tx, &dma_rx);
+    aviso_driver.cuenta = 0;
+}
+
+static void probar_tx(void) {
+    static uint8_t datos[256], salida[300];
+    usart_transfer_t xfer;
+    uint64_t caracter;
+    uint32_t irqs_usart, i;
+    size_t n;
+
+    printf("TX de %u bytes\n", (unsigned)sizeof(datos));
+    for (i = 0; i < sizeof(datos); i++) datos[i] = (uint8_t)(i * 7U + 3U);
+
+    /* Primero el driver de fsl_usart.c, con una interrupcion por byte */
+    iniciar();
+    USART_TransferCreateHandle(USART0, &manejador_irq, al_terminar_irq, NULL);
+    xfer.txData = datos;
+    xfer.dataSize = sizeof(datos);
+    USART_TransferSendNonBlocking(USART0, &manejador_irq, &xfer);
+    modelo_avanzar_us(5000);
+    irqs_usart = modelo_irqs(USART0_IRQn);
+    n = modelo_usart_enviados(salida, sizeof(salida));
+    verificar(aviso_driver.cuenta == 1U && n == sizeof(datos) && memcmp(salida, datos, n) == 0,
+              "por interrupciones: datos completos");
+
+    iniciar();
+    caracter = modelo_usart_ciclos_caracter();
+    xfer.txData = datos;
+    xfer.dataSize = sizeof(datos);
+    verificar(USART_TransferSendDMA(USART0, &manejador, &xfer) == kStatus_Success, "arranca");
+    verificar(USART_TransferSendDMA(USART0, &manejador, &xfer) == kStatus_USART_TxBusy, "la segunda espera");
+    esperar(5000);
+    n = modelo_usart_enviados(salida, sizeof(salida));
+    /* Los dos ultimos bytes estan en TXDAT y en el registro de desplazamiento */
+    verificar(aviso_driver.estado == kStatus_USART_TxIdle && n == sizeof(datos) - 2U,
+              "aviso con el ultimo byte saliendo");
+    verificar(aviso_driver.ciclo / caracter == sizeof(datos) - 2U, "a tiempo de linea");
+    modelo_avanzar(2U * caracter);
+    n += modelo_usart_enviados(salida + n, sizeof(salida) - n);
+    verificar(n == sizeof(datos) && memcmp(salida, datos, n) == 0 &&
+                  (USART_GetStatusFlags(USART0) & kUSART_TxIdleFlag) != 0U,
+              "datos completos");
+    printf("  interrupciones: %lu por bytes, %lu con DMA (%lu de USART)\n", (unsigned long)irqs_usart,
+           (unsigned long)modelo_irqs(DMA0_IRQn), (unsigned long)modelo_irqs(USART0_IRQn));
+    verificar(irqs_usart >= sizeof(datos) && modelo_irqs(DMA0_IRQn) == 1U && modelo_irqs(USART0_IRQn) == 0U,
+              "una interrupcion por bloque");
+}
+
+static void probar_rx_simple(void) {
+    static uint8_t datos[100], recibidos[100];
+    usart_transfer_t xfer;
+    uint64_t fin_linea;
+    uint32_t cuenta, i;
+
+    printf("RX simple\n");
+    for (i = 0; i < sizeof(datos); i++) datos[i] = (uint8_t)(0xA0U ^ i);
+
+    iniciar();
+    xfer.rxData = recibidos;
+    xfer.dataSize = 64;
+    USART_TransferReceiveDMA(USART0, &manejador, &xfer);
+    verificar(USART_TransferReceiveDMA(USART0, &manejador, &xfer) == kStatus_USART_RxBusy, "la segunda espera");
+    modelo_usart_recibir(datos, 64);
+    modelo_avanzar(modelo_usart_ciclos_caracter() * 10U);
+    verificar(USART_TransferGetReceiveCountDMA(USART0, &manejador, &cuenta) == kStatus_Success && cuenta == 10U,
+              "cuenta parcial");
+    esperar(5000);
+    verificar(aviso_driver.estado == kStatus_USART_RxIdle && memcmp(recibidos, datos, 64) == 0, "bloque completo");
+    verificar(modelo_irqs(DMA0_IRQn) == 1U && modelo_irqs(USART0_IRQn) == 0U, "una interrupcion");
+
+    /* Pide 100 y llegan 37: termina por inactividad */
+    memset(recibidos, 0, sizeof(recibidos));
+    xfer.dataSize = sizeof(recibidos);
+    USART_TransferReceiveDMA(USART0, &manejador, &xfer);
+    modelo_usart_recibir(datos, 37);
+    fin_linea = modelo_ciclos() + 37U * modelo_usart_ciclos_caracter();
+    esperar(5000);
+    verificar(aviso_driver.estado == kStatus_USART_RxIdleTimeout && manejador.rxDataSizeAll == 37U &&
+                  memcmp(recibidos, datos, 37) == 0,
+              "corte por linea inactiva con 37 bytes");
+    printf("  inactividad detectada %lu us despues del ultimo byte\n",
+           (unsigned long)((aviso_driver.ciclo - fin_linea) / (RELOJ_HZ / 1000000U)));
+    verificar(aviso_driver.ciclo - fin_linea <= 2U * SONDEO_US * (RELOJ_HZ / 1000000U), "dentro de dos sondeos");
+    verificar(USART_TransferReceiveDMA(USART0, &manejador, &xfer) == kStatus_Success, "el canal queda libre");
+    USART_TransferAbortReceiveDMA(USART0, &manejador);
+}
+
+/* Ping pong: los segmentos se van pegando en flujo[] */
+#define PP_BUFFER 32U
+static uint8_t pp_buffers[2][PP_BUFFER];
+static uint8_t flujo[4096];
+static size_t flujo_n;
+static uint32_t segmentos_llenos, segmentos_inactivos, errores;
+static size_t fin_ultimo_inactivo;
+
+static void al_recibir(USART_Type *base, usart_dma_handle_t *handle, uint8_t *datos, size_t largo, status_t estado,
+                       void *usuario) {
+    (void)base;
+    (void)handle;
+    (void)usuario;
+    if (estado == kStatus_USART_RxIdle) {
+        segmentos_llenos++;
+    } else if (estado == kStatus_USART_RxIdleTimeout) {
+        segmentos_inactivos++;
+    } else {
+        errores++;
+        return;
+    }
+    memcpy(flujo + flujo_n, datos, largo);
+    flujo_n += largo;
+    if (estado == kStatus_USART_RxIdleTimeout) fin_ultimo_inactivo = flujo_n;
+    aviso_driver.cuenta++;
+}
+
+static void sondear_us(uint32_t us) {
+    uint32_t t;
+
+    for (t = 0; t < us; t += SONDEO_US) {
+        modelo_avanzar_us(SONDEO_US);
+        USART_TransferHandleIdleDMA(USART0, &manejador);
+    }
+}
+
+static void probar_ping_pong(void) {
+    static const uint16_t largos[] = {10, 50, 5, 32, 64, 100, 1, 33, 31, 200};
+    static uint8_t enviado[4096];
+    size_t enviado_n = 0, previa, i, j;
+    uint32_t tramas_bien = 0, cuenta;
+    usart_transfer_t xfer;
+
+    printf("RX ping pong con buffers de %u bytes\n", PP_BUFFER);
+    iniciar();
+    flujo_n = 0;
+    verificar(USART_TransferReceivePingPongDMA(USART0, &manejador, pp_buffers[0], pp_buffers[1], PP_BUFFER,
+                                               al_recibir) == kStatus_Success,
+              "arranca");
+    xfer.rxData = enviado;
+    xfer.dataSize = 1;
+    verificar(USART_TransferReceiveDMA(USART0, &manejador, &xfer) == kStatus_USART_RxBusy,
+              "una recepcion simple espera");
+
+    /* Tramas separadas por silencios de 200 us */
+    for (i = 0; i < sizeof(largos) / sizeof(largos[0]); i++) {
+        for (j = 0; j < largos[i]; j++) enviado[enviado_n + j] = (uint8_t)(enviado_n + j * 13U);
+        modelo_usart_recibir(enviado + enviado_n, largos[i]);
+        enviado_n += largos[i];
+        sondear_us(largos[i] * 11U + 200U);
+        if (flujo_n == enviado_n && fin_ultimo_inactivo == enviado_n) tramas_bien++;
+        /* Una trama que termina justo con un buffer se entrega al llenarlo */
+        else if (flujo_n == enviado_n && enviado_n % PP_BUFFER == 0U) tramas_bien++;
+    }
+    verificar(flujo_n == enviado_n && memcmp(flujo, enviado, enviado_n) == 0, "cada byte una vez y en orden");
+    printf("  %lu tramas, %lu segmentos por buffer lleno y %lu por inactividad\n",
+           (unsigned long)(sizeof(largos) / sizeof(largos[0])), (unsigned long)segmentos_llenos,
+           (unsigned long)segmentos_inactivos);
+    verificar(tramas_bien == sizeof(largos) / sizeof(largos[0]), "cada trama entregada al terminar");
+
+    /* Un chorro continuo sin silencios: buffers llenos y un solo segmento por
+     * inactividad al final, si no termina justo con un buffer. El buffer en
+     * curso ya tiene previa bytes entregados. */
+    previa = enviado_n % PP_BUFFER;
+    segmentos_llenos = segmentos_inactivos = 0;
+    for (j = 0; j < 2048U; j++) enviado[enviado_n + j] = (uint8_t)(j ^ (j >> 8));
+    modelo_usart_recibir(enviado + enviado_n, 2048U);
+    enviado_n += 2048U;
+    sondear_us(2048U * 11U + 200U);
+    verificar(flujo_n == enviado_n && memcmp(flujo, enviado, enviado_n) == 0 && segmentos_llenos == (previa + 2048U) / PP_BUFFER &&
+                  segmentos_inactivos == ((previa + 2048U) % PP_BUFFER != 0U ? 1U : 0U),
+              "2048 bytes seguidos");
+    verificar(modelo_usart_desbordes() == 0U && errores == 0U && modelo_irqs(USART0_IRQn) == 0U,
+              "sin desbordes ni interrupciones de USART");
+    printf("  %lu interrupciones de DMA para %lu bytes\n", (unsigned long)modelo_irqs(DMA0_IRQn),
+           (unsigned long)enviado_n);
+
+    /* Abortar a mitad de un buffer */
+    previa = enviado_n % PP_BUFFER;
+    modelo_usart_recibir(enviado, 10);
+    modelo_avanzar_us(60);
+    verificar(USART_TransferGetReceiveCountDMA(USART0, &manejador, &cuenta) == kStatus_Success && cuenta > previa &&
+                  cuenta < previa + 10U,
+              "cuenta dentro del buffer");
+    USART_TransferAbortReceiveDMA(USART0, &manejador);
+    modelo_avanzar_us(200);
+    verificar(USART_TransferGetReceiveCountDMA(USART0, &manejador, &cuenta) == kStatus_NoTransferInProgress,
+              "abortado");
+    xfer.dataSize = 4;
+    verificar(USART_TransferReceiveDMA(USART0, &manejador, &xfer) == kStatus_Success, "el canal queda libre");
+}
+
+/* Anillo: cada trama se copia a trama[] para verificarla y se libera si
+ * liberar esta en 1. */
+#define ANILLO 256U
+static uint8_t anillo[ANILLO];
+static uint8_t trama[ANILLO];
+static size_t trama_n, trama_inicio;
+static status_t trama_estado;
+static uint32_t desbordes_anillo;
+static int liberar;
+
+static void al_recibir_trama(USART_Type *base, usart_dma_handle_t *handle, size_t inicio, size_t largo,
+                             status_t estado, void *usuario) {
+    size_t i;
+
+    (void)usuario;
+    if (estado == kStatus_USART_RxRingBufferOverrun) {
+        desbordes_anillo++;
+        return;
+    }
+    for (i = 0; i < largo; i++) trama[i] = anillo[(inicio + i) % ANILLO];
+    trama_n = largo;
+    trama_inicio = inicio;
+    trama_estado = estado;
+    if (liberar) USART_TransferReleaseRingBufferDMA(base, handle, largo);
+    aviso_driver.cuenta++;
+}
+
+static void probar_anillo(void) {
+    static const uint16_t largos[] = {7, 60, 1, 128, 100, 200, 33, 255, 64, 129};
+    static uint8_t enviado[1024];
+    size_t total = 0, posicion = 0, i, j;
+    uint32_t tramas_bien = 0, irqs_usart, antes;
+
+    printf("RX en anillo de %u bytes\n", ANILLO);
+    for (i = 0; i < sizeof(largos) / sizeof(largos[0]); i++) total += largos[i];
+    for (j = 0; j < total; j++) enviado[j] = (uint8_t)(j * 31U + (j >> 8));
+
+    /* El anillo de fsl_usart.c, con una interrupcion por byte */
+    iniciar();
+    USART_TransferCreateHandle(USART0, &manejador_irq, al_terminar_irq, NULL);
+    USART_TransferStartRingBuffer(USART0, &manejador_irq, anillo, ANILLO);
+    modelo_usart_recibir(enviado, 200);
+    modelo_avanzar_us(200U * 11U + 200U);
+    irqs_usart = modelo_irqs(USART0_IRQn);
+    USART_TransferStopRingBuffer(USART0, &manejador_irq);
+
+    iniciar();
+    liberar = 1;
+    verificar(USART_TransferStartRingBufferDMA(USART0, &manejador, anillo, ANILLO, al_recibir_trama) ==
+                  kStatus_Success,
+              "arranca");
+    verificar(USART_TransferStartRingBufferDMA(USART0, &manejador, anillo, ANILLO, al_recibir_trama) ==
+                  kStatus_USART_RxBusy,
+              "el segundo espera");
+
+    for (i = 0, j = 0; i < sizeof(largos) / sizeof(largos[0]); j += largos[i], i++) {
+        antes = aviso_driver.cuenta;
+        modelo_usart_recibir(enviado + j, largos[i]);
+        sondear_us(largos[i] * 11U + 200U);
+        if (aviso_driver.cuenta == antes + 1U && trama_estado == kStatus_USART_RxIdleTimeout && trama_n == largos[i] &&
+            trama_inicio == posicion && memcmp(trama, enviado + j, trama_n) == 0)
+            tramas_bien++;
+        posicion = (posicion + largos[i]) % ANILLO;
+    }
+    verificar(tramas_bien == sizeof(largos) / sizeof(largos[0]), "cada trama en su lugar, tambien las que dan la vuelta");
+    verificar(USART_TransferGetRxRingBufferLengthDMA(USART0, &manejador) == 0U, "todo liberado");
+    printf("  interrupciones: %lu para 200 bytes con fsl_usart.c, %lu para %lu bytes con DMA\n",
+           (unsigned long)irqs_usart, (unsigned long)modelo_irqs(DMA0_IRQn), (unsigned long)total);
+    verificar(irqs_usart >= 200U && modelo_irqs(DMA0_IRQn) == total / (ANILLO / 2U) && modelo_irqs(USART0_IRQn) == 0U,
+              "una interrupcion por mitad del anillo");
+
+    /* Una trama a medias se ve en el largo pero todavia no se informa */
+    antes = aviso_driver.cuenta;
+    modelo_usart_recibir(enviado, 50);
+    modelo_avanzar(modelo_usart_ciclos_caracter() * 20U);
+    verificar(USART_TransferGetRxRingBufferLengthDMA(USART0, &manejador) == 20U && aviso_driver.cuenta == antes,
+              "largo de una trama a medias");
+    sondear_us(50U * 11U + 200U);
+    verificar(aviso_driver.cuenta == antes + 1U && trama_n == 50U, "y despues entera");
+
+    /* Sin liberar, la tercera trama de 100 ya no entra */
+    liberar = 0;
+    for (i = 0; i < 3U; i++) {
+        modelo_usart_recibir(enviado, 100);
+        sondear_us(100U * 11U + 200U);
+    }
+    verificar(desbordes_anillo == 1U && modelo_usart_desbordes() == 0U, "desborde del anillo informado");
+    USART_TransferReleaseRingBufferDMA(USART0, &manejador, USART_TransferGetRxRingBufferLengthDMA(USART0, &manejador));
+    liberar = 1;
+    antes = aviso_driver.cuenta;
+    modelo_usart_recibir(enviado + 100, 80);
+    sondear_us(80U * 11U + 200U);
+    verificar(aviso_driver.cuenta == antes + 1U && trama_n == 80U && memcmp(trama, enviado + 100, 80) == 0 &&
+                  USART_TransferGetRxRingBufferLengthDMA(USART0, &manejador) == 0U,
+              "despues sigue");
+
+    USART_TransferStopRingBufferDMA(USART0, &manejador);
+    verificar(USART_TransferGetReceiveCountDMA(USART0, &manejador, &antes) == kStatus_NoTransferInProgress,
+              "detenido");
+}
+
+int main(void) {
+    printf("%u baudios, reloj de %u MHz\n", BAUDIOS, RELOJ_HZ / 1000000U);
+    probar_tx();
+    probar_rx_simple();
+    probar_ping_pong();
+    probar_anillo();
+    return verificar_terminar();
+}
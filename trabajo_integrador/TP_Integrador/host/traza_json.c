@@ -0,0 +1,300 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Convierte un volcado de la traza del kernel (freertos/inc/tracerecorder.h)
+ * al formato JSON de Chrome (chrome://tracing, ui.perfetto.dev). El volcado
+ * es la estructura xTraceRecorder tal cual: la escribe tp_integrador_sim con
+ * -r, o se saca de la placa con el depurador. No usa el kernel: el formato se
+ * lee byte a byte, en little endian.
+ *
+ * - Cada tarea es un hilo del proceso "Tareas", con un tramo por cada vez que
+ *   corre; cada interrupcion instrumentada, un hilo del proceso
+ *   "Interrupciones".
+ * - Las operaciones de colas, semaforos y mutex, las notificaciones y las
+ *   esperas son eventos instantaneos en la tarea o interrupcion que las hace.
+ * - Los marcadores son contadores con el nombre de su canal.
+ *
+ * Al comenzar cada tramo se anota cuanto espero la tarea desde que quedo
+ * lista; el resumen en stderr da la peor espera de cada tarea y cuando fue,
+ * que es lo primero que hay que mirar ante un pico de latencia. */
+
+#define MAGICO 0x52545246UL
+#define VERSION 1U
+#define CABECERA 24U
+#define REGISTRO 8U
+
+#define OBJETO_TAREA 1U
+#define OBJETO_COLA 2U
+#define OBJETO_ISR 7U
+#define OBJETO_CANAL 8U
+
+enum {
+    EV_CAMBIO = 1,
+    EV_LISTA,
+    EV_DEMORA,
+    EV_ENVIO,
+    EV_ENVIO_FALLIDO,
+    EV_RECEPCION,
+    EV_RECEPCION_FALLIDA,
+    EV_LECTURA,
+    EV_BLOQUEO_ENVIO,
+    EV_BLOQUEO_RECEPCION,
+    EV_ENVIO_ISR,
+    EV_ENVIO_ISR_FALLIDO,
+    EV_RECEPCION_ISR,
+    EV_RECEPCION_ISR_FALLIDA,
+    EV_NOTIFICA,
+    EV_NOTIFICA_ISR,
+    EV_ESPERA_NOTIFICACION,
+    EV_ISR_ENTRA,
+    EV_ISR_SALE,
+    EV_MARCADOR,
+};
+
+static const char *const nombres_cola[] = {"envio", "envio fallido", "recepcion", "recepcion fallida", "lectura",
+                                           "bloqueo en envio", "bloqueo en recepcion", "envio desde isr",
+                                           "envio desde isr fallido", "recepcion desde isr",
+                                           "recepcion desde isr fallida"};
+
+static const char *const tipos_cola[] = {"Cola", "Mutex", "Semaforo", "Semaforo binario", "Mutex recursivo"};
+
+#define OBJETOS_MAX 256U
+
+typedef struct {
+    uint8_t tipo;
+    char nombre[40];
+    /* Solo tareas. */
+    int lista;
+    double lista_desde;
+    double espera_max;
+    double espera_max_en;
+    double corriendo;
+    unsigned long activaciones;
+} objeto_t;
+
+static objeto_t objetos[OBJETOS_MAX];
+static FILE *salida;
+static int primero = 1;
+
+static uint32_t le16(const uint8_t *p) { return (uint32_t)p[0] | (uint32_t)p[1] << 8; }
+static uint32_t le32(const uint8_t *p) { return le16(p) | le16(p + 2) << 16; }
+
+static uint8_t *leer_todo(FILE *entrada, size_t *largo) {
+    size_t capacidad = 1 << 16, leidos;
+    uint8_t *datos = malloc(capacidad);
+
+    *largo = 0;
+    while (datos != NULL && (leidos = fread(datos + *largo, 1, capacidad - *largo, entrada)) > 0) {
+        *largo += leidos;
+        if (*largo == capacidad) {
+            capacidad *= 2;
+            datos = realloc(datos, capacidad);
+        }
+    }
+    return datos;
+}
+
+static const char *nombre(unsigned id) { return id != 0 && objetos[id].tipo != 0 ? objetos[id].nombre : "?"; }
+
+static void evento(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void evento(const char *fmt, ...) {
+    va_list args;
+
+    fprintf(salida, "%s\n    ", primero ? "" : ",");
+    primero = 0;
+    va_start(args, fmt);
+    vfprintf(salida, fmt, args);
+    va_end(args);
+}
+
+/* pid y tid del contexto que hace una operacion. */
+static void contexto(unsigned isr, unsigned tarea, unsigned *pid, unsigned *tid) {
+    *pid = isr != 0 ? 2U : 1U;
+    *tid = isr != 0 ? isr : tarea;
+}
+
+int main(int argc, char *argv[]) {
+    FILE *entrada = stdin;
+    const uint8_t *p, *registros;
+    uint8_t *datos;
+    size_t largo, esperado;
+    uint32_t max_objetos, largo_nombre, hz, max_registros, escritos, n, primero_i, i, anterior = 0, leidos = 0;
+    unsigned long rechazados = 0;
+    unsigned corriendo = 0, isr = 0, pid, tid, id, ev, valor, k;
+    double t = 0, t0 = 0, espera;
+    uint64_t acumulado = 0;
+    int opt;
+
+    salida = stdout;
+    while ((opt = getopt(argc, argv, "o:h")) != -1) {
+        switch (opt) {
+            case 'o':
+                salida = fopen(optarg, "w");
+                if (salida == NULL) {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            default:
+                fprintf(stderr, "Uso: %s [-o archivo.json] [volcado]\n", argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind < argc) {
+        entrada = fopen(argv[optind], "rb");
+        if (entrada == NULL) {
+            perror(argv[optind]);
+            return 1;
+        }
+    }
+
+    datos = leer_todo(entrada, &largo);
+    if (datos == NULL || largo < CABECERA || le32(datos) != MAGICO || le16(datos + 4) != VERSION) {
+        fprintf(stderr, "[TRZ] no es un volcado de la traza (version %u)\n", VERSION);
+        return 1;
+    }
+    max_objetos = datos[6];
+    largo_nombre = datos[7];
+    hz = le32(datos + 8);
+    max_registros = le32(datos + 12);
+    escritos = le32(datos + 16);
+    esperado = CABECERA + (size_t)max_objetos * (1U + largo_nombre) + (size_t)max_registros * REGISTRO;
+    if (largo < esperado || hz == 0 || max_registros == 0) {
+        fprintf(stderr, "[TRZ] volcado incompleto: %lu bytes de %lu\n", (unsigned long)largo, (unsigned long)esperado);
+        return 1;
+    }
+
+    /* Tabla de objetos: el numero es la posicion mas uno. */
+    p = datos + CABECERA;
+    for (i = 0; i < max_objetos; i++, p += 1U + largo_nombre) {
+        objeto_t *o = &objetos[i + 1U];
+        size_t l = strnlen((const char *)p + 1, largo_nombre);
+
+        o->tipo = p[0];
+        if (l >= sizeof(o->nombre)) l = sizeof(o->nombre) - 1U;
+        memcpy(o->nombre, p + 1, l);
+        o->nombre[l] = '\0';
+        /* Las colas sin registrar se nombran por su tipo y numero. */
+        if (l == 0 && o->tipo >= OBJETO_COLA && o->tipo < OBJETO_COLA + 5U)
+            snprintf(o->nombre, sizeof(o->nombre), "%s %u", tipos_cola[o->tipo - OBJETO_COLA], (unsigned)(i + 1U));
+    }
+    registros = p;
+
+    fprintf(salida, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+    evento("{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"Tareas\"}}");
+    evento("{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 2, \"args\": {\"name\": \"Interrupciones\"}}");
+    for (k = 1; k <= max_objetos; k++) {
+        if (objetos[k].tipo == OBJETO_TAREA || objetos[k].tipo == OBJETO_ISR)
+            evento("{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %u, \"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+                   objetos[k].tipo == OBJETO_TAREA ? 1U : 2U, k, objetos[k].nombre);
+    }
+
+    /* El anillo se pisa desde el registro mas viejo. */
+    n = escritos < max_registros ? escritos : max_registros;
+    primero_i = escritos < max_registros ? 0U : escritos % max_registros;
+    for (i = 0; i < n; i++) {
+        p = registros + (size_t)((primero_i + i) % max_registros) * REGISTRO;
+        /* Un objeto que no esta en la tabla del volcado es un registro roto
+         * (volcado corrupto o cortado): se descarta entero, marca incluida. */
+        if (p[5] > max_objetos) {
+            rechazados++;
+            continue;
+        }
+        /* Las marcas de 32 bits dan la vuelta; entre dos registros seguidos
+         * nunca pasa una vuelta entera. */
+        if (leidos++ > 0) acumulado += (uint32_t)(le32(p) - anterior);
+        anterior = le32(p);
+        t = (double)acumulado * 1e6 / hz;
+        if (leidos == 1) t0 = t;
+        ev = p[4];
+        id = p[5];
+        valor = le16(p + 6);
+        contexto(isr, corriendo, &pid, &tid);
+
+        switch (ev) {
+            case EV_CAMBIO:
+                if (corriendo != 0) {
+                    evento("{\"ph\": \"E\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f}", corriendo, t);
+                    objetos[corriendo].corriendo += t;
+                }
+                corriendo = id;
+                objetos[id].activaciones++;
+                objetos[id].corriendo -= t;
+                espera = objetos[id].lista ? t - objetos[id].lista_desde : 0.0;
+                if (objetos[id].lista && espera > objetos[id].espera_max) {
+                    objetos[id].espera_max = espera;
+                    objetos[id].espera_max_en = t - t0;
+                }
+                evento("{\"name\": \"%s\", \"ph\": \"B\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, "
+                       "\"args\": {\"espera desde lista us\": %.3f}}",
+                       nombre(id), id, t, espera);
+                objetos[id].lista = 0;
+                break;
+            case EV_LISTA:
+                if (!objetos[id].lista && id != corriendo) {
+                    objetos[id].lista = 1;
+                    objetos[id].lista_desde = t;
+                }
+                break;
+            case EV_DEMORA:
+            case EV_ESPERA_NOTIFICACION:
+                evento("{\"name\": \"%s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f}",
+                       ev == EV_DEMORA ? "demora" : "espera notificacion", id, t);
+                break;
+            case EV_NOTIFICA:
+            case EV_NOTIFICA_ISR:
+                evento("{\"name\": \"notifica a %s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": %u, \"tid\": %u, "
+                       "\"ts\": %.3f}",
+                       nombre(id), pid, tid, t);
+                break;
+            case EV_ISR_ENTRA:
+                isr = id;
+                evento("{\"name\": \"%s\", \"ph\": \"B\", \"pid\": 2, \"tid\": %u, \"ts\": %.3f}", nombre(id), id, t);
+                break;
+            case EV_ISR_SALE:
+                isr = 0;
+                evento("{\"ph\": \"E\", \"pid\": 2, \"tid\": %u, \"ts\": %.3f}", id, t);
+                break;
+            case EV_MARCADOR:
+                evento("{\"name\": \"%s\", \"ph\": \"C\", \"pid\": 1, \"ts\": %.3f, \"args\": {\"valor\": %u}}",
+                       nombre(id), t, valor);
+                break;
+            default:
+                if (ev >= EV_ENVIO && ev <= EV_RECEPCION_ISR_FALLIDA) {
+                    evento("{\"name\": \"%s %s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": %u, \"tid\": %u, "
+                           "\"ts\": %.3f, \"args\": {\"items\": %u}}",
+                           nombres_cola[ev - EV_ENVIO], nombre(id), pid, tid, t, valor);
+                }
+                break;
+        }
+    }
+    if (corriendo != 0) {
+        evento("{\"ph\": \"E\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f}", corriendo, t);
+        objetos[corriendo].corriendo += t;
+    }
+    fprintf(salida, "\n]}\n");
+
+    fprintf(stderr, "[TRZ] %lu registros de %lu escritos (%lu pisados) | %.3f ms\n", (unsigned long)n,
+            (unsigned long)escritos, (unsigned long)(escritos - n), (t - t0) / 1000.0);
+    if (rechazados > 0) {
+        fprintf(stderr, "[TRZ] %lu registros descartados: objeto fuera de la tabla de %lu\n", rechazados,
+                (unsigned long)max_objetos);
+    }
+    fprintf(stderr, "[TRZ]   %-15s %12s %12s %18s %14s\n", "tarea", "activaciones", "corriendo", "peor espera lista",
+            "en");
+    for (k = 1; k <= max_objetos; k++) {
+        if (objetos[k].tipo != OBJETO_TAREA || objetos[k].activaciones == 0) continue;
+        fprintf(stderr, "[TRZ]   %-15s %12lu %9.3f ms %15.3f us %11.3f ms\n", objetos[k].nombre,
+                objetos[k].activaciones, objetos[k].corriendo / 1000.0, objetos[k].espera_max,
+                objetos[k].espera_max_en / 1000.0);
+    }
+
+    free(datos);
+    if (salida != stdout) fclose(salida);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tracerecorder.h"
+#include "latencia.h"
+
+#ifndef FREERTOS_PORT_POSIX
+#include "fsl_device_registers.h"
+#endif
+
+static latencia_stats_t stats = { .min_us = UINT32_MAX };
+static UBaseType_t traza_latencia;
+
+uint32_t latencia_ahora_us(void) {
+#ifdef FREERTOS_PORT_POSIX
+    return xTaskGetTickCount() * portTICK_PERIOD_MS * 1000U;
+#else
+    TickType_t ticks;
+    uint32_t transcurrido;
+
+    /* Se relee el tick por si el SysTick recargo entre las dos lecturas. */
+    do {
+        ticks = xTaskGetTickCount();
+        transcurrido = SysTick->LOAD - SysTick->VAL;
+    } while (ticks != xTaskGetTickCount());
+
+    return ticks * portTICK_PERIOD_MS * 1000U + transcurrido / (SystemCoreClock / 1000000U);
+#endif
+}
+
+void latencia_registrar(uint32_t desde_us) {
+    uint32_t latencia = latencia_ahora_us() - desde_us;
+    uint32_t cubeta = latencia / 1000U;
+
+    if (cubeta >= LATENCIA_CUBETAS) cubeta = LATENCIA_CUBETAS - 1;
+
+    /* Cada muestra va tambien a la traza, para ubicar los picos en la linea
+     * de tiempo. */
+    if (traza_latencia == 0) traza_latencia = uxTraceRecorderRegister(traceOBJECT_CHANNEL, "Latencia us");
+    vTraceRecorderMarker(traza_latencia, latencia > UINT16_MAX ? UINT16_MAX : (uint16_t)latencia);
+
+    taskENTER_CRITICAL();
+    stats.cubetas[cubeta]++;
+    stats.muestras++;
+    stats.suma_us += latencia;
+    if (latencia < stats.min_us) stats.min_us = latencia;
+    if (latencia > stats.max_us) stats.max_us = latencia;
+    taskEXIT_CRITICAL();
+}
+
+void latencia_obtener(latencia_stats_t *copia) {
+    taskENTER_CRITICAL();
+    *copia = stats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,28 @@
+#ifndef LATENCIA_H
+#define LATENCIA_H
+
+#include <stdint.h>
+
+/* Histograma de la latencia sensor -> actuador, en cubetas de 1 ms. La ultima
+ * cubeta acumula todo lo que supera LATENCIA_CUBETAS - 1 ms. */
+#define LATENCIA_CUBETAS 16
+
+typedef struct {
+    uint32_t cubetas[LATENCIA_CUBETAS];
+    uint32_t muestras;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t suma_us;
+} latencia_stats_t;
+
+/* Marca de tiempo en microsegundos. En la placa combina el tick con la cuenta
+ * del SysTick; en el simulador de host tiene resolucion de un tick. */
+uint32_t latencia_ahora_us(void);
+
+/* Registra una muestra: la latencia es el tiempo desde la marca "desde_us". */
+void latencia_registrar(uint32_t desde_us);
+
+/* Copia consistente de las estadisticas acumuladas. */
+void latencia_obtener(latencia_stats_t *stats);
+
+#endif /* LATENCIA_H */
@@ -1,17 +1,15 @@
 #include "FreeRTOS.h"
 #include "task.h"
-#include "queue.h"
-#include "drivers_simulados.c"
-
-QueueHandle_t cola_lux;
-QueueHandle_t cola_setpoint;
-QueueHandle_t cola_pwm;
-
-extern void tarea_sensor_luz(void *);
-extern void tarea_setpoint(void *);
-extern void tarea_display(void *);
-extern void tarea_led_pwm(void *);
-extern void tarea_uart_debug(void *);
+#include "board.h"
+#include "pin_mux.h"
+#include "clock_config.h"
+#include "peripherals.h"
+#include "fsl_component_mem_manager.h"
+#include "tareas.h"
+#include "telemetria.h"
+#include "botones.h"
+#include "tickless.h"
+#include "tracerecorder.h"
 
 int main(void) {
     BOARD_InitBootPins();
@@ -19,15 +17,17 @@ int main(void) {
     BOARD_InitBootPeripherals();
     BOARD_InitDebugConsole();
 
-    cola_lux = xQueueCreate(1, sizeof(float));
-    cola_setpoint = xQueueCreate(1, sizeof(float));
-    cola_pwm = xQueueCreate(1, sizeof(float));
+    /* Registro de pools del mem_manager (mem_manager_pools.c); tareas_crear()
+     * agrega los de la aplicacion. */
+    MEM_Init();
+    telemetria_puerto_iniciar();
+    tareas_crear();
+    botones_iniciar();
+    tickless_wkt_iniciar();
 
-    xTaskCreate(tarea_sensor_luz, "SensorLuz", 128, NULL, 2, NULL);
-    xTaskCreate(tarea_setpoint, "Setpoint", 128, NULL, 2, NULL);
-    xTaskCreate(tarea_display, "Display", 128, NULL, 1, NULL);
-    xTaskCreate(tarea_led_pwm, "LedPWM", 128, NULL, 2, NULL);
-    xTaskCreate(tarea_uart_debug, "UART", 256, NULL, 1, NULL);
+    /* La traza queda grabando siempre: ante un problema se vuelca
+     * xTraceRecorder con el depurador (ver README). */
+    vTraceRecorderStart();
 
     vTaskStartScheduler();
     while (1) {}
@@ -8,6 +8,8 @@
 #define _MCUX_CONFIG_H_
 
 #define CONFIG_FLASH_BASE_ADDRESS 0x0
+/* mem_manager legacy, implementado sobre mempool.h en mem_manager_pools.c */
+#define gMemManagerLight 0
 // #define CONFIG_STREAM_FLASH 0
 // #define LIB_JPEG_USE_HW_ACCEL 0
 // #define USE_PNGDEC_DRIVER 0
@@ -0,0 +1,273 @@
+#include <stdbool.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_manager_pools.h"
+
+/* Backend del componente mem_manager del SDK sobre los pools de bloques fijos
+ * (mempool.h), en lugar de fsl_component_mem_manager.c: un pedido recibe un
+ * bloque del pool mas chico en el que entra, y si ese esta vacio, de uno mas
+ * grande. Reservar y liberar son O(1) por pool y se pueden llamar desde
+ * interrupciones, que es donde los componentes suelen hacerlo.
+ *
+ * Como en el mem_manager del SDK, cada pool tiene un id y un pedido solo se
+ * sirve de los pools con su id; MEM_BufferAlloc() pide al id 0. Los bloques
+ * salen en cero, como los del SDK.
+ *
+ * Implementa la API legacy entera (gMemManagerLight=0). El modo light, con
+ * areas en lugar de pools, y MEM_Trace() no tienen equivalente y cortan el
+ * build. */
+
+#if defined(gMemManagerLight) && (gMemManagerLight != 0)
+#error "mem_manager_pools.c implementa la API legacy del mem_manager: compilar con gMemManagerLight=0"
+#endif
+#if defined(MEM_MANAGER_ENABLE_TRACE) && (MEM_MANAGER_ENABLE_TRACE > 0U)
+#error "mem_manager_pools.c no implementa MEM_Trace(): las cuentas de cada pool estan en vMemPoolGetStats()"
+#endif
+
+typedef struct {
+    MemPoolHandle_t pool;
+    size_t tamano;
+    UBaseType_t cantidad;
+    uint8_t *datos;
+    StaticMemPool_t *bloque;
+    uint8_t id;
+} pool_mem_t;
+
+/* Ordenados de menor a mayor bloque; con el mismo tamano, en el orden en que
+ * se agregaron. Solo cambia con las interrupciones enmascaradas, asi que una
+ * interrupcion que reserva nunca lo ve a medio mover. */
+static pool_mem_t pools[MEM_POOLS_MAX];
+static UBaseType_t cantidad_pools;
+static bool iniciado;
+
+/* Estructuras de los pools de MEM_AddBuffer(), que solo trae los bloques. */
+static StaticMemPool_t bloques_sdk[MEM_POOLS_MAX];
+
+static pool_mem_t *pool_de(const void *buffer) {
+    UBaseType_t i;
+
+    for (i = 0; i < cantidad_pools; i++) {
+        if (xMemPoolOwns(pools[i].pool, buffer)) return &pools[i];
+    }
+    return NULL;
+}
+
+static MemPoolHandle_t registrar(size_t tamano, UBaseType_t cantidad, uint8_t *datos, StaticMemPool_t *bloque,
+                                 uint8_t id) {
+    MemPoolHandle_t pool = NULL;
+    UBaseType_t mascara, i;
+
+    /* Como en el SDK, MEM_Init() va antes que cualquier pool. */
+    configASSERT(iniciado);
+
+    mascara = taskENTER_CRITICAL_FROM_ISR();
+    if (cantidad_pools < MEM_POOLS_MAX) {
+        pool = xMemPoolCreateStatic(tamano, cantidad, datos, bloque);
+        for (i = cantidad_pools; i > 0U && pools[i - 1U].tamano > tamano; i--) {
+            pools[i] = pools[i - 1U];
+        }
+        pools[i] = (pool_mem_t){pool, tamano, cantidad, datos, bloque, id};
+        cantidad_pools++;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mascara);
+    return pool;
+}
+
+/* Primer byte alineado del buffer de un mem_config_t (ver MEM_AddBuffer()) */
+static uint8_t *datos_alineados(const mem_config_t *config) {
+    uintptr_t inicio = (uintptr_t)config->pbuffer;
+
+    return (uint8_t *)((inicio + portBYTE_ALIGNMENT_MASK) & ~(uintptr_t)portBYTE_ALIGNMENT_MASK);
+}
+
+static uint32_t sumar_libres(bool minimo) {
+    MemPoolStats_t stats;
+    uint32_t libre = 0;
+    UBaseType_t i;
+
+    for (i = 0; i < cantidad_pools; i++) {
+        vMemPoolGetStats(pools[i].pool, &stats);
+        libre += (uint32_t)(minimo ? stats.uxMinimumEverFree : stats.uxFree) * stats.xBlockSize;
+    }
+    return libre;
+}
+
+mem_status_t MEM_Init(void) {
+    /* Los pools vienen de tareas.c y de los componentes; no hay lista propia
+     * como PoolsDetails_c. */
+    iniciado = true;
+    return kStatus_MemSuccess;
+}
+
+MemPoolHandle_t mem_pools_crear(size_t tamano, UBaseType_t cantidad, uint8_t *datos, StaticMemPool_t *bloque,
+                                uint8_t id) {
+    MemPoolHandle_t pool = registrar(tamano, cantidad, datos, bloque, id);
+
+    configASSERT(pool);
+    return pool;
+}
+
+/* El buffer de MEM_BLOCK_BUFFER_DEFINE() es un mem_config_t que apunta a
+ * palabras para la cabecera del SDK (MEM_POOL_SIZE) y la de cada bloque
+ * (MEM_BLOCK_SIZE). Aca no hay cabeceras: esos bytes alcanzan para alinear
+ * los bloques a portBYTE_ALIGNMENT. */
+mem_status_t MEM_AddBuffer(const uint8_t *buffer) {
+    const mem_config_t *config = (const mem_config_t *)(const void *)buffer;
+    uint8_t *datos = datos_alineados(config);
+    size_t disponible = MEM_POOL_SIZE + (size_t)config->numberOfBlocks * (MEM_BLOCK_SIZE + config->blockSize) -
+                        (size_t)(datos - config->pbuffer);
+    StaticMemPool_t *bloque = NULL;
+    UBaseType_t i, j;
+
+    if (config->blockSize == 0U || config->numberOfBlocks == 0U) return kStatus_MemInitError;
+    if (mempoolSTORAGE_SIZE(config->blockSize, config->numberOfBlocks) > disponible) return kStatus_MemInitError;
+
+    /* Una estructura que no use ningun pool registrado */
+    for (i = 0; i < MEM_POOLS_MAX && bloque == NULL; i++) {
+        bloque = &bloques_sdk[i];
+        for (j = 0; j < cantidad_pools; j++) {
+            if (pools[j].bloque == bloque) bloque = NULL;
+        }
+    }
+    if (bloque == NULL) return kStatus_MemInitError;
+
+    if (registrar(config->blockSize, config->numberOfBlocks, datos, bloque, (uint8_t)config->poolId) == NULL) {
+        return kStatus_MemInitError;
+    }
+    return kStatus_MemSuccess;
+}
+
+#if (defined(MEM_MANAGER_BUFFER_REMOVE) && (MEM_MANAGER_BUFFER_REMOVE > 0U))
+/* Solo sale un pool sin bloques reservados. */
+mem_status_t MEM_RemoveBuffer(uint8_t *buffer) {
+    uint8_t *datos = datos_alineados((const mem_config_t *)(void *)buffer);
+    mem_status_t estado = kStatus_MemUnknownError;
+    MemPoolStats_t stats;
+    UBaseType_t mascara, i;
+
+    mascara = taskENTER_CRITICAL_FROM_ISR();
+    for (i = 0; i < cantidad_pools; i++) {
+        if (pools[i].datos != datos) continue;
+        vMemPoolGetStats(pools[i].pool, &stats);
+        if (stats.uxFree != stats.uxBlocks) break;
+        for (cantidad_pools--; i < cantidad_pools; i++) {
+            pools[i] = pools[i + 1U];
+        }
+        estado = kStatus_MemSuccess;
+        break;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mascara);
+    return estado;
+}
+#endif /* MEM_MANAGER_BUFFER_REMOVE */
+
+/* Sin saber desde que contexto se llama, se usan las variantes FromISR, que
+ * tambien valen desde una tarea. */
+void *MEM_BufferAllocWithId(uint32_t numBytes, uint8_t poolId) {
+    void *buffer;
+    UBaseType_t i;
+
+    if (numBytes == 0U) return NULL;
+    for (i = 0; i < cantidad_pools; i++) {
+        if (pools[i].id != poolId || pools[i].tamano < numBytes) continue;
+        buffer = pvMemPoolAllocFromISR(pools[i].pool);
+        if (buffer != NULL) {
+            memset(buffer, 0, pools[i].tamano);
+            return buffer;
+        }
+    }
+    return NULL;
+}
+
+mem_status_t MEM_BufferFree(void *buffer) {
+    pool_mem_t *p = pool_de(buffer);
+
+    if (p == NULL) return kStatus_MemFreeError;
+    vMemPoolFreeFromISR(p->pool, buffer);
+    return kStatus_MemSuccess;
+}
+
+uint16_t MEM_BufferGetSize(void *buffer) {
+    pool_mem_t *p = pool_de(buffer);
+
+    return p == NULL ? 0U : (uint16_t)p->tamano;
+}
+
+/* Como en el SDK, los bloques de esos pools vuelven todos de una vez: lo que
+ * tuviera un puntero a uno de ellos ya no debe usarlo. */
+mem_status_t MEM_BufferFreeAllWithId(uint8_t poolId) {
+    UBaseType_t mascara, i;
+
+    mascara = taskENTER_CRITICAL_FROM_ISR();
+    for (i = 0; i < cantidad_pools; i++) {
+        if (pools[i].id != poolId) continue;
+        pools[i].pool = xMemPoolCreateStatic(pools[i].tamano, pools[i].cantidad, pools[i].datos, pools[i].bloque);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mascara);
+    return kStatus_MemSuccess;
+}
+
+/* Igual que el SDK: con tamano 0 libera, sin buffer reserva del id 0, y si
+ * el bloque no alcanza copia a uno mas grande. */
+void *MEM_BufferRealloc(void *buffer, uint32_t new_size) {
+    uint16_t tamano;
+    void *nuevo;
+
+    if (new_size == 0U) {
+        (void)MEM_BufferFree(buffer);
+        return NULL;
+    }
+    if (buffer == NULL) return MEM_BufferAllocWithId(new_size, 0U);
+
+    tamano = MEM_BufferGetSize(buffer);
+    if (new_size <= tamano) return buffer;
+
+    nuevo = MEM_BufferAllocWithId(new_size, 0U);
+    if (nuevo != NULL) {
+        memcpy(nuevo, buffer, tamano);
+        (void)MEM_BufferFree(buffer);
+    }
+    return nuevo;
+}
+
+/* El buffer tiene que ser un bloque reservado y size caber en el. */
+mem_status_t MEM_BufferCheck(void *buffer, uint32_t size) {
+    pool_mem_t *p = pool_de(buffer);
+
+    if (p == NULL) return kStatus_MemUnknownError;
+    return size > p->tamano ? kStatus_MemOverFlowError : kStatus_MemSuccess;
+}
+
+/* No hay un heap que crezca, como en el mem_manager legacy. */
+uint32_t MEM_GetHeapUpperLimit(void) {
+    return 0U;
+}
+
+/* Bytes en bloques libres de todos los pools, ahora y en el peor momento.
+ * mempool.c lleva el minimo desde que se crea el pool, asi que los Reset
+ * solo lo informan. El mem_manager legacy no tiene areas: el area 0 es todo
+ * y las demas estan vacias. */
+uint32_t MEM_GetFreeHeapSize(void) {
+    return sumar_libres(false);
+}
+
+uint32_t MEM_GetFreeHeapSizeByAreaId(uint8_t area_id) {
+    return area_id == 0U ? sumar_libres(false) : 0U;
+}
+
+uint32_t MEM_GetFreeHeapSizeLowWaterMark(void) {
+    return sumar_libres(true);
+}
+
+uint32_t MEM_GetFreeHeapSizeLowWaterMarkByAreaId(uint8_t area_id) {
+    return area_id == 0U ? sumar_libres(true) : 0U;
+}
+
+uint32_t MEM_ResetFreeHeapSizeLowWaterMark(void) {
+    return sumar_libres(true);
+}
+
+uint32_t MEM_ResetFreeHeapSizeLowWaterMarkByAreaId(uint8_t area_id) {
+    return area_id == 0U ? sumar_libres(true) : 0U;
+}
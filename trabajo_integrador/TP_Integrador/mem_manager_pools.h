@@ -0,0 +1,25 @@
+#ifndef MEM_MANAGER_POOLS_H
+#define MEM_MANAGER_POOLS_H
+
+#include "FreeRTOS.h"
+#include "mempool.h"
+#include "fsl_component_mem_manager.h"
+
+/* Backend del mem_manager del SDK sobre mempool.h (mem_manager_pools.c). Se
+ * compila con gMemManagerLight=0: es la API legacy, con pools por tamano e
+ * id. */
+
+/* Pools que entran en el registro, contando los de MEM_AddBuffer(). */
+#ifndef MEM_POOLS_MAX
+#define MEM_POOLS_MAX 4U
+#endif
+
+/* Crea un pool como xMemPoolCreateStatic() y lo registra con el id dado:
+ * desde ahi MEM_BufferAllocWithId() reparte sus bloques y MEM_BufferFree()
+ * los devuelve. Es la entrada de los pools de la tabla de tareas.c, que tienen
+ * nombre en el reporte de RAM; los componentes del SDK agregan los suyos con
+ * MEM_AddBuffer(). Va despues de MEM_Init(). */
+MemPoolHandle_t mem_pools_crear(size_t tamano, UBaseType_t cantidad, uint8_t *datos, StaticMemPool_t *bloque,
+                                uint8_t id);
+
+#endif /* MEM_MANAGER_POOLS_H */
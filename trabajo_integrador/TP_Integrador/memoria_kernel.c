@@ -0,0 +1,39 @@
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Memoria de las tareas propias del kernel y hook de desborde de pila. Con
+ * configSUPPORT_STATIC_ALLOCATION el kernel pide la memoria a la aplicacion en
+ * lugar de tomarla del heap, para la tarea idle y la de los temporizadores.
+ * La usan la aplicacion (placa y simulador) y los benchmarks del host. */
+
+static StackType_t pila_idle[configMINIMAL_STACK_SIZE];
+static StaticTask_t tcb_idle;
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize) {
+    *ppxIdleTaskTCBBuffer = &tcb_idle;
+    *ppxIdleTaskStackBuffer = pila_idle;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+static StackType_t pila_timers[configTIMER_TASK_STACK_DEPTH];
+static StaticTask_t tcb_timers;
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize) {
+    *ppxTimerTaskTCBBuffer = &tcb_timers;
+    *ppxTimerTaskStackBuffer = pila_timers;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+/* configCHECK_FOR_STACK_OVERFLOW 2: el kernel revisa el final de la pila en
+ * cada cambio de contexto. No hay forma segura de informarlo (la telemetria
+ * depende de otra tarea), asi que se detiene como un configASSERT; el nombre
+ * de la tarea queda en pcTaskName para el depurador. */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
+    (void)xTask;
+    (void)pcTaskName;
+    configASSERT(0);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "mailbox.h"
+#include "telemetria.h"
+#include "periodica.h"
+#include "tareas.h"
+
+/* Una vez por periodo (temporizador de tareas.c) toma una foto del sistema: % de CPU
+ * de cada tarea en el ultimo periodo (run-time stats), minimo de pila libre
+ * desde el arranque, vencimientos perdidos y jitter de las tareas periodicas,
+ * y heap libre. La publica en buzon_monitor y la tarea UART la envia como
+ * trama de telemetria. Corre en la tarea de los temporizadores del kernel,
+ * que aparece en el reporte como "Tmr Svc". */
+
+static uint16_t saturar16(uint32_t valor) {
+    return valor > 0xFFFF ? 0xFFFF : (uint16_t)valor;
+}
+
+static TaskStatus_t estado[TELEMETRIA_TAREAS_MAX];
+static configRUN_TIME_COUNTER_TYPE tiempo_anterior[TELEMETRIA_TAREAS_MAX];
+static configRUN_TIME_COUNTER_TYPE total_anterior;
+static telemetria_monitor_t reporte;
+
+void monitor_reportar(TimerHandle_t temporizador) {
+    configRUN_TIME_COUNTER_TYPE total, milesima;
+    periodica_t otra;
+    telemetria_tarea_t *t;
+    UBaseType_t n, i, j, c;
+
+    /* Devuelve 0 si hay mas tareas que lugares en "estado". */
+    n = uxTaskGetSystemState(estado, TELEMETRIA_TAREAS_MAX, &total);
+    milesima = (total - total_anterior) / 1000;
+    total_anterior = total;
+
+    /* Las tareas nunca se borran y se numeran desde 1 al crearse, asi que el
+     * numero sirve de indice y el reporte sale siempre en el mismo orden. */
+    reporte.n = 0;
+    for (i = 0; i < n; i++) {
+        j = estado[i].xTaskNumber - 1;
+        if (j >= TELEMETRIA_TAREAS_MAX) continue;
+        if (j >= reporte.n) reporte.n = (uint8_t)(j + 1);
+
+        t = &reporte.tareas[j];
+        for (c = 0; c < TELEMETRIA_NOMBRE && estado[i].pcTaskName[c] != '\0'; c++) {
+            t->nombre[c] = estado[i].pcTaskName[c];
+        }
+        t->nombre[c] = '\0';
+        t->prioridad = (uint8_t)estado[i].uxCurrentPriority;
+        t->pila_libre = estado[i].usStackHighWaterMark;
+        t->cpu_decimas = milesima ? (uint16_t)((estado[i].ulRunTimeCounter - tiempo_anterior[j]) / milesima) : 0;
+        tiempo_anterior[j] = estado[i].ulRunTimeCounter;
+
+        if (periodica_obtener(estado[i].xHandle, &otra)) {
+            t->periodo_ms = saturar16(otra.periodo * portTICK_PERIOD_MS);
+            t->perdidos = saturar16(otra.perdidos);
+            t->jitter_max_us = saturar16(otra.jitter_max_us);
+            t->jitter_medio_us = otra.activaciones ? saturar16(otra.jitter_suma_us / otra.activaciones) : 0;
+        } else {
+            t->periodo_ms = 0;
+            t->perdidos = 0;
+            t->jitter_max_us = 0;
+            t->jitter_medio_us = 0;
+        }
+    }
+
+    /* El vencimiento ya avanzo al proximo periodo. */
+    reporte.tiempo_ms = (xTimerGetExpiryTime(temporizador) - xTimerGetPeriod(temporizador)) * portTICK_PERIOD_MS;
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    reporte.heap_libre = xPortGetFreeHeapSize();
+#else
+    reporte.heap_libre = TELEMETRIA_SIN_HEAP;
+#endif
+
+    vMailboxPublish(buzon_monitor, &reporte);
+    xTaskNotifyGive(handle_uart_debug);
+}
@@ -0,0 +1,61 @@
+#include "periodica.h"
+#include "latencia.h"
+
+static periodica_t *registro[PERIODICA_MAX];
+static UBaseType_t registradas;
+
+void periodica_iniciar(periodica_t *p, TickType_t periodo) {
+    configASSERT(periodo > 0);
+
+    p->tarea = xTaskGetCurrentTaskHandle();
+    p->periodo = periodo;
+    p->activacion = xTaskGetTickCount();
+    p->activaciones = 0;
+    p->perdidos = 0;
+    p->jitter_max_us = 0;
+    p->jitter_suma_us = 0;
+
+    taskENTER_CRITICAL();
+    configASSERT(registradas < PERIODICA_MAX);
+    registro[registradas++] = p;
+    taskEXIT_CRITICAL();
+}
+
+void periodica_esperar(periodica_t *p) {
+    TickType_t transcurrido = xTaskGetTickCount() - p->activacion;
+    uint32_t jitter;
+
+    if (transcurrido > p->periodo) {
+        /* Se corre solo la ultima activacion vencida. La division es rara:
+         * solo cuando ya se perdio un vencimiento. */
+        p->perdidos++;
+        p->activacion += (transcurrido / p->periodo - 1) * p->periodo;
+    }
+
+    vTaskDelayUntil(&p->activacion, p->periodo);
+
+    /* La marca de tiempo de latencia.c combina el tick con el SysTick, asi
+     * que en la placa el jitter se mide por debajo del tick. */
+    jitter = latencia_ahora_us() - p->activacion * portTICK_PERIOD_MS * 1000U;
+
+    taskENTER_CRITICAL();
+    p->activaciones++;
+    p->jitter_suma_us += jitter;
+    if (jitter > p->jitter_max_us) p->jitter_max_us = jitter;
+    taskEXIT_CRITICAL();
+}
+
+bool periodica_obtener(TaskHandle_t tarea, periodica_t *copia) {
+    UBaseType_t i;
+    bool encontrada = false;
+
+    taskENTER_CRITICAL();
+    for (i = 0; i < registradas && !encontrada; i++) {
+        if (registro[i]->tarea == tarea) {
+            *copia = *registro[i];
+            encontrada = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return encontrada;
+}
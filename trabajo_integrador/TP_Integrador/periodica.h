@@ -0,0 +1,44 @@
+#ifndef PERIODICA_H
+#define PERIODICA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Activacion periodica sobre vTaskDelayUntil, para las tareas que muestrean o
+ * refrescan a ritmo fijo. Las activaciones caen siempre sobre la grilla
+ * inicio + k * periodo, sin importar cuanto tarde cada trabajo, y el
+ * vencimiento de cada trabajo es la activacion siguiente (rate monotonic: las
+ * prioridades de tareas.c van de menor periodo a mayor prioridad).
+ *
+ * Por tarea se cuentan los vencimientos perdidos y el jitter de activacion:
+ * cuanto despues de la activacion ideal arranca el trabajo, en us. */
+
+#define PERIODICA_MAX 8
+
+typedef struct {
+    TaskHandle_t tarea;
+    TickType_t periodo;
+    TickType_t activacion;   /* activacion ideal del trabajo en curso */
+    uint32_t activaciones;
+    uint32_t perdidos;       /* trabajos que terminaron despues de su vencimiento */
+    uint32_t jitter_max_us;
+    uint64_t jitter_suma_us;
+} periodica_t;
+
+/* Registra a la tarea que llama con el periodo dado. El primer trabajo
+ * arranca enseguida. */
+void periodica_iniciar(periodica_t *p, TickType_t periodo);
+
+/* Termina el trabajo del periodo y bloquea hasta la proxima activacion. Si el
+ * trabajo se paso de su vencimiento, el siguiente arranca enseguida; si se
+ * paso mas de un periodo entero, las activaciones vencidas se saltean en
+ * lugar de correrlas en rafaga. */
+void periodica_esperar(periodica_t *p);
+
+/* Copia consistente de las estadisticas de una tarea. Devuelve false si la
+ * tarea no es periodica. */
+bool periodica_obtener(TaskHandle_t tarea, periodica_t *copia);
+
+#endif /* PERIODICA_H */
@@ -0,0 +1,39 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mailbox.h"
+#include "control_pi.h"
+#include "telemetria.h"
+#include "tareas.h"
+
+/* Periodo de muestreo: el del sensor (200 ms). ki ya lo incluye. */
+#define CONTROL_KP CONTROL_PI_GANANCIA(0.5)
+#define CONTROL_KI CONTROL_PI_GANANCIA(0.25)
+
+void tarea_control(void *pvParameters) {
+    control_pi_t pi;
+    uint32_t marca = 0;
+    int16_t luz = 0, setpoint = 0, salida;
+    telemetria_muestra_t muestra;
+
+    (void)pvParameters;
+    control_pi_iniciar(&pi, CONTROL_KP, CONTROL_KI, 0, CONTROL_PI_Q15(1.0));
+
+    for (;;) {
+        /* Un paso del PI por cada muestra nueva de luz. */
+        xTaskNotifyWait(0, 0, &marca, portMAX_DELAY);
+        xMailboxPeek(buzon_lux, &luz);
+        xMailboxPeek(buzon_setpoint, &setpoint);
+        salida = control_pi_paso(&pi, setpoint, luz);
+        vMailboxPublish(buzon_pwm, &salida);
+        xTaskNotify(handle_led_pwm, marca, eSetValueWithOverwrite);
+        /* La muestra ya esta en buzon_lux: el display la muestra. */
+        xTaskNotify(handle_display, DISPLAY_DATO, eSetBits);
+
+        /* Cada paso del lazo es una muestra de telemetria. */
+        muestra.tiempo_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        muestra.luz = luz;
+        muestra.setpoint = setpoint;
+        muestra.pwm = salida;
+        if (telemetria_registrar(&muestra)) xTaskNotifyGive(handle_uart_debug);
+    }
+}
\ No newline at end of file
@@ -1,28 +1,40 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "mailbox.h"
+#include "botones.h"
 #include "drivers_simulados.h"
+#include "escalas.h"
+#include "tareas.h"
 
-extern QueueHandle_t cola_lux;
-extern QueueHandle_t cola_setpoint;
-
+/* Sin periodo: el display se refresca cuando control o setpoint publican un
+ * valor nuevo (DISPLAY_DATO) o cuando USER deja un evento en cola_display
+ * (DISPLAY_BOTON), asi que muestra el ultimo dato apenas llega, cambia de
+ * valor apenas se pulsa USER y no despierta al sistema si nada cambia. */
 void tarea_display(void *pvParameters) {
     static bool mostrar_luz = true;
-    float valor = 0;
+    boton_evento_t evento;
+    uint32_t avisos = DISPLAY_DATO;
+    int16_t valor = 0;
+
+    (void)pvParameters;
 
     for (;;) {
-        if (BotonPresionado(BOTON_USER)) {
-            mostrar_luz = !mostrar_luz;
-            vTaskDelay(pdMS_TO_TICKS(300));
+        /* Un aviso puede juntar varios eventos de USER: se toman todos los que
+         * estan en la cola. */
+        if ((avisos & DISPLAY_BOTON) != 0U) {
+            while (xQueueReceive(cola_display, &evento, 0) == pdPASS) {
+                mostrar_luz = !mostrar_luz;
+            }
         }
 
         if (mostrar_luz) {
-            xQueuePeek(cola_lux, &valor, 0);
+            xMailboxPeek(buzon_lux, &valor);
         } else {
-            xQueuePeek(cola_setpoint, &valor, 0);
+            xMailboxPeek(buzon_setpoint, &valor);
         }
 
-        Display7Segmentos_Mostrar((int)valor);
-        vTaskDelay(pdMS_TO_TICKS(250));
+        Display7Segmentos_Mostrar(Q15_A_PORCENTAJE(valor));
+        xTaskNotifyWait(0, UINT32_MAX, &avisos, portMAX_DELAY);
     }
-}
\ No newline at end of file
+}
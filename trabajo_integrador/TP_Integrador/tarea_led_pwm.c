@@ -1,19 +1,18 @@
 #include "FreeRTOS.h"
 #include "task.h"
-#include "queue.h"
+#include "mailbox.h"
 #include "drivers_simulados.h"
-
-extern QueueHandle_t cola_pwm;
+#include "latencia.h"
+#include "tareas.h"
 
 void tarea_led_pwm(void *pvParameters) {
-    uint16_t adc_val = 0;
-    float porcentaje = 0;
+    uint32_t marca = 0;
+    int16_t duty = 0;
 
     for (;;) {
-        adc_val = LeerADC();
-        porcentaje = (adc_val * 100.0) / 4095.0;
-        PWM_SetDutyCycle(porcentaje);
-        xQueueOverwrite(cola_pwm, &porcentaje);
-        vTaskDelay(pdMS_TO_TICKS(200));
+        xTaskNotifyWait(0, 0, &marca, portMAX_DELAY);
+        xMailboxPeek(buzon_pwm, &duty);
+        PWM_SetDutyCycle(duty);
+        latencia_registrar(marca);
     }
 }
\ No newline at end of file
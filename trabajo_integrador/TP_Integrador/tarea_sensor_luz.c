@@ -1,19 +1,30 @@
 #include "FreeRTOS.h"
 #include "task.h"
-#include "queue.h"
+#include "mailbox.h"
 #include "drivers_simulados.h"
-
-extern QueueHandle_t cola_lux;
+#include "latencia.h"
+#include "escalas.h"
+#include "periodica.h"
+#include "tareas.h"
 
 void tarea_sensor_luz(void *pvParameters) {
     uint16_t lux = 0;
-    float porcentaje = 0;
+    uint32_t marca = 0;
+    int16_t luz = 0;
+    periodica_t periodo;
+
+    /* El periodo de muestreo viene de la tabla de tareas.c. */
+    periodica_iniciar(&periodo, (TickType_t)(uintptr_t)pvParameters);
 
     for(;;) {
         lux = BH1750_ReadLux();
-        porcentaje = (lux * 100.0) / 20000.0;
-        if (porcentaje > 100) porcentaje = 100;
-        xQueueOverwrite(cola_lux, &porcentaje);
-        vTaskDelay(pdMS_TO_TICKS(200));
+        marca = latencia_ahora_us();
+        if (lux > LUX_MAX) lux = LUX_MAX;
+        luz = LUX_A_Q15(lux);
+        vMailboxPublish(buzon_lux, &luz);
+        /* El control recibe la marca de la muestra para medir la latencia
+         * hasta el actuador. */
+        xTaskNotify(handle_control, marca, eSetValueWithOverwrite);
+        periodica_esperar(&periodo);
     }
 }
\ No newline at end of file
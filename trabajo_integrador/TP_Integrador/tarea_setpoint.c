@@ -1,25 +1,40 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "drivers_simulados.h"
+#include "mailbox.h"
+#include "botones.h"
+#include "escalas.h"
+#include "tareas.h"
 
-extern QueueHandle_t cola_setpoint;
+#define SETPOINT_MIN 25
+#define SETPOINT_MAX 75
+#define PASO_LARGO 5  /* con el boton mantenido */
 
+/* El control toma el setpoint nuevo en la proxima muestra del sensor: el PI
+ * integra una vez por periodo de muestreo. */
+static void publicar(uint8_t porcentaje) {
+    int16_t setpoint = PORCENTAJE_A_Q15(porcentaje);
+    vMailboxPublish(buzon_setpoint, &setpoint);
+    xTaskNotify(handle_display, DISPLAY_DATO, eSetBits);
+}
+
+/* Sin periodo: la tarea solo corre cuando llega un evento de S1 o S2, ya
+ * filtrado de rebotes por botones.c. */
 void tarea_setpoint(void *pvParameters) {
-    static float setpoint = 50;
+    static int16_t setpoint = 50;
+    boton_evento_t evento;
+    int16_t paso;
+
+    (void)pvParameters;
+    publicar((uint8_t)setpoint);
 
     for (;;) {
-        if (BotonPresionado(S1)) {
-            setpoint += 1;
-            if (setpoint > 75) setpoint = 75;
-            vTaskDelay(pdMS_TO_TICKS(200));
-        }
-        if (BotonPresionado(S2)) {
-            setpoint -= 1;
-            if (setpoint < 25) setpoint = 25;
-            vTaskDelay(pdMS_TO_TICKS(200));
-        }
-        xQueueOverwrite(cola_setpoint, &setpoint);
-        vTaskDelay(pdMS_TO_TICKS(100));
+        xQueueReceive(cola_setpoint, &evento, portMAX_DELAY);
+
+        paso = evento.accion == BOTON_LARGO ? PASO_LARGO : 1;
+        setpoint += evento.boton == BOTON_S1 ? paso : -paso;
+        if (setpoint > SETPOINT_MAX) setpoint = SETPOINT_MAX;
+        if (setpoint < SETPOINT_MIN) setpoint = SETPOINT_MIN;
+        publicar((uint8_t)setpoint);
     }
 }
\ No newline at end of file
@@ -1,28 +1,27 @@
 #include "FreeRTOS.h"
 #include "task.h"
-#include "queue.h"
-#include "drivers_simulados.h"
-#include <stdio.h>
+#include "mailbox.h"
+#include "telemetria.h"
+#include "tareas.h"
 
-extern QueueHandle_t cola_lux;
-extern QueueHandle_t cola_setpoint;
-extern QueueHandle_t cola_pwm;
+/* Envia la telemetria en tramas binarias (telemetria.h). Se despierta cuando
+ * tarea_control completa un lote, el monitor publica un reporte o el puerto
+ * devuelve una trama que faltaba; el timeout solo evita retener un lote
+ * parcial si el lazo se detiene. Es la unica tarea que escribe en la UART. */
+#define ESPERA_LOTE_MS 5000
 
 void tarea_uart_debug(void *pvParameters) {
-    float luz = 0, setpoint = 0, pwm = 0;
-    TickType_t start = xTaskGetTickCount();
+    static telemetria_monitor_t reporte;
+    uint32_t reporte_enviado = 0, secuencia;
 
     for (;;) {
-        TickType_t now = xTaskGetTickCount();
-        uint32_t tiempo_ms = (now - start) * portTICK_PERIOD_MS;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ESPERA_LOTE_MS));
+        telemetria_transmitir();
 
-        xQueuePeek(cola_lux, &luz, 0);
-        xQueuePeek(cola_setpoint, &setpoint, 0);
-        xQueuePeek(cola_pwm, &pwm, 0);
-
-        printf("[UART] Tiempo: %lu ms | Luz: %.1f%% | Setpoint: %.1f%% | LED: %.1f%%\r\n",
-               tiempo_ms, luz, setpoint, pwm);
-
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        secuencia = ulMailboxGetSequence(buzon_monitor);
+        if (secuencia != reporte_enviado && xMailboxPeek(buzon_monitor, &reporte) == pdPASS &&
+            telemetria_transmitir_monitor(&reporte)) {
+            reporte_enviado = secuencia;
+        }
     }
 }
\ No newline at end of file
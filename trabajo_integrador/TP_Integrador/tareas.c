@@ -0,0 +1,217 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+#include "mailbox.h"
+#include "mempool.h"
+#include "mem_manager_pools.h"
+#include "botones.h"
+#include "telemetria.h"
+#include "tareas.h"
+
+/* Tabla unica de la aplicacion. Cada entrada reserva en RAM estatica la pila
+ * (pila_<funcion>) y el TCB (tcb_<funcion>) de la tarea, y cada buzon sus
+ * datos (datos_<buzon>) y su estructura (bloque_<buzon>): el arranque no usa
+ * el heap y el reporte de RAM del link (armgcc/reporte_ram.cmake) desglosa la
+ * memoria por objeto a partir de esos nombres. Lo mismo vale para las colas
+ * de eventos, los pools de bloques y los temporizadores
+ * (temporizador_<funcion>).
+ *
+ * Las tareas con periodo (en ms) son periodicas (periodica.h) y lo reciben
+ * como parametro; las de periodo 0 se despiertan por notificacion o por un
+ * evento en su cola. Entre las
+ * periodicas las prioridades son rate monotonic: a menor periodo, mayor
+ * prioridad (tareas_crear() lo verifica). La cadena sensor -> control ->
+ * actuador sube de prioridad en cada etapa para que el dato la recorra sin
+ * esperas. */
+
+/* X(funcion, nombre, pila en palabras, prioridad, periodo, handle) */
+#define TAREAS(X) \
+    X(tarea_sensor_luz, "SensorLuz", 128, 2, 200,   NULL) \
+    X(tarea_setpoint,   "Setpoint",  128, 5, 0,     NULL) \
+    X(tarea_control,    "Control",   128, 3, 0,     &handle_control) \
+    X(tarea_led_pwm,    "LedPWM",    128, 4, 0,     &handle_led_pwm) \
+    X(tarea_uart_debug, "UART",      128, 1, 0,     &handle_uart_debug) \
+    X(tarea_display,    "Display",   128, 1, 0,     &handle_display)
+
+/* X(funcion, nombre, periodo en ms). Trabajos periodicos cortos que nunca se
+ * bloquean: corren como callbacks en la tarea de los temporizadores del
+ * kernel (configTIMER_TASK_PRIORITY) y comparten su pila, en lugar de tener
+ * una pila cada uno. El sensor sigue siendo tarea: con el BH1750 real espera
+ * la conversion entre el comando y la lectura, y encabeza la cadena de
+ * control con su jitter medido por periodica.h. El display tambien: no tiene
+ * periodo y bloquea hasta que hay un dato nuevo, en lugar de despertar al
+ * sistema a ritmo fijo. */
+#define TEMPORIZADORES(X) \
+    X(monitor_reportar, "Monitor", 10000)
+
+/* X(buzon, tipo del valor) */
+#define BUZONES(X) \
+    X(buzon_lux,      int16_t) \
+    X(buzon_setpoint, int16_t) \
+    X(buzon_pwm,      int16_t) \
+    X(buzon_monitor,  telemetria_monitor_t)
+
+/* X(cola, tipo del elemento, largo) */
+#define COLAS(X) \
+    X(cola_setpoint, boton_evento_t, 4) \
+    X(cola_display,  boton_evento_t, 4)
+
+/* X(pool, tipo del bloque, cantidad, id). Los pools quedan registrados en el
+ * mem_manager (mem_manager_pools.h) y se piden con MEM_BufferAllocWithId() y
+ * su id. Las tramas de telemetria salen de un pool para que cada una viva
+ * hasta que el puerto termina de enviarla por DMA; una se arma mientras las
+ * otras salen. */
+#define POOLS(X) \
+    X(pool_tramas, uint8_t[TELEMETRIA_TRAMA_MAX], TELEMETRIA_TRAMAS, TELEMETRIA_POOL_ID)
+
+typedef struct {
+    TaskFunction_t funcion;
+    const char *nombre;
+    uint32_t pila;
+    UBaseType_t prioridad;
+    TickType_t periodo;
+    TaskHandle_t *handle;
+    StackType_t *memoria_pila;
+    StaticTask_t *tcb;
+} tarea_desc_t;
+
+typedef struct {
+    MailboxHandle_t *handle;
+    size_t tamano;
+    uint8_t *datos;
+    StaticMailbox_t *bloque;
+} buzon_desc_t;
+
+typedef struct {
+    QueueHandle_t *handle;
+    UBaseType_t largo;
+    UBaseType_t tamano;
+    uint8_t *datos;
+    StaticQueue_t *bloque;
+} cola_desc_t;
+
+typedef struct {
+    MemPoolHandle_t *handle;
+    size_t tamano;
+    UBaseType_t cantidad;
+    uint8_t *datos;
+    StaticMemPool_t *bloque;
+    uint8_t id;
+} pool_desc_t;
+
+typedef struct {
+    TimerCallbackFunction_t funcion;
+    const char *nombre;
+    TickType_t periodo;
+    StaticTimer_t *bloque;
+} temporizador_desc_t;
+
+#define RESERVAR_TAREA(funcion, nombre, pila, prioridad, periodo, handle) \
+    static StackType_t pila_##funcion[pila];                     \
+    static StaticTask_t tcb_##funcion;
+#define DESCRIBIR_TAREA(funcion, nombre, pila, prioridad, periodo, handle) \
+    {funcion, nombre, pila, prioridad, pdMS_TO_TICKS(periodo), handle, pila_##funcion, &tcb_##funcion},
+
+#define RESERVAR_BUZON(buzon, tipo)                                  \
+    static uint8_t datos_##buzon[mailboxSTORAGE_SIZE(sizeof(tipo))]; \
+    static StaticMailbox_t bloque_##buzon;
+#define DESCRIBIR_BUZON(buzon, tipo) \
+    {&buzon, sizeof(tipo), datos_##buzon, &bloque_##buzon},
+
+#define RESERVAR_COLA(cola, tipo, largo)              \
+    static uint8_t datos_##cola[(largo) * sizeof(tipo)]; \
+    static StaticQueue_t bloque_##cola;
+#define DESCRIBIR_COLA(cola, tipo, largo) \
+    {&cola, largo, sizeof(tipo), datos_##cola, &bloque_##cola},
+
+/* Los bloques deben quedar alineados a portBYTE_ALIGNMENT (8 bytes). */
+#define RESERVAR_POOL(pool, tipo, cantidad, id)                                               \
+    static uint64_t datos_##pool[mempoolSTORAGE_SIZE(sizeof(tipo), cantidad) / sizeof(uint64_t)]; \
+    static StaticMemPool_t bloque_##pool;
+#define DESCRIBIR_POOL(pool, tipo, cantidad, id) \
+    {&pool, sizeof(tipo), cantidad, (uint8_t *)datos_##pool, &bloque_##pool, id},
+
+#define RESERVAR_TEMPORIZADOR(funcion, nombre, periodo) \
+    static StaticTimer_t temporizador_##funcion;
+#define DESCRIBIR_TEMPORIZADOR(funcion, nombre, periodo) \
+    {funcion, nombre, pdMS_TO_TICKS(periodo), &temporizador_##funcion},
+
+MailboxHandle_t buzon_lux;
+MailboxHandle_t buzon_setpoint;
+MailboxHandle_t buzon_pwm;
+MailboxHandle_t buzon_monitor;
+
+QueueHandle_t cola_setpoint;
+QueueHandle_t cola_display;
+
+MemPoolHandle_t pool_tramas;
+
+TaskHandle_t handle_control;
+TaskHandle_t handle_led_pwm;
+TaskHandle_t handle_uart_debug;
+TaskHandle_t handle_display;
+
+TAREAS(RESERVAR_TAREA)
+BUZONES(RESERVAR_BUZON)
+COLAS(RESERVAR_COLA)
+POOLS(RESERVAR_POOL)
+TEMPORIZADORES(RESERVAR_TEMPORIZADOR)
+
+static const tarea_desc_t tareas[] = {TAREAS(DESCRIBIR_TAREA)};
+static const buzon_desc_t buzones[] = {BUZONES(DESCRIBIR_BUZON)};
+static const cola_desc_t colas[] = {COLAS(DESCRIBIR_COLA)};
+static const pool_desc_t pools[] = {POOLS(DESCRIBIR_POOL)};
+static const temporizador_desc_t temporizadores[] = {TEMPORIZADORES(DESCRIBIR_TEMPORIZADOR)};
+
+#define CANTIDAD(v) (sizeof(v) / sizeof((v)[0]))
+
+void tareas_crear(void) {
+    const tarea_desc_t *t, *u;
+    const buzon_desc_t *b;
+    const cola_desc_t *c;
+    const pool_desc_t *p;
+    const temporizador_desc_t *x;
+    TaskHandle_t handle;
+    TimerHandle_t temporizador;
+
+    /* Los buzones, las colas y los pools primero: las tareas los usan apenas
+     * arranca el scheduler. */
+    for (b = buzones; b < buzones + CANTIDAD(buzones); b++) {
+        *b->handle = xMailboxCreateStatic(b->tamano, b->datos, b->bloque);
+    }
+    for (c = colas; c < colas + CANTIDAD(colas); c++) {
+        *c->handle = xQueueCreateStatic(c->largo, c->tamano, c->datos, c->bloque);
+        configASSERT(*c->handle);
+    }
+    for (p = pools; p < pools + CANTIDAD(pools); p++) {
+        *p->handle = mem_pools_crear(p->tamano, p->cantidad, p->datos, p->bloque, p->id);
+    }
+
+    for (t = tareas; t < tareas + CANTIDAD(tareas); t++) {
+        for (u = tareas; u < tareas + CANTIDAD(tareas); u++) {
+            configASSERT(t->periodo == 0 || u->periodo == 0 || t->periodo >= u->periodo ||
+                         t->prioridad >= u->prioridad);
+        }
+
+        handle = xTaskCreateStatic(t->funcion, t->nombre, t->pila, (void *)(uintptr_t)t->periodo, t->prioridad,
+                                   t->memoria_pila, t->tcb);
+        configASSERT(handle);
+        if (t->handle != NULL) *t->handle = handle;
+    }
+
+    /* S1 y S2 mueven el setpoint; USER alterna lo que muestra el display, que
+     * espera tambien los datos nuevos y por eso lo despierta una
+     * notificacion. */
+    botones_suscribir(BOTON_S1, cola_setpoint);
+    botones_suscribir(BOTON_S2, cola_setpoint);
+    botones_suscribir(BOTON_USER, cola_display);
+    botones_avisar(BOTON_USER, handle_display, DISPLAY_BOTON);
+
+    /* Con el scheduler detenido xTimerStart() solo encola la orden. */
+    for (x = temporizadores; x < temporizadores + CANTIDAD(temporizadores); x++) {
+        temporizador = xTimerCreateStatic(x->nombre, x->periodo, pdTRUE, NULL, x->funcion, x->bloque);
+        configASSERT(temporizador);
+        xTimerStart(temporizador, 0);
+    }
+}
\ No newline at end of file
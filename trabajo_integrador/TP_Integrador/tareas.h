@@ -0,0 +1,48 @@
+#ifndef TAREAS_H
+#define TAREAS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+#include "mailbox.h"
+#include "mempool.h"
+
+extern MailboxHandle_t buzon_lux;
+extern MailboxHandle_t buzon_setpoint;
+extern MailboxHandle_t buzon_pwm;
+extern MailboxHandle_t buzon_monitor;
+
+/* Eventos de los botones (botones.h). */
+extern QueueHandle_t cola_setpoint;
+extern QueueHandle_t cola_display;
+
+/* Bloques de TELEMETRIA_TRAMA_MAX bytes para las tramas de telemetria. */
+extern MemPoolHandle_t pool_tramas;
+
+/* Tareas que se despiertan por notificacion. */
+extern TaskHandle_t handle_control;
+extern TaskHandle_t handle_led_pwm;
+extern TaskHandle_t handle_uart_debug;
+extern TaskHandle_t handle_display;
+
+/* Bits de la notificacion del display. */
+#define DISPLAY_DATO  (1U << 0)  /* control o setpoint publicaron un valor */
+#define DISPLAY_BOTON (1U << 1)  /* hay un evento de USER en cola_display */
+
+void tarea_sensor_luz(void *);
+void tarea_setpoint(void *);
+void tarea_control(void *);
+void tarea_led_pwm(void *);
+void tarea_uart_debug(void *);
+void tarea_display(void *);
+
+/* Trabajos periodicos que corren como temporizadores del kernel. */
+void monitor_reportar(TimerHandle_t);
+
+/* Crea los buzones, las colas, los pools, las tareas y los temporizadores de
+ * la aplicacion. Se usa tanto en la placa (main.c) como en el simulador de
+ * host (host/main_host.c). */
+void tareas_crear(void);
+
+#endif /* TAREAS_H */
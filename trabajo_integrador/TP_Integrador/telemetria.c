@@ -0,0 +1,105 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fsl_component_mem_manager.h"
+#include "tareas.h"
+#include "telemetria.h"
+
+/* Anillo de un productor y un consumidor: el productor solo escribe
+ * "escritas" y "perdidas", el consumidor solo "leidas". Los indices corren
+ * libres y se enmascaran al acceder. */
+static telemetria_muestra_t anillo[TELEMETRIA_CAPACIDAD];
+static volatile uint32_t escritas;
+static volatile uint32_t leidas;
+static volatile uint32_t perdidas;
+
+/* Solo los usa la tarea que transmite. Cada trama se arma en un bloque que
+ * da el mem_manager con TELEMETRIA_POOL_ID (pool_tramas); el puerto se la
+ * queda mientras la envia por DMA y la devuelve al terminar, asi que el pool
+ * limita las tramas en vuelo. */
+static telemetria_muestra_t lote[TELEMETRIA_LOTE];
+static uint16_t secuencia;
+static uint32_t perdidas_informadas;
+
+/* La tarea que transmite se quedo sin trama y espera que el puerto devuelva
+ * una. */
+static volatile bool esperando_trama;
+
+static uint8_t *telemetria_trama_tomar(void) {
+    uint8_t *trama;
+
+    esperando_trama = true;
+    trama = MEM_BufferAllocWithId(TELEMETRIA_TRAMA_MAX, TELEMETRIA_POOL_ID);
+    if (trama != NULL) esperando_trama = false;
+    return trama;
+}
+
+void telemetria_trama_enviada(uint8_t *trama) {
+    BaseType_t despertar = pdFALSE;
+
+    (void)MEM_BufferFree(trama);
+    if (esperando_trama) {
+        esperando_trama = false;
+        vTaskNotifyGiveFromISR(handle_uart_debug, &despertar);
+        portYIELD_FROM_ISR(despertar);
+    }
+}
+
+bool telemetria_registrar(const telemetria_muestra_t *muestra) {
+    uint32_t e = escritas;
+
+    if (e - leidas >= TELEMETRIA_CAPACIDAD) {
+        perdidas = perdidas + 1;
+        return false;
+    }
+
+    anillo[e & (TELEMETRIA_CAPACIDAD - 1)] = *muestra;
+    portMEMORY_BARRIER();
+    escritas = e + 1;
+    return e + 1 - leidas == TELEMETRIA_LOTE;
+}
+
+void telemetria_transmitir(void) {
+    uint32_t l = leidas;
+    uint32_t pendientes, nuevas_perdidas;
+    uint8_t n, i, enviadas, largo;
+    uint8_t *trama;
+
+    while ((pendientes = escritas - l) != 0) {
+        /* Sin trama libre las muestras esperan en el anillo hasta que el
+         * puerto devuelva una. */
+        trama = telemetria_trama_tomar();
+        if (trama == NULL) break;
+
+        portMEMORY_BARRIER();
+        n = pendientes > TELEMETRIA_LOTE ? TELEMETRIA_LOTE : (uint8_t)pendientes;
+        for (i = 0; i < n; i++) {
+            lote[i] = anillo[(l + i) & (TELEMETRIA_CAPACIDAD - 1)];
+        }
+
+        nuevas_perdidas = perdidas - perdidas_informadas;
+        perdidas_informadas += nuevas_perdidas;
+        if (nuevas_perdidas > 0xFFFF) nuevas_perdidas = 0xFFFF;
+
+        enviadas = telemetria_muestras_codificar(&trama[TELEMETRIA_CABECERA], &largo, lote, n,
+                                                 (uint16_t)nuevas_perdidas);
+
+        /* Las muestras ya copiadas liberan su lugar antes de transmitir, que
+         * es lo lento. */
+        l += enviadas;
+        portMEMORY_BARRIER();
+        leidas = l;
+
+        telemetria_puerto_escribir(trama, telemetria_trama_cerrar(trama, TELEMETRIA_MUESTRAS, secuencia++, largo));
+    }
+}
+
+bool telemetria_transmitir_monitor(const telemetria_monitor_t *monitor) {
+    uint8_t *trama = telemetria_trama_tomar();
+    uint8_t largo;
+
+    if (trama == NULL) return false;
+
+    largo = telemetria_monitor_codificar(&trama[TELEMETRIA_CABECERA], monitor);
+    telemetria_puerto_escribir(trama, telemetria_trama_cerrar(trama, TELEMETRIA_MONITOR, secuencia++, largo));
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "telemetria_trama.h"
+
+/* Telemetria binaria por lotes. Las tareas registran muestras en un anillo sin
+ * bloquearse; la tarea UART las empaqueta de a TELEMETRIA_LOTE por trama
+ * (telemetria_trama.h) y las envia. Un lote de 16 muestras ocupa 142 bytes,
+ * contra unos 95 bytes por muestra del log en texto. */
+
+#define TELEMETRIA_LOTE      16
+#define TELEMETRIA_CAPACIDAD 32 /* potencia de 2, al menos dos lotes */
+
+/* Agrega una muestra. Un solo productor; nunca bloquea. Si el anillo esta
+ * lleno la muestra se descarta y se informa en la proxima trama. Devuelve
+ * true cuando se completa un lote, para que el llamador despierte a la tarea
+ * que transmite. */
+bool telemetria_registrar(const telemetria_muestra_t *muestra);
+
+/* Tramas que pueden estar armadas o esperando al puerto a la vez (bloques de
+ * pool_tramas). El pool tiene su propio id en el mem_manager, asi los
+ * componentes que piden con MEM_BufferAlloc() (id 0) no se quedan con las
+ * tramas. */
+#define TELEMETRIA_TRAMAS  3
+#define TELEMETRIA_POOL_ID 1U
+
+/* Envia en tramas todas las muestras pendientes, incluido un lote parcial.
+ * La llama solo la tarea que transmite. Si no hay trama libre las muestras
+ * esperan en el anillo, y la tarea se despierta cuando el puerto devuelve
+ * una. */
+void telemetria_transmitir(void);
+
+/* Envia el reporte del monitor en una trama. La llama solo la tarea que
+ * transmite. Devuelve false si no habia trama libre; el reporte se vuelve a
+ * intentar cuando el puerto devuelve una. */
+bool telemetria_transmitir_monitor(const telemetria_monitor_t *monitor);
+
+/* Salida de la telemetria; cada plataforma da la suya (UART con DMA en la
+ * placa, archivo en el simulador). El puerto se queda con la trama y vuelve
+ * enseguida; cuando termina de enviarla la devuelve con
+ * telemetria_trama_enviada(). Nunca tiene mas de TELEMETRIA_TRAMAS. */
+void telemetria_puerto_escribir(uint8_t *trama, size_t largo);
+
+/* Devuelve al pool una trama ya enviada y despierta a la tarea que transmite
+ * si estaba esperando una. La llama el puerto, desde su interrupcion o desde
+ * la misma tarea. */
+void telemetria_trama_enviada(uint8_t *trama);
+
+/* Prepara la USART y el DMA del puerto de la placa (telemetria_uart.c), antes
+ * del scheduler. */
+void telemetria_puerto_iniciar(void);
+
+#endif /* TELEMETRIA_H */
@@ -0,0 +1,167 @@
+#include "telemetria_trama.h"
+
+/* CRC-16/CCITT-FALSE (polinomio 0x1021, valor inicial 0xFFFF) con una tabla
+ * de 16 entradas: dos consultas por byte, sin ocupar 512 bytes de flash. */
+static const uint16_t crc_tabla[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t telemetria_crc16(const uint8_t *datos, size_t largo) {
+    uint16_t crc = 0xFFFF;
+
+    while (largo--) {
+        crc = (uint16_t)((crc << 4) ^ crc_tabla[(crc >> 12) ^ (*datos >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc_tabla[(crc >> 12) ^ (*datos & 0x0F)]);
+        datos++;
+    }
+    return crc;
+}
+
+static void escribir16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void escribir32(uint8_t *p, uint32_t v) {
+    escribir16(p, (uint16_t)v);
+    escribir16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t leer16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t leer32(const uint8_t *p) {
+    return leer16(p) | ((uint32_t)leer16(p + 2) << 16);
+}
+
+size_t telemetria_trama_cerrar(uint8_t *trama, uint8_t tipo, uint16_t secuencia, uint8_t largo) {
+    size_t fin = TELEMETRIA_CABECERA + largo;
+
+    trama[0] = TELEMETRIA_SINCRO_0;
+    trama[1] = TELEMETRIA_SINCRO_1;
+    trama[2] = tipo;
+    trama[3] = largo;
+    escribir16(&trama[4], secuencia);
+    escribir16(&trama[fin], telemetria_crc16(&trama[2], fin - 2));
+    return fin + TELEMETRIA_CRC;
+}
+
+int telemetria_trama_validar(const uint8_t *datos, size_t disponibles) {
+    size_t fin;
+
+    if (disponibles >= 1 && datos[0] != TELEMETRIA_SINCRO_0) return -1;
+    if (disponibles >= 2 && datos[1] != TELEMETRIA_SINCRO_1) return -1;
+    if (disponibles < TELEMETRIA_CABECERA) return 0;
+
+    fin = TELEMETRIA_CABECERA + datos[3];
+    if (disponibles < fin + TELEMETRIA_CRC) return 0;
+    if (leer16(&datos[fin]) != telemetria_crc16(&datos[2], fin - 2)) return -1;
+    return (int)(fin + TELEMETRIA_CRC);
+}
+
+uint8_t telemetria_muestras_codificar(uint8_t *carga, uint8_t *largo,
+                                      const telemetria_muestra_t *muestras, uint8_t n,
+                                      uint16_t perdidas) {
+    const uint8_t max = (TELEMETRIA_CARGA_MAX - TELEMETRIA_MUESTRAS_CABECERA) / TELEMETRIA_MUESTRA_BYTES;
+    uint8_t *p = carga + TELEMETRIA_MUESTRAS_CABECERA;
+    uint32_t dt;
+    uint8_t i;
+
+    if (n > max) n = max;
+    escribir32(carga, n ? muestras[0].tiempo_ms : 0);
+    escribir16(carga + 4, perdidas);
+
+    for (i = 0; i < n; i++) {
+        dt = muestras[i].tiempo_ms - muestras[0].tiempo_ms;
+        if (dt > 0xFFFF) break;
+        escribir16(p, (uint16_t)dt);
+        escribir16(p + 2, (uint16_t)muestras[i].luz);
+        escribir16(p + 4, (uint16_t)muestras[i].setpoint);
+        escribir16(p + 6, (uint16_t)muestras[i].pwm);
+        p += TELEMETRIA_MUESTRA_BYTES;
+    }
+
+    *largo = (uint8_t)(p - carga);
+    return i;
+}
+
+int telemetria_muestras_decodificar(const uint8_t *carga, uint8_t largo,
+                                    telemetria_muestra_t *muestras, uint16_t *perdidas) {
+    const uint8_t *p = carga + TELEMETRIA_MUESTRAS_CABECERA;
+    uint32_t base;
+    int i, n;
+
+    if (largo < TELEMETRIA_MUESTRAS_CABECERA ||
+        (largo - TELEMETRIA_MUESTRAS_CABECERA) % TELEMETRIA_MUESTRA_BYTES != 0) {
+        return -1;
+    }
+
+    base = leer32(carga);
+    *perdidas = leer16(carga + 4);
+    n = (largo - TELEMETRIA_MUESTRAS_CABECERA) / TELEMETRIA_MUESTRA_BYTES;
+
+    for (i = 0; i < n; i++) {
+        muestras[i].tiempo_ms = base + leer16(p);
+        muestras[i].luz = (int16_t)leer16(p + 2);
+        muestras[i].setpoint = (int16_t)leer16(p + 4);
+        muestras[i].pwm = (int16_t)leer16(p + 6);
+        p += TELEMETRIA_MUESTRA_BYTES;
+    }
+    return n;
+}
+
+uint8_t telemetria_monitor_codificar(uint8_t *carga, const telemetria_monitor_t *monitor) {
+    uint8_t *p = carga + TELEMETRIA_MONITOR_CABECERA;
+    const telemetria_tarea_t *t;
+    uint8_t i, n = monitor->n;
+
+    if (n > TELEMETRIA_TAREAS_MAX) n = TELEMETRIA_TAREAS_MAX;
+    escribir32(carga, monitor->tiempo_ms);
+    escribir32(carga + 4, monitor->heap_libre);
+
+    for (t = monitor->tareas; t < monitor->tareas + n; t++) {
+        for (i = 0; i < TELEMETRIA_NOMBRE && t->nombre[i] != '\0'; i++) p[i] = (uint8_t)t->nombre[i];
+        for (; i < TELEMETRIA_NOMBRE; i++) p[i] = 0;
+        p[TELEMETRIA_NOMBRE] = t->prioridad;
+        escribir16(p + TELEMETRIA_NOMBRE + 1, t->cpu_decimas);
+        escribir16(p + TELEMETRIA_NOMBRE + 3, t->pila_libre);
+        escribir16(p + TELEMETRIA_NOMBRE + 5, t->periodo_ms);
+        escribir16(p + TELEMETRIA_NOMBRE + 7, t->perdidos);
+        escribir16(p + TELEMETRIA_NOMBRE + 9, t->jitter_max_us);
+        escribir16(p + TELEMETRIA_NOMBRE + 11, t->jitter_medio_us);
+        p += TELEMETRIA_TAREA_BYTES;
+    }
+    return (uint8_t)(p - carga);
+}
+
+int telemetria_monitor_decodificar(const uint8_t *carga, uint8_t largo, telemetria_monitor_t *monitor) {
+    const uint8_t *p = carga + TELEMETRIA_MONITOR_CABECERA;
+    telemetria_tarea_t *t;
+    uint8_t i;
+
+    if (largo < TELEMETRIA_MONITOR_CABECERA ||
+        (largo - TELEMETRIA_MONITOR_CABECERA) % TELEMETRIA_TAREA_BYTES != 0 ||
+        (largo - TELEMETRIA_MONITOR_CABECERA) / TELEMETRIA_TAREA_BYTES > TELEMETRIA_TAREAS_MAX) {
+        return -1;
+    }
+
+    monitor->tiempo_ms = leer32(carga);
+    monitor->heap_libre = leer32(carga + 4);
+    monitor->n = (uint8_t)((largo - TELEMETRIA_MONITOR_CABECERA) / TELEMETRIA_TAREA_BYTES);
+
+    for (t = monitor->tareas; t < monitor->tareas + monitor->n; t++) {
+        for (i = 0; i < TELEMETRIA_NOMBRE; i++) t->nombre[i] = (char)p[i];
+        t->nombre[TELEMETRIA_NOMBRE] = '\0';
+        t->prioridad = p[TELEMETRIA_NOMBRE];
+        t->cpu_decimas = leer16(p + TELEMETRIA_NOMBRE + 1);
+        t->pila_libre = leer16(p + TELEMETRIA_NOMBRE + 3);
+        t->periodo_ms = leer16(p + TELEMETRIA_NOMBRE + 5);
+        t->perdidos = leer16(p + TELEMETRIA_NOMBRE + 7);
+        t->jitter_max_us = leer16(p + TELEMETRIA_NOMBRE + 9);
+        t->jitter_medio_us = leer16(p + TELEMETRIA_NOMBRE + 11);
+        p += TELEMETRIA_TAREA_BYTES;
+    }
+    return 0;
+}
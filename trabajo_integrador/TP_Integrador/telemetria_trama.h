@@ -0,0 +1,108 @@
+#ifndef TELEMETRIA_TRAMA_H
+#define TELEMETRIA_TRAMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Formato de las tramas de telemetria. No depende del kernel: lo usan la
+ * placa para armar las tramas y el decodificador del host para leerlas.
+ *
+ * Trama (little endian):
+ *   0  0xA5 0x5A          sincronismo
+ *   2  tipo      uint8
+ *   3  largo     uint8    bytes de carga
+ *   4  secuencia uint16   una por trama; un salto indica tramas perdidas
+ *   6  carga     largo bytes
+ *   .. crc       uint16   CRC-16/CCITT-FALSE desde "tipo" hasta la carga
+ *
+ * Carga de TELEMETRIA_MUESTRAS:
+ *   0  tiempo_base  uint32  ms de la primera muestra
+ *   4  perdidas     uint16  muestras descartadas desde la trama anterior
+ *   6  n muestras de 8 bytes: dt uint16 (ms desde tiempo_base), luz,
+ *      setpoint y pwm en int16 Q15.
+ *
+ * Carga de TELEMETRIA_MONITOR:
+ *   0  tiempo_ms    uint32
+ *   4  heap_libre   uint32  TELEMETRIA_SIN_HEAP si la imagen no tiene heap
+ *   8  n tareas de 23 bytes: nombre (TELEMETRIA_NOMBRE bytes, relleno con
+ *      ceros), prioridad uint8, cpu uint16 (decimas de % en el ultimo
+ *      periodo), pila_libre uint16 (minimo historico, en palabras) y, para
+ *      las tareas periodicas (periodica.h), periodo_ms uint16 (0 si no es
+ *      periodica), perdidos uint16, jitter_max_us uint16 y jitter_medio_us
+ *      uint16. Los contadores se saturan en 0xFFFF. */
+
+#define TELEMETRIA_SINCRO_0 0xA5
+#define TELEMETRIA_SINCRO_1 0x5A
+#define TELEMETRIA_CABECERA 6
+#define TELEMETRIA_CRC      2
+#define TELEMETRIA_CARGA_MAX 255
+#define TELEMETRIA_TRAMA_MAX (TELEMETRIA_CABECERA + TELEMETRIA_CARGA_MAX + TELEMETRIA_CRC)
+
+#define TELEMETRIA_MUESTRAS 1
+#define TELEMETRIA_MONITOR  2
+
+#define TELEMETRIA_MUESTRAS_CABECERA 6
+#define TELEMETRIA_MUESTRA_BYTES     8
+
+typedef struct {
+    uint32_t tiempo_ms;
+    int16_t luz;
+    int16_t setpoint;
+    int16_t pwm;
+} telemetria_muestra_t;
+
+#define TELEMETRIA_MONITOR_CABECERA 8
+#define TELEMETRIA_TAREA_BYTES      23
+#define TELEMETRIA_NOMBRE           10
+#define TELEMETRIA_TAREAS_MAX       10
+#define TELEMETRIA_SIN_HEAP         0xFFFFFFFFU
+
+typedef struct {
+    char nombre[TELEMETRIA_NOMBRE + 1];
+    uint8_t prioridad;
+    uint16_t cpu_decimas;
+    uint16_t pila_libre;
+    uint16_t periodo_ms;
+    uint16_t perdidos;
+    uint16_t jitter_max_us;
+    uint16_t jitter_medio_us;
+} telemetria_tarea_t;
+
+typedef struct {
+    uint32_t tiempo_ms;
+    uint32_t heap_libre;
+    uint8_t n;
+    telemetria_tarea_t tareas[TELEMETRIA_TAREAS_MAX];
+} telemetria_monitor_t;
+
+uint16_t telemetria_crc16(const uint8_t *datos, size_t largo);
+
+/* Completa la cabecera y el CRC de una trama cuya carga ya esta escrita a
+ * partir de trama + TELEMETRIA_CABECERA. Devuelve el largo total. */
+size_t telemetria_trama_cerrar(uint8_t *trama, uint8_t tipo, uint16_t secuencia, uint8_t largo);
+
+/* Revisa la trama que empieza en datos[0]. Devuelve su largo total si esta
+ * completa y el CRC es correcto, 0 si faltan bytes y -1 si no es una trama
+ * valida (el lector debe descartar un byte y buscar el sincronismo). */
+int telemetria_trama_validar(const uint8_t *datos, size_t disponibles);
+
+/* Escribe en carga hasta n muestras consecutivas. Corta antes si una
+ * muestra queda a mas de 65535 ms de la primera. Devuelve cuantas escribio
+ * y en *largo los bytes de carga. */
+uint8_t telemetria_muestras_codificar(uint8_t *carga, uint8_t *largo,
+                                      const telemetria_muestra_t *muestras, uint8_t n,
+                                      uint16_t perdidas);
+
+/* Inversa de la anterior. muestras debe tener lugar para
+ * (largo - TELEMETRIA_MUESTRAS_CABECERA) / TELEMETRIA_MUESTRA_BYTES muestras.
+ * Devuelve cuantas leyo, o -1 si el largo no corresponde al formato. */
+int telemetria_muestras_decodificar(const uint8_t *carga, uint8_t largo,
+                                    telemetria_muestra_t *muestras, uint16_t *perdidas);
+
+/* Escribe el reporte del monitor en carga y devuelve los bytes escritos. */
+uint8_t telemetria_monitor_codificar(uint8_t *carga, const telemetria_monitor_t *monitor);
+
+/* Inversa de la anterior. Devuelve 0, o -1 si el largo no corresponde. */
+int telemetria_monitor_decodificar(const uint8_t *carga, uint8_t largo, telemetria_monitor_t *monitor);
+
+#endif /* TELEMETRIA_TRAMA_H */
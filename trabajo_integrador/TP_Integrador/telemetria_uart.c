@@ -0,0 +1,65 @@
+#include "fsl_dma.h"
+#include "fsl_usart_dma.h"
+#include "board.h"
+#include "telemetria.h"
+
+/* La telemetria sale por la USART de la consola de depuracion, con DMA. El
+ * puerto encola las tramas y el fin de cada transferencia, en la interrupcion
+ * del DMA, devuelve la trama enviada y arranca la siguiente: la tarea que
+ * transmite no espera a la UART. */
+
+#define TELEMETRIA_USART  ((USART_Type *)BOARD_DEBUG_USART_BASEADDR)
+#define TELEMETRIA_DMA_TX 1U /* pedidos de TX de la USART0 */
+
+static dma_handle_t dma_tx;
+static usart_dma_handle_t manejador;
+static usart_transfer_t envio;
+
+/* Tramas en espera; la primera es la que esta saliendo. Nunca hay mas que
+ * las del pool. */
+static uint8_t *tramas[TELEMETRIA_TRAMAS];
+static size_t largos[TELEMETRIA_TRAMAS];
+static uint32_t primera, cantidad;
+
+static void telemetria_puerto_arrancar(void) {
+    envio.data = tramas[primera];
+    envio.dataSize = largos[primera];
+    (void)USART_TransferSendDMA(TELEMETRIA_USART, &manejador, &envio);
+}
+
+static void telemetria_puerto_al_terminar(USART_Type *base, usart_dma_handle_t *handle, status_t estado,
+                                          void *datos) {
+    uint8_t *trama;
+
+    (void)base;
+    (void)handle;
+    (void)estado;
+    (void)datos;
+
+    /* Con error la trama tambien se da por terminada: el receptor descarta
+     * lo que llego cortado por el CRC. */
+    trama = tramas[primera];
+    if (++primera == TELEMETRIA_TRAMAS) primera = 0;
+    cantidad--;
+    if (cantidad != 0U) telemetria_puerto_arrancar();
+    telemetria_trama_enviada(trama);
+}
+
+void telemetria_puerto_iniciar(void) {
+    DMA_Init(DMA0);
+    DMA_CreateHandle(&dma_tx, DMA0, TELEMETRIA_DMA_TX);
+    USART_TransferCreateHandleDMA(TELEMETRIA_USART, &manejador, telemetria_puerto_al_terminar, NULL, &dma_tx, NULL);
+}
+
+void telemetria_puerto_escribir(uint8_t *trama, size_t largo) {
+    uint32_t mascara = DisableGlobalIRQ();
+    uint32_t ultima = primera + cantidad;
+
+    if (ultima >= TELEMETRIA_TRAMAS) ultima -= TELEMETRIA_TRAMAS;
+    tramas[ultima] = trama;
+    largos[ultima] = largo;
+    /* Con la UART quieta la trama sale ya; si no, al terminar la anterior. */
+    if (++cantidad == 1U) telemetria_puerto_arrancar();
+
+    EnableGlobalIRQ(mascara);
+}
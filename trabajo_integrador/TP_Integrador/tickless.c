@@ -0,0 +1,80 @@
+#include "tickless.h"
+
+/* El temporizador descuenta en cada flanco de su oscilador, que no esta en
+ * fase con el nucleo. Un sueno que empieza en un momento cualquiera y termina
+ * con la alarma tras n cuentas dura en promedio n - 1/2 periodos; si lo corta
+ * otra interrupcion, n en promedio. Por eso las cuentas se pasan a medias
+ * cuentas con esa correccion; si no, cada sueno adelantaria el reloj del
+ * kernel media cuenta (50 us con el LPO). */
+static uint64_t medias_cuentas(uint32_t cuentas, bool alarma) {
+    return 2 * (uint64_t)cuentas - (alarma && cuentas > 0 ? 1 : 0);
+}
+
+void tickless_calibrar(tickless_t *t, uint32_t cuentas, uint64_t tiempo_q16) {
+    t->cuentas_por_tick_q16 = (uint32_t)(((uint64_t)cuentas << 32) / tiempo_q16);
+    t->deuda_q16 = 0;
+    t->resto = 0;
+    t->medidas_medias = 0;
+    t->medidas_q16 = 0;
+}
+
+uint32_t tickless_cuentas_para(const tickless_t *t, uint32_t ticks, uint32_t transcurrido_q16) {
+    uint64_t limite_q16 = ((uint64_t)TICKLESS_MAX_CUENTAS << 32) / t->cuentas_por_tick_q16;
+    uint64_t objetivo_q16 = (uint64_t)ticks << 16;
+    uint64_t ya_q16 = (uint64_t)transcurrido_q16 + t->deuda_q16;
+
+    if (objetivo_q16 <= ya_q16) return 0;
+    objetivo_q16 -= ya_q16;
+    if (objetivo_q16 > limite_q16) objetivo_q16 = limite_q16;
+
+    return (uint32_t)((objetivo_q16 * t->cuentas_por_tick_q16) >> 32);
+}
+
+uint32_t tickless_entrar(const tickless_t *t, uint32_t ticks, uint32_t fraccion_q16, bool pendiente,
+                         uint32_t *transcurrido_q16) {
+    uint32_t transcurrido = fraccion_q16 + (pendiente ? TICKLESS_UNO_Q16 : 0U);
+    uint32_t cuentas = tickless_cuentas_para(t, ticks, transcurrido);
+
+    /* Con menos de dos cuentas la alarma puede llegar antes de dormir. */
+    if (cuentas < 2U) return 0;
+    *transcurrido_q16 = transcurrido;
+    return cuentas;
+}
+
+uint32_t tickless_despertar(tickless_t *t, uint32_t transcurrido_q16, uint32_t cuentas, bool alarma,
+                            uint32_t latencia_q16, uint32_t ticks_max, uint32_t *fase_q16) {
+    uint64_t numerador = (medias_cuentas(cuentas, alarma) << 31) + t->resto;
+    uint64_t total_q16, tope_q16 = (uint64_t)ticks_max << 16;
+
+    t->resto = numerador % t->cuentas_por_tick_q16;
+    total_q16 = numerador / t->cuentas_por_tick_q16 + transcurrido_q16 + t->deuda_q16;
+    if (alarma) total_q16 += latencia_q16;
+
+    /* Si se durmio mas alla del limite (la latencia, o una interrupcion
+     * atendida tarde), el exceso se cobra en el proximo sueno: el kernel no
+     * puede pasar de su proximo desbloqueo. */
+    if (total_q16 >= tope_q16 + TICKLESS_UNO_Q16) {
+        total_q16 -= tope_q16;
+        t->deuda_q16 = total_q16 > UINT32_MAX ? UINT32_MAX : (uint32_t)total_q16;
+        *fase_q16 = 0;
+        return ticks_max;
+    }
+
+    t->deuda_q16 = 0;
+    *fase_q16 = (uint32_t)(total_q16 & (TICKLESS_UNO_Q16 - 1));
+    return (uint32_t)(total_q16 >> 16);
+}
+
+void tickless_medir(tickless_t *t, uint32_t cuentas, bool alarma, uint64_t tiempo_q16) {
+    if (cuentas == 0) return;
+
+    t->medidas_medias += (uint32_t)medias_cuentas(cuentas, alarma);
+    t->medidas_q16 += tiempo_q16;
+    if (t->medidas_medias < TICKLESS_CALIBRACION_MEDIAS) return;
+
+    /* Cada tanda reemplaza a la anterior: ya promedia varios suenos, y un
+     * promedio mas largo sigue con atraso la deriva por temperatura del LPO. */
+    t->cuentas_por_tick_q16 = (uint32_t)(((uint64_t)t->medidas_medias << 31) / t->medidas_q16);
+    t->medidas_medias = 0;
+    t->medidas_q16 = 0;
+}
@@ -0,0 +1,74 @@
+#ifndef TICKLESS_H
+#define TICKLESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Cuentas del tickless idle sobre un temporizador de bajo consumo que sigue
+ * contando con el SysTick detenido (el WKT en la placa, tickless_wkt.c). No
+ * toca hardware, asi que el simulador de host (host/sim_tickless.c) lo
+ * verifica contra un reloj ideal.
+ *
+ * Los tiempos van en ticks Q16 (TICKLESS_UNO_Q16 es un tick). El oscilador
+ * del temporizador es impreciso (el LPO del LPC845 tiene +-40 %), asi que sus
+ * cuentas por tick se calibran contra el SysTick al arrancar y despues se
+ * siguen corrigiendo con suenos medidos por el SysTick. El resto de cada
+ * conversion pasa a la siguiente: el reloj del kernel no deriva por
+ * redondeo. */
+
+#define TICKLESS_UNO_Q16 65536UL
+
+/* Tope de un sueno, para que las cuentas entren en la aritmetica de 64 bits
+ * (~30 h con el LPO a 10 kHz). */
+#define TICKLESS_MAX_CUENTAS 0x3FFFFFFFUL
+
+/* Medias cuentas medidas que se juntan antes de recalibrar (medio segundo de
+ * suenos con el LPO a 10 kHz). */
+#define TICKLESS_CALIBRACION_MEDIAS 10000U
+
+typedef struct {
+    uint32_t cuentas_por_tick_q16;
+    uint32_t deuda_q16;       /* dormido de mas, a descontar del proximo sueno */
+    uint64_t resto;           /* de la ultima conversion de cuentas a ticks */
+    uint32_t medidas_medias;  /* calibracion en curso, en medias cuentas */
+    uint64_t medidas_q16;
+} tickless_t;
+
+/* Fija la frecuencia del temporizador: cuentas enteras medidas en tiempo_q16,
+ * empezando en un flanco del oscilador. */
+void tickless_calibrar(tickless_t *t, uint32_t cuentas, uint64_t tiempo_q16);
+
+/* Cuentas a programar para despertar al final del tick ticks, si ya paso
+ * transcurrido_q16 del tick en curso. Redondea hacia abajo: se despierta antes
+ * del limite y el SysTick completa lo que falta. 0 si no vale la pena
+ * dormir. */
+uint32_t tickless_cuentas_para(const tickless_t *t, uint32_t ticks, uint32_t transcurrido_q16);
+
+/* Entrada a un sueno de ticks con el SysTick detenido: fraccion_q16 es lo que
+ * paso del tick en curso y pendiente indica que ese tick ya vencio con las
+ * interrupciones deshabilitadas y se le quito la marca de pendiente para
+ * contarlo aca. Devuelve las cuentas a programar y en transcurrido_q16 lo que
+ * ya paso, con el tick pendiente incluido. Si no vale la pena dormir devuelve
+ * 0 y no toca transcurrido_q16: el tick pendiente sigue siendo del kernel y
+ * el llamador lo tiene que volver a marcar pendiente. */
+uint32_t tickless_entrar(const tickless_t *t, uint32_t ticks, uint32_t fraccion_q16, bool pendiente,
+                         uint32_t *transcurrido_q16);
+
+/* Cierra un sueno de cuentas del temporizador que empezo con transcurrido_q16
+ * del tick en curso. alarma indica que termino por el temporizador (y no por
+ * otra interrupcion); solo en ese caso se suma latencia_q16, lo que tarda el
+ * nucleo en despertar, porque si no el temporizador siguio contando. Devuelve
+ * los ticks a sumar al kernel, nunca mas que ticks_max, y en fase_q16 lo que
+ * ya paso del tick siguiente. */
+uint32_t tickless_despertar(tickless_t *t, uint32_t transcurrido_q16, uint32_t cuentas, bool alarma,
+                            uint32_t latencia_q16, uint32_t ticks_max, uint32_t *fase_q16);
+
+/* Suma a la calibracion un sueno de cuentas que el SysTick midio en
+ * tiempo_q16. alarma como en tickless_despertar(). */
+void tickless_medir(tickless_t *t, uint32_t cuentas, bool alarma, uint64_t tiempo_q16);
+
+/* En la placa (tickless_wkt.c): enciende el LPO y el WKT y los calibra.
+ * Antes de vTaskStartScheduler(), que toma el SysTick. */
+void tickless_wkt_iniciar(void);
+
+#endif /* TICKLESS_H */
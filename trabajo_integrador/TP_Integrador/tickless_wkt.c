@@ -0,0 +1,182 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "board.h"
+#include "fsl_power.h"
+#include "fsl_wkt.h"
+#include "tickless.h"
+#include "tracerecorder.h"
+
+/* Tickless idle de la placa. Reemplaza al vPortSuppressTicksAndSleep() debil
+ * del port, que mide el sueno con el SysTick: con 24 bits a 18 MHz no pasa de
+ * 932 ticks, y el SysTick se detiene en deep sleep porque se apaga el reloj
+ * del nucleo. Aca el sueno lo mide el WKT (32 bits) con el LPO de 10 kHz, que
+ * sigue andando en deep sleep; las cuentas a ticks las lleva tickless.c.
+ *
+ * El MRT no sirve para esto: tambien es de 24 bits, se detiene en deep sleep y
+ * ya lo usa timer_manager para el antirrebote de los botones.
+ *
+ * Cada sueno es de una de tres clases:
+ * - deep sleep, si es largo, el MRT esta parado, no hay temporizadores de
+ *   alta resolucion esperando el match del CTIMER0 y la UART termino de
+ *   transmitir (deep sleep apaga sus relojes);
+ * - de calibracion, uno de cada CALIBRAR_CADA que entran en los 24 bits del
+ *   SysTick: sleep con el SysTick contando libre, que mide el sueno con el
+ *   reloj del nucleo y corrige las cuentas por tick del LPO (su deriva con la
+ *   temperatura es de varios %; el FRO, la referencia del tick, es de 1 %);
+ * - sleep comun, con el SysTick detenido. */
+
+#define CALIBRAR_CADA 2U
+#define CALIBRACION_CUENTAS 500U   /* al arrancar, ~50 ms */
+#define PROFUNDO_TICKS 5U          /* menos no compensa el despertar */
+#define LATENCIA_PROFUNDO_US 10U   /* de la alarma del WKT al nucleo andando */
+#define SYSTICK_MAX 0xFFFFFFUL
+
+#define SYSTICK_PARADO (SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk)
+
+static tickless_t lpo;
+static uint32_t ciclos_por_tick;
+static uint32_t suenos;
+static UBaseType_t traza_wkt;
+
+void WKT_IRQHandler(void) {
+    /* La alarma solo despierta al nucleo; el sueno se cierra con las
+     * interrupciones deshabilitadas y ya limpia la bandera. */
+    vTraceRecorderISREnter(traza_wkt);
+    WKT_ClearStatusFlags(WKT, kWKT_AlarmFlag);
+    vTraceRecorderISRExit(traza_wkt);
+    SDK_ISR_EXIT_BARRIER;
+}
+
+static void esperar_alarma(void) {
+    while ((WKT_GetStatusFlags(WKT) & kWKT_AlarmFlag) == 0U) {}
+    WKT_ClearStatusFlags(WKT, kWKT_AlarmFlag);
+}
+
+/* Mide CALIBRACION_CUENTAS del LPO en ciclos del nucleo, con el SysTick
+ * contando libre, antes de que el scheduler lo tome para el tick. */
+static void calibrar(void) {
+    uint32_t ciclos;
+
+    SysTick->CTRL = 0U;
+    SysTick->LOAD = SYSTICK_MAX;
+    SysTick->VAL = 0U;
+
+    /* Una cuenta para empezar sobre un flanco del LPO. */
+    WKT_StartTimer(WKT, 1U);
+    esperar_alarma();
+
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    WKT_StartTimer(WKT, CALIBRACION_CUENTAS);
+    esperar_alarma();
+    ciclos = SYSTICK_MAX - SysTick->VAL;
+    SysTick->CTRL = 0U;
+
+    tickless_calibrar(&lpo, CALIBRACION_CUENTAS, ((uint64_t)ciclos << 16) / ciclos_por_tick);
+}
+
+void tickless_wkt_iniciar(void) {
+    wkt_config_t config = {.clockSource = kWKT_LowPowerClockSource};
+
+    ciclos_por_tick = configCPU_CLOCK_HZ / configTICK_RATE_HZ;
+    traza_wkt = uxTraceRecorderRegister(traceOBJECT_ISR, "WKT");
+
+    POWER_EnableLPO(true);
+    WKT_Init(WKT, &config);
+    calibrar();
+
+    /* Al salir de deep sleep se vuelve a encender lo que estaba andando. */
+    SYSCON->PDAWAKECFG = SYSCON->PDRUNCFG;
+    EnableDeepSleepIRQ(WKT_IRQn);
+}
+
+static bool mrt_parado(void) {
+    uint32_t i;
+
+    if ((SYSCON->SYSAHBCLKCTRL0 & SYSCON_SYSAHBCLKCTRL0_MRT_MASK) == 0U) return true;
+    for (i = 0; i < FSL_FEATURE_MRT_NUMBER_OF_CHANNELS; i++) {
+        if ((MRT0->CHANNEL[i].STAT & MRT_CHANNEL_STAT_RUN_MASK) != 0U) return false;
+    }
+    return true;
+}
+
+static bool puede_dormir_profundo(TickType_t ticks) {
+    return ticks >= PROFUNDO_TICKS && mrt_parado() && (CTIMER0->MCR & CTIMER_MCR_MR1I_MASK) == 0U &&
+           (((USART_Type *)BOARD_DEBUG_USART_BASEADDR)->STAT & USART_STAT_TXIDLE_MASK) != 0U;
+}
+
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime) {
+    uint32_t fraccion_q16, transcurrido_q16, cuentas, restantes, ticks, fase_q16, carga, ciclos;
+    bool pendiente, alarma, profundo, calibrando;
+
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
+        __enable_irq();
+        return;
+    }
+
+    /* Lo que ya paso del tick en curso. Si el tick quedo pendiente, ese tick
+     * ya termino y se cuenta en el sueno en lugar de atenderlo. */
+    SysTick->CTRL = SYSTICK_PARADO;
+    fraccion_q16 = (((ciclos_por_tick - 1U) - SysTick->VAL) << 16) / ciclos_por_tick;
+    pendiente = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U;
+    if (pendiente) SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+
+    cuentas = tickless_entrar(&lpo, xExpectedIdleTime, fraccion_q16, pendiente, &transcurrido_q16);
+    if (cuentas == 0U) {
+        /* Sin sueno el tick pendiente vuelve a la interrupcion del SysTick;
+         * si no, el kernel lo pierde. */
+        if (pendiente) SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+        SysTick->CTRL = SYSTICK_PARADO | SysTick_CTRL_ENABLE_Msk;
+        __enable_irq();
+        return;
+    }
+
+    profundo = puede_dormir_profundo(xExpectedIdleTime);
+    calibrando = !profundo && xExpectedIdleTime < SYSTICK_MAX / ciclos_por_tick && ++suenos % CALIBRAR_CADA == 0U;
+
+    if (calibrando) {
+        SysTick->LOAD = SYSTICK_MAX;
+        SysTick->VAL = 0U;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+
+    WKT_StartTimer(WKT, cuentas);
+    if (profundo) {
+        POWER_EnterDeepSleep(0U);
+    } else {
+        POWER_EnterSleep();
+    }
+
+    /* Primero lo que falta contar: si la alarma llega entre las dos lecturas,
+     * la bandera la ve y el sueno fue completo. */
+    restantes = WKT_GetCounterValue(WKT);
+    alarma = (WKT_GetStatusFlags(WKT) & kWKT_AlarmFlag) != 0U;
+    WKT_StopTimer(WKT);
+    WKT_ClearStatusFlags(WKT, kWKT_AlarmFlag);
+    NVIC_ClearPendingIRQ(WKT_IRQn);
+    if (!alarma) cuentas -= restantes;
+
+    if (calibrando) {
+        ciclos = SYSTICK_MAX - SysTick->VAL;
+        SysTick->CTRL = SYSTICK_PARADO;
+        tickless_medir(&lpo, cuentas, alarma, ((uint64_t)ciclos << 16) / ciclos_por_tick);
+    }
+
+    ticks = tickless_despertar(&lpo, transcurrido_q16, cuentas, alarma,
+                               profundo ? LATENCIA_PROFUNDO_US * configTICK_RATE_HZ * 65536ULL / 1000000U : 0U,
+                               xExpectedIdleTime, &fase_q16);
+
+    /* El primer periodo del SysTick es lo que falta del tick en curso; la
+     * recarga vuelve a un tick entero en la vuelta siguiente. */
+    carga = (uint32_t)(((uint64_t)(TICKLESS_UNO_Q16 - fase_q16) * ciclos_por_tick) >> 16);
+    SysTick->LOAD = carga > 1U ? carga - 1U : 1U;
+    SysTick->VAL = 0U;
+    SysTick->CTRL = SYSTICK_PARADO | SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = ciclos_por_tick - 1U;
+
+    if (ticks > 0U) vTaskStepTick(ticks);
+    __enable_irq();
+}
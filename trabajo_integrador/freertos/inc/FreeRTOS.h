@@ -355,6 +355,82 @@
 
 #endif /* configUSE_TIMERS */
 
+#ifndef configUSE_HIGH_RES_TIMERS
+    #define configUSE_HIGH_RES_TIMERS    0
+#endif
+
+/* High resolution timers run off a free running hardware counter supplied by
+ * the port or the application. */
+#if ( configUSE_HIGH_RES_TIMERS == 1 )
+
+    #if ( configUSE_TIMERS == 0 ) || ( INCLUDE_xTimerPendFunctionCall == 0 )
+        #error configUSE_HIGH_RES_TIMERS needs configUSE_TIMERS and INCLUDE_xTimerPendFunctionCall set to 1.
+    #endif
+
+    #ifndef configHIGH_RES_TIMER_HZ
+        #error If configUSE_HIGH_RES_TIMERS is set to 1 then configHIGH_RES_TIMER_HZ must also be defined.
+    #endif
+
+    #if !defined( portHIGH_RES_TIMER_GET_COUNT ) || !defined( portHIGH_RES_TIMER_SET_COMPARE ) || !defined( portHIGH_RES_TIMER_DISABLE_COMPARE )
+        #error If configUSE_HIGH_RES_TIMERS is set to 1 then the portHIGH_RES_TIMER_ macros must also be defined.
+    #endif
+
+#endif /* configUSE_HIGH_RES_TIMERS */
+
+#ifndef configUSE_MUTEX_STATS
+    #define configUSE_MUTEX_STATS    0
+#endif
+
+/* Mutex statistics time holds and waits with a free running counter, by
+ * default the run time stats clock. */
+#if ( configUSE_MUTEX_STATS == 1 )
+
+    #if ( configUSE_MUTEXES == 0 )
+        #error configUSE_MUTEX_STATS needs configUSE_MUTEXES set to 1.
+    #endif
+
+    #ifndef configMUTEX_STATS_TIMESTAMP_HZ
+        #error If configUSE_MUTEX_STATS is set to 1 then configMUTEX_STATS_TIMESTAMP_HZ must also be defined.
+    #endif
+
+    #ifndef configMUTEX_STATS_TIMESTAMP
+        #define configMUTEX_STATS_TIMESTAMP()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+    #endif
+
+#endif /* configUSE_MUTEX_STATS */
+
+#ifndef configUSE_TRACE_RECORDER
+    #define configUSE_TRACE_RECORDER    0
+#endif
+
+/* The trace recorder defines the trace hooks, so it must be included before
+ * the defaults below. */
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+    #if ( configUSE_TRACE_FACILITY == 0 )
+        #error configUSE_TRACE_RECORDER needs configUSE_TRACE_FACILITY set to 1.
+    #endif
+
+    #ifndef configTRACE_RECORDER_TIMESTAMP_HZ
+        #error If configUSE_TRACE_RECORDER is set to 1 then configTRACE_RECORDER_TIMESTAMP_HZ must also be defined.
+    #endif
+
+    #ifndef configTRACE_RECORDER_TIMESTAMP
+        #define configTRACE_RECORDER_TIMESTAMP()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+    #endif
+
+    #ifndef configTRACE_RECORDER_RECORDS
+        #define configTRACE_RECORDER_RECORDS    512
+    #endif
+
+    #ifndef configTRACE_RECORDER_OBJECTS
+        #define configTRACE_RECORDER_OBJECTS    32
+    #endif
+
+    #include "tracerecorder.h"
+
+#endif /* configUSE_TRACE_RECORDER */
+
 #ifndef portSET_INTERRUPT_MASK_FROM_ISR
     #define portSET_INTERRUPT_MASK_FROM_ISR()    0
 #endif
@@ -857,6 +933,14 @@
     #define configUSE_TICKLESS_IDLE    0
 #endif
 
+#ifndef configUSE_DELAY_WHEEL
+    #define configUSE_DELAY_WHEEL    0
+#endif
+
+#ifndef configDELAY_WHEEL_SLOT_BITS
+    #define configDELAY_WHEEL_SLOT_BITS    4
+#endif
+
 #ifndef configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING
     #define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( x )
 #endif
@@ -1343,6 +1427,16 @@ typedef struct xSTATIC_QUEUE
         UBaseType_t uxDummy8;
         uint8_t ucDummy9;
     #endif
+
+    #if ( configUSE_MUTEX_STATS == 1 )
+        struct
+        {
+            uint32_t ulDummy10[ 6 ];
+            uint64_t ullDummy11[ 2 ];
+            UBaseType_t uxDummy12;
+        } xDummy13;
+        uint32_t ulDummy14;
+    #endif
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
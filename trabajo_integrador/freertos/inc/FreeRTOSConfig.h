@@ -15,38 +15,115 @@
   extern uint32_t SystemCoreClock;
 #endif
 #define configUSE_PREEMPTION				1
+#ifdef FREERTOS_PORT_POSIX
+/* In the host simulator the idle hook stands in for the SysTick interrupt. */
+#define configUSE_IDLE_HOOK					1
+#else
 #define configUSE_IDLE_HOOK					0
+#endif
 #define configUSE_TICK_HOOK					0
 #define configCPU_CLOCK_HZ					( SystemCoreClock )
 #define configTICK_RATE_HZ					( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES				( 8 )
 #define configMINIMAL_STACK_SIZE			( ( uint16_t ) 64 )
+#ifdef FREERTOS_PORT_POSIX
+/* TCBs and list items hold 64-bit pointers on the host. */
+#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 16384 ) )
+#else
 #define configTOTAL_HEAP_SIZE				( ( size_t ) ( 4096 ) )
+#endif
 #define configMAX_TASK_NAME_LEN				( 10 )
 #define configUSE_TRACE_FACILITY			1
 #define configUSE_16_BIT_TICKS				0
 #define configIDLE_SHOULD_YIELD				1
 #define configUSE_MUTEXES					1
 #define configQUEUE_REGISTRY_SIZE			8
-#define configCHECK_FOR_STACK_OVERFLOW		0
+#define configCHECK_FOR_STACK_OVERFLOW		2
 #define configUSE_RECURSIVE_MUTEXES			1
+/* Per mutex hold time, wait time, waiters and priority inheritance
+(vSemaphoreGetMutexStats()).  Timed like the trace recorder: the run time
+stats clock on the board, virtual time on the host. */
+#define configUSE_MUTEX_STATS				1
+#ifdef FREERTOS_PORT_POSIX
+#define configMUTEX_STATS_TIMESTAMP()		ulPortSimGetTraceTimestamp()
+#define configMUTEX_STATS_TIMESTAMP_HZ		portSIM_TRACE_TIMESTAMP_HZ
+#else
+#define configMUTEX_STATS_TIMESTAMP_HZ		1000000UL
+#endif
 #define configUSE_MALLOC_FAILED_HOOK		0
 #define configUSE_APPLICATION_TASK_TAG		0
 #define configUSE_COUNTING_SEMAPHORES		1
-#define configGENERATE_RUN_TIME_STATS		0
+#define configGENERATE_RUN_TIME_STATS		1
+/* Run time stats clock.  On the board CTIMER0 runs free at 1 MHz
+(estadisticas_ctimer.c); in the host simulator tasks use host CPU time, so
+the counter is the host clock in nanoseconds. */
+#ifdef FREERTOS_PORT_POSIX
+#define configRUN_TIME_COUNTER_TYPE			uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()	ullPortSimGetHostTimeNs()
+#else
+extern void vConfigureTimerForRunTimeStats( void );
+extern uint32_t ulGetRunTimeCounterValue( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	vConfigureTimerForRunTimeStats()
+#define portGET_RUN_TIME_COUNTER_VALUE()	ulGetRunTimeCounterValue()
+#endif
 #define configUSE_TICKLESS_IDLE				1
+/* Delayed tasks in a hierarchical timing wheel (delaywheel.c) instead of the
+sorted delayed lists: blocking with a timeout is O(1) instead of O(delayed
+tasks), for 8 * 16 lists of RAM.  host/bench_retardos compares both; the host
+build selects it with -DFREERTOS_DELAY_WHEEL=ON. */
+#ifndef configUSE_DELAY_WHEEL
+#define configUSE_DELAY_WHEEL				0
+#endif
+/* Tasks and mailboxes are allocated statically from the table in tareas.c, so
+the target links no heap at all.  The host benchmarks still use the heap. */
+#define configSUPPORT_STATIC_ALLOCATION		1
+#ifdef FREERTOS_PORT_POSIX
 #define configSUPPORT_DYNAMIC_ALLOCATION	1
+#else
+#define configSUPPORT_DYNAMIC_ALLOCATION	0
+#endif
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 				0
 #define configMAX_CO_ROUTINE_PRIORITIES		( 2 )
-/* Software timer definitions.  This example uses I2C to write to the LEDs.  As
-this takes a finite time, and because a timer callback writes to an LED, the
-priority of the timer task is kept to a minimum to ensure it does not disrupt
-test tasks that check their own execution times. */
-#define configUSE_TIMERS				0
-#define configTIMER_TASK_PRIORITY		( 0 )
+/* Software timer definitions.  Periodic jobs that never block run as timer
+callbacks (tareas.c) and share the stack of the timer task instead of having a
+task each.  The timer task runs at the priority of the least urgent task,
+below every job with a deadline.  Its stack is the 128 words the monitor had
+as a task, the deepest of the callbacks; the "pila libre" of "Tmr Svc" in the
+monitor report on the board is the figure to trim it by (the host one does not
+count). */
+#define configUSE_TIMERS				1
+#define configTIMER_TASK_PRIORITY		( 1 )
 #define configTIMER_QUEUE_LENGTH		5
 #define configTIMER_TASK_STACK_DEPTH	( configMINIMAL_STACK_SIZE * 2 )
+/* High resolution timers (timers.h): periods in microseconds, kept in their
+own list and driven by a compare interrupt instead of the tick.  On the board
+the counter is the run time stats clock and the compare its match 1
+(estadisticas_ctimer.c); the host port provides its own. */
+#define configUSE_HIGH_RES_TIMERS		1
+#define configHIGH_RES_TIMER_HZ			1000000UL
+#ifndef FREERTOS_PORT_POSIX
+extern void vHighResTimerSetCompare( uint32_t ulCount );
+extern void vHighResTimerDisableCompare( void );
+#define portHIGH_RES_TIMER_GET_COUNT()				ulGetRunTimeCounterValue()
+#define portHIGH_RES_TIMER_SET_COMPARE( ulCount )	vHighResTimerSetCompare( ulCount )
+#define portHIGH_RES_TIMER_DISABLE_COMPARE()		vHighResTimerDisableCompare()
+#endif
+/* Trace recorder (tracerecorder.h): the kernel trace hooks write 8-byte
+records into a RAM ring that host/traza_json turns into a timeline.  On the
+board timestamps are the run time stats clock, 1 us; on the host, virtual
+time in 100 ns units. */
+#define configUSE_TRACE_RECORDER		1
+#define configTRACE_RECORDER_OBJECTS	32
+#ifdef FREERTOS_PORT_POSIX
+#define configTRACE_RECORDER_RECORDS	16384
+#define configTRACE_RECORDER_TIMESTAMP()	ulPortSimGetTraceTimestamp()
+#define configTRACE_RECORDER_TIMESTAMP_HZ	portSIM_TRACE_TIMESTAMP_HZ
+#else
+#define configTRACE_RECORDER_RECORDS	256
+#define configTRACE_RECORDER_TIMESTAMP_HZ	1000000UL
+#endif
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
 #define INCLUDE_vTaskPrioritySet			1
@@ -57,6 +134,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelayUntil				1
 #define INCLUDE_vTaskDelay					1
 #define INCLUDE_xTaskGetCurrentTaskHandle 	1
+#define INCLUDE_xTimerPendFunctionCall		1
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
 	/* __BVIC_PRIO_BITS will be specified when CMSIS is being used. */
@@ -78,7 +156,12 @@ to all Cortex-M ports, and do not rely on any particular library functions. */
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY 	( configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS) )
 /* Normal assert() semantics without relying on the provision of an assert.h
 header file. */
+#ifdef FREERTOS_PORT_POSIX
+extern void vAssertCalled( const char * pcFile, unsigned long ulLine );
+#define configASSERT( x ) if( ( x ) == 0 ) { vAssertCalled( __FILE__, __LINE__ ); }
+#else
 #define configASSERT( x ) if( ( x ) == 0 ) { taskDISABLE_INTERRUPTS(); for( ;; ); }
+#endif
 #define configUSE_CUSTOM_TICK 0
 /* Definitions that map the FreeRTOS port interrupt handlers to their CMSIS
 standard names - or at least those used in the unmodified vector table. */
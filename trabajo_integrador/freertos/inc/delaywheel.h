@@ -0,0 +1,104 @@
+/*
+ * Hierarchical timing wheel for the delayed task lists.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DELAYWHEEL_H
+#define DELAYWHEEL_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include delaywheel.h"
+#endif
+
+#include "list.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Replacement for the two sorted delayed task lists of tasks.c, selected with
+ * configUSE_DELAY_WHEEL.  vListInsert() keeps a delayed list sorted by wake
+ * time, so blocking with a timeout walks the list: O(n) in the number of
+ * delayed tasks, with the scheduler suspended.  The wheel keeps the same list
+ * items in unsorted slot lists instead:
+ *
+ * - Wake times are read as digits of configDELAY_WHEEL_SLOT_BITS bits.  Level
+ *   l has one slot per value of digit l.  An item goes to the level of the
+ *   highest digit in which its wake time differs from the current tick, in
+ *   the slot of its own digit there, so inserting is O(1).
+ * - When the tick count reaches the first tick covered by a slot, the slot
+ *   is emptied into the lower levels (a cascade).  The items left in the
+ *   level 0 slot of the current tick are the ones waking now.  An item
+ *   cascades at most once per level: expiry is amortised O(1).
+ * - The next tick with work to do (a wake-up or a cascade) comes from a
+ *   bitmap of occupied slots per level, in O(levels).  With tickless idle a
+ *   long delay can end the sleep once per cascade on its way down, never
+ *   more than delaywheelLEVELS times.
+ *
+ * The wheel has delaywheelLEVELS * delaywheelSLOTS lists: 8 * 16 with 32-bit
+ * ticks and the default 4 bits per digit.
+ */
+#if ( configDELAY_WHEEL_SLOT_BITS < 1 ) || ( configDELAY_WHEEL_SLOT_BITS > 4 )
+    #error configDELAY_WHEEL_SLOT_BITS must be between 1 and 4
+#endif
+
+#define delaywheelSLOTS         ( 1U << configDELAY_WHEEL_SLOT_BITS )
+#define delaywheelLEVELS        ( ( sizeof( TickType_t ) * 8U + configDELAY_WHEEL_SLOT_BITS - 1U ) / configDELAY_WHEEL_SLOT_BITS )
+#define delaywheelLIST_COUNT    ( delaywheelLEVELS * delaywheelSLOTS )
+
+typedef struct xDELAY_WHEEL
+{
+    List_t xSlots[ delaywheelLEVELS ][ delaywheelSLOTS ];
+    uint16_t usOccupied[ delaywheelLEVELS ]; /* Bit s set if slot s may hold items. */
+} DelayWheel_t;
+
+/* The uxIndex-th slot list, for code that walks every delayed task. */
+#define delaywheelGET_LIST( pxWheel, uxIndex )    ( &( ( pxWheel )->xSlots[ 0 ][ 0 ] ) + ( uxIndex ) )
+
+/*
+ * Must be called before the wheel is used.
+ */
+void vDelayWheelInitialise( DelayWheel_t * const pxWheel ) PRIVILEGED_FUNCTION;
+
+/*
+ * Insert pxItem, whose value is its wake time, at tick xNow.  A wake time
+ * equal to xNow is moved to the next tick.  Returns the number of ticks from
+ * xNow to the first time the wheel has to look at the item again.
+ */
+TickType_t xDelayWheelInsert( DelayWheel_t * const pxWheel,
+                              ListItem_t * const pxItem,
+                              const TickType_t xNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Run the cascades due at tick xNow and return the list of the items that
+ * wake at xNow.  The caller removes every item from it.  Must be called at
+ * each tick xDelayWheelNextEvent() reports, and may be called at any other.
+ */
+List_t * pxDelayWheelAdvance( DelayWheel_t * const pxWheel,
+                              const TickType_t xNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Ticks from xNow to the next tick pxDelayWheelAdvance() has work at, in
+ * *pxTicksToEvent.  Returns pdFALSE if the wheel is empty.
+ */
+BaseType_t xDelayWheelNextEvent( DelayWheel_t * const pxWheel,
+                                 const TickType_t xNow,
+                                 TickType_t * const pxTicksToEvent ) PRIVILEGED_FUNCTION;
+
+/*
+ * pdTRUE if pxList is one of the slot lists of the wheel.
+ */
+BaseType_t xDelayWheelOwnsList( const DelayWheel_t * const pxWheel,
+                                const List_t * const pxList ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* DELAYWHEEL_H */
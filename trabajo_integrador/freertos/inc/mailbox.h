@@ -0,0 +1,136 @@
+/*
+ * Latest-value mailbox for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include mailbox.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A mailbox holds the most recent value written to it, like a queue of length
+ * one used with xQueueOverwrite() and xQueuePeek(), but without critical
+ * sections or event lists:
+ *
+ * - There is a single writer, which never blocks and may be an ISR.
+ * - Any number of readers copy the latest value without taking a lock.
+ *
+ * The value is double buffered.  The writer fills the slot that is not
+ * currently published and then publishes it by incrementing a sequence
+ * counter.  A reader copies the published slot and retries if the counter
+ * changed meanwhile, which can only happen if the writer preempted it.  As the
+ * writer always runs to completion before a preempted reader resumes, a
+ * reader never waits on a writer that cannot run.
+ *
+ * Mailboxes do not unblock tasks.  Use a task notification to tell a reader
+ * that a new value is available.
+ */
+struct MailboxDefinition;
+typedef struct MailboxDefinition * MailboxHandle_t;
+
+/*
+ * Memory for a mailbox created with xMailboxCreateStatic().  Like
+ * StaticQueue_t, its size and alignment match the real structure but its
+ * members are not meant to be used by the application.
+ */
+typedef struct xSTATIC_MAILBOX
+{
+    uint32_t ulDummy1;
+    size_t uxDummy2;
+    void * pvDummy3;
+} StaticMailbox_t;
+
+/* Bytes of slot storage a mailbox of uxItemSize bytes needs. */
+#define mailboxSTORAGE_SIZE( uxItemSize )    ( 2U * ( uxItemSize ) )
+
+/**
+ * mailbox. h
+ * @code{c}
+ * MailboxHandle_t xMailboxCreate( size_t uxItemSize );
+ * @endcode
+ *
+ * Creates a mailbox that holds one item of uxItemSize bytes.  The memory is
+ * allocated with pvPortMalloc().
+ *
+ * @return The handle of the new mailbox, or NULL if there was not enough heap.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    MailboxHandle_t xMailboxCreate( size_t uxItemSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mailbox. h
+ * @code{c}
+ * MailboxHandle_t xMailboxCreateStatic( size_t uxItemSize,
+ *                                       uint8_t * pucSlotStorage,
+ *                                       StaticMailbox_t * pxStaticMailbox );
+ * @endcode
+ *
+ * Creates a mailbox without using the heap.  pucSlotStorage must point to
+ * mailboxSTORAGE_SIZE( uxItemSize ) bytes, and pxStaticMailbox to the memory
+ * that holds the mailbox structure.  Both must outlive the mailbox.
+ *
+ * @return The handle of the new mailbox.
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    MailboxHandle_t xMailboxCreateStatic( size_t uxItemSize,
+                                          uint8_t * pucSlotStorage,
+                                          StaticMailbox_t * pxStaticMailbox ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mailbox. h
+ * @code{c}
+ * void vMailboxPublish( MailboxHandle_t xMailbox, const void * pvItem );
+ * @endcode
+ *
+ * Replaces the value held in the mailbox with the uxItemSize bytes at pvItem.
+ * Never blocks and can be called from a task or from an interrupt, but only
+ * one writer may use a given mailbox.
+ */
+void vMailboxPublish( MailboxHandle_t xMailbox,
+                      const void * pvItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * mailbox. h
+ * @code{c}
+ * BaseType_t xMailboxPeek( MailboxHandle_t xMailbox, void * pvBuffer );
+ * @endcode
+ *
+ * Copies the latest value into pvBuffer without removing it.  Never blocks
+ * and can be called from a task or from an interrupt.
+ *
+ * @return pdPASS if a value was copied, pdFAIL if nothing has been published
+ * yet, in which case pvBuffer is left unchanged.
+ */
+BaseType_t xMailboxPeek( MailboxHandle_t xMailbox,
+                         void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * mailbox. h
+ * @code{c}
+ * uint32_t ulMailboxGetSequence( MailboxHandle_t xMailbox );
+ * @endcode
+ *
+ * @return The number of values published so far.  A reader can compare it
+ * with a previous reading to know whether the value changed.
+ */
+uint32_t ulMailboxGetSequence( MailboxHandle_t xMailbox ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MAILBOX_H */
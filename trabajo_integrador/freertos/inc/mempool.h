@@ -0,0 +1,185 @@
+/*
+ * Fixed-size block pools for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include mempool.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A memory pool hands out blocks of one fixed size from storage given at
+ * creation, for objects that are allocated and freed often (message frames,
+ * transfer handles) and would otherwise go through pvPortMalloc():
+ *
+ * - Allocating and freeing pop and push a free list: constant time, no search
+ *   and no fragmentation.
+ * - The free list head is updated with a single compare-and-swap, with a tag
+ *   against ABA, so the pool is lock-free where the core has one (Cortex-M3
+ *   and up, the host).  The Cortex-M0+ has no exclusive access instructions;
+ *   there the same update runs with interrupts masked for a few instructions.
+ * - The FromISR variants can be used from interrupts.  Pools never block: an
+ *   empty pool returns NULL and counts a failure.
+ */
+struct MemPoolDefinition;
+typedef struct MemPoolDefinition * MemPoolHandle_t;
+
+/*
+ * Memory for a pool created with xMemPoolCreateStatic().  Like StaticQueue_t,
+ * its size and alignment match the real structure but its members are not
+ * meant to be used by the application.
+ */
+typedef struct xSTATIC_MEMPOOL
+{
+    uint32_t ulDummy1;
+    void * pvDummy2;
+    size_t xDummy3;
+    UBaseType_t uxDummy4[ 3 ];
+    uint32_t ulDummy5[ 2 ];
+} StaticMemPool_t;
+
+/* Usage counters of a pool, see vMemPoolGetStats(). */
+typedef struct xMEMPOOL_STATS
+{
+    size_t xBlockSize;              /* Bytes per block, after rounding. */
+    UBaseType_t uxBlocks;           /* Blocks in the pool. */
+    UBaseType_t uxFree;             /* Blocks free now. */
+    UBaseType_t uxMinimumEverFree;  /* Fewest blocks free since creation. */
+    uint32_t ulAllocations;         /* Successful allocations. */
+    uint32_t ulFrees;
+    uint32_t ulFailures;            /* Allocations that found the pool empty. */
+} MemPoolStats_t;
+
+/* Blocks are rounded up to portBYTE_ALIGNMENT. */
+#define mempoolBLOCK_SIZE( xItemSize )                  ( ( ( xItemSize ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* Bytes of block storage a pool of uxBlockCount items of xItemSize bytes
+ * needs.  The storage must be aligned to portBYTE_ALIGNMENT. */
+#define mempoolSTORAGE_SIZE( xItemSize, uxBlockCount )  ( mempoolBLOCK_SIZE( xItemSize ) * ( uxBlockCount ) )
+
+/* Largest number of blocks in one pool. */
+#define mempoolMAX_BLOCKS                               ( 0xfffeU )
+
+/* Typed allocation: pvMemPoolAlloc() cast to a pointer to Type. */
+#define mempoolALLOC( xPool, Type )                     ( ( Type * ) pvMemPoolAlloc( xPool ) )
+#define mempoolALLOC_FROM_ISR( xPool, Type )            ( ( Type * ) pvMemPoolAllocFromISR( xPool ) )
+
+/**
+ * mempool. h
+ * @code{c}
+ * MemPoolHandle_t xMemPoolCreate( size_t xItemSize, UBaseType_t uxBlockCount );
+ * @endcode
+ *
+ * Creates a pool of uxBlockCount blocks of xItemSize bytes.  The structure and
+ * the blocks are taken from the heap in one allocation.
+ *
+ * @return The handle of the new pool, or NULL if there was not enough heap.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    MemPoolHandle_t xMemPoolCreate( size_t xItemSize,
+                                    UBaseType_t uxBlockCount ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mempool. h
+ * @code{c}
+ * MemPoolHandle_t xMemPoolCreateStatic( size_t xItemSize,
+ *                                       UBaseType_t uxBlockCount,
+ *                                       uint8_t * pucBlockStorage,
+ *                                       StaticMemPool_t * pxStaticPool );
+ * @endcode
+ *
+ * Creates a pool without using the heap.  pucBlockStorage must point to
+ * mempoolSTORAGE_SIZE( xItemSize, uxBlockCount ) bytes aligned to
+ * portBYTE_ALIGNMENT, and pxStaticPool to the memory that holds the pool
+ * structure.  Both must outlive the pool.
+ *
+ * @return The handle of the new pool.
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    MemPoolHandle_t xMemPoolCreateStatic( size_t xItemSize,
+                                          UBaseType_t uxBlockCount,
+                                          uint8_t * pucBlockStorage,
+                                          StaticMemPool_t * pxStaticPool ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mempool. h
+ * @code{c}
+ * void * pvMemPoolAlloc( MemPoolHandle_t xPool );
+ * void * pvMemPoolAllocFromISR( MemPoolHandle_t xPool );
+ * @endcode
+ *
+ * Takes a block from the pool.  Never blocks.
+ *
+ * @return The block, or NULL if the pool is empty.
+ */
+void * pvMemPoolAlloc( MemPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+void * pvMemPoolAllocFromISR( MemPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool. h
+ * @code{c}
+ * void vMemPoolFree( MemPoolHandle_t xPool, void * pvBlock );
+ * void vMemPoolFreeFromISR( MemPoolHandle_t xPool, void * pvBlock );
+ * @endcode
+ *
+ * Returns a block taken from the same pool.  A block may be freed from a
+ * different context than the one that allocated it.
+ */
+void vMemPoolFree( MemPoolHandle_t xPool,
+                   void * pvBlock ) PRIVILEGED_FUNCTION;
+void vMemPoolFreeFromISR( MemPoolHandle_t xPool,
+                          void * pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool. h
+ * @code{c}
+ * BaseType_t xMemPoolOwns( MemPoolHandle_t xPool, const void * pvBlock );
+ * @endcode
+ *
+ * @return pdTRUE if pvBlock is one of the blocks of the pool, which is how a
+ * caller that serves several pools finds the pool of a block to free.
+ */
+BaseType_t xMemPoolOwns( MemPoolHandle_t xPool,
+                         const void * pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool. h
+ * @code{c}
+ * size_t xMemPoolGetBlockSize( MemPoolHandle_t xPool );
+ * @endcode
+ *
+ * @return Bytes per block, after rounding to portBYTE_ALIGNMENT.
+ */
+size_t xMemPoolGetBlockSize( MemPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool. h
+ * @code{c}
+ * void vMemPoolGetStats( MemPoolHandle_t xPool, MemPoolStats_t * pxStats );
+ * @endcode
+ *
+ * Copies the usage counters of the pool.  The copy is not atomic: with
+ * concurrent users, counters may be one operation apart.
+ */
+void vMemPoolGetStats( MemPoolHandle_t xPool,
+                       MemPoolStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MEMPOOL_H */
@@ -0,0 +1,239 @@
+/*
+ * Multi-producer, single-consumer ring buffer for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include mpscring.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A stream buffer is only safe with one writer and one reader.  An MPSC ring
+ * takes writes from any number of tasks and interrupts at once, for one
+ * reader, without a critical section around each write:
+ *
+ * - A producer reserves space for one record, or for a batch of records, in a
+ *   short section with interrupts masked: a few loads and stores, whatever
+ *   the record size.  Then it fills the records in place, with interrupts
+ *   enabled, and commits them with a single store.  A batch is published as a
+ *   whole.
+ * - Each record has a 4-byte header in front and is padded to 4 bytes.
+ *   Records never wrap: one that does not fit before the end of the storage
+ *   starts at the beginning, and the rest of the lap is skipped.
+ * - The reader sees records in reservation order, up to the first one not yet
+ *   committed.  It takes them one record at a time (xMpscRingReceiveRecord(),
+ *   or pvMpscRingPeekRecord() to read in place) or as a byte stream that joins
+ *   the records (xMpscRingReceive()).
+ * - Producers never block: a write that does not fit is dropped and counted.
+ *   The ring does not unblock the reader either; use a task notification.
+ *
+ * On the host build reservations also take a spinlock, so that producers can
+ * be host threads (the stress test in host/bench_mpscring.c).
+ */
+struct MpscRingDefinition;
+typedef struct MpscRingDefinition * MpscRingHandle_t;
+
+/*
+ * Memory for a ring created with xMpscRingCreateStatic().  Like
+ * StaticQueue_t, its size and alignment match the real structure but its
+ * members are not meant to be used by the application.
+ */
+typedef struct xSTATIC_MPSC_RING
+{
+    uint32_t ulDummy1[ 3 ];
+    void * pvDummy2;
+    uint32_t ulDummy3[ 5 ];
+} StaticMpscRing_t;
+
+/* Usage counters of a ring, see vMpscRingGetStats(). */
+typedef struct xMPSC_RING_STATS
+{
+    size_t xSize;              /* Bytes of storage. */
+    size_t xUsed;              /* Bytes reserved now, headers and padding included. */
+    size_t xMaximumUsed;       /* Most bytes ever reserved at once. */
+    uint32_t ulRecords;        /* Records written. */
+    uint32_t ulDropped;        /* Records dropped for lack of space. */
+} MpscRingStats_t;
+
+/* Bytes a record of xLength bytes takes in the ring. */
+#define mpscringRECORD_SIZE( xLength )    ( sizeof( uint32_t ) + ( ( ( xLength ) + 3U ) & ~( size_t ) 3U ) )
+
+/* Largest record. */
+#define mpscringMAX_RECORD                ( 0xffffU )
+
+/**
+ * mpscring. h
+ * @code{c}
+ * MpscRingHandle_t xMpscRingCreate( size_t xSize );
+ * MpscRingHandle_t xMpscRingCreateStatic( size_t xSize,
+ *                                         uint8_t * pucStorage,
+ *                                         StaticMpscRing_t * pxStaticRing );
+ * @endcode
+ *
+ * Creates a ring of xSize bytes, a power of two.  The static version needs
+ * xSize bytes of storage aligned to 4 bytes, and the memory that holds the
+ * ring structure; both must outlive the ring.
+ *
+ * @return The handle of the new ring, or NULL if there was not enough heap.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    MpscRingHandle_t xMpscRingCreate( size_t xSize ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    MpscRingHandle_t xMpscRingCreateStatic( size_t xSize,
+                                            uint8_t * pucStorage,
+                                            StaticMpscRing_t * pxStaticRing ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mpscring. h
+ * @code{c}
+ * void * pvMpscRingReserve( MpscRingHandle_t xRing, size_t xLength );
+ * void * pvMpscRingReserveFromISR( MpscRingHandle_t xRing, size_t xLength );
+ * @endcode
+ *
+ * Reserves a record of xLength bytes, 1 to mpscringMAX_RECORD.  The caller
+ * fills it and then passes it to vMpscRingCommit().  Records reserved after
+ * this one stay hidden from the reader until it is committed, so commit
+ * promptly.
+ *
+ * @return The record, aligned to 4 bytes, or NULL if it did not fit.
+ */
+void * pvMpscRingReserve( MpscRingHandle_t xRing,
+                          size_t xLength ) PRIVILEGED_FUNCTION;
+void * pvMpscRingReserveFromISR( MpscRingHandle_t xRing,
+                                 size_t xLength ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpscring. h
+ * @code{c}
+ * BaseType_t xMpscRingReserveBatch( MpscRingHandle_t xRing,
+ *                                   const size_t * pxLengths,
+ *                                   void ** ppvRecords,
+ *                                   UBaseType_t uxCount );
+ * BaseType_t xMpscRingReserveBatchFromISR( MpscRingHandle_t xRing,
+ *                                          const size_t * pxLengths,
+ *                                          void ** ppvRecords,
+ *                                          UBaseType_t uxCount );
+ * @endcode
+ *
+ * Reserves uxCount consecutive records of the given lengths in one masked
+ * section, and returns them in ppvRecords.  One vMpscRingCommit() of
+ * ppvRecords[ 0 ] publishes the whole batch.
+ *
+ * @return pdPASS, or pdFAIL if the batch did not fit (nothing is reserved).
+ */
+BaseType_t xMpscRingReserveBatch( MpscRingHandle_t xRing,
+                                  const size_t * pxLengths,
+                                  void ** ppvRecords,
+                                  UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+BaseType_t xMpscRingReserveBatchFromISR( MpscRingHandle_t xRing,
+                                         const size_t * pxLengths,
+                                         void ** ppvRecords,
+                                         UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpscring. h
+ * @code{c}
+ * void vMpscRingCommit( MpscRingHandle_t xRing, void * pvRecord );
+ * @endcode
+ *
+ * Publishes a record, or the batch whose first record it is.  Takes no lock,
+ * so it can be called from any context.
+ */
+void vMpscRingCommit( MpscRingHandle_t xRing,
+                      void * pvRecord ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpscring. h
+ * @code{c}
+ * BaseType_t xMpscRingWrite( MpscRingHandle_t xRing, const void * pvData, size_t xLength );
+ * BaseType_t xMpscRingWriteFromISR( MpscRingHandle_t xRing, const void * pvData, size_t xLength );
+ * @endcode
+ *
+ * Reserves, copies and commits one record.
+ *
+ * @return pdPASS, or pdFAIL if it did not fit.
+ */
+BaseType_t xMpscRingWrite( MpscRingHandle_t xRing,
+                           const void * pvData,
+                           size_t xLength ) PRIVILEGED_FUNCTION;
+BaseType_t xMpscRingWriteFromISR( MpscRingHandle_t xRing,
+                                  const void * pvData,
+                                  size_t xLength ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpscring. h
+ * @code{c}
+ * void * pvMpscRingPeekRecord( MpscRingHandle_t xRing, size_t * pxLength );
+ * void vMpscRingReleaseRecord( MpscRingHandle_t xRing );
+ * @endcode
+ *
+ * Reader only.  pvMpscRingPeekRecord() returns the oldest committed record
+ * and its length, or NULL if there is none; it stays valid until
+ * vMpscRingReleaseRecord() gives its space back to the producers.
+ */
+void * pvMpscRingPeekRecord( MpscRingHandle_t xRing,
+                             size_t * pxLength ) PRIVILEGED_FUNCTION;
+void vMpscRingReleaseRecord( MpscRingHandle_t xRing ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpscring. h
+ * @code{c}
+ * size_t xMpscRingReceiveRecord( MpscRingHandle_t xRing, void * pvBuffer, size_t xBufferLength );
+ * @endcode
+ *
+ * Reader only.  Copies the oldest committed record to pvBuffer and releases
+ * it.  A record longer than xBufferLength is left in the ring.
+ *
+ * @return The length of the record, or 0 if there was none or it did not fit.
+ */
+size_t xMpscRingReceiveRecord( MpscRingHandle_t xRing,
+                               void * pvBuffer,
+                               size_t xBufferLength ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpscring. h
+ * @code{c}
+ * size_t xMpscRingReceive( MpscRingHandle_t xRing, void * pvBuffer, size_t xBufferLength );
+ * @endcode
+ *
+ * Reader only.  Copies up to xBufferLength bytes of committed records, as one
+ * stream: a record that does not fit is continued on the next call.  Do not
+ * mix with the record functions while a record is half read.
+ *
+ * @return The number of bytes copied.
+ */
+size_t xMpscRingReceive( MpscRingHandle_t xRing,
+                         void * pvBuffer,
+                         size_t xBufferLength ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpscring. h
+ * @code{c}
+ * void vMpscRingGetStats( MpscRingHandle_t xRing, MpscRingStats_t * pxStats );
+ * @endcode
+ *
+ * Copies the usage counters of the ring.  The copy is not atomic.
+ */
+void vMpscRingGetStats( MpscRingHandle_t xRing,
+                        MpscRingStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MPSCRING_H */
@@ -0,0 +1,192 @@
+/*
+ * Zero-copy message queues for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef MSGQUEUE_H
+#define MSGQUEUE_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include msgqueue.h"
+#endif
+
+#include "queue.h"
+#include "mempool.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A message queue passes buffers between tasks and interrupts by reference.
+ * A queue created with xQueueCreate() copies each item in and out, which costs
+ * two memcpy() of the item size inside critical sections; for frames of
+ * hundreds of bytes on a core without a fast memcpy() that is expected to
+ * dominate.  The gain has not been measured on such a core: on a desktop host
+ * the copying queue is faster.  Here:
+ *
+ * - Messages are blocks of a memory pool (mempool.h) with a small header in
+ *   front.  pvMsgAlloc() returns the payload with one reference, held by the
+ *   caller.
+ * - The queue is a FreeRTOS queue of pointers, so sending and receiving keep
+ *   every blocking, timeout and priority rule of queue.c while copying one
+ *   pointer.  Sending moves the caller's reference into the queue; receiving
+ *   moves it to the receiver.
+ * - Whoever holds a reference either passes it on or drops it with
+ *   vMsgRelease().  The last release returns the block to its pool.
+ *   vMsgRetain() adds a reference, to send one message to several queues.
+ *
+ * Reference counts are updated atomically (with interrupts masked on cores
+ * without exclusive access instructions), and every call has a FromISR
+ * variant.  A message must not be written after it has been sent: other
+ * holders may be reading it.
+ *
+ * Only use the functions below on a message queue.  xQueuePeek() in
+ * particular would read a message without taking a reference.
+ */
+
+/* Bytes in front of each payload.  Keeps the payload aligned to
+ * portBYTE_ALIGNMENT. */
+#define msgqueueHEADER_SIZE                    mempoolBLOCK_SIZE( sizeof( void * ) + sizeof( UBaseType_t ) )
+
+/* Item size to create the pool of messages of xPayloadSize bytes with. */
+#define msgqueueMESSAGE_SIZE( xPayloadSize )    ( msgqueueHEADER_SIZE + ( xPayloadSize ) )
+
+/* Bytes of queue storage a message queue of uxLength messages needs. */
+#define msgqueueSTORAGE_SIZE( uxLength )        ( ( uxLength ) * sizeof( void * ) )
+
+/**
+ * msgqueue. h
+ * @code{c}
+ * QueueHandle_t xMsgQueueCreate( UBaseType_t uxLength );
+ * QueueHandle_t xMsgQueueCreateStatic( UBaseType_t uxLength,
+ *                                      uint8_t * pucQueueStorage,
+ *                                      StaticQueue_t * pxStaticQueue );
+ * @endcode
+ *
+ * Creates a queue that holds up to uxLength messages, with the same memory
+ * rules as xQueueCreate() and xQueueCreateStatic().  pucQueueStorage must
+ * point to msgqueueSTORAGE_SIZE( uxLength ) bytes.
+ *
+ * @return The handle of the new queue, or NULL if there was not enough heap.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    #define xMsgQueueCreate( uxLength )    xQueueCreate( ( uxLength ), sizeof( void * ) )
+#endif
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    #define xMsgQueueCreateStatic( uxLength, pucQueueStorage, pxStaticQueue ) \
+    xQueueCreateStatic( ( uxLength ), sizeof( void * ), ( pucQueueStorage ), ( pxStaticQueue ) )
+#endif
+
+/**
+ * msgqueue. h
+ * @code{c}
+ * void vMsgQueueDelete( QueueHandle_t xQueue );
+ * @endcode
+ *
+ * Releases the messages still in the queue and deletes it.  No task may be
+ * blocked on the queue.
+ */
+void vMsgQueueDelete( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * msgqueue. h
+ * @code{c}
+ * void * pvMsgAlloc( MemPoolHandle_t xPool );
+ * void * pvMsgAllocFromISR( MemPoolHandle_t xPool );
+ * @endcode
+ *
+ * Takes a message from xPool, a pool created with an item size of
+ * msgqueueMESSAGE_SIZE( xPayloadSize ).  Never blocks.
+ *
+ * @return The payload, with one reference held by the caller, or NULL if the
+ * pool is empty.
+ */
+void * pvMsgAlloc( MemPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+void * pvMsgAllocFromISR( MemPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * msgqueue. h
+ * @code{c}
+ * void vMsgRetain( void * pvMessage );
+ * void vMsgRetainFromISR( void * pvMessage );
+ * void vMsgRelease( void * pvMessage );
+ * void vMsgReleaseFromISR( void * pvMessage );
+ * @endcode
+ *
+ * Add or drop a reference to a message held by the caller.  The release of
+ * the last reference returns the message to its pool.
+ */
+void vMsgRetain( void * pvMessage ) PRIVILEGED_FUNCTION;
+void vMsgRetainFromISR( void * pvMessage ) PRIVILEGED_FUNCTION;
+void vMsgRelease( void * pvMessage ) PRIVILEGED_FUNCTION;
+void vMsgReleaseFromISR( void * pvMessage ) PRIVILEGED_FUNCTION;
+
+/**
+ * msgqueue. h
+ * @code{c}
+ * BaseType_t xMsgQueueSend( QueueHandle_t xQueue,
+ *                           void * pvMessage,
+ *                           TickType_t xTicksToWait );
+ * BaseType_t xMsgQueueSendFromISR( QueueHandle_t xQueue,
+ *                                  void * pvMessage,
+ *                                  BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Posts a message to the back of the queue, waiting up to xTicksToWait for
+ * space as xQueueSend() does.
+ *
+ * @return pdPASS if the message was queued, and the caller's reference went
+ * with it.  errQUEUE_FULL otherwise, and the caller still holds it.
+ */
+BaseType_t xMsgQueueSend( QueueHandle_t xQueue,
+                          void * pvMessage,
+                          TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xMsgQueueSendFromISR( QueueHandle_t xQueue,
+                                 void * pvMessage,
+                                 BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * msgqueue. h
+ * @code{c}
+ * void * pvMsgQueueReceive( QueueHandle_t xQueue,
+ *                           TickType_t xTicksToWait );
+ * void * pvMsgQueueReceiveFromISR( QueueHandle_t xQueue,
+ *                                  BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Takes the message at the front of the queue, waiting up to xTicksToWait for
+ * one as xQueueReceive() does.
+ *
+ * @return The message, whose reference now belongs to the caller, or NULL if
+ * the queue stayed empty.
+ */
+void * pvMsgQueueReceive( QueueHandle_t xQueue,
+                          TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void * pvMsgQueueReceiveFromISR( QueueHandle_t xQueue,
+                                 BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * msgqueue. h
+ * @code{c}
+ * UBaseType_t uxMsgGetReferences( const void * pvMessage );
+ * size_t xMsgGetSize( const void * pvMessage );
+ * @endcode
+ *
+ * @return The references a message has now, and its payload size (the pool's
+ * block size less the header, so at least the size it was created for).
+ */
+UBaseType_t uxMsgGetReferences( const void * pvMessage ) PRIVILEGED_FUNCTION;
+size_t xMsgGetSize( const void * pvMessage ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MSGQUEUE_H */
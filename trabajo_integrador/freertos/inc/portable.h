@@ -50,7 +50,11 @@
  * included here.  In this case the path to the correct portmacro.h header file
  * must be set in the compiler's include path. */
 #ifndef portENTER_CRITICAL
-    #include "portmacro.h"
+    #ifdef FREERTOS_PORT_POSIX
+        #include "portmacro_posix.h"
+    #else
+        #include "portmacro.h"
+    #endif
 #endif
 
 #if portBYTE_ALIGNMENT == 32
@@ -0,0 +1,203 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+#ifndef PORTMACRO_POSIX_H
+    #define PORTMACRO_POSIX_H
+
+    #ifdef __cplusplus
+        extern "C" {
+    #endif
+
+/*-----------------------------------------------------------
+ * Port specific definitions for the host (POSIX) simulator.
+ *
+ * Tasks run as ucontext coroutines on a single host thread, so only one task
+ * executes at a time and a context switch can only happen at the points where
+ * the kernel asks for one.  There is no real tick interrupt: time is virtual
+ * and is advanced by the simulator (see vPortSimulateTick()), which lets hours
+ * of scheduler activity run in seconds of wall-clock time.
+ *-----------------------------------------------------------
+ */
+
+    #include <stdint.h>
+
+/* Type definitions. */
+    #define portCHAR                 char
+    #define portFLOAT                float
+    #define portDOUBLE               double
+    #define portLONG                 long
+    #define portSHORT                short
+    #define portSTACK_TYPE           uint32_t
+    #define portBASE_TYPE            long
+    #define portPOINTER_SIZE_TYPE    uintptr_t
+
+    typedef portSTACK_TYPE   StackType_t;
+    typedef long             BaseType_t;
+    typedef unsigned long    UBaseType_t;
+
+    #if ( configUSE_16_BIT_TICKS == 1 )
+        typedef uint16_t     TickType_t;
+        #define portMAX_DELAY              ( TickType_t ) 0xffff
+    #else
+        typedef uint32_t     TickType_t;
+        #define portMAX_DELAY              ( TickType_t ) 0xffffffffUL
+        #define portTICK_TYPE_IS_ATOMIC    1
+    #endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specifics.  The FreeRTOS stack of each task only holds a
+ * pointer to the host context; the code itself runs on a separate host stack
+ * of portSIM_HOST_STACK_SIZE bytes. */
+    #define portSTACK_GROWTH          ( -1 )
+    #define portTICK_PERIOD_MS        ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+    #define portBYTE_ALIGNMENT        8
+    #define portDONT_DISCARD          __attribute__( ( used ) )
+    #define portSIM_HOST_STACK_SIZE   ( 128U * 1024U )
+/*-----------------------------------------------------------*/
+
+/* Scheduler utilities. */
+    extern void vPortYield( void );
+    extern void vPortYieldFromISR( BaseType_t xSwitchRequired );
+    #define portYIELD()                                 vPortYield()
+    #define portEND_SWITCHING_ISR( xSwitchRequired )    vPortYieldFromISR( xSwitchRequired )
+    #define portYIELD_FROM_ISR( x )                     portEND_SWITCHING_ISR( x )
+/*-----------------------------------------------------------*/
+
+/* Critical section management. */
+    extern void vPortEnterCritical( void );
+    extern void vPortExitCritical( void );
+    extern void vPortDisableInterrupts( void );
+    extern void vPortEnableInterrupts( void );
+    extern uint32_t ulSetInterruptMaskFromISR( void );
+    extern void vClearInterruptMaskFromISR( uint32_t ulMask );
+
+    #define portSET_INTERRUPT_MASK_FROM_ISR()         ulSetInterruptMaskFromISR()
+    #define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )    vClearInterruptMaskFromISR( x )
+    #define portDISABLE_INTERRUPTS()                  vPortDisableInterrupts()
+    #define portENABLE_INTERRUPTS()                   vPortEnableInterrupts()
+    #define portENTER_CRITICAL()                      vPortEnterCritical()
+    #define portEXIT_CRITICAL()                       vPortExitCritical()
+
+/*-----------------------------------------------------------*/
+
+/* Tickless idle: on the host "sleeping" is a jump of the virtual clock. */
+    #ifndef portSUPPRESS_TICKS_AND_SLEEP
+        extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+        #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
+    #endif
+/*-----------------------------------------------------------*/
+
+/* High resolution timers (timers.h): a counter of configHIGH_RES_TIMER_HZ
+ * that advances with the virtual tick, and a compare that interrupts on the
+ * first tick at or after it.  Timers keep their order and period on the host,
+ * but fire with tick resolution. */
+    #ifndef portHIGH_RES_TIMER_GET_COUNT
+        extern uint32_t ulPortSimHighResGetCount( void );
+        extern void vPortSimHighResSetCompare( uint32_t ulCount );
+        extern void vPortSimHighResDisableCompare( void );
+        #define portHIGH_RES_TIMER_GET_COUNT()              ulPortSimHighResGetCount()
+        #define portHIGH_RES_TIMER_SET_COMPARE( ulCount )    vPortSimHighResSetCompare( ulCount )
+        #define portHIGH_RES_TIMER_DISABLE_COMPARE()        vPortSimHighResDisableCompare()
+    #endif
+/*-----------------------------------------------------------*/
+
+/* Release the host context of a task when the kernel frees its TCB. */
+    extern void vPortCleanUpTCB( void * pxTCB );
+    #define portCLEAN_UP_TCB( pxTCB )    vPortCleanUpTCB( pxTCB )
+/*-----------------------------------------------------------*/
+
+/* Simulator control, used by the host application. */
+
+/* Run one simulated tick interrupt.  Normally called from the idle hook, so
+ * virtual time only advances while every application task is blocked. */
+    extern void vPortSimulateTick( void );
+
+/* Run pxHandler as if it were an interrupt service routine.  Context switches
+ * requested with portYIELD_FROM_ISR() are taken when the handler returns. */
+    extern void vPortSimulateInterrupt( void ( * pxHandler )( void ) );
+
+/* Run pxHandler as an interrupt in the tick interrupt that brings the tick
+ * count xTicksFromNow ticks ahead of the current one.  This models peripheral
+ * interrupts (pin edges, hardware timers): tickless idle never sleeps past a
+ * scheduled interrupt, exactly as a real one would wake the core.  Handlers
+ * may schedule further interrupts; at most portSIM_MAX_SCHEDULED_INTERRUPTS
+ * can be pending at a time. */
+    #define portSIM_MAX_SCHEDULED_INTERRUPTS    8
+    extern void vPortSimScheduleInterrupt( TickType_t xTicksFromNow,
+                                           void ( * pxHandler )( void ) );
+
+/* End the scheduler (vTaskStartScheduler() returns) once the tick count
+ * reaches xEndTick.  0 runs forever. */
+    extern void vPortSimSetEndTick( TickType_t xEndTick );
+
+/* Pace virtual time against the wall clock: 1 runs in real time, 10 ten times
+ * faster, 0 (the default) as fast as the host allows. */
+    extern void vPortSimSetSpeed( uint32_t ulSpeedFactor );
+
+/* Context switches performed since the scheduler was started. */
+    extern uint64_t ullPortSimGetContextSwitches( void );
+
+/* Monotonic host clock in nanoseconds, used for benchmarks. */
+    extern uint64_t ullPortSimGetHostTimeNs( void );
+
+/* Timestamps of the trace recorder: virtual time in units of 100 ns.  Within a
+ * tick it advances with the host clock, up to the end of the tick, so events
+ * keep their order and their spacing in virtual time. */
+    #define portSIM_TRACE_TIMESTAMP_HZ    10000000UL
+    extern uint32_t ulPortSimGetTraceTimestamp( void );
+
+/* Count and host time of the sections run with interrupts masked (critical
+ * sections and ISRs, the tick included) and of the tick interrupt alone.
+ * vPortSimMeasureCritical( pdTRUE ) clears the counters and starts
+ * measuring; it costs two clock reads per section. */
+    typedef struct SimCriticalStats
+    {
+        uint64_t ullCount;
+        uint64_t ullTotalNs;
+        uint64_t ullMaxNs;
+    } SimCriticalStats_t;
+
+    extern void vPortSimMeasureCritical( BaseType_t xEnable );
+    extern void vPortSimGetCriticalStats( SimCriticalStats_t * pxMasked,
+                                          SimCriticalStats_t * pxTick );
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+    #define portTASK_FUNCTION_PROTO( vFunction, pvParameters )    void vFunction( void * pvParameters )
+    #define portTASK_FUNCTION( vFunction, pvParameters )          void vFunction( void * pvParameters )
+
+    #define portNOP()
+
+    #define portMEMORY_BARRIER()    __asm volatile ( "" ::: "memory" )
+
+    #ifdef __cplusplus
+        }
+    #endif
+
+#endif /* PORTMACRO_POSIX_H */
@@ -64,6 +64,24 @@ typedef struct QueueDefinition   * QueueSetHandle_t;
  */
 typedef struct QueueDefinition   * QueueSetMemberHandle_t;
 
+/**
+ * Contention statistics of a mutex, filled in by vSemaphoreGetMutexStats()
+ * when configUSE_MUTEX_STATS is 1.  Times are in microseconds.  Only the
+ * outermost take and give of a recursive mutex count.
+ */
+typedef struct xMUTEX_STATS
+{
+    uint32_t ulTakes;         /*< Successful takes. */
+    uint32_t ulWaits;         /*< Takes that found the mutex held and had to wait, including those that timed out. */
+    uint32_t ulTimeouts;      /*< Waits that ended without the mutex. */
+    uint32_t ulInheritances;  /*< Waits during which the holder ran at the priority inherited from the waiting task. */
+    uint32_t ulHoldMax;       /*< Longest time between a take and its give. */
+    uint32_t ulWaitMax;       /*< Longest wait. */
+    uint64_t ullHoldTotal;    /*< Sum of all the hold times. */
+    uint64_t ullWaitTotal;    /*< Sum of all the waits. */
+    UBaseType_t uxMaxWaiters; /*< Most tasks blocked on the mutex at the same time. */
+} MutexStats_t;
+
 /* For internal use only. */
 #define queueSEND_TO_BACK                     ( ( BaseType_t ) 0 )
 #define queueSEND_TO_FRONT                    ( ( BaseType_t ) 1 )
@@ -1465,6 +1483,9 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 TaskHandle_t xQueueGetMutexHolder( QueueHandle_t xSemaphore ) PRIVILEGED_FUNCTION;
 TaskHandle_t xQueueGetMutexHolderFromISR( QueueHandle_t xSemaphore ) PRIVILEGED_FUNCTION;
+void vQueueGetMutexStats( QueueHandle_t xMutex,
+                          MutexStats_t * pxStats,
+                          BaseType_t xReset ) PRIVILEGED_FUNCTION;
 
 /*
  * For internal use only.  Use xSemaphoreTakeMutexRecursive() or
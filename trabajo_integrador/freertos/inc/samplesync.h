@@ -0,0 +1,225 @@
+/*
+ * Aligned sample sets from several producers for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SAMPLESYNC_H
+#define SAMPLESYNC_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include samplesync.h"
+#endif
+
+#include "event_groups.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A sample sync gathers one sample per period from each of N producers (the
+ * sensors) and hands the consumer (the fusion) only complete sets, all of the
+ * same period:
+ *
+ * - Each producer posts its sample with the number of the period it belongs
+ *   to and a timestamp.  Posting never blocks and may be done from an ISR.
+ * - Two periods are collected at once, so a producer that runs a little late
+ *   still completes the set of the previous period.  A set that is still
+ *   incomplete when a third period starts, or when a later set completes, is
+ *   dropped; a sample for a period already completed or dropped is rejected
+ *   as late.
+ * - The consumer blocks on an event group bit until a set is ready, and gets
+ *   the samples in producer order with the period and the spread of their
+ *   timestamps (the skew).  If it does not keep up, only the newest complete
+ *   set is kept.
+ * - Producers that sample on their own can first meet at a barrier built on
+ *   xEventGroupSync(), so that they all take their sample at the same time.
+ *
+ * Samples are copied in and out with interrupts masked, so keep them small.
+ */
+struct SampleSyncDefinition;
+typedef struct SampleSyncDefinition * SampleSyncHandle_t;
+
+/* A complete set, see xSampleSyncReceive(). */
+typedef struct xSAMPLE_SYNC_SET
+{
+    uint32_t ulPeriod;          /* Period all the samples belong to. */
+    uint32_t ulFirstTimestamp;  /* Earliest and latest timestamp of the set. */
+    uint32_t ulLastTimestamp;
+} SampleSyncSet_t;
+
+/* Counters of a sample sync, see vSampleSyncGetStats(). */
+typedef struct xSAMPLE_SYNC_STATS
+{
+    uint32_t ulSets;            /* Complete sets. */
+    uint32_t ulDropped;         /* Incomplete sets discarded. */
+    uint32_t ulOverwritten;     /* Complete sets replaced before the consumer took them. */
+    uint32_t ulLate;            /* Samples rejected because their period was over. */
+    uint32_t ulSkewMax;         /* Largest skew of a complete set. */
+    uint64_t ullSkewTotal;      /* Sum of the skews of the complete sets, for the mean. */
+} SampleSyncStats_t;
+
+/* Internal state of one of the two periods being collected. */
+typedef struct xSAMPLE_SYNC_SLOT
+{
+    uint32_t ulArrived;         /* Producers whose sample is in; 0 if the slot is free. */
+    uint32_t ulBank;
+    SampleSyncSet_t xSet;
+} SampleSyncSlot_t;
+
+/*
+ * Memory for a sample sync created with xSampleSyncCreateStatic().  Like
+ * StaticQueue_t, its size and alignment match the real structure but its
+ * members are not meant to be used by the application.
+ */
+typedef struct xSTATIC_SAMPLE_SYNC
+{
+    StaticEventGroup_t xDummy1;
+    void * pvDummy2[ 2 ];
+    size_t xDummy3;
+    uint32_t ulDummy4[ 4 ];
+    SampleSyncSlot_t xDummy5[ 2 ];
+    SampleSyncSet_t xDummy6;
+    SampleSyncStats_t xDummy7;
+} StaticSampleSync_t;
+
+/* Most producers: one event group bit each, and one more for the consumer. */
+#if ( configUSE_16_BIT_TICKS == 1 )
+    #define samplesyncMAX_PRODUCERS    ( 7U )
+#else
+    #define samplesyncMAX_PRODUCERS    ( 23U )
+#endif
+
+/* Bytes of sample storage for uxProducers samples of xSampleSize bytes: one
+ * bank for each period being collected and one for the set ready to read. */
+#define samplesyncSTORAGE_SIZE( uxProducers, xSampleSize )    ( 3U * ( uxProducers ) * ( xSampleSize ) )
+
+/**
+ * samplesync. h
+ * @code{c}
+ * SampleSyncHandle_t xSampleSyncCreate( UBaseType_t uxProducers, size_t xSampleSize );
+ * SampleSyncHandle_t xSampleSyncCreateStatic( UBaseType_t uxProducers,
+ *                                             size_t xSampleSize,
+ *                                             uint8_t * pucStorage,
+ *                                             StaticSampleSync_t * pxStaticSync );
+ * @endcode
+ *
+ * Creates a sample sync for uxProducers producers, 1 to
+ * samplesyncMAX_PRODUCERS, numbered from 0, each posting samples of
+ * xSampleSize bytes.  The static version needs
+ * samplesyncSTORAGE_SIZE( uxProducers, xSampleSize ) bytes of storage and the
+ * memory that holds the structure; both must outlive the sample sync.
+ *
+ * @return The handle of the new sample sync, or NULL if there was not enough
+ * heap.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    SampleSyncHandle_t xSampleSyncCreate( UBaseType_t uxProducers,
+                                          size_t xSampleSize ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+    SampleSyncHandle_t xSampleSyncCreateStatic( UBaseType_t uxProducers,
+                                                size_t xSampleSize,
+                                                uint8_t * pucStorage,
+                                                StaticSampleSync_t * pxStaticSync ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * samplesync. h
+ * @code{c}
+ * BaseType_t xSampleSyncPost( SampleSyncHandle_t xSync,
+ *                             UBaseType_t uxProducer,
+ *                             uint32_t ulPeriod,
+ *                             uint32_t ulTimestamp,
+ *                             const void * pvSample );
+ * BaseType_t xSampleSyncPostFromISR( SampleSyncHandle_t xSync,
+ *                                    UBaseType_t uxProducer,
+ *                                    uint32_t ulPeriod,
+ *                                    uint32_t ulTimestamp,
+ *                                    const void * pvSample,
+ *                                    BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Posts the sample of producer uxProducer for period ulPeriod.  Periods are
+ * numbered by the application (a sample counter, or the time divided by the
+ * sampling period) and compared with wrap around.  ulTimestamp is in any unit
+ * the producers share, and only used for the skew.  Posting again for the
+ * same period replaces the sample.  If the post completes the set, the
+ * consumer is released; from an ISR that goes through the timer task, as
+ * with xEventGroupSetBitsFromISR().
+ *
+ * @return pdPASS, or pdFAIL if the sample was late and was discarded.
+ */
+BaseType_t xSampleSyncPost( SampleSyncHandle_t xSync,
+                            UBaseType_t uxProducer,
+                            uint32_t ulPeriod,
+                            uint32_t ulTimestamp,
+                            const void * pvSample ) PRIVILEGED_FUNCTION;
+BaseType_t xSampleSyncPostFromISR( SampleSyncHandle_t xSync,
+                                   UBaseType_t uxProducer,
+                                   uint32_t ulPeriod,
+                                   uint32_t ulTimestamp,
+                                   const void * pvSample,
+                                   BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * samplesync. h
+ * @code{c}
+ * BaseType_t xSampleSyncReceive( SampleSyncHandle_t xSync,
+ *                                void * pvSamples,
+ *                                SampleSyncSet_t * pxSet,
+ *                                TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Consumer only.  Waits up to xTicksToWait for a complete set and copies its
+ * uxProducers samples, in producer order, to pvSamples.  pxSet, which may be
+ * NULL, receives the period and the timestamps of the set.
+ *
+ * @return pdPASS, or pdFAIL if no set was ready in time.
+ */
+BaseType_t xSampleSyncReceive( SampleSyncHandle_t xSync,
+                               void * pvSamples,
+                               SampleSyncSet_t * pxSet,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * samplesync. h
+ * @code{c}
+ * BaseType_t xSampleSyncBarrier( SampleSyncHandle_t xSync,
+ *                                UBaseType_t uxProducer,
+ *                                TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Producer tasks only.  Blocks until every producer has called it, with
+ * xEventGroupSync(), so that all of them go on to sample at the same time.
+ * The last producer to arrive releases the others.
+ *
+ * @return pdPASS, or pdFAIL if some producer did not arrive within
+ * xTicksToWait.
+ */
+BaseType_t xSampleSyncBarrier( SampleSyncHandle_t xSync,
+                               UBaseType_t uxProducer,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * samplesync. h
+ * @code{c}
+ * void vSampleSyncGetStats( SampleSyncHandle_t xSync, SampleSyncStats_t * pxStats );
+ * @endcode
+ *
+ * Copies the counters of the sample sync.
+ */
+void vSampleSyncGetStats( SampleSyncHandle_t xSync,
+                          SampleSyncStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* SAMPLESYNC_H */
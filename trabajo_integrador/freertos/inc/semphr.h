@@ -1162,6 +1162,36 @@ typedef QueueHandle_t SemaphoreHandle_t;
     #define xSemaphoreGetMutexHolderFromISR( xSemaphore )    xQueueGetMutexHolderFromISR( ( xSemaphore ) )
 #endif
 
+/**
+ * semphr.h
+ * @code{c}
+ * void vSemaphoreGetMutexStats( SemaphoreHandle_t xMutex, MutexStats_t *pxStats, BaseType_t xReset );
+ * @endcode
+ *
+ * Copies the contention statistics of a mutex or recursive mutex into
+ * *pxStats: how many takes had to wait and for how long, how long the mutex
+ * was held, the most tasks waiting at once and how often the holder ran at an
+ * inherited priority.  If xReset is pdTRUE the statistics start again from
+ * zero.  Only available when configUSE_MUTEX_STATS is 1.
+ *
+ * A wait that timed out is counted in the wait times as well as in
+ * ulTimeouts.  A take that waited longer than the deadline of the taking
+ * task points at the mutex, and ulHoldMax at how long its holders keep it.
+ *
+ * Example usage:
+ * @code{c}
+ * MutexStats_t xStats;
+ *
+ * vSemaphoreGetMutexStats( xMutex, &xStats, pdTRUE );
+ * printf( "%u waits, max %u us, held max %u us, %u inheritances\n",
+ *         xStats.ulWaits, xStats.ulWaitMax, xStats.ulHoldMax,
+ *         xStats.ulInheritances );
+ * @endcode
+ */
+#if ( configUSE_MUTEX_STATS == 1 )
+    #define vSemaphoreGetMutexStats( xMutex, pxStats, xReset )    vQueueGetMutexStats( ( QueueHandle_t ) ( xMutex ), ( pxStats ), ( xReset ) )
+#endif
+
 /**
  * semphr.h
  * @code{c}
@@ -1323,6 +1323,140 @@ TickType_t xTimerGetPeriod( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
  */
 TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_HIGH_RES_TIMERS == 1 )
+
+/*
+ * High resolution timers.
+ *
+ * The timers above count ticks, so a 1 ms tick is also their resolution.  A
+ * high resolution timer counts periods of a free running hardware counter
+ * instead (configHIGH_RES_TIMER_HZ), and expires in the interrupt of a compare
+ * register of that counter, between ticks.  Its callback then runs either in
+ * the timer service task, like any other timer callback, or straight in the
+ * interrupt for jobs of a few microseconds that cannot wait for the timer task
+ * to be scheduled.  A callback run in the interrupt may only use the FromISR
+ * API functions.
+ *
+ * They are started, stopped and changed directly, with interrupts masked for
+ * a few list operations, instead of through the timer command queue: starting
+ * one from a task or an interrupt takes effect at once and never blocks.
+ * Only the functions below, and the getters above, may be used on them; they
+ * cannot be deleted.  xTimerGetPeriod() and xTimerGetExpiryTime() return
+ * counts of the hardware counter.
+ *
+ * The counter is provided by three port macros, defined in FreeRTOSConfig.h:
+ * portHIGH_RES_TIMER_GET_COUNT() reads it, portHIGH_RES_TIMER_SET_COMPARE( x )
+ * makes the interrupt that calls vTimerHighResInterruptHandler() fire when it
+ * reaches x (or at once if x has already passed), and
+ * portHIGH_RES_TIMER_DISABLE_COMPARE() turns that interrupt off.
+ */
+
+/* Where the callback of a high resolution timer runs. */
+    #define tmrHIGH_RES_CALLBACK_IN_TASK    ( ( BaseType_t ) 0 )
+    #define tmrHIGH_RES_CALLBACK_IN_ISR     ( ( BaseType_t ) 1 )
+
+/* Converts microseconds to counts of the high resolution counter. */
+    #define pdUS_TO_HIGH_RES_COUNTS( xTimeInUs )    ( ( uint32_t ) ( ( ( uint64_t ) ( xTimeInUs ) * ( uint64_t ) configHIGH_RES_TIMER_HZ ) / 1000000ULL ) )
+
+/* Longest period, so that an expiry time is never mistaken for a past one. */
+    #define tmrHIGH_RES_MAX_PERIOD                  ( ( uint32_t ) 0x7fffffffUL )
+
+/* Counters kept by vTimerGetHighResStats(). */
+    typedef struct xTIMER_HIGH_RES_STATS
+    {
+        uint32_t ulExpiries;   /* Callbacks run or handed to the timer task. */
+        uint32_t ulOverruns;   /* Auto-reload periods skipped because the interrupt came too late. */
+        uint32_t ulDropped;    /* Callbacks lost because the timer command queue was full. */
+    } TimerHighResStats_t;
+
+/**
+ * timers. h
+ * @code{c}
+ * TimerHandle_t xTimerCreateHighRes( const char * const pcTimerName,
+ *                                    const uint32_t ulPeriodInCounts,
+ *                                    const BaseType_t xAutoReload,
+ *                                    void * const pvTimerID,
+ *                                    TimerCallbackFunction_t pxCallbackFunction,
+ *                                    const BaseType_t xCallbackContext );
+ * TimerHandle_t xTimerCreateHighResStatic( ..., StaticTimer_t * pxTimerBuffer );
+ * @endcode
+ *
+ * Creates a high resolution timer, in the dormant state, like xTimerCreate()
+ * and xTimerCreateStatic().  ulPeriodInCounts goes from 1 to
+ * tmrHIGH_RES_MAX_PERIOD; use pdUS_TO_HIGH_RES_COUNTS() to give it in
+ * microseconds.  xCallbackContext is tmrHIGH_RES_CALLBACK_IN_TASK or
+ * tmrHIGH_RES_CALLBACK_IN_ISR.
+ *
+ * @return The handle of the timer, or NULL if there was not enough heap.
+ */
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+        TimerHandle_t xTimerCreateHighRes( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                           const uint32_t ulPeriodInCounts,
+                                           const BaseType_t xAutoReload,
+                                           void * const pvTimerID,
+                                           TimerCallbackFunction_t pxCallbackFunction,
+                                           const BaseType_t xCallbackContext ) PRIVILEGED_FUNCTION;
+    #endif
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+        TimerHandle_t xTimerCreateHighResStatic( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                                 const uint32_t ulPeriodInCounts,
+                                                 const BaseType_t xAutoReload,
+                                                 void * const pvTimerID,
+                                                 TimerCallbackFunction_t pxCallbackFunction,
+                                                 const BaseType_t xCallbackContext,
+                                                 StaticTimer_t * pxTimerBuffer ) PRIVILEGED_FUNCTION;
+    #endif
+
+/**
+ * timers. h
+ * @code{c}
+ * void vTimerHighResStart( TimerHandle_t xTimer );
+ * void vTimerHighResStartFromISR( TimerHandle_t xTimer );
+ * void vTimerHighResChangePeriod( TimerHandle_t xTimer, const uint32_t ulNewPeriodInCounts );
+ * void vTimerHighResChangePeriodFromISR( TimerHandle_t xTimer, const uint32_t ulNewPeriodInCounts );
+ * void vTimerHighResStop( TimerHandle_t xTimer );
+ * void vTimerHighResStopFromISR( TimerHandle_t xTimer );
+ * @endcode
+ *
+ * Start (or restart) a high resolution timer one period from now, optionally
+ * with a new period, or stop it.  The counter must be running, so call them
+ * after the scheduler has started.  A callback already handed to the timer
+ * task still runs after the timer is stopped.
+ */
+    void vTimerHighResStart( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+    void vTimerHighResStartFromISR( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+    void vTimerHighResChangePeriod( TimerHandle_t xTimer,
+                                    const uint32_t ulNewPeriodInCounts ) PRIVILEGED_FUNCTION;
+    void vTimerHighResChangePeriodFromISR( TimerHandle_t xTimer,
+                                           const uint32_t ulNewPeriodInCounts ) PRIVILEGED_FUNCTION;
+    void vTimerHighResStop( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+    void vTimerHighResStopFromISR( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * timers. h
+ * @code{c}
+ * void vTimerHighResInterruptHandler( void );
+ * @endcode
+ *
+ * Called from the compare interrupt of the high resolution counter.  Runs or
+ * hands to the timer task the callbacks of every timer that has expired, and
+ * sets the compare register for the next one.
+ */
+    void vTimerHighResInterruptHandler( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * timers. h
+ * @code{c}
+ * void vTimerGetHighResStats( TimerHighResStats_t * pxStats );
+ * @endcode
+ *
+ * Copies the counters of the high resolution timers since the start.
+ */
+    void vTimerGetHighResStats( TimerHighResStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_HIGH_RES_TIMERS */
+
 /*
  * Functions beyond this part are not part of the public API and are intended
  * for use by the kernel only.
@@ -0,0 +1,246 @@
+/*
+ * Kernel trace recorder for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include tracerecorder.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * With configUSE_TRACE_RECORDER set to 1 the kernel trace hooks (traceXXX()
+ * in FreeRTOS.h) write compact records into a RAM ring, oldest overwritten
+ * first, so that after a problem the last few thousand events are there to
+ * look at:
+ *
+ * - Context switches, tasks made ready (the time from ready to running is the
+ *   scheduling latency), delays, queue, semaphore and mutex operations,
+ *   including failures and blocking, and task notifications.
+ * - Interrupt entry and exit, for the handlers that call
+ *   vTraceRecorderISREnter() and vTraceRecorderISRExit().
+ * - User markers: a value on a named channel, vTraceRecorderMarker().
+ *
+ * Each record takes 8 bytes: a timestamp from configTRACE_RECORDER_TIMESTAMP(),
+ * which counts at configTRACE_RECORDER_TIMESTAMP_HZ, the event, the object and
+ * a 16-bit value.  Tasks, queues, interrupts and channels are objects numbered
+ * from 1 in a table that keeps their names.
+ *
+ * The whole recorder is the single structure xTraceRecorder, laid out as
+ * TraceRecorderHeader_t, configTRACE_RECORDER_OBJECTS TraceObject_t and
+ * configTRACE_RECORDER_RECORDS TraceRecord_t, all little endian.  A dump is
+ * that structure as is, whether it comes from vTraceRecorderDump() or straight
+ * from a debugger, and host/traza_json converts it to a timeline.
+ *
+ * The recorder is off until vTraceRecorderStart(), but objects are named from
+ * the start, so it can be started at any time.
+ */
+
+/* Object types. */
+#define traceOBJECT_TASK                  ( 1U )
+#define traceOBJECT_QUEUE                 ( 2U )    /* Plus ucQueueType, for semaphores and mutexes. */
+#define traceOBJECT_ISR                   ( 7U )
+#define traceOBJECT_CHANNEL               ( 8U )
+
+/* Events.  The object is a task for the task events and the current task for
+ * delays and waits; the value of the queue events is the number of items left
+ * in the queue. */
+#define traceEVENT_TASK_SWITCHED_IN       ( 1U )
+#define traceEVENT_TASK_READY             ( 2U )
+#define traceEVENT_TASK_DELAY             ( 3U )
+#define traceEVENT_QUEUE_SEND             ( 4U )
+#define traceEVENT_QUEUE_SEND_FAILED      ( 5U )
+#define traceEVENT_QUEUE_RECEIVE          ( 6U )
+#define traceEVENT_QUEUE_RECEIVE_FAILED   ( 7U )
+#define traceEVENT_QUEUE_PEEK             ( 8U )
+#define traceEVENT_QUEUE_BLOCK_SEND       ( 9U )
+#define traceEVENT_QUEUE_BLOCK_RECEIVE    ( 10U )
+#define traceEVENT_QUEUE_SEND_ISR         ( 11U )
+#define traceEVENT_QUEUE_SEND_ISR_FAILED  ( 12U )
+#define traceEVENT_QUEUE_RECEIVE_ISR      ( 13U )
+#define traceEVENT_QUEUE_RECEIVE_ISR_FAILED    ( 14U )
+#define traceEVENT_TASK_NOTIFY            ( 15U )
+#define traceEVENT_TASK_NOTIFY_ISR        ( 16U )
+#define traceEVENT_TASK_NOTIFY_WAIT       ( 17U )
+#define traceEVENT_ISR_ENTER              ( 18U )
+#define traceEVENT_ISR_EXIT               ( 19U )
+#define traceEVENT_MARKER                 ( 20U )
+
+#define traceRECORDER_MAGIC               ( 0x52545246UL )  /* "FRTR" */
+#define traceRECORDER_VERSION             ( 1U )
+#define traceRECORDER_NAME_LENGTH         ( 15U )
+
+typedef struct xTRACE_RECORDER_HEADER
+{
+    uint32_t ulMagic;
+    uint16_t usVersion;
+    uint8_t ucMaxObjects;
+    uint8_t ucNameLength;
+    uint32_t ulTimestampHz;
+    uint32_t ulMaxRecords;
+    uint32_t ulWritten;         /* Records ever written; the next goes to ulWritten % ulMaxRecords. */
+    uint8_t ucObjects;          /* Objects named so far. */
+    uint8_t ucRunning;
+    uint16_t usReserved;
+} TraceRecorderHeader_t;
+
+typedef struct xTRACE_OBJECT
+{
+    uint8_t ucType;
+    char cName[ traceRECORDER_NAME_LENGTH ];
+} TraceObject_t;
+
+typedef struct xTRACE_RECORD
+{
+    uint32_t ulTimestamp;
+    uint8_t ucEvent;
+    uint8_t ucObject;
+    uint16_t usValue;
+} TraceRecord_t;
+
+/* Receives a dump, see vTraceRecorderDump(). */
+typedef void (* TraceRecorderWrite_t)( const void * pvData,
+                                       size_t xLength,
+                                       void * pvContext );
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+/**
+ * tracerecorder. h
+ * @code{c}
+ * void vTraceRecorderStart( void );
+ * void vTraceRecorderStop( void );
+ * @endcode
+ *
+ * Start and stop recording.  Starting again goes on after the records already
+ * in the ring.
+ */
+    void vTraceRecorderStart( void ) PRIVILEGED_FUNCTION;
+    void vTraceRecorderStop( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * tracerecorder. h
+ * @code{c}
+ * UBaseType_t uxTraceRecorderRegister( uint8_t ucType, const char * pcName );
+ * void vTraceRecorderSetName( UBaseType_t uxObject, const char * pcName );
+ * @endcode
+ *
+ * Adds an object of type ucType (traceOBJECT_ISR or traceOBJECT_CHANNEL; the
+ * kernel adds tasks and queues itself) to the table, and names it.  Names
+ * longer than traceRECORDER_NAME_LENGTH are cut.  vTraceRecorderSetName()
+ * renames an object, as vQueueAddToRegistry() does for queues.
+ *
+ * @return The object number, or 0 if the table is full; events of object 0
+ * are still recorded, as an unknown object.
+ */
+    UBaseType_t uxTraceRecorderRegister( uint8_t ucType,
+                                         const char * pcName ) PRIVILEGED_FUNCTION;
+    void vTraceRecorderSetName( UBaseType_t uxObject,
+                                const char * pcName ) PRIVILEGED_FUNCTION;
+
+/**
+ * tracerecorder. h
+ * @code{c}
+ * void vTraceRecorderISREnter( UBaseType_t uxIsr );
+ * void vTraceRecorderISRExit( UBaseType_t uxIsr );
+ * void vTraceRecorderMarker( UBaseType_t uxChannel, uint16_t usValue );
+ * @endcode
+ *
+ * Record the entry to and exit from an interrupt handler, and a value on a
+ * channel.  They can be called from any context.
+ */
+    void vTraceRecorderISREnter( UBaseType_t uxIsr ) PRIVILEGED_FUNCTION;
+    void vTraceRecorderISRExit( UBaseType_t uxIsr ) PRIVILEGED_FUNCTION;
+    void vTraceRecorderMarker( UBaseType_t uxChannel,
+                               uint16_t usValue ) PRIVILEGED_FUNCTION;
+
+/**
+ * tracerecorder. h
+ * @code{c}
+ * void vTraceRecorderDump( TraceRecorderWrite_t pxWrite, void * pvContext );
+ * @endcode
+ *
+ * Passes the recorder to pxWrite, in one call, with recording paused.  The
+ * events of that time are lost.
+ */
+    void vTraceRecorderDump( TraceRecorderWrite_t pxWrite,
+                             void * pvContext ) PRIVILEGED_FUNCTION;
+
+/* Used by the trace hooks below. */
+    void vTraceRecorderEvent( uint8_t ucEvent,
+                              UBaseType_t uxObject,
+                              uint16_t usValue ) PRIVILEGED_FUNCTION;
+
+/* Kernel trace hooks.  They are expanded inside tasks.c and queue.c, where
+ * the TCB and the queue structure are visible. */
+    #define traceTASK_CREATE( pxNewTCB ) \
+    ( pxNewTCB )->uxTaskNumber = uxTraceRecorderRegister( traceOBJECT_TASK, ( pxNewTCB )->pcTaskName )
+    #define traceTASK_SWITCHED_IN() \
+    vTraceRecorderEvent( traceEVENT_TASK_SWITCHED_IN, pxCurrentTCB->uxTaskNumber, 0 )
+    #define traceMOVED_TASK_TO_READY_STATE( pxTCB ) \
+    vTraceRecorderEvent( traceEVENT_TASK_READY, ( pxTCB )->uxTaskNumber, 0 )
+    #define traceTASK_DELAY() \
+    vTraceRecorderEvent( traceEVENT_TASK_DELAY, pxCurrentTCB->uxTaskNumber, 0 )
+    #define traceTASK_DELAY_UNTIL( xTimeToWake ) \
+    vTraceRecorderEvent( traceEVENT_TASK_DELAY, pxCurrentTCB->uxTaskNumber, 0 )
+    #define traceTASK_NOTIFY( uxIndexToNotify ) \
+    vTraceRecorderEvent( traceEVENT_TASK_NOTIFY, pxTCB->uxTaskNumber, 0 )
+    #define traceTASK_NOTIFY_FROM_ISR( uxIndexToNotify ) \
+    vTraceRecorderEvent( traceEVENT_TASK_NOTIFY_ISR, pxTCB->uxTaskNumber, 0 )
+    #define traceTASK_NOTIFY_GIVE_FROM_ISR( uxIndexToNotify ) \
+    vTraceRecorderEvent( traceEVENT_TASK_NOTIFY_ISR, pxTCB->uxTaskNumber, 0 )
+    #define traceTASK_NOTIFY_TAKE_BLOCK( uxIndexToWait ) \
+    vTraceRecorderEvent( traceEVENT_TASK_NOTIFY_WAIT, pxCurrentTCB->uxTaskNumber, 0 )
+    #define traceTASK_NOTIFY_WAIT_BLOCK( uxIndexToWait ) \
+    vTraceRecorderEvent( traceEVENT_TASK_NOTIFY_WAIT, pxCurrentTCB->uxTaskNumber, 0 )
+
+    #define traceQUEUE_CREATE( pxNewQueue ) \
+    ( pxNewQueue )->uxQueueNumber = uxTraceRecorderRegister( ( uint8_t ) ( traceOBJECT_QUEUE + ( pxNewQueue )->ucQueueType ), NULL )
+    #define traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName ) \
+    vTraceRecorderSetName( ( xQueue )->uxQueueNumber, ( pcQueueName ) )
+
+    #define traceRECORD_QUEUE( ucEvent, pxQueue ) \
+    vTraceRecorderEvent( ( ucEvent ), ( pxQueue )->uxQueueNumber, ( uint16_t ) ( pxQueue )->uxMessagesWaiting )
+    #define traceQUEUE_SEND( pxQueue )                       traceRECORD_QUEUE( traceEVENT_QUEUE_SEND, pxQueue )
+    #define traceQUEUE_SEND_FAILED( pxQueue )                traceRECORD_QUEUE( traceEVENT_QUEUE_SEND_FAILED, pxQueue )
+    #define traceQUEUE_RECEIVE( pxQueue )                    traceRECORD_QUEUE( traceEVENT_QUEUE_RECEIVE, pxQueue )
+    #define traceQUEUE_RECEIVE_FAILED( pxQueue )             traceRECORD_QUEUE( traceEVENT_QUEUE_RECEIVE_FAILED, pxQueue )
+    #define traceQUEUE_PEEK( pxQueue )                       traceRECORD_QUEUE( traceEVENT_QUEUE_PEEK, pxQueue )
+    #define traceBLOCKING_ON_QUEUE_SEND( pxQueue )           traceRECORD_QUEUE( traceEVENT_QUEUE_BLOCK_SEND, pxQueue )
+    #define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )        traceRECORD_QUEUE( traceEVENT_QUEUE_BLOCK_RECEIVE, pxQueue )
+    #define traceBLOCKING_ON_QUEUE_PEEK( pxQueue )           traceRECORD_QUEUE( traceEVENT_QUEUE_BLOCK_RECEIVE, pxQueue )
+    #define traceQUEUE_SEND_FROM_ISR( pxQueue )              traceRECORD_QUEUE( traceEVENT_QUEUE_SEND_ISR, pxQueue )
+    #define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )       traceRECORD_QUEUE( traceEVENT_QUEUE_SEND_ISR_FAILED, pxQueue )
+    #define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )           traceRECORD_QUEUE( traceEVENT_QUEUE_RECEIVE_ISR, pxQueue )
+    #define traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue )    traceRECORD_QUEUE( traceEVENT_QUEUE_RECEIVE_ISR_FAILED, pxQueue )
+
+#else /* configUSE_TRACE_RECORDER */
+
+/* Without the recorder the calls an application makes compile to nothing. */
+    #define vTraceRecorderStart()
+    #define vTraceRecorderStop()
+    #define uxTraceRecorderRegister( ucType, pcName )    ( ( UBaseType_t ) 0U )
+    #define vTraceRecorderSetName( uxObject, pcName )
+    #define vTraceRecorderISREnter( uxIsr )
+    #define vTraceRecorderISRExit( uxIsr )
+    #define vTraceRecorderMarker( uxChannel, usValue )
+    #define vTraceRecorderDump( pxWrite, pvContext )
+
+#endif /* configUSE_TRACE_RECORDER */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* TRACERECORDER_H */
@@ -0,0 +1,234 @@
+/*
+ * Hierarchical timing wheel for the delayed task lists.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "list.h"
+#include "delaywheel.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Only built when tasks.c uses the wheel. */
+#if ( configUSE_DELAY_WHEEL == 1 )
+
+#define delaywheelTOP_LEVEL    ( delaywheelLEVELS - 1U )
+
+/* Digit uxLevel of xTime, and the ticks below that digit. */
+#define delaywheelDIGIT( xTime, uxLevel )    ( ( UBaseType_t ) ( ( ( xTime ) >> ( ( uxLevel ) * configDELAY_WHEEL_SLOT_BITS ) ) & ( delaywheelSLOTS - 1U ) ) )
+#define delaywheelLOW_MASK( uxLevel )        ( ( ( TickType_t ) 1 << ( ( uxLevel ) * configDELAY_WHEEL_SLOT_BITS ) ) - ( TickType_t ) 1 )
+
+/* Index of the lowest set bit of a non-zero slot bitmap. */
+#if defined( __GNUC__ )
+    #define delaywheelLOWEST_BIT( ulBits )    ( ( UBaseType_t ) __builtin_ctz( ulBits ) )
+#else
+    static UBaseType_t prvLowestBit( uint32_t ulBits )
+    {
+        UBaseType_t uxBit = 0;
+
+        while( ( ulBits & 1UL ) == 0UL )
+        {
+            ulBits >>= 1;
+            uxBit++;
+        }
+
+        return uxBit;
+    }
+    #define delaywheelLOWEST_BIT( ulBits )    prvLowestBit( ulBits )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Put pxItem in the slot for its wake time seen from xNow, and return its
+ * level.
+ */
+static UBaseType_t prvPlace( DelayWheel_t * const pxWheel,
+                             ListItem_t * const pxItem,
+                             const TickType_t xNow );
+
+/*-----------------------------------------------------------*/
+
+void vDelayWheelInitialise( DelayWheel_t * const pxWheel )
+{
+    UBaseType_t uxLevel, uxSlot;
+
+    for( uxLevel = 0; uxLevel < delaywheelLEVELS; uxLevel++ )
+    {
+        for( uxSlot = 0; uxSlot < delaywheelSLOTS; uxSlot++ )
+        {
+            vListInitialise( &( pxWheel->xSlots[ uxLevel ][ uxSlot ] ) );
+        }
+
+        pxWheel->usOccupied[ uxLevel ] = 0U;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvPlace( DelayWheel_t * const pxWheel,
+                             ListItem_t * const pxItem,
+                             const TickType_t xNow )
+{
+    const TickType_t xWakeTime = listGET_LIST_ITEM_VALUE( pxItem );
+    const TickType_t xDiffering = xWakeTime ^ xNow;
+    UBaseType_t uxLevel = 0, uxSlot;
+
+    /* A wake time a whole top-level turn away or more shares the top digit
+     * with xNow once the tick count wraps, so only the top level can tell it
+     * apart from one that is due now. */
+    if( ( TickType_t ) ( xWakeTime - xNow ) > delaywheelLOW_MASK( delaywheelTOP_LEVEL ) )
+    {
+        uxLevel = delaywheelTOP_LEVEL;
+    }
+    else
+    {
+        while( ( uxLevel < delaywheelTOP_LEVEL ) && ( ( xDiffering & ~delaywheelLOW_MASK( uxLevel + 1U ) ) != ( TickType_t ) 0 ) )
+        {
+            uxLevel++;
+        }
+    }
+
+    uxSlot = delaywheelDIGIT( xWakeTime, uxLevel );
+    vListInsertEnd( &( pxWheel->xSlots[ uxLevel ][ uxSlot ] ), pxItem );
+    pxWheel->usOccupied[ uxLevel ] |= ( uint16_t ) ( 1U << uxSlot );
+
+    return uxLevel;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xDelayWheelInsert( DelayWheel_t * const pxWheel,
+                              ListItem_t * const pxItem,
+                              const TickType_t xNow )
+{
+    UBaseType_t uxLevel;
+    TickType_t xWakeTime;
+
+    if( listGET_LIST_ITEM_VALUE( pxItem ) == xNow )
+    {
+        listSET_LIST_ITEM_VALUE( pxItem, xNow + ( TickType_t ) 1 );
+    }
+
+    uxLevel = prvPlace( pxWheel, pxItem, xNow );
+    xWakeTime = listGET_LIST_ITEM_VALUE( pxItem );
+
+    /* The slot is next looked at on the first tick it covers. */
+    return ( TickType_t ) ( ( xWakeTime & ~delaywheelLOW_MASK( uxLevel ) ) - xNow );
+}
+/*-----------------------------------------------------------*/
+
+List_t * pxDelayWheelAdvance( DelayWheel_t * const pxWheel,
+                              const TickType_t xNow )
+{
+    UBaseType_t uxLevel = 0, uxSlot;
+    List_t * pxSlot;
+    ListItem_t * pxItem;
+
+    /* A tick whose lowest l digits are zero is the first tick of a slot in
+     * each of levels 1 to l.  Cascade from the top down, as the items of a
+     * higher slot can land in the lower slots that start now. */
+    while( ( uxLevel < delaywheelTOP_LEVEL ) && ( ( xNow & delaywheelLOW_MASK( uxLevel + 1U ) ) == ( TickType_t ) 0 ) )
+    {
+        uxLevel++;
+    }
+
+    for( ; uxLevel > 0U; uxLevel-- )
+    {
+        uxSlot = delaywheelDIGIT( xNow, uxLevel );
+        pxSlot = &( pxWheel->xSlots[ uxLevel ][ uxSlot ] );
+
+        /* Nothing goes back into this slot: on its first tick every wake
+         * time in it differs from xNow in a lower digit, or not at all. */
+        while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+        {
+            pxItem = listGET_HEAD_ENTRY( pxSlot );
+            ( void ) uxListRemove( pxItem );
+            ( void ) prvPlace( pxWheel, pxItem, xNow );
+        }
+
+        pxWheel->usOccupied[ uxLevel ] &= ( uint16_t ) ~( 1U << uxSlot );
+    }
+
+    /* Every item left in the level 0 slot of xNow wakes now; the caller
+     * empties it. */
+    uxSlot = delaywheelDIGIT( xNow, 0U );
+    pxWheel->usOccupied[ 0 ] &= ( uint16_t ) ~( 1U << uxSlot );
+
+    return &( pxWheel->xSlots[ 0 ][ uxSlot ] );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDelayWheelNextEvent( DelayWheel_t * const pxWheel,
+                                 const TickType_t xNow,
+                                 TickType_t * const pxTicksToEvent )
+{
+    UBaseType_t uxLevel, uxDigit, uxSlot;
+    uint32_t ulRotated;
+    TickType_t xStart, xTicks;
+    BaseType_t xFound = pdFALSE;
+
+    for( uxLevel = 0; uxLevel < delaywheelLEVELS; uxLevel++ )
+    {
+        uxDigit = delaywheelDIGIT( xNow, uxLevel );
+
+        /* Bits are removed lazily: an item can leave a slot through
+         * uxListRemove() without the wheel seeing it. */
+        while( pxWheel->usOccupied[ uxLevel ] != 0U )
+        {
+            /* The first occupied slot after the current digit, wrapping
+             * around; below the top level slots up to the current digit are
+             * always empty. */
+            ulRotated = ( uint32_t ) pxWheel->usOccupied[ uxLevel ];
+            ulRotated = ( ( ulRotated >> ( uxDigit + 1U ) ) | ( ulRotated << ( delaywheelSLOTS - uxDigit - 1U ) ) ) & ( ( 1UL << delaywheelSLOTS ) - 1UL );
+            uxSlot = ( uxDigit + 1U + delaywheelLOWEST_BIT( ulRotated ) ) & ( delaywheelSLOTS - 1U );
+
+            if( listLIST_IS_EMPTY( &( pxWheel->xSlots[ uxLevel ][ uxSlot ] ) ) != pdFALSE )
+            {
+                pxWheel->usOccupied[ uxLevel ] &= ( uint16_t ) ~( 1U << uxSlot );
+                continue;
+            }
+
+            /* First tick of the slot: xNow with digit uxLevel replaced and
+             * the lower digits cleared.  On the top level that tick may be
+             * in the next turn of the tick count, which the unsigned
+             * difference handles. */
+            if( uxLevel == delaywheelTOP_LEVEL )
+            {
+                xStart = ( TickType_t ) uxSlot << ( uxLevel * configDELAY_WHEEL_SLOT_BITS );
+            }
+            else
+            {
+                xStart = ( xNow & ~delaywheelLOW_MASK( uxLevel + 1U ) ) | ( ( TickType_t ) uxSlot << ( uxLevel * configDELAY_WHEEL_SLOT_BITS ) );
+            }
+
+            xTicks = ( TickType_t ) ( xStart - xNow );
+
+            if( ( xFound == pdFALSE ) || ( xTicks < *pxTicksToEvent ) )
+            {
+                *pxTicksToEvent = xTicks;
+                xFound = pdTRUE;
+            }
+
+            break;
+        }
+    }
+
+    return xFound;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDelayWheelOwnsList( const DelayWheel_t * const pxWheel,
+                                const List_t * const pxList )
+{
+    const List_t * const pxFirst = &( pxWheel->xSlots[ 0 ][ 0 ] );
+
+    return ( ( pxList >= pxFirst ) && ( pxList < ( pxFirst + delaywheelLIST_COUNT ) ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_DELAY_WHEEL */
@@ -0,0 +1,625 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A two-level segregated fit (TLSF) implementation of pvPortMalloc() and
+ * vPortFree() with constant-time allocation and free.
+ *
+ * Free blocks are kept in size-class bins: the first level splits sizes by
+ * power of two and the second level splits each power of two into
+ * heapSL_COUNT linear ranges.  A bitmap per level records which bins are
+ * non-empty, so finding a block is a couple of bit scans instead of the list
+ * walk of heap_2.c.  A request is rounded up to the next bin boundary, so any
+ * block in the bin found is large enough (good fit, never a search).
+ *
+ * Every block records its physical predecessor and its own size, so a freed
+ * block is merged at once with free neighbours on both sides: unlike
+ * heap_2.c, create/delete churn does not leave the heap split in small
+ * unusable pieces.  Each operation touches a bounded number of blocks and
+ * never walks a list, so the time spent with the scheduler suspended does not
+ * depend on the state of the heap.
+ *
+ * See heap_2.c and heap_4.c for the list based implementations, and the
+ * memory management pages of https://www.FreeRTOS.org for more information.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#if ( portBYTE_ALIGNMENT != 8 )
+    #error heap_tlsf.c assumes portBYTE_ALIGNMENT is 8
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* A few bytes might be lost to byte aligning the heap start address. */
+#define configADJUSTED_HEAP_SIZE    ( configTOTAL_HEAP_SIZE - portBYTE_ALIGNMENT )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX                ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )    ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )         ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* Bin layout.  Block sizes are multiples of 8 (heapALIGN_LOG2).  Sizes below
+ * heapSMALL_BLOCK_SIZE share first level 0 in linear 8 byte steps; above it
+ * each power of two [2^n, 2^(n+1)) is one first level split in heapSL_COUNT
+ * second level bins.  The largest block is below 2^heapFL_MAX_LOG2 bytes. */
+#define heapALIGN_LOG2              3U
+#define heapSL_LOG2                 2U
+#define heapSL_COUNT                ( 1U << heapSL_LOG2 )
+#define heapFL_SHIFT                ( heapSL_LOG2 + heapALIGN_LOG2 )
+#define heapSMALL_BLOCK_SIZE        ( ( size_t ) 1 << heapFL_SHIFT )
+#define heapFL_MAX_LOG2             24U
+#define heapFL_COUNT                ( heapFL_MAX_LOG2 - heapFL_SHIFT + 1U )
+
+/* The low bit of xBlockSize is set while the block is in a free list. */
+#define heapBLOCK_FREE_BIT          ( ( size_t ) 1 )
+#define heapBLOCK_SIZE( pxBlock )       ( ( pxBlock )->xBlockSize & ~heapBLOCK_FREE_BIT )
+#define heapBLOCK_IS_FREE( pxBlock )    ( ( ( pxBlock )->xBlockSize & heapBLOCK_FREE_BIT ) != 0 )
+#define heapNEXT_PHYSICAL_BLOCK( pxBlock ) \
+    ( ( BlockHeader_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapBLOCK_SIZE( pxBlock ) ) )
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+* heap - probably so it can be placed in a special segment or address. */
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Header at the start of every block.  Only the first two members are kept
+ * while the block is allocated; the free list links overlay the start of the
+ * application's data and are only valid while the block is free. */
+typedef struct A_BLOCK_HEADER
+{
+    struct A_BLOCK_HEADER * pxPrevPhysicalBlock; /*<< The block just below this one in memory, NULL for the first. */
+    size_t xBlockSize;                           /*<< Size including the header, plus heapBLOCK_FREE_BIT. */
+    struct A_BLOCK_HEADER * pxNextFreeBlock;     /*<< Free blocks only: next block in the same bin. */
+    struct A_BLOCK_HEADER * pxPrevFreeBlock;     /*<< Free blocks only: previous block in the same bin. */
+} BlockHeader_t;
+
+/* Bytes in front of the application data of an allocated block. */
+#define heapBLOCK_OVERHEAD        ( offsetof( BlockHeader_t, pxNextFreeBlock ) )
+
+/* A free block must be able to hold the whole header. */
+#define heapMINIMUM_BLOCK_SIZE    ( ( sizeof( BlockHeader_t ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* Bin heads and the bitmaps of non-empty bins. */
+PRIVILEGED_DATA static BlockHeader_t * pxFreeLists[ heapFL_COUNT ][ heapSL_COUNT ];
+PRIVILEGED_DATA static uint32_t ulFirstLevelBitmap = 0;
+PRIVILEGED_DATA static uint8_t ucSecondLevelBitmap[ heapFL_COUNT ];
+
+/* Bytes of the single free block the heap starts with: the aligned heap
+ * minus room for the end marker. */
+#define heapINITIAL_FREE_SIZE     ( ( configADJUSTED_HEAP_SIZE & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) - heapMINIMUM_BLOCK_SIZE )
+
+/* Statistics. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = heapINITIAL_FREE_SIZE;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = heapINITIAL_FREE_SIZE;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = 0;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = 0;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Initialises the heap structures before their first use.
+ */
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Index of the most significant set bit of a non-zero value.  Written as a
+ * fixed binary search instead of __builtin_clz(): the Cortex-M0+ has no CLZ
+ * instruction, and this takes the same five steps for any value.
+ */
+static uint32_t prvFindLastSet( uint32_t ulValue );
+
+/*
+ * First and second level bin of a block of xBlockSize bytes.
+ */
+static void prvMappingInsert( size_t xBlockSize,
+                              uint32_t * pulFirstLevel,
+                              uint32_t * pulSecondLevel );
+
+/*
+ * Non-empty bin whose blocks are all at least xWantedSize bytes, or NULL.
+ */
+static BlockHeader_t * prvFindSuitableBlock( size_t xWantedSize,
+                                             uint32_t * pulFirstLevel,
+                                             uint32_t * pulSecondLevel );
+
+static void prvInsertFreeBlock( BlockHeader_t * pxBlock );
+static void prvRemoveFreeBlock( BlockHeader_t * pxBlock,
+                                uint32_t ulFirstLevel,
+                                uint32_t ulSecondLevel );
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvFindLastSet( uint32_t ulValue )
+{
+    uint32_t ulBit = 0;
+
+    if( ( ulValue & 0xffff0000UL ) != 0 )
+    {
+        ulValue >>= 16;
+        ulBit += 16;
+    }
+
+    if( ( ulValue & 0xff00UL ) != 0 )
+    {
+        ulValue >>= 8;
+        ulBit += 8;
+    }
+
+    if( ( ulValue & 0xf0UL ) != 0 )
+    {
+        ulValue >>= 4;
+        ulBit += 4;
+    }
+
+    if( ( ulValue & 0xcUL ) != 0 )
+    {
+        ulValue >>= 2;
+        ulBit += 2;
+    }
+
+    if( ( ulValue & 0x2UL ) != 0 )
+    {
+        ulBit += 1;
+    }
+
+    return ulBit;
+}
+/*-----------------------------------------------------------*/
+
+/* Index of the least significant set bit of a non-zero value. */
+#define prvFindFirstSet( ulValue )    prvFindLastSet( ( ulValue ) & ( 0U - ( ulValue ) ) )
+
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xBlockSize,
+                              uint32_t * pulFirstLevel,
+                              uint32_t * pulSecondLevel )
+{
+    uint32_t ulSize = ( uint32_t ) xBlockSize;
+    uint32_t ulLastSet;
+
+    if( xBlockSize < heapSMALL_BLOCK_SIZE )
+    {
+        *pulFirstLevel = 0;
+        *pulSecondLevel = ulSize >> heapALIGN_LOG2;
+    }
+    else
+    {
+        ulLastSet = prvFindLastSet( ulSize );
+        *pulSecondLevel = ( ulSize >> ( ulLastSet - heapSL_LOG2 ) ) ^ heapSL_COUNT;
+        *pulFirstLevel = ulLastSet - ( heapFL_SHIFT - 1U );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BlockHeader_t * prvFindSuitableBlock( size_t xWantedSize,
+                                             uint32_t * pulFirstLevel,
+                                             uint32_t * pulSecondLevel )
+{
+    uint32_t ulFirstLevel, ulSecondLevel;
+    uint32_t ulSecondLevelMap, ulFirstLevelMap;
+
+    /* Round the request up to the next bin boundary so that every block of
+     * the bin found fits; this is what avoids searching inside a bin. */
+    if( xWantedSize >= heapSMALL_BLOCK_SIZE )
+    {
+        xWantedSize += ( ( size_t ) 1 << ( prvFindLastSet( ( uint32_t ) xWantedSize ) - heapSL_LOG2 ) ) - 1U;
+    }
+
+    prvMappingInsert( xWantedSize, &ulFirstLevel, &ulSecondLevel );
+
+    if( ulFirstLevel >= heapFL_COUNT )
+    {
+        return NULL;
+    }
+
+    /* First a bin at least as large in the same power of two, then the
+     * smallest non-empty bin of a larger power of two. */
+    ulSecondLevelMap = ucSecondLevelBitmap[ ulFirstLevel ] & ( ~0U << ulSecondLevel );
+
+    if( ulSecondLevelMap == 0 )
+    {
+        ulFirstLevelMap = ulFirstLevelBitmap & ( ~0U << ( ulFirstLevel + 1U ) );
+
+        if( ulFirstLevelMap == 0 )
+        {
+            return NULL;
+        }
+
+        ulFirstLevel = prvFindFirstSet( ulFirstLevelMap );
+        ulSecondLevelMap = ucSecondLevelBitmap[ ulFirstLevel ];
+    }
+
+    ulSecondLevel = prvFindFirstSet( ulSecondLevelMap );
+
+    *pulFirstLevel = ulFirstLevel;
+    *pulSecondLevel = ulSecondLevel;
+
+    return pxFreeLists[ ulFirstLevel ][ ulSecondLevel ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( BlockHeader_t * pxBlock )
+{
+    uint32_t ulFirstLevel, ulSecondLevel;
+    BlockHeader_t * pxHead;
+
+    prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &ulFirstLevel, &ulSecondLevel );
+    pxHead = pxFreeLists[ ulFirstLevel ][ ulSecondLevel ];
+
+    pxBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+    pxBlock->pxPrevFreeBlock = NULL;
+    pxBlock->pxNextFreeBlock = pxHead;
+
+    if( pxHead != NULL )
+    {
+        pxHead->pxPrevFreeBlock = pxBlock;
+    }
+
+    pxFreeLists[ ulFirstLevel ][ ulSecondLevel ] = pxBlock;
+    ulFirstLevelBitmap |= ( 1UL << ulFirstLevel );
+    ucSecondLevelBitmap[ ulFirstLevel ] |= ( uint8_t ) ( 1U << ulSecondLevel );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( BlockHeader_t * pxBlock,
+                                uint32_t ulFirstLevel,
+                                uint32_t ulSecondLevel )
+{
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+    }
+
+    if( pxBlock->pxPrevFreeBlock != NULL )
+    {
+        pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+    }
+    else
+    {
+        /* The block was the head of its bin. */
+        pxFreeLists[ ulFirstLevel ][ ulSecondLevel ] = pxBlock->pxNextFreeBlock;
+
+        if( pxBlock->pxNextFreeBlock == NULL )
+        {
+            ucSecondLevelBitmap[ ulFirstLevel ] &= ( uint8_t ) ~( 1U << ulSecondLevel );
+
+            if( ucSecondLevelBitmap[ ulFirstLevel ] == 0 )
+            {
+                ulFirstLevelBitmap &= ~( 1UL << ulFirstLevel );
+            }
+        }
+    }
+
+    pxBlock->xBlockSize &= ~heapBLOCK_FREE_BIT;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    BlockHeader_t * pxBlock;
+    BlockHeader_t * pxNewBlock;
+    PRIVILEGED_DATA static BaseType_t xHeapHasBeenInitialised = pdFALSE;
+    void * pvReturn = NULL;
+    uint32_t ulFirstLevel, ulSecondLevel;
+    size_t xAdditionalRequiredSize;
+
+    vTaskSuspendAll();
+    {
+        /* If this is the first call to malloc then the heap will require
+         * initialisation to setup the bins. */
+        if( xHeapHasBeenInitialised == pdFALSE )
+        {
+            prvHeapInit();
+            xHeapHasBeenInitialised = pdTRUE;
+        }
+
+        if( xWantedSize > 0 )
+        {
+            /* The wanted size must be increased so it can contain the header
+             * in addition to the requested amount of bytes, and rounded up to
+             * keep the next block aligned. */
+            xAdditionalRequiredSize = heapBLOCK_OVERHEAD + portBYTE_ALIGNMENT_MASK;
+
+            if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+            {
+                xWantedSize = ( xWantedSize + xAdditionalRequiredSize ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+                if( xWantedSize < heapMINIMUM_BLOCK_SIZE )
+                {
+                    xWantedSize = heapMINIMUM_BLOCK_SIZE;
+                }
+            }
+            else
+            {
+                xWantedSize = 0;
+            }
+        }
+
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+        {
+            pxBlock = prvFindSuitableBlock( xWantedSize, &ulFirstLevel, &ulSecondLevel );
+
+            if( pxBlock != NULL )
+            {
+                prvRemoveFreeBlock( pxBlock, ulFirstLevel, ulSecondLevel );
+
+                /* If the block is larger than required it can be split into
+                 * two, and the remainder goes back to its bin. */
+                if( ( heapBLOCK_SIZE( pxBlock ) - xWantedSize ) >= heapMINIMUM_BLOCK_SIZE )
+                {
+                    pxNewBlock = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                    pxNewBlock->xBlockSize = heapBLOCK_SIZE( pxBlock ) - xWantedSize;
+                    pxNewBlock->pxPrevPhysicalBlock = pxBlock;
+                    heapNEXT_PHYSICAL_BLOCK( pxNewBlock )->pxPrevPhysicalBlock = pxNewBlock;
+                    pxBlock->xBlockSize = xWantedSize;
+
+                    prvInsertFreeBlock( pxNewBlock );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xFreeBytesRemaining -= heapBLOCK_SIZE( pxBlock );
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+
+                xNumberOfSuccessfulAllocations++;
+                pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + heapBLOCK_OVERHEAD );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+    }
+    #endif
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    BlockHeader_t * pxBlock;
+    BlockHeader_t * pxNeighbour;
+    uint32_t ulFirstLevel, ulSecondLevel;
+    size_t xBlockSize;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have a header immediately before it. */
+        pxBlock = ( void * ) ( ( ( uint8_t * ) pv ) - heapBLOCK_OVERHEAD );
+
+        configASSERT( heapBLOCK_IS_FREE( pxBlock ) == 0 );
+        configASSERT( heapBLOCK_SIZE( pxBlock ) >= heapMINIMUM_BLOCK_SIZE );
+
+        if( heapBLOCK_IS_FREE( pxBlock ) == 0 )
+        {
+            xBlockSize = heapBLOCK_SIZE( pxBlock );
+
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                ( void ) memset( pv, 0, xBlockSize - heapBLOCK_OVERHEAD );
+            }
+            #endif
+
+            vTaskSuspendAll();
+            {
+                xFreeBytesRemaining += xBlockSize;
+                xNumberOfSuccessfulFrees++;
+
+                /* Merge with the free block just below, if any. */
+                pxNeighbour = pxBlock->pxPrevPhysicalBlock;
+
+                if( ( pxNeighbour != NULL ) && heapBLOCK_IS_FREE( pxNeighbour ) )
+                {
+                    prvMappingInsert( heapBLOCK_SIZE( pxNeighbour ), &ulFirstLevel, &ulSecondLevel );
+                    prvRemoveFreeBlock( pxNeighbour, ulFirstLevel, ulSecondLevel );
+                    pxNeighbour->xBlockSize += heapBLOCK_SIZE( pxBlock );
+                    pxBlock = pxNeighbour;
+                }
+
+                /* And with the one just above.  The end marker is never
+                 * free, so the last block needs no special case. */
+                pxNeighbour = heapNEXT_PHYSICAL_BLOCK( pxBlock );
+
+                if( heapBLOCK_IS_FREE( pxNeighbour ) )
+                {
+                    prvMappingInsert( heapBLOCK_SIZE( pxNeighbour ), &ulFirstLevel, &ulSecondLevel );
+                    prvRemoveFreeBlock( pxNeighbour, ulFirstLevel, ulSecondLevel );
+                    pxBlock->xBlockSize += heapBLOCK_SIZE( pxNeighbour );
+                }
+
+                heapNEXT_PHYSICAL_BLOCK( pxBlock )->pxPrevPhysicalBlock = pxBlock;
+                prvInsertFreeBlock( pxBlock );
+                traceFREE( pv, xBlockSize );
+            }
+            ( void ) xTaskResumeAll();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    BlockHeader_t * pxFirstFreeBlock;
+    BlockHeader_t * pxEndMarker;
+    uint8_t * pucAlignedHeap;
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    pucAlignedHeap = ( uint8_t * ) ( ( ( portPOINTER_SIZE_TYPE ) & ucHeap[ portBYTE_ALIGNMENT - 1 ] ) & ( ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) );
+    configASSERT( heapINITIAL_FREE_SIZE < ( ( size_t ) 1 << heapFL_MAX_LOG2 ) );
+
+    /* One free block takes the whole heap except the end marker, an
+     * allocated block of size 0 that stops merges past the end. */
+    pxFirstFreeBlock = ( BlockHeader_t * ) pucAlignedHeap;
+    pxFirstFreeBlock->pxPrevPhysicalBlock = NULL;
+    pxFirstFreeBlock->xBlockSize = heapINITIAL_FREE_SIZE;
+
+    pxEndMarker = heapNEXT_PHYSICAL_BLOCK( pxFirstFreeBlock );
+    pxEndMarker->pxPrevPhysicalBlock = pxFirstFreeBlock;
+    pxEndMarker->xBlockSize = 0;
+
+    prvInsertFreeBlock( pxFirstFreeBlock );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    BlockHeader_t * pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+    uint32_t ulFirstLevel, ulSecondLevel;
+
+    /* Walking the bins is the only part of this heap that is not constant
+     * time, so it is kept out of pvPortMalloc() and vPortFree(). */
+    vTaskSuspendAll();
+    {
+        for( ulFirstLevel = 0; ulFirstLevel < heapFL_COUNT; ulFirstLevel++ )
+        {
+            for( ulSecondLevel = 0; ulSecondLevel < heapSL_COUNT; ulSecondLevel++ )
+            {
+                for( pxBlock = pxFreeLists[ ulFirstLevel ][ ulSecondLevel ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+                {
+                    xBlocks++;
+
+                    if( heapBLOCK_SIZE( pxBlock ) > xMaxSize )
+                    {
+                        xMaxSize = heapBLOCK_SIZE( pxBlock );
+                    }
+
+                    if( heapBLOCK_SIZE( pxBlock ) < xMinSize )
+                    {
+                        xMinSize = heapBLOCK_SIZE( pxBlock );
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,132 @@
+/*
+ * Latest-value mailbox for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mailbox.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+typedef struct MailboxDefinition
+{
+    volatile uint32_t ulSequence; /* Number of values published.  Its lowest bit selects the published slot. */
+    size_t uxItemSize;
+    uint8_t * pucSlots;           /* Two slots of uxItemSize bytes. */
+} Mailbox_t;
+
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    MailboxHandle_t xMailboxCreate( size_t uxItemSize )
+    {
+        Mailbox_t * pxMailbox;
+
+        configASSERT( uxItemSize > 0 );
+
+        /* The slots follow the structure in the same allocation. */
+        pxMailbox = pvPortMalloc( sizeof( Mailbox_t ) + ( 2 * uxItemSize ) );
+
+        if( pxMailbox != NULL )
+        {
+            pxMailbox->ulSequence = 0;
+            pxMailbox->uxItemSize = uxItemSize;
+            pxMailbox->pucSlots = ( uint8_t * ) ( pxMailbox + 1 );
+        }
+
+        return pxMailbox;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+    MailboxHandle_t xMailboxCreateStatic( size_t uxItemSize,
+                                          uint8_t * pucSlotStorage,
+                                          StaticMailbox_t * pxStaticMailbox )
+    {
+        Mailbox_t * const pxMailbox = ( Mailbox_t * ) pxStaticMailbox;
+
+        configASSERT( uxItemSize > 0 );
+        configASSERT( pucSlotStorage );
+        configASSERT( pxStaticMailbox );
+
+        /* StaticMailbox_t must be able to hold a Mailbox_t. */
+        configASSERT( sizeof( StaticMailbox_t ) == sizeof( Mailbox_t ) );
+
+        pxMailbox->ulSequence = 0;
+        pxMailbox->uxItemSize = uxItemSize;
+        pxMailbox->pucSlots = pucSlotStorage;
+
+        return pxMailbox;
+    }
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+void vMailboxPublish( MailboxHandle_t xMailbox,
+                      const void * pvItem )
+{
+    Mailbox_t * const pxMailbox = xMailbox;
+    uint32_t ulNext;
+
+    configASSERT( pxMailbox );
+
+    /* Fill the slot readers are not using, then publish it.  0 means "never
+     * published", so skip it on wrap around, keeping the slot parity. */
+    ulNext = pxMailbox->ulSequence + 1;
+
+    if( ulNext == 0 )
+    {
+        ulNext = 2;
+    }
+
+    memcpy( &( pxMailbox->pucSlots[ ( ulNext & 1U ) * pxMailbox->uxItemSize ] ), pvItem, pxMailbox->uxItemSize );
+    portMEMORY_BARRIER();
+    pxMailbox->ulSequence = ulNext;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMailboxPeek( MailboxHandle_t xMailbox,
+                         void * pvBuffer )
+{
+    Mailbox_t * const pxMailbox = xMailbox;
+    uint32_t ulSequence;
+
+    configASSERT( pxMailbox );
+
+    do
+    {
+        ulSequence = pxMailbox->ulSequence;
+
+        if( ulSequence == 0 )
+        {
+            return pdFAIL;
+        }
+
+        portMEMORY_BARRIER();
+        memcpy( pvBuffer, &( pxMailbox->pucSlots[ ( ulSequence & 1U ) * pxMailbox->uxItemSize ] ), pxMailbox->uxItemSize );
+        portMEMORY_BARRIER();
+    } while( ulSequence != pxMailbox->ulSequence );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulMailboxGetSequence( MailboxHandle_t xMailbox )
+{
+    configASSERT( xMailbox );
+
+    return xMailbox->ulSequence;
+}
@@ -0,0 +1,321 @@
+/*
+ * Fixed-size block pools for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mempool.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* The free list head packs the index of the first free block (low 16 bits)
+ * with a tag incremented on every update (high 16 bits).  A free block holds
+ * the index of the next one in its first word. */
+#define mempoolINDEX_MASK       ( 0xffffUL )
+#define mempoolNO_BLOCK         ( 0xffffUL )
+#define mempoolTAG_INCREMENT    ( 0x10000UL )
+
+/* Lock-free where the compiler has a native 32-bit compare-and-swap.  Without
+ * one (ARMv6-M), every update below runs with interrupts masked and the
+ * "compare-and-swap" cannot fail. */
+#if defined( __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4 )
+    #define mempoolLOCK_FREE                      1
+    #define mempoolCAS( pxTarget, xOld, xNew )    __sync_bool_compare_and_swap( ( pxTarget ), ( xOld ), ( xNew ) )
+    #define mempoolADD( pxTarget, xValue )        __sync_add_and_fetch( ( pxTarget ), ( xValue ) )
+#else
+    #define mempoolLOCK_FREE                      0
+    #define mempoolCAS( pxTarget, xOld, xNew )    ( ( void ) ( xOld ), *( pxTarget ) = ( xNew ), pdTRUE )
+    #define mempoolADD( pxTarget, xValue )        ( *( pxTarget ) += ( xValue ) )
+#endif
+
+typedef struct MemPoolDefinition
+{
+    volatile uint32_t ulHead;                 /* Free list head: tag and block index. */
+    uint8_t * pucBlocks;
+    size_t xBlockSize;
+    UBaseType_t uxBlockCount;
+    volatile UBaseType_t uxFree;
+    volatile UBaseType_t uxMinimumEverFree;
+    volatile uint32_t ulAllocations;
+    volatile uint32_t ulFailures;
+} MemPool_t;
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialisePool( MemPool_t * pxPool,
+                               size_t xItemSize,
+                               UBaseType_t uxBlockCount,
+                               uint8_t * pucBlocks );
+static void * prvAlloc( MemPool_t * pxPool );
+static void prvFree( MemPool_t * pxPool,
+                     void * pvBlock );
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialisePool( MemPool_t * pxPool,
+                               size_t xItemSize,
+                               UBaseType_t uxBlockCount,
+                               uint8_t * pucBlocks )
+{
+    UBaseType_t ux;
+
+    pxPool->pucBlocks = pucBlocks;
+    pxPool->xBlockSize = mempoolBLOCK_SIZE( xItemSize );
+    pxPool->uxBlockCount = uxBlockCount;
+    pxPool->uxFree = uxBlockCount;
+    pxPool->uxMinimumEverFree = uxBlockCount;
+    pxPool->ulAllocations = 0;
+    pxPool->ulFailures = 0;
+
+    /* Chain every block in address order. */
+    for( ux = 0; ux < uxBlockCount; ux++ )
+    {
+        *( uint32_t * ) &( pucBlocks[ ux * pxPool->xBlockSize ] ) = ( ux + 1U < uxBlockCount ) ? ( uint32_t ) ( ux + 1U ) : mempoolNO_BLOCK;
+    }
+
+    pxPool->ulHead = ( uxBlockCount > 0 ) ? 0U : mempoolNO_BLOCK;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    MemPoolHandle_t xMemPoolCreate( size_t xItemSize,
+                                    UBaseType_t uxBlockCount )
+    {
+        MemPool_t * pxPool;
+        size_t xHeaderSize = mempoolBLOCK_SIZE( sizeof( MemPool_t ) );
+
+        configASSERT( xItemSize > 0 );
+        configASSERT( uxBlockCount <= mempoolMAX_BLOCKS );
+
+        /* The blocks follow the structure in the same allocation, which
+         * pvPortMalloc() aligns to portBYTE_ALIGNMENT. */
+        pxPool = pvPortMalloc( xHeaderSize + mempoolSTORAGE_SIZE( xItemSize, uxBlockCount ) );
+
+        if( pxPool != NULL )
+        {
+            prvInitialisePool( pxPool, xItemSize, uxBlockCount, ( ( uint8_t * ) pxPool ) + xHeaderSize );
+        }
+
+        return pxPool;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+    MemPoolHandle_t xMemPoolCreateStatic( size_t xItemSize,
+                                          UBaseType_t uxBlockCount,
+                                          uint8_t * pucBlockStorage,
+                                          StaticMemPool_t * pxStaticPool )
+    {
+        MemPool_t * const pxPool = ( MemPool_t * ) pxStaticPool;
+
+        configASSERT( xItemSize > 0 );
+        configASSERT( uxBlockCount <= mempoolMAX_BLOCKS );
+        configASSERT( pucBlockStorage );
+        configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucBlockStorage ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+        configASSERT( pxStaticPool );
+
+        /* StaticMemPool_t must be able to hold a MemPool_t. */
+        configASSERT( sizeof( StaticMemPool_t ) == sizeof( MemPool_t ) );
+
+        prvInitialisePool( pxPool, xItemSize, uxBlockCount, pucBlockStorage );
+
+        return pxPool;
+    }
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+static void * prvAlloc( MemPool_t * pxPool )
+{
+    uint32_t ulHead, ulIndex, ulNext;
+    UBaseType_t uxFree, uxMinimum;
+
+    do
+    {
+        ulHead = pxPool->ulHead;
+        ulIndex = ulHead & mempoolINDEX_MASK;
+
+        if( ulIndex == mempoolNO_BLOCK )
+        {
+            mempoolADD( &( pxPool->ulFailures ), 1U );
+            return NULL;
+        }
+
+        /* If another context takes this block first, the next index read
+         * here may be stale, but the tag has changed and the swap fails. */
+        ulNext = *( volatile uint32_t * ) &( pxPool->pucBlocks[ ulIndex * pxPool->xBlockSize ] );
+    } while( !mempoolCAS( &( pxPool->ulHead ), ulHead, ( ( ulHead + mempoolTAG_INCREMENT ) & ~mempoolINDEX_MASK ) | ulNext ) );
+
+    mempoolADD( &( pxPool->ulAllocations ), 1U );
+    uxFree = mempoolADD( &( pxPool->uxFree ), ( UBaseType_t ) -1 );
+
+    /* Lower the low-water mark unless another context already did. */
+    uxMinimum = pxPool->uxMinimumEverFree;
+
+    while( ( uxFree < uxMinimum ) && !mempoolCAS( &( pxPool->uxMinimumEverFree ), uxMinimum, uxFree ) )
+    {
+        uxMinimum = pxPool->uxMinimumEverFree;
+    }
+
+    return &( pxPool->pucBlocks[ ulIndex * pxPool->xBlockSize ] );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFree( MemPool_t * pxPool,
+                     void * pvBlock )
+{
+    uint32_t ulHead, ulIndex;
+
+    configASSERT( xMemPoolOwns( pxPool, pvBlock ) );
+
+    ulIndex = ( uint32_t ) ( ( ( uint8_t * ) pvBlock - pxPool->pucBlocks ) / pxPool->xBlockSize );
+
+    do
+    {
+        ulHead = pxPool->ulHead;
+        *( volatile uint32_t * ) pvBlock = ulHead & mempoolINDEX_MASK;
+    } while( !mempoolCAS( &( pxPool->ulHead ), ulHead, ( ( ulHead + mempoolTAG_INCREMENT ) & ~mempoolINDEX_MASK ) | ulIndex ) );
+
+    mempoolADD( &( pxPool->uxFree ), 1U );
+}
+/*-----------------------------------------------------------*/
+
+void * pvMemPoolAlloc( MemPoolHandle_t xPool )
+{
+    void * pvBlock;
+
+    configASSERT( xPool );
+
+    #if ( mempoolLOCK_FREE == 0 )
+        taskENTER_CRITICAL();
+    #endif
+    {
+        pvBlock = prvAlloc( xPool );
+    }
+    #if ( mempoolLOCK_FREE == 0 )
+        taskEXIT_CRITICAL();
+    #endif
+
+    return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+void * pvMemPoolAllocFromISR( MemPoolHandle_t xPool )
+{
+    void * pvBlock;
+
+    #if ( mempoolLOCK_FREE == 0 )
+        UBaseType_t uxSavedInterruptStatus;
+    #endif
+
+    configASSERT( xPool );
+
+    #if ( mempoolLOCK_FREE == 0 )
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    #endif
+    {
+        pvBlock = prvAlloc( xPool );
+    }
+    #if ( mempoolLOCK_FREE == 0 )
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+    #endif
+
+    return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolFree( MemPoolHandle_t xPool,
+                   void * pvBlock )
+{
+    configASSERT( xPool );
+
+    #if ( mempoolLOCK_FREE == 0 )
+        taskENTER_CRITICAL();
+    #endif
+    {
+        prvFree( xPool, pvBlock );
+    }
+    #if ( mempoolLOCK_FREE == 0 )
+        taskEXIT_CRITICAL();
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolFreeFromISR( MemPoolHandle_t xPool,
+                          void * pvBlock )
+{
+    #if ( mempoolLOCK_FREE == 0 )
+        UBaseType_t uxSavedInterruptStatus;
+    #endif
+
+    configASSERT( xPool );
+
+    #if ( mempoolLOCK_FREE == 0 )
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    #endif
+    {
+        prvFree( xPool, pvBlock );
+    }
+    #if ( mempoolLOCK_FREE == 0 )
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMemPoolOwns( MemPoolHandle_t xPool,
+                         const void * pvBlock )
+{
+    const uint8_t * pucBlock = pvBlock;
+    size_t xOffset;
+
+    configASSERT( xPool );
+
+    if( ( pucBlock < xPool->pucBlocks ) || ( pucBlock >= &( xPool->pucBlocks[ xPool->uxBlockCount * xPool->xBlockSize ] ) ) )
+    {
+        return pdFALSE;
+    }
+
+    xOffset = ( size_t ) ( pucBlock - xPool->pucBlocks );
+
+    return ( ( xOffset % xPool->xBlockSize ) == 0 ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMemPoolGetBlockSize( MemPoolHandle_t xPool )
+{
+    configASSERT( xPool );
+
+    return xPool->xBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolGetStats( MemPoolHandle_t xPool,
+                       MemPoolStats_t * pxStats )
+{
+    configASSERT( xPool );
+
+    pxStats->xBlockSize = xPool->xBlockSize;
+    pxStats->uxBlocks = xPool->uxBlockCount;
+    pxStats->uxFree = xPool->uxFree;
+    pxStats->uxMinimumEverFree = xPool->uxMinimumEverFree;
+    pxStats->ulAllocations = xPool->ulAllocations;
+
+    /* Allocations not yet freed are the blocks in use, so the number of frees
+     * follows and the free path has one counter less to update. */
+    pxStats->ulFrees = pxStats->ulAllocations - ( uint32_t ) ( pxStats->uxBlocks - pxStats->uxFree );
+    pxStats->ulFailures = xPool->ulFailures;
+}
+/*-----------------------------------------------------------*/
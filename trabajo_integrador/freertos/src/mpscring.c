@@ -0,0 +1,494 @@
+/*
+ * Multi-producer, single-consumer ring buffer for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mpscring.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Record header: the length in the low bits, and two flags.  A padding record
+ * fills the end of the storage when the next record does not fit there. */
+#define mpscringLENGTH_MASK    ( 0x00ffffffUL )
+#define mpscringCOMMITTED      ( 0x40000000UL )
+#define mpscringPADDING        ( 0x80000000UL )
+
+#define mpscringHEADER_SIZE    ( ( uint32_t ) sizeof( uint32_t ) )
+
+/* On the host, producers may be threads running in parallel with the
+ * scheduler: they take a spinlock instead of masking the simulated interrupts,
+ * and the barriers must also order the stores for the other cores.  On a
+ * single-core target a compiler barrier is enough. */
+#if defined( FREERTOS_PORT_POSIX )
+    #define mpscringSPINLOCK    1
+    #define mpscringBARRIER()    __sync_synchronize()
+#else
+    #define mpscringSPINLOCK    0
+    #define mpscringBARRIER()    portMEMORY_BARRIER()
+#endif
+
+typedef struct MpscRingDefinition
+{
+    volatile uint32_t ulHead;         /* Bytes ever reserved by the producers. */
+    volatile uint32_t ulTail;         /* Bytes ever released by the reader. */
+    uint32_t ulReadOffset;            /* Bytes of the oldest record already received. */
+    uint8_t * pucStorage;
+    uint32_t ulMask;                  /* Size of the storage less one. */
+    uint32_t ulMaximumUsed;
+    uint32_t ulRecords;
+    uint32_t ulDropped;
+    volatile uint32_t ulLock;         /* Only used with mpscringSPINLOCK. */
+} MpscRing_t;
+
+#define mpscringHEADER_AT( pxRing, ulPosition )    ( ( volatile uint32_t * ) &( ( pxRing )->pucStorage[ ( ulPosition ) & ( pxRing )->ulMask ] ) )
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseRing( MpscRing_t * pxRing,
+                               size_t xSize,
+                               uint8_t * pucStorage );
+static UBaseType_t prvLock( MpscRing_t * pxRing,
+                            BaseType_t xFromISR );
+static void prvUnlock( MpscRing_t * pxRing,
+                       BaseType_t xFromISR,
+                       UBaseType_t uxSavedInterruptStatus );
+static BaseType_t prvReserve( MpscRing_t * pxRing,
+                              const size_t * pxLengths,
+                              void ** ppvRecords,
+                              UBaseType_t uxCount,
+                              BaseType_t xFromISR );
+static BaseType_t prvWrite( MpscRing_t * pxRing,
+                            const void * pvData,
+                            size_t xLength,
+                            BaseType_t xFromISR );
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseRing( MpscRing_t * pxRing,
+                               size_t xSize,
+                               uint8_t * pucStorage )
+{
+    pxRing->ulHead = 0;
+    pxRing->ulTail = 0;
+    pxRing->ulReadOffset = 0;
+    pxRing->pucStorage = pucStorage;
+    pxRing->ulMask = ( uint32_t ) xSize - 1U;
+    pxRing->ulMaximumUsed = 0;
+    pxRing->ulRecords = 0;
+    pxRing->ulDropped = 0;
+    pxRing->ulLock = 0;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    MpscRingHandle_t xMpscRingCreate( size_t xSize )
+    {
+        MpscRing_t * pxRing;
+
+        configASSERT( ( xSize >= 2U * mpscringHEADER_SIZE ) && ( ( xSize & ( xSize - 1U ) ) == 0U ) );
+
+        /* The storage goes right after the structure, whose size is a
+         * multiple of 4. */
+        pxRing = pvPortMalloc( sizeof( MpscRing_t ) + xSize );
+
+        if( pxRing != NULL )
+        {
+            prvInitialiseRing( pxRing, xSize, ( ( uint8_t * ) pxRing ) + sizeof( MpscRing_t ) );
+        }
+
+        return pxRing;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+    MpscRingHandle_t xMpscRingCreateStatic( size_t xSize,
+                                            uint8_t * pucStorage,
+                                            StaticMpscRing_t * pxStaticRing )
+    {
+        MpscRing_t * const pxRing = ( MpscRing_t * ) pxStaticRing;
+
+        configASSERT( ( xSize >= 2U * mpscringHEADER_SIZE ) && ( ( xSize & ( xSize - 1U ) ) == 0U ) );
+        configASSERT( pucStorage );
+        configASSERT( ( ( ( portPOINTER_SIZE_TYPE ) pucStorage ) & 3U ) == 0 );
+        configASSERT( pxStaticRing );
+
+        /* StaticMpscRing_t must be able to hold an MpscRing_t. */
+        configASSERT( sizeof( StaticMpscRing_t ) == sizeof( MpscRing_t ) );
+
+        prvInitialiseRing( pxRing, xSize, pucStorage );
+
+        return pxRing;
+    }
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvLock( MpscRing_t * pxRing,
+                            BaseType_t xFromISR )
+{
+    #if ( mpscringSPINLOCK == 1 )
+        ( void ) xFromISR;
+
+        while( __sync_lock_test_and_set( &( pxRing->ulLock ), 1U ) != 0U )
+        {
+            while( pxRing->ulLock != 0U )
+            {
+            }
+        }
+
+        return 0;
+    #else
+        ( void ) pxRing;
+
+        if( xFromISR != pdFALSE )
+        {
+            return portSET_INTERRUPT_MASK_FROM_ISR();
+        }
+
+        taskENTER_CRITICAL();
+
+        return 0;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlock( MpscRing_t * pxRing,
+                       BaseType_t xFromISR,
+                       UBaseType_t uxSavedInterruptStatus )
+{
+    #if ( mpscringSPINLOCK == 1 )
+        ( void ) xFromISR;
+        ( void ) uxSavedInterruptStatus;
+
+        __sync_lock_release( &( pxRing->ulLock ) );
+    #else
+        ( void ) pxRing;
+
+        if( xFromISR != pdFALSE )
+        {
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+        else
+        {
+            taskEXIT_CRITICAL();
+        }
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReserve( MpscRing_t * pxRing,
+                              const size_t * pxLengths,
+                              void ** ppvRecords,
+                              UBaseType_t uxCount,
+                              BaseType_t xFromISR )
+{
+    const uint32_t ulSize = pxRing->ulMask + 1U;
+    uint32_t ulTotal = 0, ulHead, ulOffset, ulPadding, ulUsed, ulPosition;
+    UBaseType_t ux, uxSavedInterruptStatus;
+    BaseType_t xReturn = pdFAIL;
+
+    configASSERT( pxRing );
+    configASSERT( uxCount > 0U );
+
+    /* The masked section below does not depend on the size of the batch. */
+    for( ux = 0; ux < uxCount; ux++ )
+    {
+        configASSERT( ( pxLengths[ ux ] > 0U ) && ( pxLengths[ ux ] <= mpscringMAX_RECORD ) );
+        ulTotal += ( uint32_t ) mpscringRECORD_SIZE( pxLengths[ ux ] );
+    }
+
+    uxSavedInterruptStatus = prvLock( pxRing, xFromISR );
+    {
+        ulHead = pxRing->ulHead;
+        ulOffset = ulHead & pxRing->ulMask;
+
+        /* A batch is contiguous: if it does not fit before the end of the
+         * storage, the rest of the lap becomes padding. */
+        ulPadding = ( ( ulOffset + ulTotal ) > ulSize ) ? ( ulSize - ulOffset ) : 0U;
+        ulUsed = ( ulHead - pxRing->ulTail ) + ulPadding + ulTotal;
+
+        if( ( ulTotal <= ulSize ) && ( ulUsed <= ulSize ) )
+        {
+            if( ulPadding != 0U )
+            {
+                *mpscringHEADER_AT( pxRing, ulHead ) = mpscringPADDING | mpscringCOMMITTED | ( ulPadding - mpscringHEADER_SIZE );
+                ulHead += ulPadding;
+            }
+
+            /* The first header is not committed yet, so the reader stops at
+             * it; the others are only reachable through it. */
+            *mpscringHEADER_AT( pxRing, ulHead ) = ( uint32_t ) pxLengths[ 0 ];
+            ppvRecords[ 0 ] = ( void * ) ( mpscringHEADER_AT( pxRing, ulHead ) + 1 );
+
+            mpscringBARRIER();
+            pxRing->ulHead = ulHead + ulTotal;
+
+            pxRing->ulRecords += ( uint32_t ) uxCount;
+
+            if( ulUsed > pxRing->ulMaximumUsed )
+            {
+                pxRing->ulMaximumUsed = ulUsed;
+            }
+
+            xReturn = pdPASS;
+        }
+        else
+        {
+            pxRing->ulDropped += ( uint32_t ) uxCount;
+        }
+    }
+    prvUnlock( pxRing, xFromISR, uxSavedInterruptStatus );
+
+    if( xReturn == pdPASS )
+    {
+        ulPosition = ulHead + ( uint32_t ) mpscringRECORD_SIZE( pxLengths[ 0 ] );
+
+        for( ux = 1; ux < uxCount; ux++ )
+        {
+            *mpscringHEADER_AT( pxRing, ulPosition ) = mpscringCOMMITTED | ( uint32_t ) pxLengths[ ux ];
+            ppvRecords[ ux ] = ( void * ) ( mpscringHEADER_AT( pxRing, ulPosition ) + 1 );
+            ulPosition += ( uint32_t ) mpscringRECORD_SIZE( pxLengths[ ux ] );
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void * pvMpscRingReserve( MpscRingHandle_t xRing,
+                          size_t xLength )
+{
+    void * pvRecord = NULL;
+
+    ( void ) prvReserve( xRing, &xLength, &pvRecord, 1U, pdFALSE );
+
+    return pvRecord;
+}
+/*-----------------------------------------------------------*/
+
+void * pvMpscRingReserveFromISR( MpscRingHandle_t xRing,
+                                 size_t xLength )
+{
+    void * pvRecord = NULL;
+
+    ( void ) prvReserve( xRing, &xLength, &pvRecord, 1U, pdTRUE );
+
+    return pvRecord;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMpscRingReserveBatch( MpscRingHandle_t xRing,
+                                  const size_t * pxLengths,
+                                  void ** ppvRecords,
+                                  UBaseType_t uxCount )
+{
+    return prvReserve( xRing, pxLengths, ppvRecords, uxCount, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMpscRingReserveBatchFromISR( MpscRingHandle_t xRing,
+                                         const size_t * pxLengths,
+                                         void ** ppvRecords,
+                                         UBaseType_t uxCount )
+{
+    return prvReserve( xRing, pxLengths, ppvRecords, uxCount, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+void vMpscRingCommit( MpscRingHandle_t xRing,
+                      void * pvRecord )
+{
+    volatile uint32_t * const pulHeader = ( ( volatile uint32_t * ) pvRecord ) - 1;
+
+    ( void ) xRing;
+    configASSERT( pvRecord );
+    configASSERT( ( *pulHeader & ( mpscringCOMMITTED | mpscringPADDING ) ) == 0U );
+
+    /* The contents of the records must be visible before the flag is. */
+    mpscringBARRIER();
+    *pulHeader |= mpscringCOMMITTED;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWrite( MpscRing_t * pxRing,
+                            const void * pvData,
+                            size_t xLength,
+                            BaseType_t xFromISR )
+{
+    void * pvRecord;
+
+    if( prvReserve( pxRing, &xLength, &pvRecord, 1U, xFromISR ) != pdPASS )
+    {
+        return pdFAIL;
+    }
+
+    memcpy( pvRecord, pvData, xLength );
+    vMpscRingCommit( pxRing, pvRecord );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMpscRingWrite( MpscRingHandle_t xRing,
+                           const void * pvData,
+                           size_t xLength )
+{
+    return prvWrite( xRing, pvData, xLength, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMpscRingWriteFromISR( MpscRingHandle_t xRing,
+                                  const void * pvData,
+                                  size_t xLength )
+{
+    return prvWrite( xRing, pvData, xLength, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+void * pvMpscRingPeekRecord( MpscRingHandle_t xRing,
+                             size_t * pxLength )
+{
+    MpscRing_t * const pxRing = xRing;
+    uint32_t ulTail = pxRing->ulTail, ulHeader;
+
+    configASSERT( pxRing );
+
+    for( ; ; )
+    {
+        if( ulTail == pxRing->ulHead )
+        {
+            return NULL;
+        }
+
+        /* The header was written before ulHead moved past it. */
+        mpscringBARRIER();
+        ulHeader = *mpscringHEADER_AT( pxRing, ulTail );
+
+        if( ( ulHeader & mpscringCOMMITTED ) == 0U )
+        {
+            return NULL;
+        }
+
+        mpscringBARRIER();
+
+        if( ( ulHeader & mpscringPADDING ) == 0U )
+        {
+            break;
+        }
+
+        /* Give the padding back straight away. */
+        ulTail += mpscringHEADER_SIZE + ( ulHeader & mpscringLENGTH_MASK );
+        pxRing->ulTail = ulTail;
+    }
+
+    if( pxLength != NULL )
+    {
+        *pxLength = ulHeader & mpscringLENGTH_MASK;
+    }
+
+    return ( void * ) ( mpscringHEADER_AT( pxRing, ulTail ) + 1 );
+}
+/*-----------------------------------------------------------*/
+
+void vMpscRingReleaseRecord( MpscRingHandle_t xRing )
+{
+    MpscRing_t * const pxRing = xRing;
+    const uint32_t ulTail = pxRing->ulTail;
+    const uint32_t ulHeader = *mpscringHEADER_AT( pxRing, ulTail );
+
+    configASSERT( ( ulTail != pxRing->ulHead ) && ( ( ulHeader & ( mpscringCOMMITTED | mpscringPADDING ) ) == mpscringCOMMITTED ) );
+
+    /* Finish reading the record before the producers may overwrite it. */
+    mpscringBARRIER();
+    pxRing->ulReadOffset = 0;
+    pxRing->ulTail = ulTail + ( uint32_t ) mpscringRECORD_SIZE( ulHeader & mpscringLENGTH_MASK );
+}
+/*-----------------------------------------------------------*/
+
+size_t xMpscRingReceiveRecord( MpscRingHandle_t xRing,
+                               void * pvBuffer,
+                               size_t xBufferLength )
+{
+    size_t xLength;
+    void * pvRecord = pvMpscRingPeekRecord( xRing, &xLength );
+
+    if( ( pvRecord == NULL ) || ( xLength > xBufferLength ) )
+    {
+        return 0;
+    }
+
+    memcpy( pvBuffer, pvRecord, xLength );
+    vMpscRingReleaseRecord( xRing );
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMpscRingReceive( MpscRingHandle_t xRing,
+                         void * pvBuffer,
+                         size_t xBufferLength )
+{
+    MpscRing_t * const pxRing = xRing;
+    uint8_t * pucBuffer = pvBuffer;
+    size_t xReceived = 0, xLength, xCopy;
+    uint8_t * pucRecord;
+
+    while( xReceived < xBufferLength )
+    {
+        pucRecord = pvMpscRingPeekRecord( xRing, &xLength );
+
+        if( pucRecord == NULL )
+        {
+            break;
+        }
+
+        xCopy = xLength - pxRing->ulReadOffset;
+
+        if( xCopy > ( xBufferLength - xReceived ) )
+        {
+            xCopy = xBufferLength - xReceived;
+        }
+
+        memcpy( &( pucBuffer[ xReceived ] ), &( pucRecord[ pxRing->ulReadOffset ] ), xCopy );
+        xReceived += xCopy;
+        pxRing->ulReadOffset += ( uint32_t ) xCopy;
+
+        if( pxRing->ulReadOffset == xLength )
+        {
+            vMpscRingReleaseRecord( xRing );
+        }
+    }
+
+    return xReceived;
+}
+/*-----------------------------------------------------------*/
+
+void vMpscRingGetStats( MpscRingHandle_t xRing,
+                        MpscRingStats_t * pxStats )
+{
+    MpscRing_t * const pxRing = xRing;
+
+    configASSERT( pxRing );
+    configASSERT( pxStats );
+
+    pxStats->xSize = ( size_t ) pxRing->ulMask + 1U;
+    pxStats->xUsed = ( size_t ) ( pxRing->ulHead - pxRing->ulTail );
+    pxStats->xMaximumUsed = pxRing->ulMaximumUsed;
+    pxStats->ulRecords = pxRing->ulRecords;
+    pxStats->ulDropped = pxRing->ulDropped;
+}
+/*-----------------------------------------------------------*/
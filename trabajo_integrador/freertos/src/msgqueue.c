@@ -0,0 +1,237 @@
+/*
+ * Zero-copy message queues for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "mempool.h"
+#include "msgqueue.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Atomic where the compiler has native atomics, as in mempool.c.  Without
+ * them (ARMv6-M) the callers below mask interrupts around the update. */
+#if defined( __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4 )
+    #define msgqueueLOCK_FREE                  1
+    #define msgqueueADD( pxTarget, xValue )    __sync_add_and_fetch( ( pxTarget ), ( xValue ) )
+#else
+    #define msgqueueLOCK_FREE                  0
+    #define msgqueueADD( pxTarget, xValue )    ( *( pxTarget ) += ( xValue ) )
+#endif
+
+/* In front of every payload, msgqueueHEADER_SIZE bytes before it. */
+typedef struct MsgHeader
+{
+    MemPoolHandle_t xPool;
+    volatile UBaseType_t uxReferences;
+} MsgHeader_t;
+
+#define msgqueueHEADER( pvMessage )    ( ( MsgHeader_t * ) ( ( ( uint8_t * ) ( pvMessage ) ) - msgqueueHEADER_SIZE ) )
+
+/*-----------------------------------------------------------*/
+
+static void * prvInitialiseMessage( MemPoolHandle_t xPool,
+                                    void * pvBlock );
+static UBaseType_t prvAddReferences( void * pvMessage,
+                                     UBaseType_t uxDelta,
+                                     BaseType_t xFromISR );
+
+/*-----------------------------------------------------------*/
+
+static void * prvInitialiseMessage( MemPoolHandle_t xPool,
+                                    void * pvBlock )
+{
+    MsgHeader_t * pxHeader = pvBlock;
+
+    configASSERT( sizeof( MsgHeader_t ) <= msgqueueHEADER_SIZE );
+
+    if( pxHeader == NULL )
+    {
+        return NULL;
+    }
+
+    /* The block is the caller's alone until it is sent. */
+    pxHeader->xPool = xPool;
+    pxHeader->uxReferences = 1U;
+
+    return ( ( uint8_t * ) pvBlock ) + msgqueueHEADER_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvAddReferences( void * pvMessage,
+                                     UBaseType_t uxDelta,
+                                     BaseType_t xFromISR )
+{
+    MsgHeader_t * const pxHeader = msgqueueHEADER( pvMessage );
+    UBaseType_t uxReferences;
+
+    #if ( msgqueueLOCK_FREE == 0 )
+        UBaseType_t uxSavedInterruptStatus = 0;
+
+        if( xFromISR != pdFALSE )
+        {
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+        }
+    #else
+        ( void ) xFromISR;
+    #endif
+    {
+        /* The caller holds a reference, so the count cannot be 0 here. */
+        configASSERT( pxHeader->uxReferences > 0U );
+        uxReferences = msgqueueADD( &( pxHeader->uxReferences ), uxDelta );
+    }
+    #if ( msgqueueLOCK_FREE == 0 )
+        if( xFromISR != pdFALSE )
+        {
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+        else
+        {
+            taskEXIT_CRITICAL();
+        }
+    #endif
+
+    return uxReferences;
+}
+/*-----------------------------------------------------------*/
+
+void * pvMsgAlloc( MemPoolHandle_t xPool )
+{
+    configASSERT( xMemPoolGetBlockSize( xPool ) > msgqueueHEADER_SIZE );
+
+    return prvInitialiseMessage( xPool, pvMemPoolAlloc( xPool ) );
+}
+/*-----------------------------------------------------------*/
+
+void * pvMsgAllocFromISR( MemPoolHandle_t xPool )
+{
+    configASSERT( xMemPoolGetBlockSize( xPool ) > msgqueueHEADER_SIZE );
+
+    return prvInitialiseMessage( xPool, pvMemPoolAllocFromISR( xPool ) );
+}
+/*-----------------------------------------------------------*/
+
+void vMsgRetain( void * pvMessage )
+{
+    ( void ) prvAddReferences( pvMessage, 1U, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+void vMsgRetainFromISR( void * pvMessage )
+{
+    ( void ) prvAddReferences( pvMessage, 1U, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+void vMsgRelease( void * pvMessage )
+{
+    MsgHeader_t * const pxHeader = msgqueueHEADER( pvMessage );
+
+    /* With one reference the caller is the only holder and nobody else can
+     * change the count: the common case of a message with a single receiver
+     * needs no atomic update. */
+    if( ( pxHeader->uxReferences == 1U ) || ( prvAddReferences( pvMessage, ( UBaseType_t ) -1, pdFALSE ) == 0U ) )
+    {
+        pxHeader->uxReferences = 0U;
+        vMemPoolFree( pxHeader->xPool, pxHeader );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vMsgReleaseFromISR( void * pvMessage )
+{
+    MsgHeader_t * const pxHeader = msgqueueHEADER( pvMessage );
+
+    if( ( pxHeader->uxReferences == 1U ) || ( prvAddReferences( pvMessage, ( UBaseType_t ) -1, pdTRUE ) == 0U ) )
+    {
+        pxHeader->uxReferences = 0U;
+        vMemPoolFreeFromISR( pxHeader->xPool, pxHeader );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMsgQueueSend( QueueHandle_t xQueue,
+                          void * pvMessage,
+                          TickType_t xTicksToWait )
+{
+    configASSERT( pvMessage );
+
+    /* Only the pointer is copied into the queue. */
+    return xQueueSendToBack( xQueue, &pvMessage, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMsgQueueSendFromISR( QueueHandle_t xQueue,
+                                 void * pvMessage,
+                                 BaseType_t * pxHigherPriorityTaskWoken )
+{
+    configASSERT( pvMessage );
+
+    return xQueueSendToBackFromISR( xQueue, &pvMessage, pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+void * pvMsgQueueReceive( QueueHandle_t xQueue,
+                          TickType_t xTicksToWait )
+{
+    void * pvMessage;
+
+    if( xQueueReceive( xQueue, &pvMessage, xTicksToWait ) != pdPASS )
+    {
+        return NULL;
+    }
+
+    return pvMessage;
+}
+/*-----------------------------------------------------------*/
+
+void * pvMsgQueueReceiveFromISR( QueueHandle_t xQueue,
+                                 BaseType_t * pxHigherPriorityTaskWoken )
+{
+    void * pvMessage;
+
+    if( xQueueReceiveFromISR( xQueue, &pvMessage, pxHigherPriorityTaskWoken ) != pdPASS )
+    {
+        return NULL;
+    }
+
+    return pvMessage;
+}
+/*-----------------------------------------------------------*/
+
+void vMsgQueueDelete( QueueHandle_t xQueue )
+{
+    void * pvMessage;
+
+    while( ( pvMessage = pvMsgQueueReceive( xQueue, 0 ) ) != NULL )
+    {
+        vMsgRelease( pvMessage );
+    }
+
+    vQueueDelete( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMsgGetReferences( const void * pvMessage )
+{
+    return msgqueueHEADER( pvMessage )->uxReferences;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMsgGetSize( const void * pvMessage )
+{
+    return xMemPoolGetBlockSize( msgqueueHEADER( pvMessage )->xPool ) - msgqueueHEADER_SIZE;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,652 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*-----------------------------------------------------------
+* Implementation of functions defined in portable.h for the host (POSIX)
+* simulator port.
+*----------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/* Host side state of one task.  The FreeRTOS stack only stores a pointer to
+ * this structure, the task itself runs on pvHostStack. */
+typedef struct SimThread
+{
+    ucontext_t xContext;
+    void * pvHostStack;
+    TaskFunction_t pxCode;
+    void * pvParameters;
+} SimThread_t;
+
+/* The first member of a TCB is pxTopOfStack, which points at the slot holding
+ * the SimThread_t pointer written by pxPortInitialiseStack(). */
+#define prvGetThreadFromTask( xTask )    ( *( SimThread_t ** ) ( *( StackType_t ** ) ( xTask ) ) )
+
+/*
+ * Used to catch tasks that attempt to return from their implementing function.
+ */
+static void prvTaskExitError( void );
+
+/*-----------------------------------------------------------*/
+
+/* Same meaning as in the Cortex-M0 port.  Interrupts are "masked" while
+ * xInterruptsMasked is set, and an "ISR" is running while uxInterruptNesting
+ * is not zero.  Context switches requested in any of those states are held in
+ * xSwitchPending, the equivalent of a pended PendSV. */
+static UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
+static UBaseType_t uxInterruptNesting = 0;
+static BaseType_t xInterruptsMasked = pdTRUE;
+static BaseType_t xSwitchPending = pdFALSE;
+
+/* Context vTaskStartScheduler() was called from, resumed by vPortEndScheduler(). */
+static ucontext_t xSchedulerContext;
+
+/* Lengths of the sections run with interrupts masked (critical sections and
+ * ISRs) and of the tick interrupt, while vPortSimMeasureCritical() is on. */
+static BaseType_t xMeasureCritical = pdFALSE;
+static uint64_t ullMaskedSinceNs = 0;
+static SimCriticalStats_t xMaskedStats;
+static SimCriticalStats_t xTickStats;
+
+static TickType_t xSimEndTick = 0;
+static uint32_t ulSimSpeedFactor = 0;
+static uint64_t ullSimStartNs = 0;
+static uint64_t ullSimPacedTicks = 0;
+static uint64_t ullContextSwitches = 0;
+
+/* Peripheral interrupts scheduled by vPortSimScheduleInterrupt(). */
+typedef struct SimScheduledInterrupt
+{
+    TickType_t xTick;
+    void ( * pxHandler )( void );
+} SimScheduledInterrupt_t;
+
+static SimScheduledInterrupt_t xScheduledInterrupts[ portSIM_MAX_SCHEDULED_INTERRUPTS ];
+static UBaseType_t uxScheduledInterrupts = 0;
+
+#if ( configUSE_HIGH_RES_TIMERS == 1 )
+
+/* Compare register of the high resolution timer counter.  The counter follows
+ * the virtual tick, so a compare fires on the first tick at or after it. */
+    #define portSIM_HIGH_RES_COUNTS_PER_TICK    ( ( uint32_t ) ( configHIGH_RES_TIMER_HZ / configTICK_RATE_HZ ) )
+
+    static BaseType_t xHighResCompareEnabled = pdFALSE;
+    static uint32_t ulHighResCompare = 0;
+#endif
+
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortSimGetHostTimeNs( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskEntry( void )
+{
+    SimThread_t * pxThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    /* A new task starts with interrupts enabled, as after the exception
+     * return on the target. */
+    xInterruptsMasked = pdFALSE;
+
+    pxThread->pxCode( pxThread->pvParameters );
+
+    prvTaskExitError();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    SimThread_t * pxThread;
+
+    pxThread = malloc( sizeof( SimThread_t ) );
+    configASSERT( pxThread != NULL );
+    pxThread->pvHostStack = malloc( portSIM_HOST_STACK_SIZE );
+    configASSERT( pxThread->pvHostStack != NULL );
+    pxThread->pxCode = pxCode;
+    pxThread->pvParameters = pvParameters;
+
+    getcontext( &( pxThread->xContext ) );
+    pxThread->xContext.uc_stack.ss_sp = pxThread->pvHostStack;
+    pxThread->xContext.uc_stack.ss_size = portSIM_HOST_STACK_SIZE;
+    pxThread->xContext.uc_link = NULL;
+    makecontext( &( pxThread->xContext ), prvTaskEntry, 0 );
+
+    /* pxTopOfStack is already aligned to portBYTE_ALIGNMENT, stepping back by
+     * the size of a pointer keeps the slot aligned and inside the stack. */
+    pxTopOfStack -= sizeof( SimThread_t * ) / sizeof( StackType_t );
+    memcpy( pxTopOfStack, &pxThread, sizeof( SimThread_t * ) );
+
+    return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCleanUpTCB( void * pxTCB )
+{
+    SimThread_t * pxThread = prvGetThreadFromTask( pxTCB );
+
+    free( pxThread->pvHostStack );
+    free( pxThread );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskExitError( void )
+{
+    /* A function that implements a task must not exit or attempt to return to
+     * its caller as there is nothing to return to.  If a task wants to exit it
+     * should instead call vTaskDelete( NULL ). */
+    fprintf( stderr, "FreeRTOS: task '%s' returned from its function\n",
+             pcTaskGetName( NULL ) );
+    abort();
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchContext( void )
+{
+    SimThread_t * pxOld = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+    SimThread_t * pxNew;
+
+    xInterruptsMasked = pdTRUE;
+    vTaskSwitchContext();
+    pxNew = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    if( pxNew != pxOld )
+    {
+        ullContextSwitches++;
+        swapcontext( &( pxOld->xContext ), &( pxNew->xContext ) );
+    }
+
+    xInterruptsMasked = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/* Take a pended context switch as soon as interrupts are enabled again,
+ * the point at which PendSV would run on the target. */
+static void prvServicePendingSwitch( void )
+{
+    if( ( xSwitchPending != pdFALSE ) &&
+        ( xInterruptsMasked == pdFALSE ) &&
+        ( uxCriticalNesting == 0 ) &&
+        ( uxInterruptNesting == 0 ) )
+    {
+        xSwitchPending = pdFALSE;
+        prvSwitchContext();
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+BaseType_t xPortStartScheduler( void )
+{
+    SimThread_t * pxFirst = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    /* Initialise the critical nesting count ready for the first task. */
+    uxCriticalNesting = 0;
+    uxInterruptNesting = 0;
+    xSwitchPending = pdFALSE;
+    ullSimStartNs = ullPortSimGetHostTimeNs();
+    ullSimPacedTicks = 0;
+
+    /* Start the first task.  Control only comes back here once
+     * vTaskEndScheduler() has been called. */
+    swapcontext( &xSchedulerContext, &( pxFirst->xContext ) );
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+    SimThread_t * pxThread = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+    swapcontext( &( pxThread->xContext ), &xSchedulerContext );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+    xSwitchPending = pdTRUE;
+    prvServicePendingSwitch();
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( BaseType_t xSwitchRequired )
+{
+    if( xSwitchRequired != pdFALSE )
+    {
+        vPortYield();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddSample( SimCriticalStats_t * pxStats,
+                          uint64_t ullNs )
+{
+    pxStats->ullCount++;
+    pxStats->ullTotalNs += ullNs;
+
+    if( ullNs > pxStats->ullMaxNs )
+    {
+        pxStats->ullMaxNs = ullNs;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvMask( void )
+{
+    if( ( xInterruptsMasked == pdFALSE ) && ( xMeasureCritical != pdFALSE ) )
+    {
+        ullMaskedSinceNs = ullPortSimGetHostTimeNs();
+    }
+
+    xInterruptsMasked = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnmask( void )
+{
+    if( ( xInterruptsMasked != pdFALSE ) && ( xMeasureCritical != pdFALSE ) && ( ullMaskedSinceNs != 0 ) )
+    {
+        prvAddSample( &xMaskedStats, ullPortSimGetHostTimeNs() - ullMaskedSinceNs );
+    }
+
+    ullMaskedSinceNs = 0;
+    xInterruptsMasked = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+    prvMask();
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+    prvUnmask();
+    prvServicePendingSwitch();
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+    portDISABLE_INTERRUPTS();
+    uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+    configASSERT( uxCriticalNesting );
+    uxCriticalNesting--;
+
+    if( uxCriticalNesting == 0 )
+    {
+        portENABLE_INTERRUPTS();
+    }
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulSetInterruptMaskFromISR( void )
+{
+    uint32_t ulMask = ( uint32_t ) xInterruptsMasked;
+
+    prvMask();
+
+    return ulMask;
+}
+/*-----------------------------------------------------------*/
+
+void vClearInterruptMaskFromISR( uint32_t ulMask )
+{
+    if( ulMask == ( uint32_t ) pdFALSE )
+    {
+        prvUnmask();
+    }
+
+    prvServicePendingSwitch();
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimulateInterrupt( void ( * pxHandler )( void ) )
+{
+    uxInterruptNesting++;
+    pxHandler();
+    uxInterruptNesting--;
+
+    prvServicePendingSwitch();
+}
+/*-----------------------------------------------------------*/
+
+/* Sleep on the host so that virtual time does not run ahead of the wall
+ * clock by more than the configured speed factor. */
+static void prvPaceVirtualTime( TickType_t xTicks )
+{
+    uint64_t ullTargetNs;
+    struct timespec xTarget;
+
+    if( ulSimSpeedFactor == 0 )
+    {
+        return;
+    }
+
+    ullSimPacedTicks += xTicks;
+    ullTargetNs = ullSimStartNs +
+                  ( ullSimPacedTicks * ( 1000000000ULL / configTICK_RATE_HZ ) ) / ulSimSpeedFactor;
+
+    if( ullTargetNs > ullPortSimGetHostTimeNs() )
+    {
+        xTarget.tv_sec = ( time_t ) ( ullTargetNs / 1000000000ULL );
+        xTarget.tv_nsec = ( long ) ( ullTargetNs % 1000000000ULL );
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xTarget, NULL );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickISR( void )
+{
+    uint32_t ulPreviousMask;
+    uint64_t ullStartNs = 0;
+
+    if( xMeasureCritical != pdFALSE )
+    {
+        ullStartNs = ullPortSimGetHostTimeNs();
+    }
+
+    ulPreviousMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        portYIELD_FROM_ISR( xTaskIncrementTick() );
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( ulPreviousMask );
+
+    if( ullStartNs != 0 )
+    {
+        prvAddSample( &xTickStats, ullPortSimGetHostTimeNs() - ullStartNs );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimScheduleInterrupt( TickType_t xTicksFromNow,
+                                void ( * pxHandler )( void ) )
+{
+    configASSERT( uxScheduledInterrupts < portSIM_MAX_SCHEDULED_INTERRUPTS );
+    configASSERT( xTicksFromNow > 0 );
+
+    xScheduledInterrupts[ uxScheduledInterrupts ].xTick = xTaskGetTickCount() + xTicksFromNow;
+    xScheduledInterrupts[ uxScheduledInterrupts ].pxHandler = pxHandler;
+    uxScheduledInterrupts++;
+}
+/*-----------------------------------------------------------*/
+
+/* Ticks from now to the earliest scheduled interrupt, or portMAX_DELAY if
+ * none is pending.  Entries already due count as 0. */
+static TickType_t prvTicksToNextInterrupt( void )
+{
+    TickType_t xNow = xTaskGetTickCount();
+    TickType_t xMin = portMAX_DELAY;
+    TickType_t xLeft;
+    UBaseType_t ux;
+
+    for( ux = 0; ux < uxScheduledInterrupts; ux++ )
+    {
+        xLeft = xScheduledInterrupts[ ux ].xTick - xNow;
+
+        /* A due entry wraps to a value above half the tick range. */
+        if( xLeft > ( portMAX_DELAY / 2 ) )
+        {
+            xLeft = 0;
+        }
+
+        if( xLeft < xMin )
+        {
+            xMin = xLeft;
+        }
+    }
+
+    #if ( configUSE_HIGH_RES_TIMERS == 1 )
+        if( xHighResCompareEnabled != pdFALSE )
+        {
+            uint32_t ulLeft = ulHighResCompare - ulPortSimHighResGetCount();
+
+            xLeft = ( ulLeft > 0x7fffffffUL ) ? 0 :
+                    ( TickType_t ) ( ( ulLeft + portSIM_HIGH_RES_COUNTS_PER_TICK - 1U ) / portSIM_HIGH_RES_COUNTS_PER_TICK );
+
+            if( xLeft < xMin )
+            {
+                xMin = xLeft;
+            }
+        }
+    #endif
+
+    return xMin;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunScheduledInterrupts( void )
+{
+    TickType_t xNow = xTaskGetTickCount();
+    void ( * pxHandler )( void );
+    UBaseType_t ux = 0;
+
+    while( ux < uxScheduledInterrupts )
+    {
+        if( ( TickType_t ) ( xNow - xScheduledInterrupts[ ux ].xTick ) <= ( portMAX_DELAY / 2 ) )
+        {
+            /* Remove the entry before running the handler so that it can
+             * schedule itself again. */
+            pxHandler = xScheduledInterrupts[ ux ].pxHandler;
+            uxScheduledInterrupts--;
+            xScheduledInterrupts[ ux ] = xScheduledInterrupts[ uxScheduledInterrupts ];
+            vPortSimulateInterrupt( pxHandler );
+        }
+        else
+        {
+            ux++;
+        }
+    }
+
+    #if ( configUSE_HIGH_RES_TIMERS == 1 )
+        if( ( xHighResCompareEnabled != pdFALSE ) &&
+            ( ( ulPortSimHighResGetCount() - ulHighResCompare ) <= 0x7fffffffUL ) )
+        {
+            /* A match interrupts once; the handler sets the next compare. */
+            xHighResCompareEnabled = pdFALSE;
+            vPortSimulateInterrupt( vTimerHighResInterruptHandler );
+        }
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_HIGH_RES_TIMERS == 1 )
+
+    uint32_t ulPortSimHighResGetCount( void )
+    {
+        return ( uint32_t ) xTaskGetTickCount() * portSIM_HIGH_RES_COUNTS_PER_TICK;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortSimHighResSetCompare( uint32_t ulCount )
+    {
+        ulHighResCompare = ulCount;
+        xHighResCompareEnabled = pdTRUE;
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortSimHighResDisableCompare( void )
+    {
+        xHighResCompareEnabled = pdFALSE;
+    }
+
+#endif /* configUSE_HIGH_RES_TIMERS */
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortSimGetTraceTimestamp( void )
+{
+    static TickType_t xLastTick;
+    static uint64_t ullLastTickNs;
+    const uint32_t ulPerTick = portSIM_TRACE_TIMESTAMP_HZ / configTICK_RATE_HZ;
+    TickType_t xNow = xTaskGetTickCount();
+    uint64_t ullNs = ullPortSimGetHostTimeNs();
+    uint64_t ullElapsed;
+
+    /* The tick is taken as starting at the first timestamp read in it. */
+    if( ( xNow != xLastTick ) || ( ullLastTickNs == 0 ) )
+    {
+        xLastTick = xNow;
+        ullLastTickNs = ullNs;
+    }
+
+    ullElapsed = ( ( ullNs - ullLastTickNs ) * portSIM_TRACE_TIMESTAMP_HZ ) / 1000000000ULL;
+
+    if( ullElapsed >= ulPerTick )
+    {
+        ullElapsed = ulPerTick - 1U;
+    }
+
+    return ( ( uint32_t ) xNow * ulPerTick ) + ( uint32_t ) ullElapsed;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimulateTick( void )
+{
+    if( ( xSimEndTick != 0 ) && ( xTaskGetTickCount() >= xSimEndTick ) )
+    {
+        vTaskEndScheduler();
+    }
+
+    prvPaceVirtualTime( 1 );
+    vPortSimulateInterrupt( prvTickISR );
+    prvRunScheduledInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+        TickType_t xNextInterrupt;
+
+        if( xSimEndTick != 0 )
+        {
+            TickType_t xRemaining = xSimEndTick - xTaskGetTickCount();
+
+            if( xExpectedIdleTime > xRemaining )
+            {
+                xExpectedIdleTime = xRemaining;
+            }
+        }
+
+        /* Wake in time for the tick that runs the next scheduled interrupt,
+         * as the real interrupt would end the sleep. */
+        xNextInterrupt = prvTicksToNextInterrupt();
+
+        if( xNextInterrupt <= xExpectedIdleTime )
+        {
+            xExpectedIdleTime = ( xNextInterrupt > 0 ) ? ( xNextInterrupt - 1 ) : 0;
+        }
+
+        if( xExpectedIdleTime == 0 )
+        {
+            return;
+        }
+
+        portDISABLE_INTERRUPTS();
+
+        /* As on the target, an interrupt may have made a task ready between
+         * the idle task deciding to sleep and interrupts being masked. */
+        if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+        {
+            portENABLE_INTERRUPTS();
+            return;
+        }
+
+        /* Nothing runs while the core sleeps, so the whole idle period passes
+         * at once.  The scheduler is suspended, so re-enabling interrupts
+         * before stepping the tick cannot cause a context switch. */
+        prvPaceVirtualTime( xExpectedIdleTime );
+        portENABLE_INTERRUPTS();
+        vTaskStepTick( xExpectedIdleTime );
+    }
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+void vPortSimSetEndTick( TickType_t xEndTick )
+{
+    xSimEndTick = xEndTick;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimSetSpeed( uint32_t ulSpeedFactor )
+{
+    ulSimSpeedFactor = ulSpeedFactor;
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortSimGetContextSwitches( void )
+{
+    return ullContextSwitches;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimMeasureCritical( BaseType_t xEnable )
+{
+    memset( &xMaskedStats, 0, sizeof( xMaskedStats ) );
+    memset( &xTickStats, 0, sizeof( xTickStats ) );
+    ullMaskedSinceNs = 0;
+    xMeasureCritical = xEnable;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimGetCriticalStats( SimCriticalStats_t * pxMasked,
+                               SimCriticalStats_t * pxTick )
+{
+    *pxMasked = xMaskedStats;
+    *pxTick = xTickStats;
+}
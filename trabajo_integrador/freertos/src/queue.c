@@ -130,6 +130,11 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
         UBaseType_t uxQueueNumber;
         uint8_t ucQueueType;
     #endif
+
+    #if ( configUSE_MUTEX_STATS == 1 )
+        MutexStats_t xMutexStats; /*< Accumulated in timestamp counts, converted to microseconds by vQueueGetMutexStats(). */
+        uint32_t ulHoldStart;     /*< Timestamp of the take by the current holder. */
+    #endif
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -138,6 +143,18 @@ typedef xQUEUE Queue_t;
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MUTEX_STATS == 1 )
+
+    #if ( ( configMUTEX_STATS_TIMESTAMP_HZ % 1000000UL ) != 0 )
+        #error configMUTEX_STATS_TIMESTAMP_HZ must be a multiple of 1 MHz.
+    #endif
+
+    #define queueMUTEX_STATS_TO_US( x )    ( ( x ) / ( configMUTEX_STATS_TIMESTAMP_HZ / 1000000UL ) )
+
+#endif
+
+/*-----------------------------------------------------------*/
+
 /*
  * The queue registry is just a means for kernel aware debuggers to locate
  * queue structures.  It has no other purpose so is an optional component.
@@ -231,6 +248,15 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
     static void prvInitialiseMutex( Queue_t * pxNewQueue ) PRIVILEGED_FUNCTION;
 #endif
 
+/*
+ * Adds a wait of ulWait timestamp counts to the statistics of a mutex.  Called
+ * from a critical section.
+ */
+#if ( configUSE_MUTEX_STATS == 1 )
+    static void prvRecordMutexWait( Queue_t * const pxMutex,
+                                    uint32_t ulWait ) PRIVILEGED_FUNCTION;
+#endif
+
 #if ( configUSE_MUTEXES == 1 )
 
 /*
@@ -553,6 +579,13 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
             /* In case this is a recursive mutex. */
             pxNewQueue->u.xSemaphore.uxRecursiveCallCount = 0;
 
+            #if ( configUSE_MUTEX_STATS == 1 )
+            {
+                ( void ) memset( &( pxNewQueue->xMutexStats ), 0x00, sizeof( pxNewQueue->xMutexStats ) );
+                pxNewQueue->ulHoldStart = 0;
+            }
+            #endif
+
             traceCREATE_MUTEX( pxNewQueue );
 
             /* Start with the semaphore in the expected state. */
@@ -663,6 +696,59 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
 #endif /* if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) ) */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MUTEX_STATS == 1 )
+
+    static void prvRecordMutexWait( Queue_t * const pxMutex,
+                                    uint32_t ulWait )
+    {
+        pxMutex->xMutexStats.ulWaits++;
+        pxMutex->xMutexStats.ullWaitTotal += ulWait;
+
+        if( ulWait > pxMutex->xMutexStats.ulWaitMax )
+        {
+            pxMutex->xMutexStats.ulWaitMax = ulWait;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vQueueGetMutexStats( QueueHandle_t xMutex,
+                              MutexStats_t * pxStats,
+                              BaseType_t xReset )
+    {
+        Queue_t * const pxMutex = ( Queue_t * ) xMutex;
+
+        configASSERT( pxMutex );
+        configASSERT( pxStats );
+        configASSERT( pxMutex->uxQueueType == queueQUEUE_IS_MUTEX );
+
+        taskENTER_CRITICAL();
+        {
+            *pxStats = pxMutex->xMutexStats;
+
+            if( xReset != pdFALSE )
+            {
+                ( void ) memset( &( pxMutex->xMutexStats ), 0x00, sizeof( pxMutex->xMutexStats ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        pxStats->ulHoldMax = queueMUTEX_STATS_TO_US( pxStats->ulHoldMax );
+        pxStats->ulWaitMax = queueMUTEX_STATS_TO_US( pxStats->ulWaitMax );
+        pxStats->ullHoldTotal = queueMUTEX_STATS_TO_US( pxStats->ullHoldTotal );
+        pxStats->ullWaitTotal = queueMUTEX_STATS_TO_US( pxStats->ullWaitTotal );
+    }
+
+#endif /* configUSE_MUTEX_STATS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_RECURSIVE_MUTEXES == 1 )
 
     BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex )
@@ -1529,6 +1615,11 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
         BaseType_t xInheritanceOccurred = pdFALSE;
     #endif
 
+    #if ( configUSE_MUTEX_STATS == 1 )
+        uint32_t ulWaitStart = 0;
+        BaseType_t xInheritanceCounted = pdFALSE;
+    #endif
+
     /* Check the queue pointer is not NULL. */
     configASSERT( ( pxQueue ) );
 
@@ -1571,6 +1662,22 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                         /* Record the information required to implement
                          * priority inheritance should it become necessary. */
                         pxQueue->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
+
+                        #if ( configUSE_MUTEX_STATS == 1 )
+                        {
+                            pxQueue->ulHoldStart = configMUTEX_STATS_TIMESTAMP();
+                            pxQueue->xMutexStats.ulTakes++;
+
+                            if( xEntryTimeSet != pdFALSE )
+                            {
+                                prvRecordMutexWait( pxQueue, pxQueue->ulHoldStart - ulWaitStart );
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                        #endif /* configUSE_MUTEX_STATS */
                     }
                     else
                     {
@@ -1616,6 +1723,12 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                      * so configure the timeout structure ready to block. */
                     vTaskInternalSetTimeOutState( &xTimeOut );
                     xEntryTimeSet = pdTRUE;
+
+                    #if ( configUSE_MUTEX_STATS == 1 )
+                    {
+                        ulWaitStart = configMUTEX_STATS_TIMESTAMP();
+                    }
+                    #endif
                 }
                 else
                 {
@@ -1650,6 +1763,23 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                         taskENTER_CRITICAL();
                         {
                             xInheritanceOccurred = xTaskPriorityInherit( pxQueue->u.xSemaphore.xMutexHolder );
+
+                            #if ( configUSE_MUTEX_STATS == 1 )
+                            {
+                                /* Counted once per wait, however many times
+                                 * the task blocks again before it gets the
+                                 * mutex. */
+                                if( ( xInheritanceOccurred != pdFALSE ) && ( xInheritanceCounted == pdFALSE ) )
+                                {
+                                    pxQueue->xMutexStats.ulInheritances++;
+                                    xInheritanceCounted = pdTRUE;
+                                }
+                                else
+                                {
+                                    mtCOVERAGE_TEST_MARKER();
+                                }
+                            }
+                            #endif /* configUSE_MUTEX_STATS */
                         }
                         taskEXIT_CRITICAL();
                     }
@@ -1661,6 +1791,23 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                 #endif /* if ( configUSE_MUTEXES == 1 ) */
 
                 vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+
+                #if ( configUSE_MUTEX_STATS == 1 )
+                {
+                    /* The scheduler is suspended, and mutexes cannot be given
+                     * from interrupts, so the list cannot change here. */
+                    if( ( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX ) &&
+                        ( listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToReceive ) ) > pxQueue->xMutexStats.uxMaxWaiters ) )
+                    {
+                        pxQueue->xMutexStats.uxMaxWaiters = listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToReceive ) );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_MUTEX_STATS */
+
                 prvUnlockQueue( pxQueue );
 
                 if( xTaskResumeAll() == pdFALSE )
@@ -1716,6 +1863,24 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                 }
                 #endif /* configUSE_MUTEXES */
 
+                #if ( configUSE_MUTEX_STATS == 1 )
+                {
+                    if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+                    {
+                        taskENTER_CRITICAL();
+                        {
+                            pxQueue->xMutexStats.ulTimeouts++;
+                            prvRecordMutexWait( pxQueue, configMUTEX_STATS_TIMESTAMP() - ulWaitStart );
+                        }
+                        taskEXIT_CRITICAL();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_MUTEX_STATS */
+
                 traceQUEUE_RECEIVE_FAILED( pxQueue );
                 return errQUEUE_EMPTY;
             }
@@ -2189,6 +2354,32 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
         {
             if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
             {
+                #if ( configUSE_MUTEX_STATS == 1 )
+                {
+                    /* The holder is NULL for the give that creates the
+                     * mutex. */
+                    if( pxQueue->u.xSemaphore.xMutexHolder != NULL )
+                    {
+                        const uint32_t ulHold = configMUTEX_STATS_TIMESTAMP() - pxQueue->ulHoldStart;
+
+                        pxQueue->xMutexStats.ullHoldTotal += ulHold;
+
+                        if( ulHold > pxQueue->xMutexStats.ulHoldMax )
+                        {
+                            pxQueue->xMutexStats.ulHoldMax = ulHold;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_MUTEX_STATS */
+
                 /* The mutex is no longer being held. */
                 xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
                 pxQueue->u.xSemaphore.xMutexHolder = NULL;
@@ -0,0 +1,419 @@
+/*
+ * Aligned sample sets from several producers for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#include "samplesync.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Producer n uses bit n of the event group at the barrier; the consumer waits
+ * on the bit above the last producer. */
+#define samplesyncREADY_BIT          ( ( EventBits_t ) 1U << samplesyncMAX_PRODUCERS )
+
+/* ulFlags. */
+#define samplesyncHAVE_LAST_PERIOD    ( 0x01UL )
+#define samplesyncSET_READY           ( 0x02UL )
+
+#define samplesyncNO_SLOT             ( 2U )
+
+typedef struct SampleSyncDefinition
+{
+    StaticEventGroup_t xEventGroupBuffer;
+    EventGroupHandle_t xEventGroup;
+    uint8_t * pucBanks;               /* Three banks of ulProducers samples. */
+    size_t xSampleSize;
+    uint32_t ulProducers;
+    uint32_t ulReadyBank;             /* Bank of the last complete set. */
+    uint32_t ulLastPeriod;            /* Last period completed or dropped; older samples are late. */
+    uint32_t ulFlags;
+    SampleSyncSlot_t xSlots[ 2 ];     /* The periods being collected. */
+    SampleSyncSet_t xReadySet;
+    SampleSyncStats_t xStats;
+} SampleSync_t;
+
+/* Periods are compared with wrap around. */
+#define samplesyncIS_BEFORE( ulA, ulB )    ( ( int32_t ) ( ( ulA ) - ( ulB ) ) < 0 )
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseSync( SampleSync_t * pxSync,
+                               UBaseType_t uxProducers,
+                               size_t xSampleSize,
+                               uint8_t * pucStorage );
+static BaseType_t prvPost( SampleSync_t * pxSync,
+                           UBaseType_t uxProducer,
+                           uint32_t ulPeriod,
+                           uint32_t ulTimestamp,
+                           const void * pvSample,
+                           BaseType_t * pxCompleted );
+static void prvDropSlot( SampleSync_t * pxSync,
+                         SampleSyncSlot_t * pxSlot );
+static void prvCompleteSlot( SampleSync_t * pxSync,
+                             SampleSyncSlot_t * pxSlot );
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseSync( SampleSync_t * pxSync,
+                               UBaseType_t uxProducers,
+                               size_t xSampleSize,
+                               uint8_t * pucStorage )
+{
+    memset( pxSync, 0, sizeof( SampleSync_t ) );
+
+    pxSync->xEventGroup = xEventGroupCreateStatic( &( pxSync->xEventGroupBuffer ) );
+    pxSync->pucBanks = pucStorage;
+    pxSync->xSampleSize = xSampleSize;
+    pxSync->ulProducers = ( uint32_t ) uxProducers;
+    pxSync->ulReadyBank = 2U;
+    pxSync->xSlots[ 0 ].ulBank = 0U;
+    pxSync->xSlots[ 1 ].ulBank = 1U;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    SampleSyncHandle_t xSampleSyncCreate( UBaseType_t uxProducers,
+                                          size_t xSampleSize )
+    {
+        SampleSync_t * pxSync;
+
+        configASSERT( ( uxProducers > 0U ) && ( uxProducers <= samplesyncMAX_PRODUCERS ) );
+        configASSERT( xSampleSize > 0U );
+
+        /* The banks follow the structure in the same allocation. */
+        pxSync = pvPortMalloc( sizeof( SampleSync_t ) + samplesyncSTORAGE_SIZE( uxProducers, xSampleSize ) );
+
+        if( pxSync != NULL )
+        {
+            prvInitialiseSync( pxSync, uxProducers, xSampleSize, ( uint8_t * ) ( pxSync + 1 ) );
+        }
+
+        return pxSync;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+    SampleSyncHandle_t xSampleSyncCreateStatic( UBaseType_t uxProducers,
+                                                size_t xSampleSize,
+                                                uint8_t * pucStorage,
+                                                StaticSampleSync_t * pxStaticSync )
+    {
+        SampleSync_t * const pxSync = ( SampleSync_t * ) pxStaticSync;
+
+        configASSERT( ( uxProducers > 0U ) && ( uxProducers <= samplesyncMAX_PRODUCERS ) );
+        configASSERT( xSampleSize > 0U );
+        configASSERT( pucStorage );
+        configASSERT( pxStaticSync );
+
+        /* StaticSampleSync_t must be able to hold a SampleSync_t. */
+        configASSERT( sizeof( StaticSampleSync_t ) == sizeof( SampleSync_t ) );
+
+        prvInitialiseSync( pxSync, uxProducers, xSampleSize, pucStorage );
+
+        return pxSync;
+    }
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+static void prvDropSlot( SampleSync_t * pxSync,
+                         SampleSyncSlot_t * pxSlot )
+{
+    /* Samples still to come for this period are late from now on. */
+    if( ( ( pxSync->ulFlags & samplesyncHAVE_LAST_PERIOD ) == 0U ) ||
+        samplesyncIS_BEFORE( pxSync->ulLastPeriod, pxSlot->xSet.ulPeriod ) )
+    {
+        pxSync->ulLastPeriod = pxSlot->xSet.ulPeriod;
+        pxSync->ulFlags |= samplesyncHAVE_LAST_PERIOD;
+    }
+
+    pxSlot->ulArrived = 0U;
+    pxSync->xStats.ulDropped++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCompleteSlot( SampleSync_t * pxSync,
+                             SampleSyncSlot_t * pxSlot )
+{
+    SampleSyncSlot_t * const pxOther = ( pxSlot == &( pxSync->xSlots[ 0 ] ) ) ? &( pxSync->xSlots[ 1 ] ) : &( pxSync->xSlots[ 0 ] );
+    uint32_t ulBank, ulSkew;
+
+    /* An older period can no longer produce a newer set. */
+    if( ( pxOther->ulArrived != 0U ) && samplesyncIS_BEFORE( pxOther->xSet.ulPeriod, pxSlot->xSet.ulPeriod ) )
+    {
+        prvDropSlot( pxSync, pxOther );
+    }
+
+    pxSync->ulLastPeriod = pxSlot->xSet.ulPeriod;
+    pxSync->ulFlags |= samplesyncHAVE_LAST_PERIOD;
+
+    if( ( pxSync->ulFlags & samplesyncSET_READY ) != 0U )
+    {
+        pxSync->xStats.ulOverwritten++;
+    }
+
+    /* The complete bank becomes the ready one, and the slot collects the next
+     * period in the bank that was ready. */
+    ulBank = pxSync->ulReadyBank;
+    pxSync->ulReadyBank = pxSlot->ulBank;
+    pxSlot->ulBank = ulBank;
+    pxSlot->ulArrived = 0U;
+
+    pxSync->xReadySet = pxSlot->xSet;
+    pxSync->ulFlags |= samplesyncSET_READY;
+
+    ulSkew = pxSlot->xSet.ulLastTimestamp - pxSlot->xSet.ulFirstTimestamp;
+    pxSync->xStats.ulSets++;
+    pxSync->xStats.ullSkewTotal += ulSkew;
+
+    if( ulSkew > pxSync->xStats.ulSkewMax )
+    {
+        pxSync->xStats.ulSkewMax = ulSkew;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* Called with interrupts masked. */
+static BaseType_t prvPost( SampleSync_t * pxSync,
+                           UBaseType_t uxProducer,
+                           uint32_t ulPeriod,
+                           uint32_t ulTimestamp,
+                           const void * pvSample,
+                           BaseType_t * pxCompleted )
+{
+    SampleSyncSlot_t * pxSlot = NULL;
+    UBaseType_t uxFree = samplesyncNO_SLOT, uxOldest = samplesyncNO_SLOT, ux;
+
+    if( ( ( pxSync->ulFlags & samplesyncHAVE_LAST_PERIOD ) != 0U ) &&
+        !samplesyncIS_BEFORE( pxSync->ulLastPeriod, ulPeriod ) )
+    {
+        pxSync->xStats.ulLate++;
+        return pdFAIL;
+    }
+
+    for( ux = 0; ux < 2U; ux++ )
+    {
+        if( pxSync->xSlots[ ux ].ulArrived == 0U )
+        {
+            uxFree = ux;
+        }
+        else if( pxSync->xSlots[ ux ].xSet.ulPeriod == ulPeriod )
+        {
+            pxSlot = &( pxSync->xSlots[ ux ] );
+        }
+        else if( ( uxOldest == samplesyncNO_SLOT ) ||
+                 samplesyncIS_BEFORE( pxSync->xSlots[ ux ].xSet.ulPeriod, pxSync->xSlots[ uxOldest ].xSet.ulPeriod ) )
+        {
+            uxOldest = ux;
+        }
+    }
+
+    if( pxSlot == NULL )
+    {
+        if( uxFree == samplesyncNO_SLOT )
+        {
+            /* Both slots hold other periods: a third one starts by dropping
+             * the oldest, unless it is older than both. */
+            if( samplesyncIS_BEFORE( ulPeriod, pxSync->xSlots[ uxOldest ].xSet.ulPeriod ) )
+            {
+                pxSync->xStats.ulLate++;
+                return pdFAIL;
+            }
+
+            prvDropSlot( pxSync, &( pxSync->xSlots[ uxOldest ] ) );
+            uxFree = uxOldest;
+        }
+
+        pxSlot = &( pxSync->xSlots[ uxFree ] );
+        pxSlot->xSet.ulPeriod = ulPeriod;
+        pxSlot->xSet.ulFirstTimestamp = ulTimestamp;
+        pxSlot->xSet.ulLastTimestamp = ulTimestamp;
+    }
+    else if( samplesyncIS_BEFORE( ulTimestamp, pxSlot->xSet.ulFirstTimestamp ) )
+    {
+        pxSlot->xSet.ulFirstTimestamp = ulTimestamp;
+    }
+    else if( samplesyncIS_BEFORE( pxSlot->xSet.ulLastTimestamp, ulTimestamp ) )
+    {
+        pxSlot->xSet.ulLastTimestamp = ulTimestamp;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    memcpy( &( pxSync->pucBanks[ ( ( pxSlot->ulBank * pxSync->ulProducers ) + uxProducer ) * pxSync->xSampleSize ] ),
+            pvSample, pxSync->xSampleSize );
+    pxSlot->ulArrived |= 1UL << uxProducer;
+
+    if( pxSlot->ulArrived == ( ( 1UL << pxSync->ulProducers ) - 1U ) )
+    {
+        prvCompleteSlot( pxSync, pxSlot );
+        *pxCompleted = pdTRUE;
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSampleSyncPost( SampleSyncHandle_t xSync,
+                            UBaseType_t uxProducer,
+                            uint32_t ulPeriod,
+                            uint32_t ulTimestamp,
+                            const void * pvSample )
+{
+    SampleSync_t * const pxSync = xSync;
+    BaseType_t xReturn, xCompleted = pdFALSE;
+
+    configASSERT( pxSync );
+    configASSERT( uxProducer < pxSync->ulProducers );
+    configASSERT( pvSample );
+
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvPost( pxSync, uxProducer, ulPeriod, ulTimestamp, pvSample, &xCompleted );
+    }
+    taskEXIT_CRITICAL();
+
+    if( xCompleted != pdFALSE )
+    {
+        ( void ) xEventGroupSetBits( pxSync->xEventGroup, samplesyncREADY_BIT );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSampleSyncPostFromISR( SampleSyncHandle_t xSync,
+                                   UBaseType_t uxProducer,
+                                   uint32_t ulPeriod,
+                                   uint32_t ulTimestamp,
+                                   const void * pvSample,
+                                   BaseType_t * pxHigherPriorityTaskWoken )
+{
+    SampleSync_t * const pxSync = xSync;
+    BaseType_t xReturn, xCompleted = pdFALSE;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pxSync );
+    configASSERT( uxProducer < pxSync->ulProducers );
+    configASSERT( pvSample );
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        xReturn = prvPost( pxSync, uxProducer, ulPeriod, ulTimestamp, pvSample, &xCompleted );
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    /* If the timer queue is full the set stays ready, and the consumer gets
+     * it with the next one. */
+    if( xCompleted != pdFALSE )
+    {
+        ( void ) xEventGroupSetBitsFromISR( pxSync->xEventGroup, samplesyncREADY_BIT, pxHigherPriorityTaskWoken );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSampleSyncReceive( SampleSyncHandle_t xSync,
+                               void * pvSamples,
+                               SampleSyncSet_t * pxSet,
+                               TickType_t xTicksToWait )
+{
+    SampleSync_t * const pxSync = xSync;
+    TimeOut_t xTimeOut;
+    EventBits_t uxBits;
+    BaseType_t xReturn = pdFAIL;
+
+    configASSERT( pxSync );
+    configASSERT( pvSamples );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    for( ; ; )
+    {
+        uxBits = xEventGroupWaitBits( pxSync->xEventGroup, samplesyncREADY_BIT, pdFALSE, pdFALSE, xTicksToWait );
+
+        taskENTER_CRITICAL();
+        {
+            if( ( pxSync->ulFlags & samplesyncSET_READY ) != 0U )
+            {
+                memcpy( pvSamples, &( pxSync->pucBanks[ pxSync->ulReadyBank * pxSync->ulProducers * pxSync->xSampleSize ] ),
+                        pxSync->ulProducers * pxSync->xSampleSize );
+
+                if( pxSet != NULL )
+                {
+                    *pxSet = pxSync->xReadySet;
+                }
+
+                pxSync->ulFlags &= ~samplesyncSET_READY;
+                xReturn = pdPASS;
+            }
+
+            /* A producer that completed a set just before may still set the
+             * bit after this; the next call then wakes up with nothing ready
+             * and waits again. */
+            ( void ) xEventGroupClearBits( pxSync->xEventGroup, samplesyncREADY_BIT );
+        }
+        taskEXIT_CRITICAL();
+
+        if( ( xReturn == pdPASS ) || ( ( uxBits & samplesyncREADY_BIT ) == 0U ) ||
+            ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+        {
+            break;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSampleSyncBarrier( SampleSyncHandle_t xSync,
+                               UBaseType_t uxProducer,
+                               TickType_t xTicksToWait )
+{
+    SampleSync_t * const pxSync = xSync;
+    EventBits_t uxAll, uxBits;
+
+    configASSERT( pxSync );
+    configASSERT( uxProducer < pxSync->ulProducers );
+
+    uxAll = ( ( EventBits_t ) 1U << pxSync->ulProducers ) - 1U;
+
+    uxBits = xEventGroupSync( pxSync->xEventGroup, ( EventBits_t ) 1U << uxProducer, uxAll, xTicksToWait );
+
+    return ( ( uxBits & uxAll ) == uxAll ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+void vSampleSyncGetStats( SampleSyncHandle_t xSync,
+                          SampleSyncStats_t * pxStats )
+{
+    SampleSync_t * const pxSync = xSync;
+
+    configASSERT( pxSync );
+    configASSERT( pxStats );
+
+    taskENTER_CRITICAL();
+    {
+        *pxStats = pxSync->xStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
@@ -70,6 +70,8 @@
     #define tmrSTATUS_IS_ACTIVE                  ( ( uint8_t ) 0x01 )
     #define tmrSTATUS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 0x02 )
     #define tmrSTATUS_IS_AUTORELOAD              ( ( uint8_t ) 0x04 )
+    #define tmrSTATUS_IS_HIGH_RES                ( ( uint8_t ) 0x08 )
+    #define tmrSTATUS_CALLBACK_IN_ISR            ( ( uint8_t ) 0x10 )
 
 /* The definition of the timers themselves. */
     typedef struct tmrTimerControl                  /* The old naming convention is used to prevent breaking kernel aware debuggers. */
@@ -143,6 +145,17 @@
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
     PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
 
+    #if ( configUSE_HIGH_RES_TIMERS == 1 )
+
+/* Active high resolution timers, nearest expiry first.  The item values are
+ * counts of the hardware counter, which wraps, so the list is kept in order
+ * by prvInsertHighResTimer() rather than by vListInsert().  It is also used
+ * from the compare interrupt, so it is only accessed with interrupts masked. */
+        PRIVILEGED_DATA static List_t xHighResTimerList;
+        PRIVILEGED_DATA static TimerHighResStats_t xHighResStats;
+
+    #endif
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
@@ -394,6 +407,13 @@
 
         configASSERT( xTimer );
 
+        #if ( configUSE_HIGH_RES_TIMERS == 1 )
+        {
+            /* High resolution timers do not go through the timer queue. */
+            configASSERT( ( xTimer->ucStatus & tmrSTATUS_IS_HIGH_RES ) == 0 );
+        }
+        #endif
+
         /* Send a message to the timer service task to perform a particular action
          * on a particular timer definition. */
         if( xTimerQueue != NULL )
@@ -944,6 +964,12 @@
                 pxCurrentTimerList = &xActiveTimerList1;
                 pxOverflowTimerList = &xActiveTimerList2;
 
+                #if ( configUSE_HIGH_RES_TIMERS == 1 )
+                {
+                    vListInitialise( &xHighResTimerList );
+                }
+                #endif
+
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
                     /* The timer queue is allocated statically in case
@@ -1097,6 +1123,322 @@
     #endif /* INCLUDE_xTimerPendFunctionCall */
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_HIGH_RES_TIMERS == 1 )
+
+        static void prvInitialiseHighResTimer( Timer_t * const pxTimer,
+                                               const BaseType_t xCallbackContext )
+        {
+            if( pxTimer != NULL )
+            {
+                pxTimer->ucStatus |= tmrSTATUS_IS_HIGH_RES;
+
+                if( xCallbackContext == tmrHIGH_RES_CALLBACK_IN_ISR )
+                {
+                    pxTimer->ucStatus |= tmrSTATUS_CALLBACK_IN_ISR;
+                }
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+            TimerHandle_t xTimerCreateHighRes( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                               const uint32_t ulPeriodInCounts,
+                                               const BaseType_t xAutoReload,
+                                               void * const pvTimerID,
+                                               TimerCallbackFunction_t pxCallbackFunction,
+                                               const BaseType_t xCallbackContext )
+            {
+                TimerHandle_t xTimer;
+
+                /* The period is kept in xTimerPeriodInTicks. */
+                configASSERT( sizeof( TickType_t ) >= sizeof( uint32_t ) );
+                configASSERT( ulPeriodInCounts <= tmrHIGH_RES_MAX_PERIOD );
+
+                xTimer = xTimerCreate( pcTimerName, ( TickType_t ) ulPeriodInCounts, xAutoReload, pvTimerID, pxCallbackFunction );
+                prvInitialiseHighResTimer( xTimer, xCallbackContext );
+
+                return xTimer;
+            }
+
+        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+            TimerHandle_t xTimerCreateHighResStatic( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                                     const uint32_t ulPeriodInCounts,
+                                                     const BaseType_t xAutoReload,
+                                                     void * const pvTimerID,
+                                                     TimerCallbackFunction_t pxCallbackFunction,
+                                                     const BaseType_t xCallbackContext,
+                                                     StaticTimer_t * pxTimerBuffer )
+            {
+                TimerHandle_t xTimer;
+
+                configASSERT( sizeof( TickType_t ) >= sizeof( uint32_t ) );
+                configASSERT( ulPeriodInCounts <= tmrHIGH_RES_MAX_PERIOD );
+
+                xTimer = xTimerCreateStatic( pcTimerName, ( TickType_t ) ulPeriodInCounts, xAutoReload, pvTimerID, pxCallbackFunction, pxTimerBuffer );
+                prvInitialiseHighResTimer( xTimer, xCallbackContext );
+
+                return xTimer;
+            }
+
+        #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+        static void prvInsertHighResTimer( Timer_t * const pxTimer,
+                                           const uint32_t ulExpiry )
+        {
+            ListItem_t * const pxNewListItem = &( pxTimer->xTimerListItem );
+            ListItem_t const * const pxEnd = listGET_END_MARKER( &xHighResTimerList );
+            ListItem_t * pxNext = listGET_HEAD_ENTRY( &xHighResTimerList );
+            uint32_t ulHead;
+
+            listSET_LIST_ITEM_VALUE( pxNewListItem, ulExpiry );
+            listSET_LIST_ITEM_OWNER( pxNewListItem, pxTimer );
+
+            /* Every timer in the list expires at or after the head, which may
+             * already be due, so expiry times are compared as distances from
+             * the head.  A timer that expires before the head goes first. */
+            if( listLIST_IS_EMPTY( &xHighResTimerList ) == pdFALSE )
+            {
+                ulHead = listGET_ITEM_VALUE_OF_HEAD_ENTRY( &xHighResTimerList );
+
+                if( ( ulExpiry - ulHead ) <= tmrHIGH_RES_MAX_PERIOD )
+                {
+                    /* After timers with the same expiry time, as vListInsert()
+                     * does. */
+                    while( ( pxNext != pxEnd ) &&
+                           ( ( listGET_LIST_ITEM_VALUE( pxNext ) - ulHead ) <= ( ulExpiry - ulHead ) ) )
+                    {
+                        pxNext = listGET_NEXT( pxNext );
+                    }
+                }
+            }
+
+            /* vListInsertEnd() inserts in front of pxIndex, which this list
+             * does not otherwise use.  Linking the item here instead would
+             * write the end marker through a ListItem_t, which the compiler
+             * may reorder against reads of the MiniListItem_t. */
+            xHighResTimerList.pxIndex = pxNext;
+            vListInsertEnd( &xHighResTimerList, pxNewListItem );
+            xHighResTimerList.pxIndex = ( ListItem_t * ) pxEnd;
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvHighResCommand( Timer_t * const pxTimer,
+                                       const BaseType_t xStart,
+                                       const uint32_t ulNewPeriodInCounts,
+                                       const BaseType_t xFromISR )
+        {
+            UBaseType_t uxSavedInterruptStatus = 0;
+            uint32_t ulExpiry;
+
+            configASSERT( pxTimer );
+            configASSERT( ( pxTimer->ucStatus & tmrSTATUS_IS_HIGH_RES ) != 0 );
+            configASSERT( ulNewPeriodInCounts <= tmrHIGH_RES_MAX_PERIOD );
+
+            if( xFromISR != pdFALSE )
+            {
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+            }
+            else
+            {
+                taskENTER_CRITICAL();
+            }
+
+            {
+                if( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) != 0 )
+                {
+                    /* If it was the head, the compare interrupt may fire for
+                     * nothing and is set again for the new head. */
+                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                }
+
+                if( ulNewPeriodInCounts != 0U )
+                {
+                    pxTimer->xTimerPeriodInTicks = ( TickType_t ) ulNewPeriodInCounts;
+                }
+
+                if( xStart != pdFALSE )
+                {
+                    ulExpiry = portHIGH_RES_TIMER_GET_COUNT() + ( uint32_t ) pxTimer->xTimerPeriodInTicks;
+                    prvInsertHighResTimer( pxTimer, ulExpiry );
+                    pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+
+                    if( listGET_OWNER_OF_HEAD_ENTRY( &xHighResTimerList ) == pxTimer )
+                    {
+                        portHIGH_RES_TIMER_SET_COMPARE( ulExpiry );
+                    }
+                }
+            }
+
+            if( xFromISR != pdFALSE )
+            {
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+            }
+            else
+            {
+                taskEXIT_CRITICAL();
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerHighResStart( TimerHandle_t xTimer )
+        {
+            prvHighResCommand( xTimer, pdTRUE, 0U, pdFALSE );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerHighResStartFromISR( TimerHandle_t xTimer )
+        {
+            prvHighResCommand( xTimer, pdTRUE, 0U, pdTRUE );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerHighResChangePeriod( TimerHandle_t xTimer,
+                                        const uint32_t ulNewPeriodInCounts )
+        {
+            configASSERT( ulNewPeriodInCounts > 0U );
+            prvHighResCommand( xTimer, pdTRUE, ulNewPeriodInCounts, pdFALSE );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerHighResChangePeriodFromISR( TimerHandle_t xTimer,
+                                               const uint32_t ulNewPeriodInCounts )
+        {
+            configASSERT( ulNewPeriodInCounts > 0U );
+            prvHighResCommand( xTimer, pdTRUE, ulNewPeriodInCounts, pdTRUE );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerHighResStop( TimerHandle_t xTimer )
+        {
+            prvHighResCommand( xTimer, pdFALSE, 0U, pdFALSE );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerHighResStopFromISR( TimerHandle_t xTimer )
+        {
+            prvHighResCommand( xTimer, pdFALSE, 0U, pdTRUE );
+        }
+/*-----------------------------------------------------------*/
+
+/* Runs the callback of a high resolution timer in the timer task. */
+        static void prvHighResDeferredCallback( void * pvTimer,
+                                                uint32_t ulUnused )
+        {
+            Timer_t * const pxTimer = pvTimer;
+
+            ( void ) ulUnused;
+
+            traceTIMER_EXPIRED( pxTimer );
+            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerHighResInterruptHandler( void )
+        {
+            Timer_t * pxTimer;
+            UBaseType_t uxSavedInterruptStatus;
+            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+            uint32_t ulNow, ulExpiry;
+
+            /* One expired timer per pass, with interrupts masked only while
+             * the list changes.  Callbacks run unmasked, and may start or stop
+             * timers themselves. */
+            for( ; ; )
+            {
+                pxTimer = NULL;
+
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+                {
+                    ulNow = portHIGH_RES_TIMER_GET_COUNT();
+
+                    if( listLIST_IS_EMPTY( &xHighResTimerList ) != pdFALSE )
+                    {
+                        portHIGH_RES_TIMER_DISABLE_COMPARE();
+                    }
+                    else
+                    {
+                        ulExpiry = listGET_ITEM_VALUE_OF_HEAD_ENTRY( &xHighResTimerList );
+
+                        if( ( ulNow - ulExpiry ) > tmrHIGH_RES_MAX_PERIOD )
+                        {
+                            /* Not due yet. */
+                            portHIGH_RES_TIMER_SET_COMPARE( ulExpiry );
+                        }
+                        else
+                        {
+                            pxTimer = listGET_OWNER_OF_HEAD_ENTRY( &xHighResTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too. */
+                            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                            xHighResStats.ulExpiries++;
+
+                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+                            {
+                                ulExpiry += ( uint32_t ) pxTimer->xTimerPeriodInTicks;
+
+                                /* Too late for the next period as well: skip
+                                 * to one period from now instead of running
+                                 * the callback back to back. */
+                                if( ( ulNow - ulExpiry ) <= tmrHIGH_RES_MAX_PERIOD )
+                                {
+                                    xHighResStats.ulOverruns++;
+                                    ulExpiry = ulNow + ( uint32_t ) pxTimer->xTimerPeriodInTicks;
+                                }
+
+                                prvInsertHighResTimer( pxTimer, ulExpiry );
+                            }
+                            else
+                            {
+                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                            }
+                        }
+                    }
+                }
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+                if( pxTimer == NULL )
+                {
+                    break;
+                }
+
+                if( ( pxTimer->ucStatus & tmrSTATUS_CALLBACK_IN_ISR ) != 0 )
+                {
+                    traceTIMER_EXPIRED( pxTimer );
+                    pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+                }
+                else if( xTimerPendFunctionCallFromISR( prvHighResDeferredCallback, pxTimer, 0, &xHigherPriorityTaskWoken ) != pdPASS )
+                {
+                    xHighResStats.ulDropped++;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+        }
+/*-----------------------------------------------------------*/
+
+        void vTimerGetHighResStats( TimerHighResStats_t * pxStats )
+        {
+            configASSERT( pxStats );
+
+            taskENTER_CRITICAL();
+            {
+                *pxStats = xHighResStats;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+    #endif /* configUSE_HIGH_RES_TIMERS */
+/*-----------------------------------------------------------*/
+
     #if ( configUSE_TRACE_FACILITY == 1 )
 
         UBaseType_t uxTimerGetTimerNumber( TimerHandle_t xTimer )
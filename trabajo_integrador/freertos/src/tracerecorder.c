@@ -0,0 +1,179 @@
+/*
+ * Kernel trace recorder for FreeRTOS.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tracerecorder.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+    #if ( ( configTRACE_RECORDER_RECORDS & ( configTRACE_RECORDER_RECORDS - 1 ) ) != 0 )
+        #error configTRACE_RECORDER_RECORDS must be a power of two.
+    #endif
+
+    #if ( configTRACE_RECORDER_OBJECTS > 255 )
+        #error configTRACE_RECORDER_OBJECTS must fit in the 8-bit object field of a record.
+    #endif
+
+    typedef struct xTRACE_RECORDER
+    {
+        TraceRecorderHeader_t xHeader;
+        TraceObject_t xObjects[ configTRACE_RECORDER_OBJECTS ];
+        TraceRecord_t xRecords[ configTRACE_RECORDER_RECORDS ];
+    } TraceRecorder_t;
+
+/* Not static, so that a debugger can dump it by name. */
+    TraceRecorder_t xTraceRecorder =
+    {
+        {
+            traceRECORDER_MAGIC,
+            traceRECORDER_VERSION,
+            configTRACE_RECORDER_OBJECTS,
+            traceRECORDER_NAME_LENGTH,
+            configTRACE_RECORDER_TIMESTAMP_HZ,
+            configTRACE_RECORDER_RECORDS,
+            0, 0, 0, 0
+        },
+        { { 0U, { 0 } } },
+        { { 0U, 0U, 0U, 0U } }
+    };
+
+/*-----------------------------------------------------------*/
+
+    static void prvCopyName( TraceObject_t * pxObject,
+                             const char * pcName );
+
+/*-----------------------------------------------------------*/
+
+    static void prvCopyName( TraceObject_t * pxObject,
+                             const char * pcName )
+    {
+        UBaseType_t ux;
+
+        for( ux = 0; ux < traceRECORDER_NAME_LENGTH; ux++ )
+        {
+            pxObject->cName[ ux ] = ( pcName != NULL ) ? pcName[ ux ] : '\0';
+
+            if( pxObject->cName[ ux ] == '\0' )
+            {
+                pcName = NULL;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRecorderStart( void )
+    {
+        xTraceRecorder.xHeader.ucRunning = 1U;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRecorderStop( void )
+    {
+        xTraceRecorder.xHeader.ucRunning = 0U;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxTraceRecorderRegister( uint8_t ucType,
+                                         const char * pcName )
+    {
+        UBaseType_t uxObject = 0, uxSavedInterruptStatus;
+
+        /* Called from task creation, inside a critical section, as well as
+         * from the application. */
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            if( xTraceRecorder.xHeader.ucObjects < configTRACE_RECORDER_OBJECTS )
+            {
+                uxObject = ( UBaseType_t ) ++xTraceRecorder.xHeader.ucObjects;
+                xTraceRecorder.xObjects[ uxObject - 1U ].ucType = ucType;
+                prvCopyName( &( xTraceRecorder.xObjects[ uxObject - 1U ] ), pcName );
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        return uxObject;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRecorderSetName( UBaseType_t uxObject,
+                                const char * pcName )
+    {
+        if( ( uxObject > 0U ) && ( uxObject <= configTRACE_RECORDER_OBJECTS ) )
+        {
+            prvCopyName( &( xTraceRecorder.xObjects[ uxObject - 1U ] ), pcName );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRecorderEvent( uint8_t ucEvent,
+                              UBaseType_t uxObject,
+                              uint16_t usValue )
+    {
+        TraceRecord_t * pxRecord;
+        UBaseType_t uxSavedInterruptStatus;
+
+        if( xTraceRecorder.xHeader.ucRunning == 0U )
+        {
+            return;
+        }
+
+        /* The timestamp is taken inside the masked section, so records are in
+         * timestamp order. */
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            pxRecord = &( xTraceRecorder.xRecords[ xTraceRecorder.xHeader.ulWritten & ( configTRACE_RECORDER_RECORDS - 1U ) ] );
+            pxRecord->ulTimestamp = configTRACE_RECORDER_TIMESTAMP();
+            pxRecord->ucEvent = ucEvent;
+            pxRecord->ucObject = ( uint8_t ) uxObject;
+            pxRecord->usValue = usValue;
+            xTraceRecorder.xHeader.ulWritten++;
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRecorderISREnter( UBaseType_t uxIsr )
+    {
+        vTraceRecorderEvent( traceEVENT_ISR_ENTER, uxIsr, 0 );
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRecorderISRExit( UBaseType_t uxIsr )
+    {
+        vTraceRecorderEvent( traceEVENT_ISR_EXIT, uxIsr, 0 );
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRecorderMarker( UBaseType_t uxChannel,
+                               uint16_t usValue )
+    {
+        vTraceRecorderEvent( traceEVENT_MARKER, uxChannel, usValue );
+    }
+/*-----------------------------------------------------------*/
+
+    void vTraceRecorderDump( TraceRecorderWrite_t pxWrite,
+                             void * pvContext )
+    {
+        uint8_t ucRunning = xTraceRecorder.xHeader.ucRunning;
+
+        configASSERT( pxWrite );
+
+        /* The dump shows the recorder stopped. */
+        xTraceRecorder.xHeader.ucRunning = 0U;
+        pxWrite( &xTraceRecorder, sizeof( xTraceRecorder ), pvContext );
+        xTraceRecorder.xHeader.ucRunning = ucRunning;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TRACE_RECORDER */
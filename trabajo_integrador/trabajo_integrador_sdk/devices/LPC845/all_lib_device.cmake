@@ -166,9 +166,15 @@
 #  # description: USART Driver
 #  set(CONFIG_USE_driver_lpc_miniusart true)
 
+#  # description: USART DMA Driver
+#  set(CONFIG_USE_driver_lpc_miniusart_dma true)
+
 #  # description: SPI Driver
 #  set(CONFIG_USE_driver_lpc_minispi true)
 
+#  # description: SPI DMA Driver
+#  set(CONFIG_USE_driver_lpc_minispi_dma true)
+
 #  # description: IOCON Driver
 #  set(CONFIG_USE_driver_lpc_iocon_lite true)
 
@@ -415,7 +421,9 @@ include_if_use(driver_lpc_gpio.LPC845)
 include_if_use(driver_lpc_i2c.LPC845)
 include_if_use(driver_lpc_iocon_lite.LPC845)
 include_if_use(driver_lpc_minispi.LPC845)
+include_if_use(driver_lpc_minispi_dma.LPC845)
 include_if_use(driver_lpc_miniusart.LPC845)
+include_if_use(driver_lpc_miniusart_dma.LPC845)
 include_if_use(driver_mrt.LPC845)
 include_if_use(driver_pint.LPC845)
 include_if_use(driver_power.LPC845)
@@ -0,0 +1,272 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "fsl_spi_dma.h"
+
+/* Component ID definition, used by tools. */
+#ifndef FSL_COMPONENT_ID
+#define FSL_COMPONENT_ID "platform.drivers.lpc_minispi_dma"
+#endif
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static void SPI_RxDMACallback(dma_handle_t *handle, void *userData, bool transferDone, uint32_t intmode);
+static bool SPI_CheckSegmentDMA(const spi_transfer_t *xfer, uint8_t bytesPerFrame);
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/* The receive chain ends with the last frame on the bus, so its interrupt ends the transfer. */
+static void SPI_RxDMACallback(dma_handle_t *handle, void *userData, bool transferDone, uint32_t intmode)
+{
+    assert(NULL != userData);
+
+    spi_dma_handle_t *spiHandle = (spi_dma_handle_t *)userData;
+    SPI_Type *base              = spiHandle->base;
+
+    (void)handle;
+    (void)intmode;
+
+    spiHandle->state = (uint32_t)kStatus_SPI_Idle;
+
+    if (spiHandle->callback != NULL)
+    {
+        spiHandle->callback(base, spiHandle, transferDone ? kStatus_Success : kStatus_SPI_Error,
+                            spiHandle->userData);
+    }
+}
+
+/* A segment is a whole number of frames that fits one descriptor, on buffers the DMA can use. */
+static bool SPI_CheckSegmentDMA(const spi_transfer_t *xfer, uint8_t bytesPerFrame)
+{
+    if ((0U == xfer->dataSize) || (0U != (xfer->dataSize % bytesPerFrame)) ||
+        ((xfer->dataSize / bytesPerFrame) > DMA_MAX_TRANSFER_COUNT))
+    {
+        return false;
+    }
+    if ((2U == bytesPerFrame) &&
+        ((0U != ((uintptr_t)xfer->txData & 1U)) || (0U != ((uintptr_t)xfer->rxData & 1U))))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * brief Initialize the SPI master DMA handle.
+ *
+ * param base SPI peripheral base address.
+ * param handle SPI handle pointer.
+ * param callback User callback function called at the end of a transfer.
+ * param userData User data for callback.
+ * param txHandle DMA handle pointer for SPI Tx, the handle shall be static allocated by users.
+ * param rxHandle DMA handle pointer for SPI Rx, the handle shall be static allocated by users.
+ */
+status_t SPI_MasterTransferCreateHandleDMA(SPI_Type *base,
+                                           spi_dma_handle_t *handle,
+                                           spi_dma_callback_t callback,
+                                           void *userData,
+                                           dma_handle_t *txHandle,
+                                           dma_handle_t *rxHandle)
+{
+    /* check 'base' */
+    assert(!(NULL == base));
+    if (NULL == base)
+    {
+        return kStatus_InvalidArgument;
+    }
+    /* check 'handle' */
+    assert(!(NULL == handle));
+    if (NULL == handle)
+    {
+        return kStatus_InvalidArgument;
+    }
+    /* check DMA handles */
+    assert(!((NULL == txHandle) || (NULL == rxHandle)));
+    if ((NULL == txHandle) || (NULL == rxHandle))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    (void)memset(handle, 0, sizeof(*handle));
+    handle->base     = base;
+    handle->txHandle = txHandle;
+    handle->rxHandle = rxHandle;
+    handle->callback = callback;
+    handle->userData = userData;
+    handle->state    = (uint32_t)kStatus_SPI_Idle;
+
+    /* The send chain raises no interrupt: the receive chain ends later. */
+    DMA_SetCallback(rxHandle, SPI_RxDMACallback, handle);
+    DMA_EnableChannelPeriphRq(txHandle->base, txHandle->channel);
+    DMA_EnableChannelPeriphRq(rxHandle->base, rxHandle->channel);
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Perform a non-blocking SPI transfer using DMA.
+ *
+ * param base SPI peripheral base address.
+ * param handle SPI DMA handle pointer.
+ * param xfer Pointer to dma transfer structure.
+ * retval kStatus_Success Successfully start a transfer.
+ * retval kStatus_InvalidArgument Input argument is invalid.
+ * retval kStatus_SPI_Busy SPI is not idle, is running another transfer.
+ */
+status_t SPI_MasterTransferDMA(SPI_Type *base, spi_dma_handle_t *handle, spi_transfer_t *xfer)
+{
+    return SPI_MasterTransferScatterGatherDMA(base, handle, xfer, 1U);
+}
+
+/*!
+ * brief Perform a non-blocking SPI transfer of several buffers using DMA.
+ *
+ * param base SPI peripheral base address.
+ * param handle SPI DMA handle pointer.
+ * param xfers Array of segments.
+ * param count Number of segments, at most SPI_DMA_MAX_SEGMENTS.
+ * retval kStatus_Success Successfully start a transfer.
+ * retval kStatus_InvalidArgument Input argument is invalid.
+ * retval kStatus_SPI_Busy SPI is not idle, is running another transfer.
+ */
+status_t SPI_MasterTransferScatterGatherDMA(SPI_Type *base,
+                                            spi_dma_handle_t *handle,
+                                            spi_transfer_t *xfers,
+                                            size_t count)
+{
+    assert(!((NULL == base) || (NULL == handle) || (NULL == xfers)));
+
+    uint32_t instance = SPI_GetInstance(base);
+    spi_transfer_t *last;
+    const uint8_t *lastFrame;
+    uint32_t control, xferCfg, frames;
+    uint8_t bytesPerFrame;
+    size_t i, n;
+    void *src;
+    void *dst;
+
+    /* Check if SPI is busy */
+    if (handle->state == (uint32_t)kStatus_SPI_Busy)
+    {
+        return kStatus_SPI_Busy;
+    }
+    if ((0U == count) || (count > SPI_DMA_MAX_SEGMENTS))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    /* Read datawidth and ssel info from TXCTL. */
+    control       = base->TXCTL & (SPI_TXCTL_LEN_MASK | (uint32_t)kSPI_SselDeAssertAll);
+    bytesPerFrame = ((control >> SPI_TXCTL_LEN_SHIFT) > (uint32_t)kSPI_Data8Bits) ? 2U : 1U;
+
+    handle->transferSize = 0U;
+    for (i = 0U; i < count; i++)
+    {
+        if (!SPI_CheckSegmentDMA(&xfers[i], bytesPerFrame))
+        {
+            return kStatus_InvalidArgument;
+        }
+        handle->transferSize += xfers[i].dataSize;
+    }
+
+    last = &xfers[count - 1U];
+    control |= last->configFlags & (uint32_t)kSPI_EndOfFrame;
+
+    /* The last frame goes to TXDATCTL with the end of transfer, as SPI_WriteDataWithConfigFlags()
+     * writes it; the DMA sends it from the handle. */
+    if (last->txData != NULL)
+    {
+        lastFrame        = &last->txData[last->dataSize - bytesPerFrame];
+        handle->lastWord = (2U == bytesPerFrame) ? ((uint32_t)lastFrame[0] | ((uint32_t)lastFrame[1] << 8U)) :
+                                                   (uint32_t)lastFrame[0];
+    }
+    else
+    {
+        handle->lastWord = (uint32_t)s_dummyData[instance];
+    }
+    handle->lastWord |= control | (last->configFlags & (uint32_t)kSPI_EndOfTransfer);
+
+    /* Send chain: the frames of each segment to TXDAT, then the last one to TXDATCTL. */
+    n = 0U;
+    for (i = 0U; i < count; i++)
+    {
+        frames = (uint32_t)(xfers[i].dataSize / bytesPerFrame) - ((i == (count - 1U)) ? 1U : 0U);
+        if (0U == frames)
+        {
+            continue;
+        }
+        src     = (xfers[i].txData != NULL) ? (void *)(uintptr_t)xfers[i].txData :
+                                              (void *)(uintptr_t)&s_dummyData[instance];
+        xferCfg = DMA_CHANNEL_XFER(true, false, false, false, bytesPerFrame,
+                                   (xfers[i].txData != NULL) ? (uint8_t)kDMA_AddressInterleave1xWidth :
+                                                               (uint8_t)kDMA_AddressInterleave0xWidth,
+                                   (uint8_t)kDMA_AddressInterleave0xWidth, frames * bytesPerFrame);
+        DMA_SetupDescriptor(&handle->txDescriptor[n], xferCfg, src, (void *)(uintptr_t)&base->TXDAT,
+                            &handle->txDescriptor[n + 1U]);
+        n++;
+    }
+    xferCfg = DMA_CHANNEL_XFER(false, false, false, false, sizeof(uint32_t), (uint8_t)kDMA_AddressInterleave0xWidth,
+                               (uint8_t)kDMA_AddressInterleave0xWidth, sizeof(uint32_t));
+    DMA_SetupDescriptor(&handle->txDescriptor[n], xferCfg, &handle->lastWord, (void *)(uintptr_t)&base->TXDATCTL,
+                        NULL);
+
+    /* Receive chain: every frame, into the segment buffer or the dummy. Only the last descriptor
+     * interrupts. */
+    for (i = 0U; i < count; i++)
+    {
+        dst     = (xfers[i].rxData != NULL) ? (void *)xfers[i].rxData : (void *)&handle->rxDummy;
+        xferCfg = DMA_CHANNEL_XFER(i != (count - 1U), false, i == (count - 1U), false, bytesPerFrame,
+                                   (uint8_t)kDMA_AddressInterleave0xWidth,
+                                   (xfers[i].rxData != NULL) ? (uint8_t)kDMA_AddressInterleave1xWidth :
+                                                               (uint8_t)kDMA_AddressInterleave0xWidth,
+                                   xfers[i].dataSize);
+        DMA_SetupDescriptor(&handle->rxDescriptor[i], xferCfg, (void *)(uintptr_t)&base->RXDAT, dst,
+                            (i != (count - 1U)) ? &handle->rxDescriptor[i + 1U] : NULL);
+    }
+
+    handle->bytesPerFrame = bytesPerFrame;
+    handle->state         = (uint32_t)kStatus_SPI_Busy;
+
+    /* A frame left in RXDAT would shift the receive chain by one. */
+    while ((SPI_GetStatusFlags(base) & (uint32_t)kSPI_RxReadyFlag) != 0U)
+    {
+        (void)SPI_ReadData(base);
+    }
+    base->TXCTL = control;
+
+    DMA_SubmitChannelDescriptor(handle->rxHandle, &handle->rxDescriptor[0]);
+    DMA_StartTransfer(handle->rxHandle);
+    DMA_SubmitChannelDescriptor(handle->txHandle, &handle->txDescriptor[0]);
+    DMA_StartTransfer(handle->txHandle);
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Abort a SPI transfer using DMA.
+ *
+ * param base SPI peripheral base address.
+ * param handle SPI DMA handle pointer.
+ */
+void SPI_MasterTransferAbortDMA(SPI_Type *base, spi_dma_handle_t *handle)
+{
+    assert(NULL != handle);
+
+    /* Stop tx transfer first */
+    DMA_AbortTransfer(handle->txHandle);
+    /* Then rx transfer */
+    DMA_AbortTransfer(handle->rxHandle);
+
+    /* A frame left in TXDAT would still go out and land in RXDAT. Disabling the SPI resets it and
+     * deasserts the slave select. */
+    SPI_Enable(base, false);
+    SPI_Enable(base, true);
+
+    handle->state = (uint32_t)kStatus_SPI_Idle;
+}
@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef FSL_SPI_DMA_H_
+#define FSL_SPI_DMA_H_
+
+#include "fsl_common.h"
+#include "fsl_dma.h"
+#include "fsl_spi.h"
+
+/*!
+ * @addtogroup spi_dma_driver
+ * @{
+ */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @name Driver version */
+/*! @{ */
+/*! @brief SPI DMA driver version. */
+#define FSL_SPI_DMA_DRIVER_VERSION (MAKE_VERSION(2, 0, 0))
+/*! @} */
+
+/*! @brief Maximum number of segments in a scatter gather transfer. */
+#ifndef SPI_DMA_MAX_SEGMENTS
+#define SPI_DMA_MAX_SEGMENTS (4U)
+#endif
+
+/* Forward declaration of the handle typedef. */
+typedef struct _spi_dma_handle spi_dma_handle_t;
+
+/*! @brief SPI DMA callback called at the end of transfer. */
+typedef void (*spi_dma_callback_t)(SPI_Type *base, spi_dma_handle_t *handle, status_t status, void *userData);
+
+/*!
+ * @brief SPI DMA transfer handle, users should not touch the content of the handle.
+ *
+ * The DMA reads the descriptors and the last frame from the handle, so it must stay in memory
+ * the DMA can reach for as long as it is used.
+ */
+struct _spi_dma_handle
+{
+    SPI_Type *base;              /*!< SPI peripheral of the handle. */
+    volatile uint32_t state;     /*!< kStatus_SPI_Busy while a transfer is running, kStatus_SPI_Idle otherwise. */
+    dma_handle_t *txHandle;      /*!< DMA handler for SPI send */
+    dma_handle_t *rxHandle;      /*!< DMA handler for SPI receive */
+    uint8_t bytesPerFrame;       /*!< Bytes in a frame: 1 up to 8 bits, 2 above. */
+    spi_dma_callback_t callback; /*!< Callback for SPI DMA transfer */
+    void *userData;              /*!< User Data for SPI DMA callback */
+    size_t transferSize;         /*!< Bytes of the transfer running. */
+    uint32_t lastWord;           /*!< Last frame with its control bits, for TXDATCTL. */
+    uint16_t rxDummy;            /*!< Sink for the frames received into no buffer. */
+
+    SDK_ALIGN(dma_descriptor_t txDescriptor[SPI_DMA_MAX_SEGMENTS + 1U], FSL_FEATURE_DMA_LINK_DESCRIPTOR_ALIGN_SIZE);
+    /*!< Send chain: one descriptor per segment, then the last frame. */
+    SDK_ALIGN(dma_descriptor_t rxDescriptor[SPI_DMA_MAX_SEGMENTS], FSL_FEATURE_DMA_LINK_DESCRIPTOR_ALIGN_SIZE);
+    /*!< Receive chain: one descriptor per segment. */
+};
+
+/*******************************************************************************
+ * APIs
+ ******************************************************************************/
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @name DMA Transactional
+ * @{
+ */
+
+/*!
+ * @brief Initialize the SPI master DMA handle.
+ *
+ * This function initializes the SPI master DMA handle which can be used for other SPI master
+ * transactional APIs. Usually, for a specified SPI instance, call this API once to get the
+ * initialized handle.
+ *
+ * The DMA channels must be the ones the SPI requests: on LPC845 channels 10 (RX) and 11 (TX)
+ * for SPI0, 12 and 13 for SPI1. The channels are switched to peripheral requests here.
+ *
+ * @param base SPI peripheral base address.
+ * @param handle SPI handle pointer.
+ * @param callback User callback function called at the end of a transfer.
+ * @param userData User data for callback.
+ * @param txHandle DMA handle pointer for SPI Tx, the handle shall be static allocated by users.
+ * @param rxHandle DMA handle pointer for SPI Rx, the handle shall be static allocated by users.
+ */
+status_t SPI_MasterTransferCreateHandleDMA(SPI_Type *base,
+                                           spi_dma_handle_t *handle,
+                                           spi_dma_callback_t callback,
+                                           void *userData,
+                                           dma_handle_t *txHandle,
+                                           dma_handle_t *rxHandle);
+
+/*!
+ * @brief Perform a non-blocking SPI transfer using DMA.
+ *
+ * Same as SPI_MasterTransferScatterGatherDMA() with a single segment.
+ *
+ * @param base SPI peripheral base address.
+ * @param handle SPI DMA handle pointer.
+ * @param xfer Pointer to dma transfer structure.
+ * @retval kStatus_Success Successfully start a transfer.
+ * @retval kStatus_InvalidArgument Input argument is invalid.
+ * @retval kStatus_SPI_Busy SPI is not idle, is running another transfer.
+ */
+status_t SPI_MasterTransferDMA(SPI_Type *base, spi_dma_handle_t *handle, spi_transfer_t *xfer);
+
+/*!
+ * @brief Perform a non-blocking SPI transfer of several buffers using DMA.
+ *
+ * The segments go out back to back as one transfer, for example a command from one buffer
+ * and its payload from another, without copying them together. Each segment sends from
+ * txData, or the dummy data when it is NULL, and receives into rxData, or nowhere when it is
+ * NULL. Send and receive run on linked descriptor chains with no CPU work per frame; the
+ * callback is called once, after the last frame is received.
+ *
+ * The slave select is the one in TXCTL and is asserted with the first frame. The configFlags
+ * of the last segment act as in SPI_WriteDataWithConfigFlags() on the last frame:
+ * @ref kSPI_EndOfTransfer deasserts the slave select after it, otherwise it stays asserted and
+ * the next transfer continues the same transaction. @ref kSPI_EndOfFrame applies to every
+ * frame. @ref kSPI_ReceiveIgnore is not supported: the receive chain runs for every frame.
+ *
+ * @note Each segment is a whole number of frames, at most DMA_MAX_TRANSFER_COUNT; with frames
+ * over 8 bits its buffers are 16-bit aligned.
+ *
+ * @param base SPI peripheral base address.
+ * @param handle SPI DMA handle pointer.
+ * @param xfers Array of segments.
+ * @param count Number of segments, at most SPI_DMA_MAX_SEGMENTS.
+ * @retval kStatus_Success Successfully start a transfer.
+ * @retval kStatus_InvalidArgument Input argument is invalid.
+ * @retval kStatus_SPI_Busy SPI is not idle, is running another transfer.
+ */
+status_t SPI_MasterTransferScatterGatherDMA(SPI_Type *base,
+                                            spi_dma_handle_t *handle,
+                                            spi_transfer_t *xfers,
+                                            size_t count);
+
+/*!
+ * @brief Abort a SPI transfer using DMA.
+ *
+ * The SPI is disabled and enabled again: the frame on the bus is cut short and the slave
+ * select is deasserted at once.
+ *
+ * @param base SPI peripheral base address.
+ * @param handle SPI DMA handle pointer.
+ */
+void SPI_MasterTransferAbortDMA(SPI_Type *base, spi_dma_handle_t *handle);
+
+/*! @} */
+
+#if defined(__cplusplus)
+}
+#endif
+
+/*! @} */
+
+#endif /* FSL_SPI_DMA_H_ */
@@ -0,0 +1,738 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "fsl_usart_dma.h"
+
+/* Component ID definition, used by tools. */
+#ifndef FSL_COMPONENT_ID
+#define FSL_COMPONENT_ID "platform.drivers.lpc_miniusart_dma"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+enum _usart_dma_transfer_states
+{
+    kUSART_TxIdle,        /* TX idle. */
+    kUSART_TxBusy,        /* TX busy. */
+    kUSART_RxIdle,        /* RX idle. */
+    kUSART_RxBusy,        /* RX busy. */
+    kUSART_RxPingPongBusy,  /* RX ping pong receive running. */
+    kUSART_RxRingBufferBusy /* RX ring buffer receive running. */
+};
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static void USART_TransferSendDMACallback(dma_handle_t *handle, void *param, bool transferDone, uint32_t intmode);
+static void USART_TransferReceiveDMACallback(dma_handle_t *handle, void *param, bool transferDone, uint32_t intmode);
+static size_t USART_GetRxDMACount(usart_dma_handle_t *handle);
+static void USART_StartRxChainDMA(
+    USART_Type *base, usart_dma_handle_t *handle, uint8_t *buffer0, uint8_t *buffer1, size_t size);
+static size_t USART_GetRxRingBufferHeadDMA(usart_dma_handle_t *handle);
+static void USART_UpdateRxRingBufferDMA(usart_dma_handle_t *handle);
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static void USART_TransferSendDMACallback(dma_handle_t *handle, void *param, bool transferDone, uint32_t intmode)
+{
+    assert(NULL != param);
+
+    usart_dma_handle_t *usartHandle = (usart_dma_handle_t *)param;
+
+    (void)handle;
+    (void)intmode;
+
+    usartHandle->txState = (uint8_t)kUSART_TxIdle;
+
+    if (usartHandle->callback != NULL)
+    {
+        usartHandle->callback(usartHandle->base, usartHandle,
+                              transferDone ? kStatus_USART_TxIdle : kStatus_USART_TxError, usartHandle->userData);
+    }
+}
+
+static void USART_TransferReceiveDMACallback(dma_handle_t *handle, void *param, bool transferDone, uint32_t intmode)
+{
+    assert(NULL != param);
+
+    usart_dma_handle_t *usartHandle = (usart_dma_handle_t *)param;
+    uint8_t *data;
+    size_t length;
+
+    (void)handle;
+
+    if ((uint8_t)kUSART_RxRingBufferBusy == usartHandle->rxState)
+    {
+        /* The end of a half only keeps the count up to date; frames end on an idle line. */
+        if (transferDone)
+        {
+            USART_UpdateRxRingBufferDMA(usartHandle);
+        }
+        else if (usartHandle->rxRingBufferCallback != NULL)
+        {
+            usartHandle->rxRingBufferCallback(usartHandle->base, usartHandle, 0U, 0U, kStatus_USART_RxError,
+                                              usartHandle->userData);
+        }
+        else
+        {
+            /* Avoid MISRA 15.7 */
+        }
+        return;
+    }
+
+    if ((uint8_t)kUSART_RxPingPongBusy == usartHandle->rxState)
+    {
+        if (!transferDone)
+        {
+            if (usartHandle->rxDataCallback != NULL)
+            {
+                usartHandle->rxDataCallback(usartHandle->base, usartHandle, NULL, 0U, kStatus_USART_RxError,
+                                            usartHandle->userData);
+            }
+            return;
+        }
+
+        /* Buffer 0 ends with INTA and buffer 1 with INTB; the DMA has already moved on to the other one. */
+        data   = usartHandle->rxBuffer[(intmode == (uint32_t)kDMA_IntB) ? 1U : 0U] + usartHandle->rxReported;
+        length = usartHandle->rxBufferSize - usartHandle->rxReported;
+
+        usartHandle->rxBufferIndex = (intmode == (uint32_t)kDMA_IntB) ? 0U : 1U;
+        usartHandle->rxReported    = 0U;
+        usartHandle->rxLastCount   = 0U;
+
+        if ((length != 0U) && (usartHandle->rxDataCallback != NULL))
+        {
+            usartHandle->rxDataCallback(usartHandle->base, usartHandle, data, length, kStatus_USART_RxIdle,
+                                        usartHandle->userData);
+        }
+        return;
+    }
+
+    usartHandle->rxState = (uint8_t)kUSART_RxIdle;
+
+    if (usartHandle->callback != NULL)
+    {
+        usartHandle->callback(usartHandle->base, usartHandle,
+                              transferDone ? kStatus_USART_RxIdle : kStatus_USART_RxError, usartHandle->userData);
+    }
+}
+
+/* Bytes the DMA has written into the current receive buffer. */
+static size_t USART_GetRxDMACount(usart_dma_handle_t *handle)
+{
+    size_t size = ((uint8_t)kUSART_RxBusy == handle->rxState) ? handle->rxDataSizeAll : handle->rxBufferSize;
+
+    return size - DMA_GetRemainingBytes(handle->rxDmaHandle->base, handle->rxDmaHandle->channel);
+}
+
+/* Starts two descriptors, each linked to the other, that fill buffer0 and buffer1 in turn. */
+static void USART_StartRxChainDMA(
+    USART_Type *base, usart_dma_handle_t *handle, uint8_t *buffer0, uint8_t *buffer1, size_t size)
+{
+    dma_handle_t *dmaHandle = handle->rxDmaHandle;
+    uint32_t xferCfgA, xferCfgB;
+
+    handle->rxBuffer[0]   = buffer0;
+    handle->rxBuffer[1]   = buffer1;
+    handle->rxBufferSize  = size;
+    handle->rxBufferIndex = 0U;
+    handle->rxReported    = 0U;
+    handle->rxLastCount   = 0U;
+
+    /* Buffer 0 raises INTA and buffer 1 INTB, so the callback knows which one ended. */
+    xferCfgA = DMA_CHANNEL_XFER(true, false, true, false, sizeof(uint8_t), (uint8_t)kDMA_AddressInterleave0xWidth,
+                                (uint8_t)kDMA_AddressInterleave1xWidth, size);
+    xferCfgB = DMA_CHANNEL_XFER(true, false, false, true, sizeof(uint8_t), (uint8_t)kDMA_AddressInterleave0xWidth,
+                                (uint8_t)kDMA_AddressInterleave1xWidth, size);
+    DMA_SetupDescriptor(&handle->rxDescriptor[0], xferCfgA, (void *)(uintptr_t)&base->RXDAT, buffer0,
+                        &handle->rxDescriptor[1]);
+    DMA_SetupDescriptor(&handle->rxDescriptor[1], xferCfgB, (void *)(uintptr_t)&base->RXDAT, buffer1,
+                        &handle->rxDescriptor[0]);
+
+    DMA_EnableChannelPeriphRq(dmaHandle->base, dmaHandle->channel);
+    DMA_SubmitChannelDescriptor(dmaHandle, &handle->rxDescriptor[0]);
+    DMA_StartTransfer(dmaHandle);
+}
+
+/* Ring buffer index the DMA writes next. The descriptor loaded in the channel tells the half, INTA
+ * for the first and INTB for the second; it is read again in case the DMA moved on in between. */
+static size_t USART_GetRxRingBufferHeadDMA(usart_dma_handle_t *handle)
+{
+    DMA_Type *dmaBase = handle->rxDmaHandle->base;
+    uint32_t channel  = handle->rxDmaHandle->channel;
+    uint32_t half;
+    size_t remaining;
+
+    do
+    {
+        half      = dmaBase->CHANNEL[channel].XFERCFG & DMA_CHANNEL_XFERCFG_SETINTB_MASK;
+        remaining = DMA_GetRemainingBytes(dmaBase, channel);
+    } while (half != (dmaBase->CHANNEL[channel].XFERCFG & DMA_CHANNEL_XFERCFG_SETINTB_MASK));
+
+    return ((0U != half) ? handle->rxBufferSize : 0U) + handle->rxBufferSize - remaining;
+}
+
+/* Accounts the bytes the DMA wrote since the previous update. The end of each half updates it, so
+ * that is less than a whole ring buffer. */
+static void USART_UpdateRxRingBufferDMA(usart_dma_handle_t *handle)
+{
+    size_t size     = handle->rxRingBufferSize;
+    size_t head     = USART_GetRxRingBufferHeadDMA(handle);
+    size_t received = (head + size - handle->rxRingBufferHead) % size;
+
+    handle->rxRingBufferHead = head;
+    handle->rxRingBufferLength += received;
+    handle->rxRingBufferFrame += received;
+
+    /* The DMA wrote over data not released yet: drop everything up to here. */
+    if (handle->rxRingBufferLength > size)
+    {
+        handle->rxRingBufferLength = 0U;
+        handle->rxRingBufferFrame  = 0U;
+        if (handle->rxRingBufferCallback != NULL)
+        {
+            handle->rxRingBufferCallback(handle->base, handle, head, 0U, kStatus_USART_RxRingBufferOverrun,
+                                         handle->userData);
+        }
+    }
+}
+
+/*!
+ * brief Initializes the USART handle which is used in transactional functions.
+ * param base USART peripheral base address.
+ * param handle Pointer to usart_dma_handle_t structure.
+ * param callback Callback function.
+ * param userData User data.
+ * param txDmaHandle User-requested DMA handle for TX DMA transfer, NULL if not used.
+ * param rxDmaHandle User-requested DMA handle for RX DMA transfer, NULL if not used.
+ */
+status_t USART_TransferCreateHandleDMA(USART_Type *base,
+                                       usart_dma_handle_t *handle,
+                                       usart_dma_transfer_callback_t callback,
+                                       void *userData,
+                                       dma_handle_t *txDmaHandle,
+                                       dma_handle_t *rxDmaHandle)
+{
+    /* check 'base' */
+    assert(!(NULL == base));
+    if (NULL == base)
+    {
+        return kStatus_InvalidArgument;
+    }
+    /* check 'handle' */
+    assert(!(NULL == handle));
+    if (NULL == handle)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    (void)memset(handle, 0, sizeof(*handle));
+    handle->base     = base;
+    handle->callback = callback;
+    handle->userData = userData;
+    handle->rxState  = (uint8_t)kUSART_RxIdle;
+    handle->txState  = (uint8_t)kUSART_TxIdle;
+
+    handle->rxDmaHandle = rxDmaHandle;
+    handle->txDmaHandle = txDmaHandle;
+
+    /* Configure TX. */
+    if (txDmaHandle != NULL)
+    {
+        DMA_SetCallback(txDmaHandle, USART_TransferSendDMACallback, handle);
+        DMA_EnableChannelPeriphRq(txDmaHandle->base, txDmaHandle->channel);
+    }
+
+    /* Configure RX. */
+    if (rxDmaHandle != NULL)
+    {
+        DMA_SetCallback(rxDmaHandle, USART_TransferReceiveDMACallback, handle);
+        DMA_EnableChannelPeriphRq(rxDmaHandle->base, rxDmaHandle->channel);
+    }
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Sends data using DMA.
+ *
+ * This function sends data using DMA. This is a non-blocking function, which returns
+ * right away. When all data is written to the TX register, the callback function is called.
+ *
+ * param base USART peripheral base address.
+ * param handle USART handle pointer.
+ * param xfer USART DMA transfer structure. See #usart_transfer_t.
+ * retval kStatus_Success if succeed, others failed.
+ * retval kStatus_USART_TxBusy Previous transfer on going.
+ * retval kStatus_InvalidArgument Invalid argument.
+ */
+status_t USART_TransferSendDMA(USART_Type *base, usart_dma_handle_t *handle, usart_transfer_t *xfer)
+{
+    assert(!((NULL == handle) || (NULL == handle->txDmaHandle) || (NULL == xfer)));
+
+    status_t status;
+    dma_transfer_config_t xferConfig;
+
+    /* Check if the device is busy. */
+    if ((uint8_t)kUSART_TxBusy == handle->txState)
+    {
+        return kStatus_USART_TxBusy;
+    }
+    /* The DMA counts transfers in a 10-bit field. */
+    if ((NULL == xfer->txData) || (0U == xfer->dataSize) || (xfer->dataSize > DMA_MAX_TRANSFER_COUNT))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    handle->txState       = (uint8_t)kUSART_TxBusy;
+    handle->txDataSizeAll = xfer->dataSize;
+
+    /* Prepare transfer. */
+    DMA_PrepareTransfer(&xferConfig, (void *)(uintptr_t)xfer->txData, (void *)(uintptr_t)&base->TXDAT,
+                        sizeof(uint8_t), xfer->dataSize, kDMA_MemoryToPeripheral, NULL);
+
+    /* Submit transfer. */
+    status = DMA_SubmitTransfer(handle->txDmaHandle, &xferConfig);
+    if (kStatus_Success != status)
+    {
+        handle->txState = (uint8_t)kUSART_TxIdle;
+        return kStatus_USART_TxBusy;
+    }
+    DMA_StartTransfer(handle->txDmaHandle);
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Receives data using DMA.
+ *
+ * This function receives data using DMA. This is a non-blocking function, which returns
+ * right away. When all data is received, the receive callback function is called.
+ *
+ * param base USART peripheral base address.
+ * param handle Pointer to usart_dma_handle_t structure.
+ * param xfer USART DMA transfer structure. See #usart_transfer_t.
+ * retval kStatus_Success if succeed, others failed.
+ * retval kStatus_USART_RxBusy Previous transfer on going.
+ * retval kStatus_InvalidArgument Invalid argument.
+ */
+status_t USART_TransferReceiveDMA(USART_Type *base, usart_dma_handle_t *handle, usart_transfer_t *xfer)
+{
+    assert(!((NULL == handle) || (NULL == handle->rxDmaHandle) || (NULL == xfer)));
+
+    status_t status;
+    dma_transfer_config_t xferConfig;
+
+    /* Check if the device is busy. */
+    if ((uint8_t)kUSART_RxIdle != handle->rxState)
+    {
+        return kStatus_USART_RxBusy;
+    }
+    if ((NULL == xfer->rxData) || (0U == xfer->dataSize) || (xfer->dataSize > DMA_MAX_TRANSFER_COUNT))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    handle->rxState       = (uint8_t)kUSART_RxBusy;
+    handle->rxDataSizeAll = xfer->dataSize;
+    handle->rxLastCount   = 0U;
+
+    /* Prepare transfer. */
+    DMA_PrepareTransfer(&xferConfig, (void *)(uintptr_t)&base->RXDAT, xfer->rxData, sizeof(uint8_t), xfer->dataSize,
+                        kDMA_PeripheralToMemory, NULL);
+
+    /* Submit transfer. */
+    status = DMA_SubmitTransfer(handle->rxDmaHandle, &xferConfig);
+    if (kStatus_Success != status)
+    {
+        handle->rxState = (uint8_t)kUSART_RxIdle;
+        return kStatus_USART_RxBusy;
+    }
+    DMA_StartTransfer(handle->rxDmaHandle);
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Receives continuously into two buffers using DMA.
+ *
+ * param base USART peripheral base address.
+ * param handle Pointer to usart_dma_handle_t structure.
+ * param buffer0 First receive buffer.
+ * param buffer1 Second receive buffer.
+ * param size Size of each buffer, at most DMA_MAX_TRANSFER_COUNT - 1 bytes.
+ * param callback Receive callback function.
+ * retval kStatus_Success if succeed, others failed.
+ * retval kStatus_USART_RxBusy Previous transfer on going.
+ * retval kStatus_InvalidArgument Invalid argument.
+ */
+status_t USART_TransferReceivePingPongDMA(USART_Type *base,
+                                          usart_dma_handle_t *handle,
+                                          uint8_t *buffer0,
+                                          uint8_t *buffer1,
+                                          size_t size,
+                                          usart_dma_rx_data_callback_t callback)
+{
+    assert(!((NULL == handle) || (NULL == handle->rxDmaHandle)));
+
+    dma_handle_t *dmaHandle = handle->rxDmaHandle;
+
+    if ((uint8_t)kUSART_RxIdle != handle->rxState)
+    {
+        return kStatus_USART_RxBusy;
+    }
+    /* DMA_GetRemainingBytes() cannot tell a full chained buffer of 1024 from an empty one. */
+    if ((NULL == buffer0) || (NULL == buffer1) || (0U == size) || (size >= DMA_MAX_TRANSFER_COUNT))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (DMA_ChannelIsActive(dmaHandle->base, dmaHandle->channel))
+    {
+        return kStatus_USART_RxBusy;
+    }
+
+    handle->rxDataCallback = callback;
+    handle->rxState        = (uint8_t)kUSART_RxPingPongBusy;
+    USART_StartRxChainDMA(base, handle, buffer0, buffer1, size);
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Receives continuously into a ring buffer using DMA.
+ *
+ * param base USART peripheral base address.
+ * param handle Pointer to usart_dma_handle_t structure.
+ * param ringBuffer Start address of the ring buffer.
+ * param ringBufferSize Size of the ring buffer, even and at most 2 * (DMA_MAX_TRANSFER_COUNT - 1) bytes.
+ * param callback Frame callback function.
+ * retval kStatus_Success if succeed, others failed.
+ * retval kStatus_USART_RxBusy Previous transfer on going.
+ * retval kStatus_InvalidArgument Invalid argument.
+ */
+status_t USART_TransferStartRingBufferDMA(USART_Type *base,
+                                          usart_dma_handle_t *handle,
+                                          uint8_t *ringBuffer,
+                                          size_t ringBufferSize,
+                                          usart_dma_ring_buffer_callback_t callback)
+{
+    assert(!((NULL == handle) || (NULL == handle->rxDmaHandle)));
+
+    dma_handle_t *dmaHandle = handle->rxDmaHandle;
+
+    if ((uint8_t)kUSART_RxIdle != handle->rxState)
+    {
+        return kStatus_USART_RxBusy;
+    }
+    /* Each half is one descriptor of the ping pong chain, with the same limit. */
+    if ((NULL == ringBuffer) || (0U == ringBufferSize) || (0U != (ringBufferSize & 1U)) ||
+        ((ringBufferSize / 2U) >= DMA_MAX_TRANSFER_COUNT))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (DMA_ChannelIsActive(dmaHandle->base, dmaHandle->channel))
+    {
+        return kStatus_USART_RxBusy;
+    }
+
+    handle->rxRingBufferCallback = callback;
+    handle->rxRingBufferSize     = ringBufferSize;
+    handle->rxRingBufferHead     = 0U;
+    handle->rxRingBufferLength   = 0U;
+    handle->rxRingBufferFrame    = 0U;
+    handle->rxState              = (uint8_t)kUSART_RxRingBufferBusy;
+    USART_StartRxChainDMA(base, handle, ringBuffer, ringBuffer + (ringBufferSize / 2U), ringBufferSize / 2U);
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Stops the ring buffer receive.
+ *
+ * param base USART peripheral base address.
+ * param handle Pointer to usart_dma_handle_t structure.
+ */
+void USART_TransferStopRingBufferDMA(USART_Type *base, usart_dma_handle_t *handle)
+{
+    assert(NULL != handle);
+
+    if ((uint8_t)kUSART_RxRingBufferBusy == handle->rxState)
+    {
+        USART_TransferAbortReceiveDMA(base, handle);
+    }
+}
+
+/*!
+ * brief Gets the number of bytes received in the ring buffer and not released yet.
+ *
+ * param base USART peripheral base address.
+ * param handle Pointer to usart_dma_handle_t structure.
+ * return Length of the data in the ring buffer, including a frame not reported yet.
+ */
+size_t USART_TransferGetRxRingBufferLengthDMA(USART_Type *base, usart_dma_handle_t *handle)
+{
+    assert(!((NULL == handle) || (NULL == handle->rxDmaHandle)));
+
+    uint32_t regPrimask;
+    size_t length, size;
+
+    (void)base;
+
+    /* The counts are updated from interrupts. */
+    regPrimask = DisableGlobalIRQ();
+    length     = handle->rxRingBufferLength;
+    if ((uint8_t)kUSART_RxRingBufferBusy == handle->rxState)
+    {
+        size = handle->rxRingBufferSize;
+        length += (USART_GetRxRingBufferHeadDMA(handle) + size - handle->rxRingBufferHead) % size;
+    }
+    EnableGlobalIRQ(regPrimask);
+
+    return length;
+}
+
+/*!
+ * brief Releases the oldest bytes of the ring buffer.
+ *
+ * param base USART peripheral base address.
+ * param handle Pointer to usart_dma_handle_t structure.
+ * param length Bytes to release, at most USART_TransferGetRxRingBufferLengthDMA().
+ */
+void USART_TransferReleaseRingBufferDMA(USART_Type *base, usart_dma_handle_t *handle, size_t length)
+{
+    assert(NULL != handle);
+
+    uint32_t regPrimask;
+
+    (void)base;
+
+    /* After an overrun the frame may be gone already. */
+    regPrimask                 = DisableGlobalIRQ();
+    handle->rxRingBufferLength = handle->rxRingBufferLength - MIN(length, handle->rxRingBufferLength);
+    EnableGlobalIRQ(regPrimask);
+}
+
+/*!
+ * brief Checks the receiver for an idle line.
+ *
+ * param base USART peripheral base address.
+ * param handle Pointer to usart_dma_handle_t structure.
+ */
+void USART_TransferHandleIdleDMA(USART_Type *base, usart_dma_handle_t *handle)
+{
+    assert(!((NULL == handle) || (NULL == handle->rxDmaHandle)));
+
+    dma_handle_t *dmaHandle = handle->rxDmaHandle;
+    uint32_t channelMask    = 1UL << DMA_CHANNEL_INDEX(dmaHandle->base, dmaHandle->channel);
+    uint32_t flags;
+    size_t count, reported;
+    uint8_t *data;
+    bool idle;
+
+    if ((uint8_t)kUSART_RxIdle == handle->rxState)
+    {
+        return;
+    }
+
+    /* Keep the DMA callback of this channel out while the counts are compared and the segment is
+     * reported, so segments come out in order. A flag raised meanwhile is served afterwards. */
+    DMA_DisableChannelInterrupts(dmaHandle->base, dmaHandle->channel);
+
+    /* A buffer ended and its interrupt is pending: the remaining count already belongs to the next
+     * buffer, so leave it to the interrupt. */
+    if (((DMA_COMMON_REG_GET(dmaHandle->base, dmaHandle->channel, INTA) |
+          DMA_COMMON_REG_GET(dmaHandle->base, dmaHandle->channel, INTB)) &
+         channelMask) != 0U)
+    {
+        DMA_EnableChannelInterrupts(dmaHandle->base, dmaHandle->channel);
+        return;
+    }
+
+    flags = USART_GetStatusFlags(base);
+    if ((flags & (uint32_t)kUSART_HardwareOverrunFlag) != 0U)
+    {
+        USART_ClearStatusFlags(base, (uint32_t)kUSART_HardwareOverrunFlag);
+        DMA_EnableChannelInterrupts(dmaHandle->base, dmaHandle->channel);
+        if ((uint8_t)kUSART_RxPingPongBusy == handle->rxState)
+        {
+            if (handle->rxDataCallback != NULL)
+            {
+                handle->rxDataCallback(base, handle, NULL, 0U, kStatus_USART_HardwareOverrun, handle->userData);
+            }
+        }
+        else if ((uint8_t)kUSART_RxRingBufferBusy == handle->rxState)
+        {
+            if (handle->rxRingBufferCallback != NULL)
+            {
+                handle->rxRingBufferCallback(base, handle, handle->rxRingBufferHead, 0U,
+                                             kStatus_USART_HardwareOverrun, handle->userData);
+            }
+        }
+        else if (handle->callback != NULL)
+        {
+            handle->callback(base, handle, kStatus_USART_HardwareOverrun, handle->userData);
+        }
+        else
+        {
+            /* Avoid MISRA 15.7 */
+        }
+        return;
+    }
+
+    /* Idle: nothing arrived since the previous check, no character on the line and none waiting
+     * for the DMA in RXDAT. */
+    if ((uint8_t)kUSART_RxRingBufferBusy == handle->rxState)
+    {
+        USART_UpdateRxRingBufferDMA(handle);
+        count = handle->rxRingBufferFrame;
+        idle  = (count != 0U) && (handle->rxRingBufferHead == handle->rxLastCount) &&
+               ((flags & ((uint32_t)kUSART_RxIdleFlag | (uint32_t)kUSART_RxReady)) == (uint32_t)kUSART_RxIdleFlag);
+        handle->rxLastCount = handle->rxRingBufferHead;
+        if (idle)
+        {
+            handle->rxRingBufferFrame = 0U;
+            if (handle->rxRingBufferCallback != NULL)
+            {
+                handle->rxRingBufferCallback(base, handle,
+                                             (handle->rxRingBufferHead + handle->rxRingBufferSize - count) %
+                                                 handle->rxRingBufferSize,
+                                             count, kStatus_USART_RxIdleTimeout, handle->userData);
+            }
+        }
+        DMA_EnableChannelInterrupts(dmaHandle->base, dmaHandle->channel);
+        return;
+    }
+
+    count    = USART_GetRxDMACount(handle);
+    reported = ((uint8_t)kUSART_RxPingPongBusy == handle->rxState) ? handle->rxReported : 0U;
+    idle     = (count > reported) && (count == handle->rxLastCount) &&
+           ((flags & ((uint32_t)kUSART_RxIdleFlag | (uint32_t)kUSART_RxReady)) == (uint32_t)kUSART_RxIdleFlag);
+    handle->rxLastCount = count;
+
+    if (!idle)
+    {
+        DMA_EnableChannelInterrupts(dmaHandle->base, dmaHandle->channel);
+        return;
+    }
+
+    if ((uint8_t)kUSART_RxPingPongBusy == handle->rxState)
+    {
+        data               = handle->rxBuffer[handle->rxBufferIndex] + reported;
+        handle->rxReported = count;
+        if (handle->rxDataCallback != NULL)
+        {
+            handle->rxDataCallback(base, handle, data, count - reported, kStatus_USART_RxIdleTimeout,
+                                   handle->userData);
+        }
+        DMA_EnableChannelInterrupts(dmaHandle->base, dmaHandle->channel);
+        return;
+    }
+
+    /* A single receive ends here with what it got. */
+    DMA_AbortTransfer(dmaHandle);
+    DMA_EnableChannelInterrupts(dmaHandle->base, dmaHandle->channel);
+    handle->rxDataSizeAll = count;
+    handle->rxState       = (uint8_t)kUSART_RxIdle;
+    if (handle->callback != NULL)
+    {
+        handle->callback(base, handle, kStatus_USART_RxIdleTimeout, handle->userData);
+    }
+}
+
+/*!
+ * brief Aborts the sent data using DMA.
+ *
+ * This function aborts send data using DMA.
+ *
+ * param base USART peripheral base address
+ * param handle Pointer to usart_dma_handle_t structure
+ */
+void USART_TransferAbortSendDMA(USART_Type *base, usart_dma_handle_t *handle)
+{
+    assert(NULL != handle);
+    assert(NULL != handle->txDmaHandle);
+
+    /* Stop transfer. */
+    DMA_AbortTransfer(handle->txDmaHandle);
+
+    handle->txState = (uint8_t)kUSART_TxIdle;
+}
+
+/*!
+ * brief Aborts the received data using DMA.
+ *
+ * This function aborts the data receive using DMA, single, ping pong or ring buffer.
+ *
+ * param base USART peripheral base address
+ * param handle Pointer to usart_dma_handle_t structure
+ */
+void USART_TransferAbortReceiveDMA(USART_Type *base, usart_dma_handle_t *handle)
+{
+    assert(NULL != handle);
+    assert(NULL != handle->rxDmaHandle);
+
+    /* Stop transfer. */
+    DMA_AbortTransfer(handle->rxDmaHandle);
+
+    handle->rxState = (uint8_t)kUSART_RxIdle;
+}
+
+/*!
+ * brief Get the number of bytes that have been received.
+ *
+ * This function gets the number of bytes that have been received.
+ *
+ * param base USART peripheral base address.
+ * param handle USART handle pointer.
+ * param count Receive bytes count.
+ * retval kStatus_NoTransferInProgress No receive in progress.
+ * retval kStatus_InvalidArgument Parameter is invalid.
+ * retval kStatus_Success Get successfully through the parameter \p count;
+ */
+status_t USART_TransferGetReceiveCountDMA(USART_Type *base, usart_dma_handle_t *handle, uint32_t *count)
+{
+    assert(!((NULL == handle) || (NULL == handle->rxDmaHandle) || (NULL == count)));
+
+    if ((uint8_t)kUSART_RxIdle == handle->rxState)
+    {
+        return kStatus_NoTransferInProgress;
+    }
+
+    *count = (uint32_t)USART_GetRxDMACount(handle);
+
+    return kStatus_Success;
+}
+
+/*!
+ * brief Get the number of bytes that have been sent.
+ *
+ * This function gets the number of bytes that have been sent.
+ *
+ * param base USART peripheral base address.
+ * param handle USART handle pointer.
+ * param count Sent bytes count.
+ * retval kStatus_NoTransferInProgress No send in progress.
+ * retval kStatus_InvalidArgument Parameter is invalid.
+ * retval kStatus_Success Get successfully through the parameter \p count;
+ */
+status_t USART_TransferGetSendCountDMA(USART_Type *base, usart_dma_handle_t *handle, uint32_t *count)
+{
+    assert(!((NULL == handle) || (NULL == handle->txDmaHandle) || (NULL == count)));
+
+    if ((uint8_t)kUSART_TxIdle == handle->txState)
+    {
+        return kStatus_NoTransferInProgress;
+    }
+
+    *count = handle->txDataSizeAll - DMA_GetRemainingBytes(handle->txDmaHandle->base, handle->txDmaHandle->channel);
+
+    return kStatus_Success;
+}
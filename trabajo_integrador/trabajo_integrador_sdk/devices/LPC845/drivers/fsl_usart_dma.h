@@ -0,0 +1,328 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef FSL_USART_DMA_H_
+#define FSL_USART_DMA_H_
+
+#include "fsl_common.h"
+#include "fsl_dma.h"
+#include "fsl_usart.h"
+
+/*!
+ * @addtogroup usart_dma_driver
+ * @{
+ */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @name Driver version */
+/*! @{ */
+/*! @brief USART dma driver version. */
+#define FSL_USART_DMA_DRIVER_VERSION (MAKE_VERSION(2, 1, 0))
+/*! @} */
+
+#if !(defined(FSL_FEATURE_USART_HAS_RXIDLETO_CHECK) && FSL_FEATURE_USART_HAS_RXIDLETO_CHECK)
+/*! @brief Receive idle timeout status.
+ *
+ * This USART has no receive idle timeout interrupt; the DMA driver detects the idle line
+ * in USART_TransferHandleIdleDMA() and reports it with the same status code.
+ */
+enum
+{
+    kStatus_USART_RxIdleTimeout = MAKE_STATUS(kStatusGroup_LPC_USART, 13), /*!< USART receive idle times out. */
+};
+#endif
+
+/* Forward declaration of the handle typedef. */
+typedef struct _usart_dma_handle usart_dma_handle_t;
+
+/*! @brief USART transfer callback function. */
+typedef void (*usart_dma_transfer_callback_t)(USART_Type *base,
+                                              usart_dma_handle_t *handle,
+                                              status_t status,
+                                              void *userData);
+
+/*!
+ * @brief USART ping pong receive callback function.
+ *
+ * Called with each new segment of received data: the end of a buffer (@ref kStatus_USART_RxIdle)
+ * or the data received up to an idle line (@ref kStatus_USART_RxIdleTimeout). On an error the
+ * status is the error code and the segment is empty.
+ */
+typedef void (*usart_dma_rx_data_callback_t)(
+    USART_Type *base, usart_dma_handle_t *handle, uint8_t *data, size_t length, status_t status, void *userData);
+
+/*!
+ * @brief USART ring buffer frame callback function.
+ *
+ * Called with each frame, the data received up to an idle line (@ref kStatus_USART_RxIdleTimeout).
+ * The frame is @p length bytes of the ring buffer from index @p offset, and continues at the start
+ * of the ring buffer when it passes the end. It stays in the ring buffer until released with
+ * USART_TransferReleaseRingBufferDMA(). On an error the status is the error code and the frame
+ * is empty.
+ */
+typedef void (*usart_dma_ring_buffer_callback_t)(
+    USART_Type *base, usart_dma_handle_t *handle, size_t offset, size_t length, status_t status, void *userData);
+
+/*!
+ * @brief USART DMA handle
+ */
+struct _usart_dma_handle
+{
+    USART_Type *base; /*!< USART peripheral base address. */
+
+    usart_dma_transfer_callback_t callback; /*!< Callback function. */
+    void *userData;                         /*!< USART callback function parameter.*/
+    size_t rxDataSizeAll;                   /*!< Size of the data to receive. */
+    size_t txDataSizeAll;                   /*!< Size of the data to send out. */
+
+    dma_handle_t *txDmaHandle; /*!< The DMA TX channel used. */
+    dma_handle_t *rxDmaHandle; /*!< The DMA RX channel used. */
+
+    volatile uint8_t txState; /*!< TX transfer state. */
+    volatile uint8_t rxState; /*!< RX transfer state */
+
+    usart_dma_rx_data_callback_t rxDataCallback; /*!< Ping pong receive callback function. */
+    uint8_t *rxBuffer[2];                        /*!< Ping pong receive buffers. */
+    size_t rxBufferSize;                         /*!< Size of each ping pong buffer. */
+    volatile uint8_t rxBufferIndex;              /*!< Ping pong buffer the DMA is filling. */
+    volatile size_t rxReported;                  /*!< Bytes of that buffer already passed to the callback. */
+    size_t rxLastCount;                          /*!< Bytes received at the previous idle check. */
+
+    usart_dma_ring_buffer_callback_t rxRingBufferCallback; /*!< Ring buffer frame callback function. */
+    size_t rxRingBufferSize;                               /*!< Size of the ring buffer. */
+    size_t rxRingBufferHead;                               /*!< Index the DMA writes next, at the last update. */
+    volatile size_t rxRingBufferLength;                    /*!< Bytes received and not released yet. */
+    size_t rxRingBufferFrame;                              /*!< Bytes of the frame not reported yet. */
+
+    SDK_ALIGN(dma_descriptor_t rxDescriptor[2], FSL_FEATURE_DMA_LINK_DESCRIPTOR_ALIGN_SIZE);
+    /*!< Ping pong descriptors, each one linked to the other. */
+};
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* _cplusplus */
+
+/*!
+ * @name DMA transactional
+ * @{
+ */
+
+/*!
+ * @brief Initializes the USART handle which is used in transactional functions.
+ *
+ * The DMA channels must be the ones the USART requests: on LPC845 channels 0 (RX) and 1 (TX)
+ * for USART0, 2 and 3 for USART1, and so on. The channels are switched to peripheral requests
+ * here.
+ *
+ * @param base USART peripheral base address.
+ * @param handle Pointer to usart_dma_handle_t structure.
+ * @param callback Callback function.
+ * @param userData User data.
+ * @param txDmaHandle User-requested DMA handle for TX DMA transfer, NULL if not used.
+ * @param rxDmaHandle User-requested DMA handle for RX DMA transfer, NULL if not used.
+ */
+status_t USART_TransferCreateHandleDMA(USART_Type *base,
+                                       usart_dma_handle_t *handle,
+                                       usart_dma_transfer_callback_t callback,
+                                       void *userData,
+                                       dma_handle_t *txDmaHandle,
+                                       dma_handle_t *rxDmaHandle);
+
+/*!
+ * @brief Sends data using DMA.
+ *
+ * This function sends data using DMA. This is a non-blocking function, which returns
+ * right away. When all data is written to the TX register, the callback function is called
+ * with @ref kStatus_USART_TxIdle. The last character may still be shifting out; check
+ * @ref kUSART_TxIdleFlag before disabling the transmitter.
+ *
+ * @param base USART peripheral base address.
+ * @param handle USART handle pointer.
+ * @param xfer USART DMA transfer structure, at most DMA_MAX_TRANSFER_COUNT bytes. See #usart_transfer_t.
+ * @retval kStatus_Success if succeed, others failed.
+ * @retval kStatus_USART_TxBusy Previous transfer on going.
+ * @retval kStatus_InvalidArgument Invalid argument.
+ */
+status_t USART_TransferSendDMA(USART_Type *base, usart_dma_handle_t *handle, usart_transfer_t *xfer);
+
+/*!
+ * @brief Receives data using DMA.
+ *
+ * This function receives data using DMA. This is a non-blocking function, which returns
+ * right away. When all data is received, the callback function is called with
+ * @ref kStatus_USART_RxIdle. If USART_TransferHandleIdleDMA() sees the line idle before,
+ * the transfer ends early with @ref kStatus_USART_RxIdleTimeout and rxDataSizeAll in the
+ * handle is set to the number of bytes received.
+ *
+ * @param base USART peripheral base address.
+ * @param handle Pointer to usart_dma_handle_t structure.
+ * @param xfer USART DMA transfer structure, at most DMA_MAX_TRANSFER_COUNT bytes. See #usart_transfer_t.
+ * @retval kStatus_Success if succeed, others failed.
+ * @retval kStatus_USART_RxBusy Previous transfer on going.
+ * @retval kStatus_InvalidArgument Invalid argument.
+ */
+status_t USART_TransferReceiveDMA(USART_Type *base, usart_dma_handle_t *handle, usart_transfer_t *xfer);
+
+/*!
+ * @brief Receives continuously into two buffers using DMA.
+ *
+ * Two descriptors, each linked to the other, keep the DMA filling @p buffer0 and @p buffer1
+ * in turn until the receive is aborted, with no CPU work per byte. The DMA interrupt at the
+ * end of each buffer passes the rest of that buffer to @p callback with
+ * @ref kStatus_USART_RxIdle; USART_TransferHandleIdleDMA() passes what arrived before an idle
+ * line with @ref kStatus_USART_RxIdleTimeout. Each byte is passed exactly once.
+ *
+ * The callback must be done with a segment before the DMA comes back to that buffer, one
+ * buffer time later.
+ *
+ * @param base USART peripheral base address.
+ * @param handle Pointer to usart_dma_handle_t structure.
+ * @param buffer0 First receive buffer.
+ * @param buffer1 Second receive buffer.
+ * @param size Size of each buffer, at most DMA_MAX_TRANSFER_COUNT - 1 bytes.
+ * @param callback Receive callback function.
+ * @retval kStatus_Success if succeed, others failed.
+ * @retval kStatus_USART_RxBusy Previous transfer on going.
+ * @retval kStatus_InvalidArgument Invalid argument.
+ */
+status_t USART_TransferReceivePingPongDMA(USART_Type *base,
+                                          usart_dma_handle_t *handle,
+                                          uint8_t *buffer0,
+                                          uint8_t *buffer1,
+                                          size_t size,
+                                          usart_dma_rx_data_callback_t callback);
+
+/*!
+ * @brief Receives continuously into a ring buffer using DMA.
+ *
+ * The two halves of @p ringBuffer are filled by two descriptors linked to each other, so the
+ * DMA writes straight into the ring buffer until the receive is stopped. The index the DMA writes
+ * next is taken from the descriptor loaded in the channel and DMA_GetRemainingBytes(); the DMA
+ * interrupts only at the end of each half. USART_TransferHandleIdleDMA() reports each frame,
+ * everything received up to an idle line, to @p callback where it lies in the ring buffer, so the
+ * data is not copied. Frames are released with USART_TransferReleaseRingBufferDMA().
+ *
+ * If the data not released is overwritten, @p callback gets
+ * @ref kStatus_USART_RxRingBufferOverrun, found at the latest at the end of the next half, and
+ * everything received up to then is dropped. The next frame may then start in the middle.
+ *
+ * @param base USART peripheral base address.
+ * @param handle Pointer to usart_dma_handle_t structure.
+ * @param ringBuffer Start address of the ring buffer.
+ * @param ringBufferSize Size of the ring buffer, even and at most 2 * (DMA_MAX_TRANSFER_COUNT - 1) bytes.
+ * @param callback Frame callback function.
+ * @retval kStatus_Success if succeed, others failed.
+ * @retval kStatus_USART_RxBusy Previous transfer on going.
+ * @retval kStatus_InvalidArgument Invalid argument.
+ */
+status_t USART_TransferStartRingBufferDMA(USART_Type *base,
+                                          usart_dma_handle_t *handle,
+                                          uint8_t *ringBuffer,
+                                          size_t ringBufferSize,
+                                          usart_dma_ring_buffer_callback_t callback);
+
+/*!
+ * @brief Stops the ring buffer receive.
+ *
+ * @param base USART peripheral base address.
+ * @param handle Pointer to usart_dma_handle_t structure.
+ */
+void USART_TransferStopRingBufferDMA(USART_Type *base, usart_dma_handle_t *handle);
+
+/*!
+ * @brief Gets the number of bytes received in the ring buffer and not released yet.
+ *
+ * @param base USART peripheral base address.
+ * @param handle Pointer to usart_dma_handle_t structure.
+ * @return Length of the data in the ring buffer, including a frame not reported yet.
+ */
+size_t USART_TransferGetRxRingBufferLengthDMA(USART_Type *base, usart_dma_handle_t *handle);
+
+/*!
+ * @brief Releases the oldest bytes of the ring buffer.
+ *
+ * Frees @p length bytes, usually a frame once it was handled, for the DMA to write again.
+ *
+ * @param base USART peripheral base address.
+ * @param handle Pointer to usart_dma_handle_t structure.
+ * @param length Bytes to release, at most USART_TransferGetRxRingBufferLengthDMA().
+ */
+void USART_TransferReleaseRingBufferDMA(USART_Type *base, usart_dma_handle_t *handle, size_t length);
+
+/*!
+ * @brief Checks the receiver for an idle line.
+ *
+ * This USART has no receive timeout interrupt, so the idle line is found by polling: when
+ * no byte arrived since the previous call and the receiver is idle, the data received so far
+ * is reported. Call it periodically, for example from a timer, every few character times;
+ * the idle timeout is between one and two calling periods. In ring buffer mode this is what
+ * reports the frames.
+ *
+ * @param base USART peripheral base address.
+ * @param handle Pointer to usart_dma_handle_t structure.
+ */
+void USART_TransferHandleIdleDMA(USART_Type *base, usart_dma_handle_t *handle);
+
+/*!
+ * @brief Aborts the sent data using DMA.
+ *
+ * This function aborts send data using DMA.
+ *
+ * @param base USART peripheral base address
+ * @param handle Pointer to usart_dma_handle_t structure
+ */
+void USART_TransferAbortSendDMA(USART_Type *base, usart_dma_handle_t *handle);
+
+/*!
+ * @brief Aborts the received data using DMA.
+ *
+ * This function aborts the data receive using DMA, single, ping pong or ring buffer.
+ *
+ * @param base USART peripheral base address
+ * @param handle Pointer to usart_dma_handle_t structure
+ */
+void USART_TransferAbortReceiveDMA(USART_Type *base, usart_dma_handle_t *handle);
+
+/*!
+ * @brief Get the number of bytes that have been sent.
+ *
+ * @param base USART peripheral base address.
+ * @param handle USART handle pointer.
+ * @param count Sent bytes count.
+ * @retval kStatus_NoTransferInProgress No send in progress.
+ * @retval kStatus_InvalidArgument Parameter is invalid.
+ * @retval kStatus_Success Get successfully through the parameter \p count;
+ */
+status_t USART_TransferGetSendCountDMA(USART_Type *base, usart_dma_handle_t *handle, uint32_t *count);
+
+/*!
+ * @brief Get the number of bytes that have been received.
+ *
+ * In ping pong mode this is the number of bytes in the buffer being filled.
+ *
+ * @param base USART peripheral base address.
+ * @param handle USART handle pointer.
+ * @param count Receive bytes count.
+ * @retval kStatus_NoTransferInProgress No receive in progress.
+ * @retval kStatus_InvalidArgument Parameter is invalid.
+ * @retval kStatus_Success Get successfully through the parameter \p count;
+ */
+status_t USART_TransferGetReceiveCountDMA(USART_Type *base, usart_dma_handle_t *handle, uint32_t *count);
+
+/*! @} */
+
+#if defined(__cplusplus)
+}
+#endif
+
+/*! @}*/
+
+#endif /* FSL_USART_DMA_H_ */